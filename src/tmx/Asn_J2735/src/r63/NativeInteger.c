@@ -276,6 +276,37 @@ NativeInteger_decode_uper(const asn_codec_ctx_t *opt_codec_ctx,
 		if(!native) ASN__DECODE_FAILED;
 	}
 
+	/*
+	 * A fully constrained, non-extensible whole number is decoded straight
+	 * into the native value, without the temporary INTEGER and its buffer.
+	 */
+	if(!constraints) constraints = td->encoding_constraints.per_constraints;
+	if(constraints && constraints->value.flags == APC_CONSTRAINED
+			&& constraints->value.range_bits >= 0
+			&& (size_t)constraints->value.range_bits <= 8 * sizeof(uintmax_t)) {
+		const asn_per_constraint_t *ct = &constraints->value;
+		uintmax_t uvalue = 0;
+		intmax_t svalue;
+
+		if(uper_get_constrained_whole_number(pd, &uvalue, ct->range_bits))
+			ASN__DECODE_STARVED;
+
+		if(specs && specs->field_unsigned) {
+			*(unsigned long *)native = (unsigned long)(uvalue + ct->lower_bound);
+		} else {
+			if(per_imax_range_unrebase(uvalue, ct->lower_bound,
+					ct->upper_bound, &svalue)
+				|| svalue < LONG_MIN || svalue > LONG_MAX)
+				ASN__DECODE_FAILED;
+			*native = (long)svalue;
+		}
+
+		ASN_DEBUG("NativeInteger %s got value %ld", td->name, *native);
+		rval.code = RC_OK;
+		rval.consumed = 0;
+		return rval;
+	}
+
 	memset(&tmpint, 0, sizeof tmpint);
 	rval = INTEGER_decode_uper(opt_codec_ctx, td, constraints,
 				   &tmpintptr, pd);
@@ -0,0 +1,328 @@
+/*
+ * Rtcm3Framer.h
+ *
+ * Splits a stream of RTCM 3 bytes, as received from an NTRIP caster, into
+ * the transport layer frames of RTCM 10403.3 section 4.
+ *
+ *  Created on: Oct 17, 2026
+ *      @author: ivp
+ */
+
+#ifndef INCLUDE_RTCM_RTCM3FRAMER_H_
+#define INCLUDE_RTCM_RTCM3FRAMER_H_
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <tmx/messages/byte_stream.hpp>
+
+namespace tmx {
+namespace messages {
+namespace rtcm {
+
+/**
+ * Calculate the CRC-24Q parity of the given bytes, as used by RTCM 3.
+ *
+ * @param data The bytes to check, which for a frame is everything up to the CRC
+ * @param len The number of bytes
+ * @return The 24 bit parity
+ */
+inline uint32_t crc24q(const tmx::byte_t *data, size_t len) {
+	// Taken from gpsd/crc24q.c per the GPSD license.
+	static constexpr uint32_t table[256] = {
+		0x00000000, 0x01864CFB, 0x028AD50D, 0x030C99F6,
+		0x0493E6E1, 0x0515AA1A, 0x061933EC, 0x079F7F17,
+		0x08A18139, 0x0927CDC2, 0x0A2B5434, 0x0BAD18CF,
+		0x0C3267D8, 0x0DB42B23, 0x0EB8B2D5, 0x0F3EFE2E,
+		0x10C54E89, 0x11430272, 0x124F9B84, 0x13C9D77F,
+		0x1456A868, 0x15D0E493, 0x16DC7D65, 0x175A319E,
+		0x1864CFB0, 0x19E2834B, 0x1AEE1ABD, 0x1B685646,
+		0x1CF72951, 0x1D7165AA, 0x1E7DFC5C, 0x1FFBB0A7,
+		0x200CD1E9, 0x218A9D12, 0x228604E4, 0x2300481F,
+		0x249F3708, 0x25197BF3, 0x2615E205, 0x2793AEFE,
+		0x28AD50D0, 0x292B1C2B, 0x2A2785DD, 0x2BA1C926,
+		0x2C3EB631, 0x2DB8FACA, 0x2EB4633C, 0x2F322FC7,
+		0x30C99F60, 0x314FD39B, 0x32434A6D, 0x33C50696,
+		0x345A7981, 0x35DC357A, 0x36D0AC8C, 0x3756E077,
+		0x38681E59, 0x39EE52A2, 0x3AE2CB54, 0x3B6487AF,
+		0x3CFBF8B8, 0x3D7DB443, 0x3E712DB5, 0x3FF7614E,
+		0x4019A3D2, 0x419FEF29, 0x429376DF, 0x43153A24,
+		0x448A4533, 0x450C09C8, 0x4600903E, 0x4786DCC5,
+		0x48B822EB, 0x493E6E10, 0x4A32F7E6, 0x4BB4BB1D,
+		0x4C2BC40A, 0x4DAD88F1, 0x4EA11107, 0x4F275DFC,
+		0x50DCED5B, 0x515AA1A0, 0x52563856, 0x53D074AD,
+		0x544F0BBA, 0x55C94741, 0x56C5DEB7, 0x5743924C,
+		0x587D6C62, 0x59FB2099, 0x5AF7B96F, 0x5B71F594,
+		0x5CEE8A83, 0x5D68C678, 0x5E645F8E, 0x5FE21375,
+		0x6015723B, 0x61933EC0, 0x629FA736, 0x6319EBCD,
+		0x648694DA, 0x6500D821, 0x660C41D7, 0x678A0D2C,
+		0x68B4F302, 0x6932BFF9, 0x6A3E260F, 0x6BB86AF4,
+		0x6C2715E3, 0x6DA15918, 0x6EADC0EE, 0x6F2B8C15,
+		0x70D03CB2, 0x71567049, 0x725AE9BF, 0x73DCA544,
+		0x7443DA53, 0x75C596A8, 0x76C90F5E, 0x774F43A5,
+		0x7871BD8B, 0x79F7F170, 0x7AFB6886, 0x7B7D247D,
+		0x7CE25B6A, 0x7D641791, 0x7E688E67, 0x7FEEC29C,
+		0x803347A4, 0x81B50B5F, 0x82B992A9, 0x833FDE52,
+		0x84A0A145, 0x8526EDBE, 0x862A7448, 0x87AC38B3,
+		0x8892C69D, 0x89148A66, 0x8A181390, 0x8B9E5F6B,
+		0x8C01207C, 0x8D876C87, 0x8E8BF571, 0x8F0DB98A,
+		0x90F6092D, 0x917045D6, 0x927CDC20, 0x93FA90DB,
+		0x9465EFCC, 0x95E3A337, 0x96EF3AC1, 0x9769763A,
+		0x98578814, 0x99D1C4EF, 0x9ADD5D19, 0x9B5B11E2,
+		0x9CC46EF5, 0x9D42220E, 0x9E4EBBF8, 0x9FC8F703,
+		0xA03F964D, 0xA1B9DAB6, 0xA2B54340, 0xA3330FBB,
+		0xA4AC70AC, 0xA52A3C57, 0xA626A5A1, 0xA7A0E95A,
+		0xA89E1774, 0xA9185B8F, 0xAA14C279, 0xAB928E82,
+		0xAC0DF195, 0xAD8BBD6E, 0xAE872498, 0xAF016863,
+		0xB0FAD8C4, 0xB17C943F, 0xB2700DC9, 0xB3F64132,
+		0xB4693E25, 0xB5EF72DE, 0xB6E3EB28, 0xB765A7D3,
+		0xB85B59FD, 0xB9DD1506, 0xBAD18CF0, 0xBB57C00B,
+		0xBCC8BF1C, 0xBD4EF3E7, 0xBE426A11, 0xBFC426EA,
+		0xC02AE476, 0xC1ACA88D, 0xC2A0317B, 0xC3267D80,
+		0xC4B90297, 0xC53F4E6C, 0xC633D79A, 0xC7B59B61,
+		0xC88B654F, 0xC90D29B4, 0xCA01B042, 0xCB87FCB9,
+		0xCC1883AE, 0xCD9ECF55, 0xCE9256A3, 0xCF141A58,
+		0xD0EFAAFF, 0xD169E604, 0xD2657FF2, 0xD3E33309,
+		0xD47C4C1E, 0xD5FA00E5, 0xD6F69913, 0xD770D5E8,
+		0xD84E2BC6, 0xD9C8673D, 0xDAC4FECB, 0xDB42B230,
+		0xDCDDCD27, 0xDD5B81DC, 0xDE57182A, 0xDFD154D1,
+		0xE026359F, 0xE1A07964, 0xE2ACE092, 0xE32AAC69,
+		0xE4B5D37E, 0xE5339F85, 0xE63F0673, 0xE7B94A88,
+		0xE887B4A6, 0xE901F85D, 0xEA0D61AB, 0xEB8B2D50,
+		0xEC145247, 0xED921EBC, 0xEE9E874A, 0xEF18CBB1,
+		0xF0E37B16, 0xF16537ED, 0xF269AE1B, 0xF3EFE2E0,
+		0xF4709DF7, 0xF5F6D10C, 0xF6FA48FA, 0xF77C0401,
+		0xF842FA2F, 0xF9C4B6D4, 0xFAC82F22, 0xFB4E63D9,
+		0xFCD11CCE, 0xFD575035, 0xFE5BC9C3, 0xFFDD8538,
+	};
+
+	uint32_t crc = 0;
+	for (size_t i = 0; i < len; i++)
+		crc = (crc << 8) ^ table[data[i] ^ (tmx::byte_t)(crc >> 16)];
+
+	return crc & 0x00ffffff;
+}
+
+/**
+ * Read an unsigned field directly out of a buffer of RTCM data, which packs its
+ * fields most significant bit first without regard to byte boundaries.
+ *
+ * @param data The buffer
+ * @param pos The bit position of the field from the start of the buffer
+ * @param len The number of bits in the field, which can be no more than 57
+ * @return The field value
+ */
+inline uint64_t getBits(const tmx::byte_t *data, size_t pos, size_t len) {
+	uint64_t value = 0;
+	for (size_t i = pos / 8; i <= (pos + len - 1) / 8; i++)
+		value = (value << 8) | data[i];
+
+	value >>= (8 - (pos + len) % 8) % 8;
+	return value & (~0ull >> (64 - len));
+}
+
+/**
+ * An incremental framer for an RTCM 3 byte stream.  Bytes are pushed in as they are
+ * received, in whatever pieces the transport delivers them, and each complete frame
+ * is handed back exactly once after its CRC is checked.
+ *
+ * Frames that are whole within the pushed bytes are checked in place.  Only a frame
+ * that is split across pushes is copied, into a fixed buffer big enough for the
+ * largest frame, so no memory is allocated.  If a frame fails its check, then the
+ * search for the next preamble starts at the byte after the bad one.  A damaged header
+ * that claims a long frame therefore holds back the frames behind it until enough of
+ * the stream has arrived to fail its check.
+ */
+class Rtcm3Framer {
+public:
+	static constexpr tmx::byte_t preamble = 0xD3;
+	static constexpr size_t headerBytes = 3;
+	static constexpr size_t crcBytes = 3;
+	static constexpr size_t maxPayloadBytes = 1023;
+	static constexpr size_t maxFrameBytes = headerBytes + maxPayloadBytes + crcBytes;
+
+	/**
+	 * Add bytes from the stream.  The handler is invoked as handler(frame, length) for each
+	 * complete frame, including its header and CRC.  The frame is only valid during the call.
+	 *
+	 * @param data The next bytes of the stream
+	 * @param len The number of bytes
+	 * @param handler The function to invoke with each frame
+	 * @return The number of frames found
+	 */
+	template <typename Handler>
+	size_t push(const tmx::byte_t *data, size_t len, Handler &&handler) {
+		size_t frames = 0;
+
+		while (len > 0) {
+			if (_length == 0) {
+				// Look for the next frame directly in the input
+				const tmx::byte_t *found = (const tmx::byte_t *)::memchr(data, preamble, len);
+				size_t skip = found ? found - data : len;
+				_discarded += skip;
+				data += skip;
+				len -= skip;
+
+				if (len >= headerBytes) {
+					if (!isHeader(data)) {
+						discardInput(data, len);
+						continue;
+					}
+
+					size_t frameLen = frameLength(data);
+					if (len >= frameLen) {
+						if (isValid(data, frameLen)) {
+							handler((const tmx::byte_t *)data, frameLen);
+							frames++;
+							_frames++;
+							data += frameLen;
+							len -= frameLen;
+						} else {
+							_crcErrors++;
+							discardInput(data, len);
+						}
+						continue;
+					}
+				}
+
+				if (len == 0)
+					break;
+			}
+
+			// Copy only as much as the frame in the buffer needs, then check it
+			size_t need = (_length < headerBytes ? headerBytes : frameLength(_buffer.data())) - _length;
+			size_t n = need < len ? need : len;
+			::memcpy(_buffer.data() + _length, data, n);
+			_length += n;
+			data += n;
+			len -= n;
+
+			frames += drain(handler);
+		}
+
+		return frames;
+	}
+
+	/**
+	 * Drop any partial frame, such as when the stream is reconnected.
+	 */
+	void reset() {
+		_discarded += _length;
+		_length = 0;
+	}
+
+	/**
+	 * @return The number of frames found since the framer was created
+	 */
+	uint64_t frameCount() const { return _frames; }
+
+	/**
+	 * @return The number of frames that failed the CRC check since the framer was created
+	 */
+	uint64_t crcErrorCount() const { return _crcErrors; }
+
+	/**
+	 * @return The number of bytes that were not part of any frame since the framer was created
+	 */
+	uint64_t discardedBytes() const { return _discarded; }
+
+	/**
+	 * @return The number of bytes in the frame that starts with the given header
+	 */
+	static size_t frameLength(const tmx::byte_t *header) {
+		return headerBytes + payloadLength(header) + crcBytes;
+	}
+
+	/**
+	 * @return The number of bytes in the payload of the frame that starts with the given header
+	 */
+	static size_t payloadLength(const tmx::byte_t *header) {
+		return (size_t)getBits(header, 14, 10);
+	}
+
+	/**
+	 * @return The message number of the given frame, or 0 if the payload is too short to hold one
+	 */
+	static uint16_t messageNumber(const tmx::byte_t *frame) {
+		return payloadLength(frame) < 2 ? 0 : (uint16_t)getBits(frame, 8 * headerBytes, 12);
+	}
+
+private:
+	std::array<tmx::byte_t, maxFrameBytes> _buffer;
+	size_t _length = 0;
+
+	uint64_t _frames = 0;
+	uint64_t _crcErrors = 0;
+	uint64_t _discarded = 0;
+
+	// The 6 bits between the preamble and the length are reserved as 0
+	static bool isHeader(const tmx::byte_t *data) {
+		return data[0] == preamble && (data[1] & 0xFC) == 0;
+	}
+
+	static bool isValid(const tmx::byte_t *frame, size_t frameLen) {
+		return crc24q(frame, frameLen - crcBytes) == (uint32_t)getBits(frame + frameLen - crcBytes, 0, 24);
+	}
+
+	void discardInput(const tmx::byte_t *&data, size_t &len) {
+		_discarded++;
+		data++;
+		len--;
+	}
+
+	/**
+	 * Remove bytes from the front of the buffer, along with anything up to the next preamble.
+	 */
+	void consume(size_t n) {
+		const tmx::byte_t *rest = _buffer.data() + n;
+		size_t restLen = _length - n;
+
+		const tmx::byte_t *found = (const tmx::byte_t *)::memchr(rest, preamble, restLen);
+		size_t skip = found ? found - rest : restLen;
+		_discarded += skip;
+
+		::memmove(_buffer.data(), rest + skip, restLen - skip);
+		_length = restLen - skip;
+	}
+
+	/**
+	 * Hand back every complete frame in the buffer.  After a bad frame, the bytes that
+	 * followed its preamble are searched again, so the buffer may hold more than one frame.
+	 */
+	template <typename Handler>
+	size_t drain(Handler &handler) {
+		size_t frames = 0;
+
+		while (_length >= headerBytes) {
+			if (!isHeader(_buffer.data())) {
+				_discarded++;
+				consume(1);
+				continue;
+			}
+
+			size_t frameLen = frameLength(_buffer.data());
+			if (_length < frameLen)
+				break;
+
+			if (isValid(_buffer.data(), frameLen)) {
+				handler((const tmx::byte_t *)_buffer.data(), frameLen);
+				frames++;
+				_frames++;
+				consume(frameLen);
+			} else {
+				_crcErrors++;
+				_discarded++;
+				consume(1);
+			}
+		}
+
+		return frames;
+	}
+};
+
+} /* End namespace rtcm */
+} /* End namespace messages */
+} /* End namespace tmx */
+
+#endif /* INCLUDE_RTCM_RTCM3FRAMER_H_ */
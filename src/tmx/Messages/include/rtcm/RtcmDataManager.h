@@ -164,9 +164,10 @@ public:
 		uintmax_t value = 0;
 		extractFrom(value, countBits<RtcmAttrs...>(), attrs...);
 
-		std::vector<data_type> words;
+		// The number of words is known, so split them straight into place
+		std::vector<data_type> words(numWords);
 		for (size_t w = 0; w < numWords; w++)
-			splitWord<rtcm_word>(words, value, (numWords - w - 1));
+			words[w] = (data_type)((value >> (rtcm_word::size * (numWords - w - 1))) & rtcm_word::bitmask());
 
 		return words;
 	}
@@ -101,8 +101,8 @@ private:
 					this->set_subtype(ptr->get_VersionName());
 					thisVer = ptr->get_Version();
 
-					// Reconstruct the message as specific to the type
-					if (ptr->get_MessageType()) {
+					// Reconstruct the message as specific to the type, unless it would be decoded the same way again
+					if (factory.hasType(thisVer, ptr->get_MessageType())) {
 						auto tmp = factory.create(thisVer, ptr->get_MessageType());
 						if (tmp) {
 							tmp->set_contents(ptr->get_contents());
@@ -24,9 +24,7 @@ namespace rtcm {
 class RtcmMessageFactory {
 public:
 	TmxRtcmMessage *create(RTCM_VERSION version = UNKNOWN, msgtype_type type = 0) {
-		if (!_types[rtcm::UNKNOWN].size()) {
-			registerTypes<RTCM_EOF>();
-		}
+		registerAllTypes();
 
 		// This could be a stream of messages.  Go until there are no more bytes
 		if (type < _types[version].size() && _types[version][type])
@@ -39,6 +37,14 @@ public:
 		return create(RtcmVersion(version), type);
 	}
 
+	/**
+	 * @return True if the message type has its own implementation, rather than the generic one for the version
+	 */
+	bool hasType(RTCM_VERSION version, msgtype_type type) {
+		registerAllTypes();
+		return type > 0 && type < _types[version].size() && _types[version][type];
+	}
+
 private:
 	/**
 	 * Base template for allocator
@@ -100,6 +106,12 @@ private:
 		registrarDispatch(tuple);
 	}
 
+	void registerAllTypes() {
+		if (!_types[rtcm::UNKNOWN].size()) {
+			registerTypes<RTCM_EOF>();
+		}
+	}
+
 	template <RTCM_VERSION Version>
 	void registerTypes() {
 		if (Version < RTCM_EOF) {
@@ -56,7 +56,7 @@ struct traits {
 
 	static constexpr const size_t size = Size;
 	static constexpr const data_type default_value() { return 0; }
-	static const data_type bitmask() { static bitset mask(-1); return (data_type)mask.to_ulong(); }
+	static constexpr const data_type bitmask() { return (data_type)(~0ull >> (64 - Size)); }
 	static constexpr const size_t byteSize = sizeof(data_type);
 	static constexpr const bool is_signed = std::is_signed<T>::value;
 
@@ -26,6 +26,19 @@
 #define IVPMSG_HFIELD_DSRCMETADATA_PSID "psid"
 #define IVPMSG_HFIELD_TIMESTAMP "timestamp"
 
+#define IVPMSG_BINARY_VERSION 1
+#define IVPMSG_BINARY_OPTION_DSRCMETADATA 0x0001
+#define IVPMSG_BINARY_NULL_STRING 0xFFFF
+#define IVPMSG_BINARY_FIXED_HEADER_SIZE 20
+
+typedef enum {
+	IvpMsgBinaryPayload_none = 0,
+	IvpMsgBinaryPayload_json = 1,
+	IvpMsgBinaryPayload_string = 2,
+	IvpMsgBinaryPayload_hexLower = 3,
+	IvpMsgBinaryPayload_hexUpper = 4
+} IvpMsgBinaryPayload;
+
 static pthread_mutex_t ivpMsg_numberOfMessages_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int ivpMsg_numberOfMessages = 0;
 
@@ -213,6 +226,330 @@ char *ivpMsg_createJsonString(IvpMessage *msg, IvpMsg_FormatOptions options)
 	return results;
 }
 
+static IvpMsgBinaryPayload ivpMsg_getHexPayloadType(const char *str, size_t length)
+{
+	int hasLower = 0;
+	int hasUpper = 0;
+	size_t i;
+
+	if (length == 0 || (length % 2) != 0)
+		return IvpMsgBinaryPayload_string;
+
+	for (i = 0; i < length; i++)
+	{
+		char c = str[i];
+		if (c >= 'a' && c <= 'f')
+			hasLower = 1;
+		else if (c >= 'A' && c <= 'F')
+			hasUpper = 1;
+		else if (c < '0' || c > '9')
+			return IvpMsgBinaryPayload_string;
+	}
+
+	// Mixed case can not be recreated from the bytes, so it is sent as is.
+	if (hasLower && hasUpper)
+		return IvpMsgBinaryPayload_string;
+
+	return hasUpper ? IvpMsgBinaryPayload_hexUpper : IvpMsgBinaryPayload_hexLower;
+}
+
+static int ivpMsg_hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return c - 'A' + 10;
+}
+
+static unsigned char *ivpMsg_putUInt(unsigned char *pos, uint64_t value, int size)
+{
+	int i;
+	for (i = size - 1; i >= 0; i--)
+	{
+		pos[i] = (unsigned char)(value & 0xFF);
+		value >>= 8;
+	}
+	return pos + size;
+}
+
+static unsigned char *ivpMsg_putString(unsigned char *pos, const char *str)
+{
+	if (str == NULL)
+		return ivpMsg_putUInt(pos, IVPMSG_BINARY_NULL_STRING, 2);
+
+	size_t length = strlen(str);
+	pos = ivpMsg_putUInt(pos, length, 2);
+	memcpy(pos, str, length);
+	return pos + length;
+}
+
+static size_t ivpMsg_binaryStringSize(const char *str)
+{
+	return 2 + (str == NULL ? 0 : strlen(str));
+}
+
+char *ivpMsg_createBinary(IvpMessage *msg, int *outLength)
+{
+	assert(msg != NULL);
+	assert(outLength != NULL);
+	if (msg == NULL || outLength == NULL)
+		return NULL;
+
+	*outLength = 0;
+
+	// Strings longer than this can not be represented by the 2 byte length.
+	if ((msg->type != NULL && strlen(msg->type) >= IVPMSG_BINARY_NULL_STRING)
+			|| (msg->subtype != NULL && strlen(msg->subtype) >= IVPMSG_BINARY_NULL_STRING)
+			|| (msg->source != NULL && strlen(msg->source) >= IVPMSG_BINARY_NULL_STRING)
+			|| (msg->encoding != NULL && strlen(msg->encoding) >= IVPMSG_BINARY_NULL_STRING))
+		return NULL;
+
+	IvpMsgBinaryPayload payloadType = IvpMsgBinaryPayload_none;
+	char *jsonPayload = NULL;
+	const char *payload = NULL;
+	size_t payloadLength = 0;
+
+	if (msg->payload != NULL)
+	{
+		if ((msg->payload->type & 0xFF) == cJSON_String && msg->payload->valuestring != NULL)
+		{
+			payload = msg->payload->valuestring;
+			payloadLength = strlen(payload);
+			payloadType = ivpMsg_getHexPayloadType(payload, payloadLength);
+		}
+		else
+		{
+			jsonPayload = cJSON_PrintUnformatted(msg->payload);
+			if (jsonPayload == NULL)
+				return NULL;
+
+			payload = jsonPayload;
+			payloadLength = strlen(payload);
+			payloadType = IvpMsgBinaryPayload_json;
+		}
+	}
+
+	size_t payloadBytes = payloadType == IvpMsgBinaryPayload_hexLower || payloadType == IvpMsgBinaryPayload_hexUpper ?
+			payloadLength / 2 : payloadLength;
+
+	size_t length = IVPMSG_BINARY_FIXED_HEADER_SIZE
+			+ (msg->dsrcMetadata != NULL ? 8 : 0)
+			+ ivpMsg_binaryStringSize(msg->type)
+			+ ivpMsg_binaryStringSize(msg->subtype)
+			+ ivpMsg_binaryStringSize(msg->source)
+			+ ivpMsg_binaryStringSize(msg->encoding)
+			+ 4 + payloadBytes;
+
+	unsigned char *results = malloc(length);
+	if (results != NULL)
+	{
+		unsigned char *pos = results;
+
+		*pos++ = IVPMSG_BINARY_VERSION;
+		*pos++ = (unsigned char)payloadType;
+		pos = ivpMsg_putUInt(pos, msg->dsrcMetadata != NULL ? IVPMSG_BINARY_OPTION_DSRCMETADATA : 0, 2);
+		pos = ivpMsg_putUInt(pos, msg->flags, 4);
+		pos = ivpMsg_putUInt(pos, msg->sourceId, 4);
+		pos = ivpMsg_putUInt(pos, msg->timestamp, 8);
+
+		if (msg->dsrcMetadata != NULL)
+		{
+			pos = ivpMsg_putUInt(pos, (uint32_t)msg->dsrcMetadata->psid, 4);
+			pos = ivpMsg_putUInt(pos, (uint32_t)msg->dsrcMetadata->channel, 4);
+		}
+
+		pos = ivpMsg_putString(pos, msg->type);
+		pos = ivpMsg_putString(pos, msg->subtype);
+		pos = ivpMsg_putString(pos, msg->source);
+		pos = ivpMsg_putString(pos, msg->encoding);
+
+		pos = ivpMsg_putUInt(pos, payloadBytes, 4);
+		if (payloadBytes != payloadLength)
+		{
+			size_t i;
+			for (i = 0; i < payloadBytes; i++)
+				*pos++ = (unsigned char)((ivpMsg_hexValue(payload[2 * i]) << 4) | ivpMsg_hexValue(payload[2 * i + 1]));
+		}
+		else if (payloadBytes > 0)
+		{
+			memcpy(pos, payload, payloadBytes);
+			pos += payloadBytes;
+		}
+
+		assert(pos == results + length);
+		*outLength = (int)length;
+	}
+
+	if (jsonPayload != NULL)
+		free(jsonPayload);
+
+	return (char *)results;
+}
+
+typedef struct {
+	const unsigned char *pos;
+	const unsigned char *end;
+} IvpMsgBinaryReader;
+
+static int ivpMsg_getUInt(IvpMsgBinaryReader *reader, int size, uint64_t *value)
+{
+	if (reader->end - reader->pos < size)
+		return 0;
+
+	*value = 0;
+	int i;
+	for (i = 0; i < size; i++)
+		*value = (*value << 8) | *reader->pos++;
+	return 1;
+}
+
+static int ivpMsg_getString(IvpMsgBinaryReader *reader, char **value)
+{
+	uint64_t length;
+	if (!ivpMsg_getUInt(reader, 2, &length))
+		return 0;
+
+	if (length == IVPMSG_BINARY_NULL_STRING)
+		return 1;
+
+	if ((uint64_t)(reader->end - reader->pos) < length)
+		return 0;
+
+	*value = malloc(length + 1);
+	if (*value == NULL)
+		return 0;
+
+	memcpy(*value, reader->pos, length);
+	(*value)[length] = '\0';
+	reader->pos += length;
+	return 1;
+}
+
+static cJSON *ivpMsg_getPayload(IvpMsgBinaryReader *reader, IvpMsgBinaryPayload payloadType, int *ok)
+{
+	static const char lowerDigits[] = "0123456789abcdef";
+	static const char upperDigits[] = "0123456789ABCDEF";
+
+	uint64_t length;
+	cJSON *results = NULL;
+
+	*ok = 0;
+	if (!ivpMsg_getUInt(reader, 4, &length) || (uint64_t)(reader->end - reader->pos) < length)
+		return NULL;
+
+	if (payloadType == IvpMsgBinaryPayload_none)
+	{
+		*ok = 1;
+		return NULL;
+	}
+
+	size_t strLength = (payloadType == IvpMsgBinaryPayload_hexLower || payloadType == IvpMsgBinaryPayload_hexUpper) ? length * 2 : length;
+	char *str = malloc(strLength + 1);
+	if (str == NULL)
+		return NULL;
+
+	if (strLength != length)
+	{
+		const char *digits = payloadType == IvpMsgBinaryPayload_hexUpper ? upperDigits : lowerDigits;
+		size_t i;
+		for (i = 0; i < length; i++)
+		{
+			str[2 * i] = digits[reader->pos[i] >> 4];
+			str[2 * i + 1] = digits[reader->pos[i] & 0x0F];
+		}
+	}
+	else
+	{
+		memcpy(str, reader->pos, length);
+	}
+	str[strLength] = '\0';
+	reader->pos += length;
+
+	switch (payloadType)
+	{
+	case IvpMsgBinaryPayload_json:
+		results = cJSON_Parse(str);
+		break;
+	case IvpMsgBinaryPayload_string:
+	case IvpMsgBinaryPayload_hexLower:
+	case IvpMsgBinaryPayload_hexUpper:
+		results = cJSON_CreateString(str);
+		break;
+	default:
+		break;
+	}
+
+	free(str);
+
+	*ok = results != NULL;
+	return results;
+}
+
+IvpMessage *ivpMsg_parseBinary(const char *data, int length)
+{
+	assert(data != NULL);
+	if (data == NULL || length < IVPMSG_BINARY_FIXED_HEADER_SIZE)
+		return NULL;
+
+	IvpMsgBinaryReader reader;
+	reader.pos = (const unsigned char *)data;
+	reader.end = reader.pos + length;
+
+	uint64_t version = 0, payloadType = 0, options = 0, flags = 0, sourceId = 0, timestamp = 0;
+	ivpMsg_getUInt(&reader, 1, &version);
+	ivpMsg_getUInt(&reader, 1, &payloadType);
+	ivpMsg_getUInt(&reader, 2, &options);
+	ivpMsg_getUInt(&reader, 4, &flags);
+	ivpMsg_getUInt(&reader, 4, &sourceId);
+	ivpMsg_getUInt(&reader, 8, &timestamp);
+
+	if (version != IVPMSG_BINARY_VERSION || payloadType > IvpMsgBinaryPayload_hexUpper)
+		return NULL;
+
+	IvpMessage *results = calloc(1, sizeof(IvpMessage));
+	if (results == NULL)
+		return NULL;
+
+	results->flags = (IvpMsgFlags)flags;
+	results->sourceId = (unsigned int)sourceId;
+	results->timestamp = timestamp;
+
+	int ok = 1;
+	if (options & IVPMSG_BINARY_OPTION_DSRCMETADATA)
+	{
+		uint64_t psid, channel;
+		ok = ivpMsg_getUInt(&reader, 4, &psid) && ivpMsg_getUInt(&reader, 4, &channel);
+		if (ok)
+		{
+			results->dsrcMetadata = (IvpDsrcMetadata *)malloc(sizeof(IvpDsrcMetadata));
+			assert(results->dsrcMetadata != NULL);
+			results->dsrcMetadata->psid = (int)(uint32_t)psid;
+			results->dsrcMetadata->channel = (int)(uint32_t)channel;
+		}
+	}
+
+	ok = ok && ivpMsg_getString(&reader, &results->type)
+			&& ivpMsg_getString(&reader, &results->subtype)
+			&& ivpMsg_getString(&reader, &results->source)
+			&& ivpMsg_getString(&reader, &results->encoding);
+
+	if (ok)
+		results->payload = ivpMsg_getPayload(&reader, (IvpMsgBinaryPayload)payloadType, &ok);
+
+	pthread_mutex_lock(&ivpMsg_numberOfMessages_mutex);
+	ivpMsg_numberOfMessages++;
+	pthread_mutex_unlock(&ivpMsg_numberOfMessages_mutex);
+
+	if (!ok)
+	{
+		ivpMsg_destroy(results);
+		return NULL;
+	}
+
+	return results;
+}
+
 void ivpMsg_destroy(IvpMessage *msg)
 {
 	assert(msg != NULL);
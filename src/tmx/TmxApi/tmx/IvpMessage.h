@@ -18,6 +18,14 @@ extern "C"
 typedef unsigned int IvpMsgFlags;
 #define IvpMsgFlags_None 0x00
 #define IvpMsgFlags_RouteDSRC 0x01
+/*!
+ * Only used on a registration message, to tell the core that the plugin can receive binary frames.
+ */
+#define IvpMsgFlags_BinaryFraming 0x80000000
+/*!
+ * Only used on a registration message, to tell the core that the plugin can use a shared memory transport.
+ */
+#define IvpMsgFlags_SharedMemory 0x40000000
 
 typedef struct IvpDsrcMetadata {
 	int psid;
@@ -111,6 +119,43 @@ IvpMessage *ivpMsg_copy(IvpMessage *msg);
  */
 char *ivpMsg_createJsonString(IvpMessage *msg, IvpMsg_FormatOptions options);
 
+/*!
+ * Creates a binary representation of an IvpMessage, for use in a binary frame.
+ *
+ * Header fields are stored in a fixed layout in network byte order.  A payload that is a hex string
+ * is stored as the raw bytes, so it takes half the space and does not need to be escaped.
+ *
+ * @param msg
+ * 		The message to create the binary representation of.
+ *
+ * @param outLength
+ * 		Set to the length of the returned buffer.
+ *
+ * @returns
+ * 		A new malloc'ed buffer or NULL if an error occurred.
+ *
+ * @requires
+ * 		msg != NULL
+ */
+char *ivpMsg_createBinary(IvpMessage *msg, int *outLength);
+
+/*!
+ * Creates a new IvpMessage from the binary representation created by ivpMsg_createBinary.
+ *
+ * @param data
+ * 		The binary message.
+ *
+ * @param length
+ * 		The number of bytes in data.
+ *
+ * @returns
+ * 		A malloc'ed IvpMessage or NULL if an error occurred.
+ *
+ * @requires
+ * 		data != NULL
+ */
+IvpMessage *ivpMsg_parseBinary(const char *data, int length);
+
 /*!
  * Properly destroys and free's an IvpMessage.  All IvpMessages should be destroyed using this function.
  *
@@ -7,6 +7,7 @@
 
 #include "IvpPlugin.h"
 #include "utils/MsgFramer.h"
+#include "utils/ShmRing.h"
 
 #include <string.h>
 #include <assert.h>
@@ -18,6 +19,23 @@
 #include <arpa/inet.h>
 #include <errno.h>
 
+/*!
+ * How long to wait for a message on the shared memory ring before checking the socket to the core.
+ */
+#define IVP_SHARED_MEMORY_POLL_MS 100
+/*!
+ * The number of shared memory messages to process between checks of the socket to the core.
+ */
+#define IVP_SHARED_MEMORY_SOCKET_CHECK_INTERVAL 64
+/*!
+ * How long to wait for space in the shared memory ring before dropping a message.
+ */
+#define IVP_SHARED_MEMORY_WRITE_TIMEOUT_MS 1000
+/*!
+ * The number of messages dropped from the shared memory ring between warnings.
+ */
+#define IVP_SHARED_MEMORY_DROP_REPORT_INTERVAL 1000
+
 const IvpPluginInformation IVP_PLUGIN_INFORMATION_INITIALIZER = { .onMsgReceived = NULL, .onStateChange = NULL, .onError = NULL, .onConfigChanged = NULL, .manifestLocation = NULL };
 
 void ivp_broadcastAndDestroyMessage(IvpPlugin *plugin, IvpMessage *msg);
@@ -28,6 +46,11 @@ void ivp_onStateChange(IvpPlugin *plugin, IvpPluginState state);
 void ivp_onMessageReceived(IvpPlugin *plugin, IvpMessage *msg);
 void ivp_onConfigChanged(IvpPlugin *plugin, const char *value, const char *key);
 void *ivp_receive(void *arg);
+void ivp_openSharedMemory(IvpPlugin *plugin, IvpMessage *msg);
+void ivp_closeSharedMemory(IvpPlugin *plugin);
+void ivp_processMessage(IvpPlugin *plugin, IvpMessage *msg);
+void ivp_receiveFromSocket(IvpPlugin *plugin, int fd, MsgFramer *framer, int flags);
+void ivp_receiveFromSharedMemory(IvpPlugin *plugin, int fd, MsgFramer *framer);
 
 IvpPlugin *ivp_create(IvpPluginInformation info)
 {
@@ -167,6 +190,16 @@ void ivp_removeStatusItem(IvpPlugin *plugin, const char *key)
 		ivpPluginStatus_destroyCollection(collection);
 }
 
+void ivp_setStatusItems(IvpPlugin *plugin, IvpPluginStatusCollection *collection)
+{
+	assert(plugin != NULL);
+	assert(collection != NULL);
+	if (plugin == NULL || collection == NULL)
+		return;
+
+	ivp_broadcastAndDestroyMessage(plugin, ivpPluginStatus_createMsg(collection));
+}
+
 void ivp_addEventLog(IvpPlugin *plugin, IvpLogLevel level, const char *description)
 {
 	assert(plugin != NULL);
@@ -188,24 +221,58 @@ void ivp_broadcastMessage(IvpPlugin *plugin, IvpMessage *msg)
 	if (plugin->state != IvpPluginState_connected && plugin->state != IvpPluginState_registered)
 		return;
 
-	char *jsonMsg = ivpMsg_createJsonString(msg, IvpMsg_FormatOptions_none);
-	if (jsonMsg != NULL)
+	MsgFramer_FrameType frameType;
+	int msgLength = 0;
+	char *rawMsg = NULL;
+
+	// The receive thread sets the framing, so it is read under the lock.  The message is encoded outside of it.
+	pthread_mutex_lock(&plugin->lock);
+	int binaryFraming = plugin->binaryFraming;
+	pthread_mutex_unlock(&plugin->lock);
+
+	if (binaryFraming)
+	{
+		frameType = MsgFramer_FrameType_binary;
+		rawMsg = ivpMsg_createBinary(msg, &msgLength);
+	}
+	else
+	{
+		frameType = MsgFramer_FrameType_json;
+		rawMsg = ivpMsg_createJsonString(msg, IvpMsg_FormatOptions_none);
+		if (rawMsg != NULL)
+			msgLength = strlen(rawMsg);
+	}
+
+	if (rawMsg != NULL)
 	{
-		int framedLength;
-		char *framedMsg = msgFramer_createFramedMsg(jsonMsg, strlen(jsonMsg), &framedLength);
-		if (framedMsg != NULL)
+		pthread_mutex_lock(&plugin->lock);
+		if (plugin->state == IvpPluginState_connected || plugin->state == IvpPluginState_registered)
 		{
-			pthread_mutex_lock(&plugin->lock);
-			if (plugin->state == IvpPluginState_connected || plugin->state == IvpPluginState_registered)
+			// A message too large for the ring is sent over the socket, which the core still reads.
+			if (plugin->sharedMemorySend != NULL && frameType == MsgFramer_FrameType_binary
+					&& (uint32_t)msgLength <= shmRing_getMaxLength(plugin->sharedMemorySend))
 			{
-				if (send(plugin->socket, framedMsg, framedLength, 0) <= 0)
+				// A full ring means the core is not keeping up, so the message is dropped after the timeout.
+				int result = shmRing_write(plugin->sharedMemorySend, rawMsg, msgLength, IVP_SHARED_MEMORY_WRITE_TIMEOUT_MS);
+				if (result < 0)
+				{
 					ivp_onStateChange(plugin, IvpPluginState_disconnected);
+				}
+				else if (result == 0)
+				{
+					// Reported on the first drop and every IVP_SHARED_MEMORY_DROP_REPORT_INTERVAL after it.
+					if (plugin->sharedMemoryDrops++ % IVP_SHARED_MEMORY_DROP_REPORT_INTERVAL == 0)
+						ivp_onError(plugin, ivpError_createError(IvpLogLevel_warn, IvpError_messageDropped, 0));
+				}
+			}
+			else if (msgFramer_writeFramedMsg(plugin->socket, rawMsg, msgLength, frameType) <= 0)
+			{
+				ivp_onStateChange(plugin, IvpPluginState_disconnected);
 			}
-			pthread_mutex_unlock(&plugin->lock);
-
-			free(framedMsg);
 		}
-		free(jsonMsg);
+		pthread_mutex_unlock(&plugin->lock);
+
+		free(rawMsg);
 	}
 }
 
@@ -263,6 +330,8 @@ void ivp_destroy(IvpPlugin *plugin)
 	pthread_cancel(plugin->receiveThread);
 	pthread_join(plugin->receiveThread, NULL);
 
+	ivp_closeSharedMemory(plugin);
+
 	if (plugin->jsonManifest != NULL)
 		cJSON_Delete(plugin->jsonManifest);
 	if (plugin->filter != NULL)
@@ -430,6 +499,143 @@ void ivp_onConfigChanged(IvpPlugin *plugin, const char *key, const char *value)
 		plugin->info.onConfigChanged(plugin, key, value);
 }
 
+void ivp_openSharedMemory(IvpPlugin *plugin, IvpMessage *msg)
+{
+	IvpTransportInfo *info = ivpTransport_getTransportInfo(msg);
+	ShmRing *receiveRing = NULL;
+	ShmRing *sendRing = NULL;
+
+	if (info != NULL)
+	{
+		receiveRing = shmRing_open(info->pluginReceive);
+		sendRing = shmRing_open(info->pluginSend);
+		ivpTransport_destroyTransportInfo(info);
+	}
+
+	if (receiveRing == NULL || sendRing == NULL)
+	{
+		if (receiveRing != NULL)
+			shmRing_close(receiveRing);
+		if (sendRing != NULL)
+			shmRing_close(sendRing);
+
+		// The core has already moved to the rings, so reconnect without asking for them.
+		plugin->sharedMemoryDisabled = 1;
+		ivp_onError(plugin, ivpError_createError(IvpLogLevel_warn, IvpError_connectionDropped, errno));
+		ivp_onStateChange(plugin, IvpPluginState_disconnected);
+		return;
+	}
+
+	pthread_mutex_lock(&plugin->lock);
+	plugin->binaryFraming = 1;
+	plugin->sharedMemoryReceive = receiveRing;
+	plugin->sharedMemorySend = sendRing;
+	pthread_mutex_unlock(&plugin->lock);
+}
+
+void ivp_closeSharedMemory(IvpPlugin *plugin)
+{
+	pthread_mutex_lock(&plugin->lock);
+
+	if (plugin->sharedMemoryReceive != NULL)
+		shmRing_close(plugin->sharedMemoryReceive);
+	if (plugin->sharedMemorySend != NULL)
+		shmRing_close(plugin->sharedMemorySend);
+
+	plugin->sharedMemoryReceive = NULL;
+	plugin->sharedMemorySend = NULL;
+
+	pthread_mutex_unlock(&plugin->lock);
+}
+
+void ivp_processMessage(IvpPlugin *plugin, IvpMessage *msg)
+{
+	if (msg != NULL)
+	{
+		if (ivpTransport_isTransportMsg(msg))
+			ivp_openSharedMemory(plugin, msg);
+		else
+			ivp_onMessageReceived(plugin, msg);
+
+		ivpMsg_destroy(msg);
+	}
+	else
+	{
+		ivp_onError(plugin, ivpError_createError(IvpLogLevel_warn, IvpError_messageParse, 0));
+	}
+}
+
+void ivp_receiveFromSocket(IvpPlugin *plugin, int fd, MsgFramer *framer, int flags)
+{
+	int recvcount = recv(fd, msgFramer_getBuf(framer), msgFramer_getBufLength(framer), flags);
+	if (recvcount <= 0)
+	{
+		if (recvcount < 0 && (flags & MSG_DONTWAIT) && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return;
+
+		if (recvcount < 0)
+		{
+			ivp_onError(plugin, ivpError_createError(IvpLogLevel_error, IvpError_connectionDropped, errno));
+		}
+		ivp_onStateChange(plugin, IvpPluginState_disconnected);
+	}
+	else
+	{
+		msgFramer_incrementBufPos(framer, recvcount);
+
+		char *rawmsg = NULL;
+		int rawmsgLength;
+		MsgFramer_FrameType frameType;
+
+		while((rawmsg = msgFramer_getNextFrame(framer, &rawmsgLength, &frameType)) != NULL)
+		{
+			if (frameType == MsgFramer_FrameType_binary)
+			{
+				// The core only sends binary frames when it can receive them as well.
+				pthread_mutex_lock(&plugin->lock);
+				plugin->binaryFraming = 1;
+				pthread_mutex_unlock(&plugin->lock);
+				ivp_processMessage(plugin, ivpMsg_parseBinary(rawmsg, rawmsgLength));
+			}
+			else
+			{
+				ivp_processMessage(plugin, ivpMsg_parse(rawmsg));
+			}
+		}
+	}
+}
+
+void ivp_receiveFromSharedMemory(IvpPlugin *plugin, int fd, MsgFramer *framer)
+{
+	int checkSocket = 1;
+	int count;
+
+	for (count = 0; count < IVP_SHARED_MEMORY_SOCKET_CHECK_INTERVAL; count++)
+	{
+		const char *data;
+		uint32_t length;
+
+		int result = shmRing_read(plugin->sharedMemoryReceive, &data, &length, IVP_SHARED_MEMORY_POLL_MS);
+		if (result < 0)
+		{
+			ivp_onStateChange(plugin, IvpPluginState_disconnected);
+			return;
+		}
+		if (result == 0)
+			break;
+
+		IvpMessage *msg = ivpMsg_parseBinary(data, length);
+		shmRing_release(plugin->sharedMemoryReceive);
+
+		ivp_processMessage(plugin, msg);
+		checkSocket = 0;
+	}
+
+	// The core only sends on the socket when a message is too large for the ring, and closes it when the connection ends.
+	if (checkSocket || count == IVP_SHARED_MEMORY_SOCKET_CHECK_INTERVAL)
+		ivp_receiveFromSocket(plugin, fd, framer, MSG_DONTWAIT);
+}
+
 void *ivp_receive(void *arg)
 {
 	IvpPlugin *plugin = (IvpPlugin *)arg;
@@ -462,46 +668,34 @@ void *ivp_receive(void *arg)
 		}
 
 		plugin->socket = fd;
+		pthread_mutex_lock(&plugin->lock);
+		plugin->binaryFraming = 0;
+		pthread_mutex_unlock(&plugin->lock);
 		ivp_onStateChange(plugin, IvpPluginState_connected);
 
-		ivp_broadcastAndDestroyMessage(plugin, ivpRegister_createMsgFromJson(plugin->jsonManifest));
+		// Let the core know binary frames are understood.  An older core ignores the flag and keeps using JSON.
+		IvpMessage *registerMsg = ivpRegister_createMsgFromJson(plugin->jsonManifest);
+		if (registerMsg != NULL)
+		{
+			registerMsg->flags |= IvpMsgFlags_BinaryFraming;
+			if (!plugin->sharedMemoryDisabled)
+				registerMsg->flags |= IvpMsgFlags_SharedMemory;
+		}
+		ivp_broadcastAndDestroyMessage(plugin, registerMsg);
 
 		MsgFramer framer = MSG_FRAMER_INITIALIZER;
 
 		while(plugin->state == IvpPluginState_connected
 				|| plugin->state == IvpPluginState_registered)
 		{
-			int recvcount = recv(fd, msgFramer_getBuf(&framer), msgFramer_getBufLength(&framer), 0);
-			if (recvcount <= 0)
-			{
-				if (recvcount < 0)
-				{
-					ivp_onError(plugin, ivpError_createError(IvpLogLevel_error, IvpError_connectionDropped, errno));
-				}
-				ivp_onStateChange(plugin, IvpPluginState_disconnected);
-			}
+			if (plugin->sharedMemoryReceive != NULL)
+				ivp_receiveFromSharedMemory(plugin, fd, &framer);
 			else
-			{
-				msgFramer_incrementBufPos(&framer, recvcount);
-
-				char *rawmsg = NULL;
-
-				while((rawmsg = msgFramer_getNextMsg(&framer)) != NULL)
-				{
-					IvpMessage *msg = ivpMsg_parse(rawmsg);
-					if (msg != NULL)
-					{
-						ivp_onMessageReceived(plugin, msg);
-						ivpMsg_destroy(msg);
-					}
-					else
-					{
-						ivp_onError(plugin, ivpError_createError(IvpLogLevel_warn, IvpError_messageParse, 0));
-					}
-				}
-			}
+				ivp_receiveFromSocket(plugin, fd, &framer, 0);
 		}
 
+		ivp_closeSharedMemory(plugin);
+		msgFramer_destroy(&framer);
 		close(fd);
 		plugin->socket = -1;
 	}
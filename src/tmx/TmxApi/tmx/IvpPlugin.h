@@ -16,6 +16,7 @@
 #include "apimessages/IvpRegister.h"
 #include "apimessages/IvpEventLog.h"
 #include "apimessages/IvpMessageType.h"
+#include "apimessages/IvpTransport.h"
 #include <pthread.h>
 
 #ifdef __cplusplus
@@ -83,6 +84,23 @@ typedef struct IvpPlugin {
 	char *coreIpAddr;
 	int corePortNumber;
 	int socket;
+	/*!
+	 * Set once the core has sent a binary frame, meaning it can also receive them.  Guarded by the lock.
+	 */
+	int binaryFraming;
+	/*!
+	 * Shared memory rings to and from the core, when the core has handed them to the plugin.
+	 */
+	struct ShmRing *sharedMemoryReceive;
+	struct ShmRing *sharedMemorySend;
+	/*!
+	 * Set if the shared memory rings could not be opened, so the plugin does not ask for them again.
+	 */
+	int sharedMemoryDisabled;
+	/*!
+	 * The number of messages dropped because the core did not make room for them in the send ring in time.
+	 */
+	uint64_t sharedMemoryDrops;
 	pthread_t receiveThread;
 	pthread_mutex_t lock;
 } IvpPlugin;
@@ -128,6 +146,16 @@ void ivp_setStatusItem(IvpPlugin *plugin, const char *key, const char *value);
  */
 void ivp_removeStatusItem(IvpPlugin *plugin, const char *key);
 
+/*!
+ * Sends all of the status items in the collection as a single status message.  Items with a NULL value are removed.
+ * The collection is not destroyed.
+ *
+ * @requires
+ * 		plugin != NULL
+ * 		collection != NULL
+ */
+void ivp_setStatusItems(IvpPlugin *plugin, IvpPluginStatusCollection *collection);
+
 /*!
  *
  * @requires
@@ -45,7 +45,8 @@ typedef enum {
 	IvpError_msgTypeCollectionFormat,
 	IvpError_msgTypeCollectionMissingType,
 	IvpError_msgTypeCollectionMissingSubType,
-	IvpError_msgTypeCollectionDuplicate
+	IvpError_msgTypeCollectionDuplicate,
+	IvpError_messageDropped
 } IvpErrorNumber;
 
 /*!
@@ -0,0 +1,82 @@
+/*
+ * IvpTransport.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "IvpTransport.h"
+#include <string.h>
+#include <assert.h>
+
+#define IVP_TRANSPORT_FIELD_PLUGINRECEIVE "pluginReceive"
+#define IVP_TRANSPORT_FIELD_PLUGINSEND "pluginSend"
+
+inline int ivpTransport_isTransportMsg(IvpMessage *msg)
+{
+	assert(msg != NULL);
+	if (msg == NULL)
+		return 0;
+	return msg->type != NULL && strcmp(msg->type, IVPMSG_TYPE_APIRESV_TRANSPORT) == 0;
+}
+
+IvpMessage *ivpTransport_createSharedMemoryMsg(const char *pluginReceive, const char *pluginSend)
+{
+	assert(pluginReceive != NULL);
+	assert(pluginSend != NULL);
+	if (pluginReceive == NULL || pluginSend == NULL)
+		return NULL;
+
+	IvpMessage *results = NULL;
+
+	cJSON *payload = cJSON_CreateObject();
+	assert(payload != NULL);
+	if (payload != NULL)
+	{
+		cJSON_AddStringToObject(payload, IVP_TRANSPORT_FIELD_PLUGINRECEIVE, pluginReceive);
+		cJSON_AddStringToObject(payload, IVP_TRANSPORT_FIELD_PLUGINSEND, pluginSend);
+
+		results = ivpMsg_create(IVPMSG_TYPE_APIRESV_TRANSPORT, NULL, IVP_ENCODING_JSON, IvpMsgFlags_None, payload);
+		assert(results != NULL);
+
+		cJSON_Delete(payload);
+	}
+
+	return results;
+}
+
+IvpTransportInfo *ivpTransport_getTransportInfo(IvpMessage *msg)
+{
+	assert(msg != NULL);
+	assert(ivpTransport_isTransportMsg(msg));
+	assert(msg->payload != NULL);
+	if (msg == NULL || !ivpTransport_isTransportMsg(msg) || msg->payload == NULL)
+		return NULL;
+
+	IvpTransportInfo *results = calloc(1, sizeof(IvpTransportInfo));
+	assert(results != NULL);
+	if (results != NULL)
+	{
+		cJSONxtra_tryGetStr(msg->payload, IVP_TRANSPORT_FIELD_PLUGINRECEIVE, &results->pluginReceive);
+		cJSONxtra_tryGetStr(msg->payload, IVP_TRANSPORT_FIELD_PLUGINSEND, &results->pluginSend);
+
+		if (results->pluginReceive == NULL || results->pluginSend == NULL)
+		{
+			ivpTransport_destroyTransportInfo(results);
+			results = NULL;
+		}
+	}
+
+	return results;
+}
+
+void ivpTransport_destroyTransportInfo(IvpTransportInfo *info)
+{
+	assert(info != NULL);
+	if (info == NULL)
+		return;
+
+	if (info->pluginReceive != NULL) free(info->pluginReceive);
+	if (info->pluginSend != NULL) free(info->pluginSend);
+	free(info);
+}
@@ -0,0 +1,46 @@
+/*
+ * IvpTransport.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef IVPTRANSPORT_H_
+#define IVPTRANSPORT_H_
+
+#include "../tmx.h"
+#include "../IvpMessage.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Sent by the core to a plugin on the same host to move the message traffic onto shared memory rings.
+ * Both names are POSIX shared memory names of rings created by the core.
+ */
+typedef struct {
+	/*!
+	 * The ring that the core writes to and the plugin reads from.
+	 */
+	char *pluginReceive;
+	/*!
+	 * The ring that the plugin writes to and the core reads from.
+	 */
+	char *pluginSend;
+} IvpTransportInfo;
+
+int ivpTransport_isTransportMsg(IvpMessage *msg);
+
+IvpMessage *ivpTransport_createSharedMemoryMsg(const char *pluginReceive, const char *pluginSend);
+
+IvpTransportInfo *ivpTransport_getTransportInfo(IvpMessage *msg);
+
+void ivpTransport_destroyTransportInfo(IvpTransportInfo *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IVPTRANSPORT_H_ */
@@ -11,6 +11,7 @@
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include <tmx/apimessages/TmxEventLog.hpp>
 #include <tmx/messages/TmxJ2735.hpp>
@@ -144,6 +145,15 @@ private:
 		return theMap;
 	}
 
+	/**
+	 * @return The only static flag guarding the one time initialization of the maps
+	 */
+	static std::once_flag &get_init_flag()
+	{
+		static std::once_flag theFlag;
+		return theFlag;
+	}
+
 	/**
 	 * A template function to build a new allocator for the message type and add it to both allocator maps
 	 */
@@ -170,13 +180,15 @@ private:
 	std::unique_ptr<J2735Exception> error_message;
 public:
 	/**
-	 * Creates a new factory to use.  The allocator maps will only be initialized once.
+	 * Creates a new factory to use.  The allocator maps will only be initialized once, even
+	 * if factories are created on several threads at the same time, and are read-only after
+	 * that.  Therefore, each thread may keep its own long-lived factory.
 	 */
 	J2735MessageFactory():
 		byInt(get_int_map()),
 		byStr(get_str_map())
 	{
-		if (byInt.size() <= 0 || byStr.size() <= 0)
+		std::call_once(get_init_flag(), [this]()
 		{
 			add_allocator_to_maps<BsmMessage>();
 #if SAEJ2735_SPEC < 63
@@ -209,7 +221,7 @@ public:
 #if SAEJ2735_SPEC < 63
 			add_allocator_to_maps<UperFrameMessage>();
 #endif
-		}
+		});
 	}
 
 	~J2735MessageFactory()	{ }
@@ -303,7 +315,7 @@ public:
 
 	inline int GetMessageId(tmx::byte_stream &bytes)
 	{
-		std::string unused;
+		const char *unused = NULL;
 		return GetCodecAndMessageId(unused, bytes);
 	}
 
@@ -382,14 +394,9 @@ public:
 		error_message.reset();
 
 		// look for extra bytes in the byte_stream 
-		int msgidindex;
-		if(msgidindex = TmxJ2735ExtendedBytes(bytes))
-		{
-			std::string byteStr(bytes.begin(),bytes.end());
-		}
-
+		TmxJ2735ExtendedBytes(bytes);
 
-		std::string codec;
+		const char *codec = NULL;
 		int id = GetCodecAndMessageId(codec, bytes);
 		if (id > 0)
 		{
@@ -397,7 +404,7 @@ public:
 			if (msg)
 			{
 				initialize(msg, bytes);
-				if (!codec.empty())
+				if (codec && !msg->is_encoding(codec))
 					msg->set_encoding(codec);
 
 				return msg;
@@ -411,7 +418,7 @@ public:
 	}
 
 private:
-	inline int GetCodecAndMessageId(std::string &codec, tmx::byte_stream &bytes)
+	inline int GetCodecAndMessageId(const char *&codec, tmx::byte_stream &bytes)
 	{
 		error_message.reset();
 
@@ -429,11 +436,11 @@ private:
 		{
 			id = OtherCodec.decode_contentId(bytes);
 			if (id > 0)
-				codec.assign(OtherCodec.Encoding);
+				codec = OtherCodec.Encoding;
 		}
 		else
 		{
-			codec.assign(Codec.Encoding);
+			codec = Codec.Encoding;
 		}
 
 
@@ -34,6 +34,11 @@ template <> template <> \
 inline TMX_J2735_ADD_NAMESPACE(messages, NM ## Message) \
 routeable_message::get_payload<TMX_J2735_ADD_NAMESPACE(messages, NM ## Message)>() \
 { \
+	/* A message from the J2735 factory is decoded in place, without copying it first */ \
+	TMX_J2735_ADD_NAMESPACE(messages, NM ## EncodedMessage) *thisMsg = \
+		dynamic_cast<TMX_J2735_ADD_NAMESPACE(messages, NM ## EncodedMessage) *>(this); \
+	if (thisMsg) \
+		return thisMsg->get_payload<TMX_J2735_ADD_NAMESPACE(messages, NM ## Message)>(); \
 	TMX_J2735_ADD_NAMESPACE(messages, NM ## EncodedMessage) encMsg(*this); \
 	return encMsg.get_payload<TMX_J2735_ADD_NAMESPACE(messages, NM ## Message)>(); \
 }
@@ -113,12 +113,13 @@ public:
 	/**
 	 * Same as above, but copy from a different message type, presumably
 	 * one that is convertible to this type.  A new reference to the ASN.1 struct
-	 * message pointer is created, but the original owner still maintains ownership.
+	 * message pointer is created, which shares ownership with the original, so
+	 * the struct stays valid for as long as either message refers to it.
 	 */
 	template <typename OtherMsgType>
 	TmxJ2735Message(const std::shared_ptr<OtherMsgType> &other):
 		tmx::xml_message(),
-		_j2735_data(j2735::j2735_cast<message_type>(other.get()), [](message_type *p) { }) { }
+		_j2735_data(other, j2735::j2735_cast<message_type>(other.get())) { }
 
 	/**
 	 * Destructor
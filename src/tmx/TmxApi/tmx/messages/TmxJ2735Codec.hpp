@@ -120,6 +120,116 @@ struct der
 	}
 };
 
+/**
+ * The leading fields of a UPER encoded J2735 message frame.  These can be read straight
+ * from the bits at the front of the frame, without running the ASN.1 decoder.
+ */
+struct uper_frame_header
+{
+	/// The J2735 message ID of the frame contents
+	int contentId = -1;
+	/// The number of bytes in the frame contents, as given by the length determinant
+	size_t length = 0;
+	/// The offset, in bits, of the frame contents from the start of the bytes
+	size_t contentBit = 0;
+};
+
+/**
+ * Read the next count bits, most significant first, from the UPER encoded bytes.
+ * @param bytes The UPER encoded bytes
+ * @param bit The current bit position, which is advanced past the bits read
+ * @param count The number of bits to read, at most 32
+ * @param value The value of the bits read
+ * @return True if the bits were read, or false if there are not enough bytes
+ */
+inline bool uper_read_bits(const tmx::byte_stream &bytes, size_t &bit, unsigned int count, uint32_t &value)
+{
+	if (bit + count > bytes.size() * 8)
+		return false;
+
+	value = 0;
+	for (unsigned int i = 0; i < count; i++, bit++)
+		value = (value << 1) | ((bytes[bit / 8] >> (7 - (bit % 8))) & 0x01);
+
+	return true;
+}
+
+/**
+ * Scan the header of a UPER encoded J2735 message frame to obtain the message ID and the
+ * length of the contents.  Only the first few bytes are read, and the frame is accepted
+ * only if the declared length of the contents fits within the bytes given.
+ * @param bytes The UPER encoded bytes
+ * @param header The header fields that were found
+ * @return True if the bytes start with a valid message frame header, false otherwise
+ */
+inline bool uper_scan_frame_header(const tmx::byte_stream &bytes, uper_frame_header &header)
+{
+	size_t bit = 0;
+	uint32_t value;
+
+#if SAEJ2735_SPEC < 63
+	// UPERframe: extension bit, presence bits for msgSubID and timeStamp, then msgID (0..255)
+	uint32_t optional;
+	if (!uper_read_bits(bytes, bit, 1, value) || !uper_read_bits(bytes, bit, 2, optional) ||
+			!uper_read_bits(bytes, bit, 8, value))
+		return false;
+
+	if ((optional & 0x02) && !uper_read_bits(bytes, bit, 8, value))
+		return false;
+	if ((optional & 0x01) && !uper_read_bits(bytes, bit, 20, value))
+		return false;
+
+	// The contentID (0..255), followed by the msgBlob with a SIZE(10..2000) length
+	if (!uper_read_bits(bytes, bit, 8, value))
+		return false;
+	header.contentId = value;
+
+	if (!uper_read_bits(bytes, bit, 11, value) || value > 2000 - 10)
+		return false;
+	header.length = value + 10;
+#else
+	// MessageFrame: extension bit, which is never set in practice, then messageId (0..32767)
+	if (!uper_read_bits(bytes, bit, 1, value) || value)
+		return false;
+	if (!uper_read_bits(bytes, bit, 15, value))
+		return false;
+	header.contentId = value;
+
+	// The open type value is preceded by an unconstrained length determinant
+	if (!uper_read_bits(bytes, bit, 1, value))
+		return false;
+
+	if (!value)
+	{
+		if (!uper_read_bits(bytes, bit, 7, value))
+			return false;
+	}
+	else
+	{
+		if (!uper_read_bits(bytes, bit, 1, value))
+			return false;
+
+		if (!value)
+		{
+			if (!uper_read_bits(bytes, bit, 14, value))
+				return false;
+		}
+		else
+		{
+			// Fragmented, so only the size of the first fragment is known
+			if (!uper_read_bits(bytes, bit, 6, value) || value < 1 || value > 4)
+				return false;
+			value *= 16384;
+		}
+	}
+
+	header.length = value;
+#endif
+
+	header.contentBit = bit;
+	return header.length > 0 && header.contentBit + header.length * 8 <= bytes.size() * 8;
+}
+
 /**
  * A structure for ASN.1 UPER encoding/decoding.  Attached to encoding type "asn.1-uper/hexstring"
  */
@@ -165,43 +275,18 @@ struct uper
 
 	/**
 	 * Attempt to pull out the content ID from the UPER encoded bytes.  This is done by
-	 * decoding the message frame and looking at the contained ID in the frame.
+	 * scanning the message frame header bits, so the frame is not decoded.
 	 * @param bytes The bytes to decode
-	 * @return The message ID enclosed in this DER encoding, or < 0 if none can be found
-	 * TODO Try to scan the bytes in the frame instead of decoding all the way
+	 * @return The message ID enclosed in this UPER encoding, or < 0 if none can be found
+	 * @see uper_scan_frame_header()
 	 */
 	static int decode_contentId(const tmx::byte_stream &bytes)
 	{
-		int id;
-
-		MessageFrameMessage::message_type *frame = NULL;
-		asn_TYPE_descriptor_t *descriptor = NULL;
-
-#if SAEJ2735_SPEC < 63
-		static uper<MessageFrameMessage> decoder;
-
-		descriptor = MessageFrameMessage::get_descriptor();
-
-		asn_dec_rval_t ret = decoder.decode((void **)&frame, bytes, descriptor);
-		if (ret.code != RC_OK || frame == NULL)
-			return -1;
+		uper_frame_header header;
+		if (uper_scan_frame_header(bytes, header))
+			return header.contentId;
 
-		id = frame->contentID;
-#else
-		// Message ID is encoded directly in the message frame, first two bytes
-		if (bytes.size() > 1)
-			id = bytes[0];
-
-		if (bytes.size() > 2) {
-			id <<= 8;
-			id |= bytes[1];
-		}
-#endif
-
-		if (descriptor)
-			ASN_STRUCT_FREE((*descriptor), frame);
-
-		return id;
+		return -1;
 	}
 
 };
@@ -218,6 +303,10 @@ public:
 	TmxJ2735EncodedMessageBase(tmx::message_container_type &contents): tmx::routeable_message(contents) {}
 	TmxJ2735EncodedMessageBase(const tmx::routeable_message &other): tmx::routeable_message(other) {}
 	virtual ~TmxJ2735EncodedMessageBase() {}
+protected:
+	TmxJ2735EncodedMessageBase(IvpMessage *other, const char *type, const char *subtype, const char *encoding):
+		tmx::routeable_message(other, type, subtype, encoding) {}
+public:
 
 	virtual tmx::xml_message get_payload() = 0;
 	virtual int get_msgId() = 0;
@@ -230,9 +319,8 @@ public:
 
 	virtual void set_data(const tmx::byte_stream &data)
 	{
-		std::string enc = get_encoding();
-		set_payload_bytes(data);
-		set_encoding(enc);
+		// The encoding is kept, since it names the codec of the data
+		replace_payload_bytes(data);
 	}
 };
 
@@ -252,12 +340,8 @@ public:
 	 * Construct an message with the optionally supplied IVP message.  The
 	 * default codec is used for this type.
 	 */
-	TmxJ2735EncodedMessage(IvpMessage *other = 0): TmxJ2735EncodedMessageBase(other)
-	{
-		this->set_type(MsgType::MessageType);
-		this->set_subtype(MsgType::MessageSubType);
-		this->set_encoding(DefaultCodec);
-	}
+	TmxJ2735EncodedMessage(IvpMessage *other = 0):
+		TmxJ2735EncodedMessageBase(other, MsgType::MessageType, MsgType::MessageSubType, DefaultCodec) { }
 
 	/**
 	 * Construct a message from a copy of another message of the same type
@@ -300,7 +384,19 @@ public:
 	 * @return The decoded J2735 message
 	 */
 	template <typename DecType>
-	static typename DecType::type *decode_j2735_message(tmx::byte_stream bytes)
+	static typename DecType::type *decode_j2735_message(const tmx::byte_stream &bytes)
+	{
+		return new typename DecType::type(decode_j2735_data<DecType>(bytes));
+	}
+
+	/**
+	 * Decode the J2735 data structure from the given bytes using a specific decoder type, without
+	 * creating a message to hold it.
+	 * @param bytes The byte stream to decode
+	 * @return The decoded J2735 data structure
+	 */
+	template <typename DecType>
+	static std::shared_ptr<typename DecType::message_type> decode_j2735_data(const tmx::byte_stream &bytes)
 	{
 		typedef typename DecType::type type;
 		typedef typename DecType::message_type msg_type;
@@ -311,7 +407,8 @@ public:
 
 		if (rval.code == RC_OK)
 		{
-			return new type(obj);
+			return std::shared_ptr<msg_type>(obj,
+					[](msg_type *p) { j2735::j2735_destroy<typename type::traits_type>(p); });
 		}
 		else
 		{
@@ -363,11 +460,11 @@ public:
 	{
 		if (!_decoded)
 		{
-			const tmx::byte_stream &theData = this->get_data();
-			int msgId = get_msgId();
+			const tmx::byte_stream &theData = this->get_payload_bytes_view();
+			int msgId = get_msgId(theData);
 
 			// If the encoding is incorrect for this J2735 specification, send an empty message
-			if (strcmp(ASN1_CODEC<MessageFrameMessage>::Encoding, this->get_encoding().c_str()) != 0)
+			if (!this->is_encoding(ASN1_CODEC<MessageFrameMessage>::Encoding))
 			{
 				// Unable to decode
 				_decoded.reset(new MsgType());
@@ -376,10 +473,9 @@ public:
 			{
 				if (msgId > MessageFrameMessage::get_default_messageId())
 				{
-					MessageFrameMessage *frame = TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_message<
-							codec::uper<MessageFrameMessage> >(theData);
-					if (frame)
-						_decoded.reset(new MsgType(frame->get_j2735_data()));
+					// The message refers to its part of the frame, and keeps the whole frame until it is done
+					_decoded.reset(new MsgType(TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_data<
+							codec::uper<MessageFrameMessage> >(theData)));
 				}
 				else
 				{
@@ -390,10 +486,9 @@ public:
 			{
 				if (msgId > MessageFrameMessage::get_default_messageId())
 				{
-					MessageFrameMessage *frame = TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_message<
-							codec::der<MessageFrameMessage> >(theData);
-					if (frame)
-						_decoded.reset(new MsgType(frame->get_j2735_data()));
+					// The message refers to its part of the frame, and keeps the whole frame until it is done
+					_decoded.reset(new MsgType(TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_data<
+							codec::der<MessageFrameMessage> >(theData)));
 				}
 				else
 				{
@@ -492,16 +587,25 @@ public:
 	 * @return The message identifier for the encoded type
 	 */
 	int get_msgId()
+	{
+		return get_msgId(this->get_payload_bytes_view());
+	}
+
+	/**
+	 * @param theData The already retrieved message data
+	 * @return The message identifier for the encoded type
+	 */
+	int get_msgId(const tmx::byte_stream &theData)
 	{
 		int id = -1;
 
 		if (is_uper())
 		{
-			id = UperCodec::decode_contentId(this->get_data());
+			id = UperCodec::decode_contentId(theData);
 		}
 		else if (is_der())
 		{
-			id = DerCodec::decode_contentId(this->get_data());
+			id = DerCodec::decode_contentId(theData);
 		}
 
 		if (id > 0)
@@ -537,7 +641,7 @@ private:
 	template <typename EncType>
 	bool is_encoded()
 	{
-		return (this->get_encoding() == EncType::Encoding);
+		return this->is_encoding(EncType::Encoding);
 	}
 
 public:
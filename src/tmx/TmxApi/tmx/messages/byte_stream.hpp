@@ -12,9 +12,11 @@
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include <tmx/attributes/attribute_cast.hpp>
+#include <tmx/utils/ByteCodec.h>
 
 namespace tmx {
 
@@ -22,52 +24,74 @@ typedef uint8_t byte_t;
 
 typedef std::vector<byte_t> byte_stream;
 
+inline std::string byte_stream_encode(const tmx::byte_stream &bytes);
+
 inline std::ostream &operator<<(std::ostream &os, const tmx::byte_stream &bytes)
 {
-	char buf[3];
-	for(unsigned int i = 0; i < bytes.size(); i++)
-	{
-		std::snprintf(buf, 3, "%02x", bytes[i]);
-		os << buf;
-	}
+	return os << byte_stream_encode(bytes);
+}
 
-	return os;
+/**
+ * @return The value of a hex digit, or -1 if the character is not a hex digit
+ */
+inline int hex_digit_value(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
 }
 
-inline std::istream &operator>>(std::istream &is, tmx::byte_stream &bytes)
+/**
+ * Decode a hex string into the given bytes, replacing their contents.  Each pair of characters is one byte,
+ * and an odd last character is the high digit of the last byte.  Parsing of a pair stops at the first
+ * character that is not a hex digit, as strtoul does.
+ */
+inline void byte_stream_decode(const char *str, size_t length, tmx::byte_stream &bytes)
 {
-	std::string str(std::istreambuf_iterator<typename std::istream::char_type>(is), {});
+	bytes.resize((length + 1) / 2);
+
+	// Whole valid pairs are decoded in bulk, the lenient rules only apply from the first invalid pair on
+	size_t j = bytes.empty() ? 0 : byteCodec_hexDecode(str, length, bytes.data());
 
-	char buf[3] = { '0', '0', '\0' };
-	tmx::byte_t b = 0;
-	for (std::string::iterator i = str.begin(); i != str.end(); i++)
+	for (size_t i = 2 * j; i < length; i += 2, j++)
 	{
-		buf[0] = *i;
-		i++;
-		if (i != str.end())
-			buf[1] = *i;
-		else
-			buf[1] = '0';
+		int hi = hex_digit_value(str[i]);
+		int lo = i + 1 < length ? hex_digit_value(str[i + 1]) : 0;
 
-		b = (tmx::byte_t)std::strtoul(buf, NULL, 16);
-		bytes.push_back(b);
+		if (hi < 0)
+			bytes[j] = 0;
+		else if (lo < 0)
+			bytes[j] = (tmx::byte_t)hi;
+		else
+			bytes[j] = (tmx::byte_t)(hi << 4 | lo);
 	}
+}
+
+inline std::istream &operator>>(std::istream &is, tmx::byte_stream &bytes)
+{
+	std::string str(std::istreambuf_iterator<typename std::istream::char_type>(is), {});
+
+	tmx::byte_stream decoded;
+	byte_stream_decode(str.data(), str.size(), decoded);
+	bytes.insert(bytes.end(), decoded.begin(), decoded.end());
 
 	return is;
 }
 
 inline std::string byte_stream_encode(const tmx::byte_stream &bytes)
 {
-	std::ostringstream oss;
-	operator<<(oss, bytes);
-	return oss.str();
+	std::string str(bytes.size() * 2, '0');
+	if (!bytes.empty())
+		byteCodec_hexEncode(bytes.data(), bytes.size(), &str[0]);
+
+	return str;
 }
 
 inline tmx::byte_stream byte_stream_decode(const std::string &str)
 {
 	tmx::byte_stream bytes;
-	std::istringstream iss(str);
-	operator>>(iss, bytes);
+	byte_stream_decode(str.data(), str.size(), bytes);
 	return bytes;
 }
 
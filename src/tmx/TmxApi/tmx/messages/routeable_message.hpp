@@ -11,7 +11,6 @@
 #include <sys/time.h>
 #include <tmx/IvpMessage.h>
 #include <tmx/tmx.h>
-#include <tmx/attributes/attribute_wrapped_type.hpp>
 #include <tmx/messages/byte_stream.hpp>
 #include <tmx/messages/message.hpp>
 
@@ -59,7 +58,7 @@ public:
 	 */
 	template <typename OtherFormat>
 	tmx_routeable_message(const tmx_routeable_message<OtherFormat> &other, message_converter *converter = 0):
-		tmx_message<Format>(other, converter) { set_contents(other.ivpMsg); }
+		tmx_message<Format>(other, converter) { set_contents(other.get_message()); }
 
 	/**
 	 * Create a message that has a copy of the contents of the other message.
@@ -67,7 +66,7 @@ public:
 	 * @param other The message to copy from
 	 */
 	tmx_routeable_message(const tmx_routeable_message<Format> &other):
-		tmx_routeable_message<Format>(other, 0) { set_contents(other.get_message()); }
+		tmx_message<Format>(other) { set_contents(other.get_message()); }
 
 	/**
 	 * Create a message from a string representation of the contents.
@@ -82,6 +81,43 @@ public:
 	 */
 	virtual ~tmx_routeable_message() { destroy(); }
 
+protected:
+	/**
+	 * Create an empty message with the given header, or from an incoming IVP message with the header replaced.
+	 * The empty message is created with its header in place, rather than set over the default values.
+	 */
+	tmx_routeable_message(IvpMessage *other, const char *type, const char *subtype, const char *encoding):
+		tmx_message<Format>()
+	{
+		if (other)
+		{
+			set_contents(other);
+			set_type(type);
+			set_subtype(subtype);
+			set_encoding(encoding);
+		}
+		else
+		{
+			ivpMsg = ivpMsg_create(type, subtype, encoding, IvpMsgFlags_None, NULL);
+		}
+	}
+
+public:
+	/**
+	 * Assignment operator will copy the contents and the IVP message of the other message to this message.
+	 * @param other The message to copy from
+	 * @return This message
+	 */
+	tmx_routeable_message<Format> &operator=(const tmx_routeable_message<Format> &other)
+	{
+		if (this != &other)
+		{
+			tmx_message<Format>::operator=(other);
+			set_contents(other.get_message());
+		}
+		return (*this);
+	}
+
 private:
 	template <typename OtherFormat>
 	void fill(tmx_message<OtherFormat> *msg)
@@ -89,8 +125,10 @@ private:
 		// If the payload is a sub-tree, set the contents to a copy of that tree.
 		// Otherwise, use the string value of the payload
 		boost::optional<message_tree_type &> payload = this->as_tree(ATTR_PAYLOAD);
-		if (payload)
+		if (payload && !payload.get().empty())
 			msg->set_contents(payload.get());
+		else if (is_payload_tree())
+			msg->set_contents(payload_as_tree());
 		else
 			msg->set_contents(get_payload_str());
 	}
@@ -128,48 +166,72 @@ public:
 	/**
 	 * @return A string representation of the payload
 	 */
-	std::string get_payload_str()
+	std::string get_payload_str() const
 	{
 		std::string payloadStr;
 
-		// The payload object is most recent
-		if (!ivpMsg->payload)
+		if (!ivpMsg || !ivpMsg->payload)
 			return payloadStr;
 
+		// Most payloads, such as the hex string of an encoded message, are a string that can be used as is
+		if (is_payload_type(cJSON_String))
+		{
+			if (ivpMsg->payload->valuestring)
+				payloadStr.assign(ivpMsg->payload->valuestring);
+			return payloadStr;
+		}
+
 		// Convert payload to a string
 		char *json = cJSON_PrintUnformatted(ivpMsg->payload);
 		if (json) payloadStr.assign(json);
-
-		// The cJSON print code may add quotation marks.
-		if (payloadStr.length() > 0 && payloadStr[0] == '\"')
-			payloadStr.erase(0, 1);
-		if (payloadStr.length() > 0 && payloadStr[payloadStr.length()-1] == '\"')
-			payloadStr.erase(payloadStr.length()-1);
 		free(json);
 
-		if (ivpMsg->payload->type == cJSON_Object || ivpMsg->payload->type == cJSON_Array)
-		{
-			message_container_type container;
-			std::stringstream ss;
-			ss << payloadStr;
-			container.load<JSON>(ss);
-			this->as_tree().get().put_child(ATTR_PAYLOAD, container.get_storage().get_tree());
-		}
-		else
-		{
-			this->msg.store(ATTR_PAYLOAD, payloadStr);
-		}
-
 		return payloadStr;
 	}
 
+	/**
+	 * Retrieve the string payload without making a copy.  The pointer is only valid until the payload changes.
+	 *
+	 * @return The string payload, such as the hex string of an encoded message, or NULL if the payload is not a string
+	 */
+	const char *get_payload_hex() const
+	{
+		if (!ivpMsg || !ivpMsg->payload || !is_payload_type(cJSON_String))
+			return NULL;
+
+		return ivpMsg->payload->valuestring;
+	}
+
 	/**
 	 * @see get_payload_str()
 	 * @return A byte stream representation of the payload string
 	 */
 	byte_stream get_payload_bytes()
 	{
-		return battelle::attributes::attribute_lexical_cast<byte_stream>(this->get_payload_str());
+		return get_payload_bytes_view();
+	}
+
+	/**
+	 * Retrieve the payload bytes without making a copy.  The hex string is only decoded the first time,
+	 * and the reference is valid until the payload changes.
+	 *
+	 * @see get_payload_bytes()
+	 * @return The bytes of the payload string
+	 */
+	const byte_stream &get_payload_bytes_view()
+	{
+		if (!payloadBytesValid)
+		{
+			const char *hex = get_payload_hex();
+			if (hex)
+				byte_stream_decode(hex, strlen(hex), payloadBytes);
+			else
+				payloadBytes = byte_stream_decode(get_payload_str());
+
+			payloadBytesValid = true;
+		}
+
+		return payloadBytes;
 	}
 
 	/**
@@ -192,7 +254,7 @@ public:
 			message_container_type container(payload.get_container());
 			std::stringstream ss;
 			container.template save<JSON>(ss);
-			this->ivpMsg->payload = cJSON_Parse(ss.str().c_str());
+			replace_payload(cJSON_Parse(ss.str().c_str()));
 		}
 	}
 
@@ -222,8 +284,7 @@ public:
 	void set_payload(std::string payload)
 	{
 		this->set_encoding(IVP_ENCODING_STRING);
-		this->msg.store(ATTR_PAYLOAD, payload);
-		this->ivpMsg->payload = cJSON_CreateString(payload.c_str());
+		replace_payload(cJSON_CreateString(payload.c_str()));
 	}
 
 	/**
@@ -233,7 +294,7 @@ public:
 	{
 		this->set_encoding(IVP_ENCODING_STRING);
 		this->msg.store(ATTR_PAYLOAD, payload ? "1" : "0");
-		this->ivpMsg->payload = cJSON_CreateBool(payload ? 1 : 0);
+		replace_payload(cJSON_CreateBool(payload ? 1 : 0));
 	}
 
 	/**
@@ -243,7 +304,7 @@ public:
 	{
 		this->set_encoding(IVP_ENCODING_STRING);
 		this->msg.store(ATTR_PAYLOAD, to_string(number));
-		this->ivpMsg->payload = cJSON_CreateNumber((double)number);
+		replace_payload(cJSON_CreateNumber((double)number));
 	}
 
 	/**
@@ -253,7 +314,7 @@ public:
 	{
 		this->set_encoding(IVP_ENCODING_STRING);
 		this->msg.store(ATTR_PAYLOAD, to_string(number));
-		this->ivpMsg->payload = cJSON_CreateNumber(number);
+		replace_payload(cJSON_CreateNumber(number));
 	}
 
 	/**
@@ -262,8 +323,8 @@ public:
 	 */
 	void set_payload_bytes(const byte_stream &bytes)
 	{
-		set_payload(battelle::attributes::attribute_lexical_cast<std::string>(bytes));
 		this->set_encoding(IVP_ENCODING_BYTEARRAY);
+		replace_payload_bytes(bytes);
 	}
 
 	/**
@@ -274,32 +335,18 @@ public:
 	 */
 	void set_contents(const IvpMessage *msg)
 	{
-		destroy();
-
+		// Copied first, in case the message is the current one
+		IvpMessage *copy;
 		if (msg)
-		{
-			ivpMsg = ivpMsg_copy(const_cast<IvpMessage *>(msg));
-		}
+			copy = ivpMsg_copy(const_cast<IvpMessage *>(msg));
 		else
-		{
-			ivpMsg = ivpMsg_create(NULL, NULL, NULL, 0, NULL);
-		}
+			copy = ivpMsg_create(NULL, NULL, NULL, 0, NULL);
 
-		// Bind the header attributes
-		_type.bind(ivpMsg->type);
-		_subtype.bind(ivpMsg->subtype);
-		_source.bind(ivpMsg->source);
-		_sourceId.bind(ivpMsg->sourceId);
-		_encoding.bind(ivpMsg->encoding);
-		_timestamp.bind(ivpMsg->timestamp);
-		_flags.bind(ivpMsg->flags);
+		destroy();
+		ivpMsg = copy;
 
-		// Note that the DSRC metadata is optional, so only bind when set
-		if (ivpMsg->dsrcMetadata)
-		{
-			_dsrcChannel.bind(ivpMsg->dsrcMetadata->channel);
-			_dsrcPsid.bind(ivpMsg->dsrcMetadata->psid);
-		}
+		this->msgVersion = -1;
+		payloadBytesValid = false;
 
 		init_attributes();
 	}
@@ -314,12 +361,35 @@ public:
 		{
 			// We cannot re-initialize on an empty container.
 			// Just flush out the current IVP message
-			std::string msgContents(ivpMsg_createJsonString(ivpMsg, IvpMsg_FormatOptions_none));
+			char *json = ivpMsg_createJsonString(ivpMsg, IvpMsg_FormatOptions_none);
+			std::string msgContents(json ? json : "");
+			free(json);
 			set_contents(msgContents);
 		}
 
-		// Reload the pointer from the contents
-		set_contents(ivpMsg_parse(const_cast<char*>(to_string().c_str())));
+		// Reload the pointer from the contents.  The container is used as is, since the header
+		// of the current IVP message would otherwise be written over it.
+		std::stringstream ss;
+		this->msg.template save<Format>(ss);
+		std::string contents = ss.str();
+
+		IvpMessage *parsed = ivpMsg_parse(const_cast<char *>(contents.c_str()));
+		set_contents(parsed);
+		if (parsed)
+			ivpMsg_destroy(parsed);
+
+		// The IVP message parser only reads numbers, but the container may hold them as strings
+		if (!ivpMsg->sourceId)
+			ivpMsg->sourceId = this->template get<unsigned int>(ATTR_HEADER ".sourceId", 0);
+		if (!ivpMsg->timestamp)
+			ivpMsg->timestamp = this->template get<uint64_t>(ATTR_HEADER ".timestamp", 0);
+		if (!ivpMsg->flags)
+			ivpMsg->flags = (IvpMsgFlags)this->template get<unsigned int>(ATTR_HEADER ".flags", 0);
+		if (ivpMsg->dsrcMetadata)
+		{
+			ivpMsg->dsrcMetadata->channel = this->template get<int>(ATTR_HEADER "." DSRC_HEADER ".channel", -1);
+			ivpMsg->dsrcMetadata->psid = this->template get<int>(ATTR_HEADER "." DSRC_HEADER ".psid", -1);
+		}
 	}
 
 	/**
@@ -356,54 +426,53 @@ public:
 		if (sourceId > 0) this->set_sourceId(sourceId);
 		if (flags > 0) this->set_flags(flags);
 	}
-private:
 	// Header attributes
 
-    struct IvpMessageHeaderCreator
-	{
-		typedef message_path_type path_type;
+	/**
+	 * The header is kept in the fixed fields of the IVP message, and is only written to the container
+	 * when the message is serialized.  These types give the data type and default value of each attribute.
+	 */
+	struct type { typedef std::string data_type; static data_type default_value() { return UNKNOWN_TYPE; } };
+	struct subtype { typedef std::string data_type; static data_type default_value() { return UNKNOWN_SUBTYPE; } };
+	struct source { typedef std::string data_type; static data_type default_value() { return ""; } };
+	struct sourceId { typedef unsigned int data_type; static data_type default_value() { return 0; } };
+	struct encoding { typedef std::string data_type; static data_type default_value() { return ""; } };
+	struct timestamp { typedef uint64_t data_type; static data_type default_value() { return 0; } };
+	struct flags { typedef unsigned int data_type; static data_type default_value() { return 0; } };
+	struct dsrcChannel { typedef int data_type; static data_type default_value() { return -1; } };
+	struct dsrcPsid { typedef int data_type; static data_type default_value() { return -1; } };
 
-		path_type operator()(path_type attr_path)
-		{
-			path_type p(ATTR_HEADER);
-			std::string tmp(attr_path.dump());
-			if (attr_path.dump().compare(0, 4, "dsrc") == 0)
-			{
-				// DSRC attributes go under a separate sub-object
-				p /= DSRC_HEADER;
-				tmp.replace(0, 4, "");
-				tmp[0] = tolower(tmp[0]);
-				p /= tmp;
-			}
-			else
-			{
-				p /= attr_path;
-			}
-			return p;
-		}
-	};
-
-    template <typename T>
-    using ivp_header_attribute_base =
-    		battelle::attributes::standard_2level_attribute<T, message_container_type::storage_type, IvpMessageHeaderCreator>;
-
-    template <typename T>
-    using ivp_header_attribute =
-    		battelle::attributes::standard_wrapped_attribute<ivp_header_attribute_base<T> >;
-
-    template <typename T>
-    using ivp_str_header_attribute =
-    		battelle::attributes::standard_wrapped_attribute<ivp_header_attribute_base<T>, battelle::attributes::StringAllocator>;
-
- 	rw_attribute(this->msg, ivp_str_header_attribute<type>, std::string, type, get_, "Unknown", set_, )
-    rw_attribute(this->msg, ivp_str_header_attribute<subtype>, std::string, subtype, get_, "Unknown", set_, )
-	rw_attribute(this->msg, ivp_str_header_attribute<source>, std::string, source, get_, "", set_, )
-	rw_attribute(this->msg, ivp_header_attribute<sourceId>, unsigned int, sourceId, get_, 0, set_, )
-	rw_attribute(this->msg, ivp_str_header_attribute<encoding>, std::string, encoding, get_, "", set_, )
-	rw_attribute(this->msg, ivp_header_attribute<timestamp>, uint64_t, timestamp, get_, 0, set_, )
-	rw_attribute(this->msg, ivp_header_attribute<flags>, unsigned int, flags, get_, 0, set_, )
-	rw_attribute(this->msg, ivp_header_attribute<dsrcChannel>, int, dsrcChannel, get_, -1, set_, )
-	rw_attribute(this->msg, ivp_header_attribute<dsrcPsid>, int, dsrcPsid, get_, -1, set_, )
+	std::string get_type() const { return header_str(ivpMsg->type, type::default_value()); }
+	void set_type(const std::string &value) { set_header_str(ivpMsg->type, value); }
+
+	std::string get_subtype() const { return header_str(ivpMsg->subtype, subtype::default_value()); }
+	void set_subtype(const std::string &value) { set_header_str(ivpMsg->subtype, value); }
+
+	std::string get_source() const { return header_str(ivpMsg->source, source::default_value()); }
+	void set_source(const std::string &value) { set_header_str(ivpMsg->source, value); }
+
+	unsigned int get_sourceId() const { return ivpMsg->sourceId; }
+	void set_sourceId(const unsigned int value) { ivpMsg->sourceId = value; this->msgVersion = -1; }
+
+	std::string get_encoding() const { return header_str(ivpMsg->encoding, encoding::default_value()); }
+	void set_encoding(const std::string &value) { set_header_str(ivpMsg->encoding, value); }
+
+	/**
+	 * @return True if the message has the given encoding, which is checked without copying the current one
+	 */
+	bool is_encoding(const char *value) const { return strcmp(ivpMsg->encoding ? ivpMsg->encoding : "", value) == 0; }
+
+	uint64_t get_timestamp() const { return ivpMsg->timestamp; }
+	void set_timestamp(const uint64_t value) { ivpMsg->timestamp = value; this->msgVersion = -1; }
+
+	unsigned int get_flags() const { return ivpMsg->flags; }
+	void set_flags(const unsigned int value) { ivpMsg->flags = (IvpMsgFlags)value; this->msgVersion = -1; }
+
+	int get_dsrcChannel() const { return ivpMsg->dsrcMetadata ? ivpMsg->dsrcMetadata->channel : dsrcChannel::default_value(); }
+	void set_dsrcChannel(const int value) { addDsrcMetadata(get_dsrcPsid(), value); }
+
+	int get_dsrcPsid() const { return ivpMsg->dsrcMetadata ? ivpMsg->dsrcMetadata->psid : dsrcPsid::default_value(); }
+	void set_dsrcPsid(const int value) { addDsrcMetadata(value, get_dsrcChannel()); }
 
 public:
 	// Some other helpful routines
@@ -458,32 +527,144 @@ public:
 	void addDsrcMetadata(int psid, int channel = 183)
 	{
 		ivpMsg_addDsrcMetadata(ivpMsg, psid, channel);
-		_dsrcChannel.bind(ivpMsg->dsrcMetadata->channel);
-		_dsrcPsid.bind(ivpMsg->dsrcMetadata->psid);
+		this->msgVersion = -1;
 	}
 
+	/**
+	 * Write the header and payload to the container, so it can be used directly.
+	 */
 	virtual void flush() {
-		get_payload_str();
+		flush(this->msg);
+
+		// Clear the string cache
+		this->msgString.clear();
+		this->msgVersion = -1;
+	}
+
+protected:
+	/**
+	 * Set the payload with the given byte stream, leaving the encoding as it is.
+	 * @param bytes The payload bytes
+	 */
+	void replace_payload_bytes(const byte_stream &bytes)
+	{
+		replace_payload(cJSON_CreateString(byte_stream_encode(bytes).c_str()));
+
+		// Keep the bytes, so they do not need to be decoded again
+		payloadBytes = bytes;
+		payloadBytesValid = true;
+	}
+
+	/**
+	 * Write the header and payload of the IVP message to the given container.
+	 */
+	virtual void flush(message_container_type &container) const
+	{
+		if (!ivpMsg)
+			return;
+
+		container.store(ATTR_HEADER ".type", get_type());
+		container.store(ATTR_HEADER ".subtype", get_subtype());
+		if (ivpMsg->source)
+			container.store(ATTR_HEADER ".source", ivpMsg->source);
+		if (ivpMsg->sourceId)
+			container.store(ATTR_HEADER ".sourceId", std::to_string(ivpMsg->sourceId));
+		container.store(ATTR_HEADER ".encoding", get_encoding());
+		container.store(ATTR_HEADER ".timestamp", std::to_string(ivpMsg->timestamp));
+		container.store(ATTR_HEADER ".flags", std::to_string(ivpMsg->flags));
+		if (ivpMsg->dsrcMetadata)
+		{
+			container.store(ATTR_HEADER "." DSRC_HEADER ".channel", std::to_string(ivpMsg->dsrcMetadata->channel));
+			container.store(ATTR_HEADER "." DSRC_HEADER ".psid", std::to_string(ivpMsg->dsrcMetadata->psid));
+		}
+
+		if (!ivpMsg->payload)
+			return;
+
+		message_tree_type &tree = container.get_storage().get_tree();
+		if (is_payload_tree())
+		{
+			tree.put_child(ATTR_PAYLOAD, payload_as_tree());
+			container.store(ATTR_PAYLOAD, "");
+		}
+		else if (is_payload_type(cJSON_String))
+		{
+			container.store(ATTR_PAYLOAD, get_payload_str());
+		}
+		else if (!tree.get_child_optional(ATTR_PAYLOAD))
+		{
+			// Numbers and booleans are kept in the container as they were set
+			container.store(ATTR_PAYLOAD, get_payload_str());
+		}
 	}
 
 private:
 	// For incoming messages, keep a copy of the source IVP message
 	IvpMessage *ivpMsg = NULL;
 
+	// The decoded bytes of the payload string, kept until the payload changes
+	byte_stream payloadBytes;
+	bool payloadBytesValid = false;
+
+	static std::string header_str(const char *value, const std::string &defaultValue)
+	{
+		return value ? std::string(value) : defaultValue;
+	}
+
+	void set_header_str(char *&field, const std::string &value)
+	{
+		// Most messages are given the same header values over again
+		if (field && value == field)
+			return;
+
+		if (field)
+			free(field);
+		field = strdup(value.c_str());
+		this->msgVersion = -1;
+	}
+
+	bool is_payload_type(int type) const
+	{
+		return (ivpMsg->payload->type & 0xFF) == type;
+	}
+
+	bool is_payload_tree() const
+	{
+		return ivpMsg && ivpMsg->payload && (is_payload_type(cJSON_Object) || is_payload_type(cJSON_Array));
+	}
+
+	message_tree_type payload_as_tree() const
+	{
+		message_container_type container;
+		std::stringstream ss;
+		ss << get_payload_str();
+		container.load<JSON>(ss);
+		return container.get_storage().get_tree();
+	}
+
+	void replace_payload(cJSON *payload)
+	{
+		if (ivpMsg->payload)
+			cJSON_Delete(ivpMsg->payload);
+		ivpMsg->payload = payload;
+
+		this->msgVersion = -1;
+		payloadBytesValid = false;
+	}
+
 	void destroy()
 	{
 		if (ivpMsg)
 			ivpMsg_destroy(ivpMsg);
+		ivpMsg = NULL;
 	}
 
 	void init_attributes()
 	{
-		// Initialize type, sub-type, encoding, timestamp and flags in that order to ensure they get set
-		this->get_type();
-		this->get_subtype();
-		this->get_encoding();
-		this->get_timestamp();
-		this->get_flags();
+		// Initialize type, sub-type and encoding to ensure they get set
+		if (!ivpMsg->type) set_type(type::default_value());
+		if (!ivpMsg->subtype) set_subtype(subtype::default_value());
+		if (!ivpMsg->encoding) set_encoding(encoding::default_value());
 	}
 };
 
@@ -0,0 +1,605 @@
+/*
+ * ByteCodec.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "ByteCodec.h"
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BYTE_CODEC_X86
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BYTE_CODEC_NEON
+#endif
+
+/*
+ * The vector kernels only handle whole blocks, and return how much of the input they consumed.
+ * The scalar code finishes the rest, which is also where invalid input is handled, so every
+ * implementation produces exactly the same output.
+ */
+typedef struct {
+	size_t (*hexEncode)(const uint8_t *bytes, size_t length, char *hex);
+	size_t (*hexDecode)(const char *hex, size_t pairs, uint8_t *bytes);
+	size_t (*base64Encode)(const uint8_t *bytes, size_t length, char *base64);
+	size_t (*base64Decode)(const char *base64, size_t length, uint8_t *bytes);
+} ByteCodecKernels;
+
+static const char byteCodec_hexDigits[] = "0123456789abcdef";
+static const char byteCodec_base64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int8_t byteCodec_hexValues[256];
+static int8_t byteCodec_base64Values[256];
+
+static pthread_once_t byteCodec_once = PTHREAD_ONCE_INIT;
+static ByteCodecImpl byteCodec_impl = ByteCodecImpl_Scalar;
+static const ByteCodecKernels *byteCodec_kernels;
+
+static size_t byteCodec_noEncodeKernel(const uint8_t *bytes, size_t length, char *out)
+{
+	return 0;
+}
+
+static size_t byteCodec_noDecodeKernel(const char *in, size_t length, uint8_t *bytes)
+{
+	return 0;
+}
+
+static const ByteCodecKernels byteCodec_scalarKernels = {
+	byteCodec_noEncodeKernel,
+	byteCodec_noDecodeKernel,
+	byteCodec_noEncodeKernel,
+	byteCodec_noDecodeKernel
+};
+
+#ifdef BYTE_CODEC_X86
+
+/*
+ * Converts 16 characters to their hex digit values, and sets valid to all ones for each valid digit.
+ */
+static inline __m128i byteCodec_hexValuesSse2(__m128i c, __m128i *valid)
+{
+	__m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+	__m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+	__m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+	*valid = _mm_or_si128(isDigit, isAlpha);
+	return _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+			_mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+static inline __m128i byteCodec_hexDigitsSse2(__m128i n)
+{
+	__m128i letters = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+	return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), letters);
+}
+
+static size_t byteCodec_hexEncodeSse2(const uint8_t *bytes, size_t length, char *hex)
+{
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *)(bytes + i));
+		__m128i hi = byteCodec_hexDigitsSse2(_mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)));
+		__m128i lo = byteCodec_hexDigitsSse2(_mm_and_si128(v, _mm_set1_epi8(0x0F)));
+
+		_mm_storeu_si128((__m128i *)(hex + 2 * i), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *)(hex + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+
+	return i;
+}
+
+static size_t byteCodec_hexDecodeSse2(const char *hex, size_t pairs, uint8_t *bytes)
+{
+	size_t i = 0;
+	for (; i + 16 <= pairs; i += 16)
+	{
+		__m128i valid0, valid1;
+		__m128i v0 = byteCodec_hexValuesSse2(_mm_loadu_si128((const __m128i *)(hex + 2 * i)), &valid0);
+		__m128i v1 = byteCodec_hexValuesSse2(_mm_loadu_si128((const __m128i *)(hex + 2 * i + 16)), &valid1);
+
+		if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF)
+			break;
+
+		// Each 16 bit lane holds the high digit in its low byte and the low digit in its high byte
+		__m128i mask = _mm_set1_epi16(0x00FF);
+		v0 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v0, mask), 4), _mm_srli_epi16(v0, 8));
+		v1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v1, mask), 4), _mm_srli_epi16(v1, 8));
+
+		_mm_storeu_si128((__m128i *)(bytes + i), _mm_packus_epi16(v0, v1));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i byteCodec_hexValuesAvx2(__m256i c, __m256i *valid)
+{
+	__m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+	__m256i isDigit = _mm256_andnot_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('0'), c), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+	__m256i isAlpha = _mm256_andnot_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8('a'), lower), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+	*valid = _mm256_or_si256(isDigit, isAlpha);
+	return _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+			_mm256_and_si256(isAlpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i byteCodec_hexDigitsAvx2(__m256i n)
+{
+	__m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+	return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), letters);
+}
+
+__attribute__((target("avx2")))
+static size_t byteCodec_hexEncodeAvx2(const uint8_t *bytes, size_t length, char *hex)
+{
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *)(bytes + i));
+		__m256i hi = byteCodec_hexDigitsAvx2(_mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F)));
+		__m256i lo = byteCodec_hexDigitsAvx2(_mm256_and_si256(v, _mm256_set1_epi8(0x0F)));
+
+		// The unpacks work within each 128 bit lane, so the lanes are put back in order after
+		__m256i first = _mm256_unpacklo_epi8(hi, lo);
+		__m256i second = _mm256_unpackhi_epi8(hi, lo);
+
+		_mm256_storeu_si256((__m256i *)(hex + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256((__m256i *)(hex + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+
+	i += byteCodec_hexEncodeSse2(bytes + i, length - i, hex + 2 * i);
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t byteCodec_hexDecodeAvx2(const char *hex, size_t pairs, uint8_t *bytes)
+{
+	size_t i = 0;
+	for (; i + 32 <= pairs; i += 32)
+	{
+		__m256i valid0, valid1;
+		__m256i v0 = byteCodec_hexValuesAvx2(_mm256_loadu_si256((const __m256i *)(hex + 2 * i)), &valid0);
+		__m256i v1 = byteCodec_hexValuesAvx2(_mm256_loadu_si256((const __m256i *)(hex + 2 * i + 32)), &valid1);
+
+		if (_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != -1)
+			break;
+
+		__m256i mask = _mm256_set1_epi16(0x00FF);
+		v0 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v0, mask), 4), _mm256_srli_epi16(v0, 8));
+		v1 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v1, mask), 4), _mm256_srli_epi16(v1, 8));
+
+		// The pack interleaves the 128 bit lanes of its inputs
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), 0xD8);
+		_mm256_storeu_si256((__m256i *)(bytes + i), packed);
+	}
+
+	i += byteCodec_hexDecodeSse2(hex + 2 * i, pairs - i, bytes + i);
+	return i;
+}
+
+/*
+ * Base64 with AVX2 follows the approach of Muła and Lemire, "Faster Base64 Encoding and Decoding
+ * using AVX2 Instructions".  Each 128 bit lane encodes 12 bytes into 16 characters.
+ */
+__attribute__((target("avx2")))
+static size_t byteCodec_base64EncodeAvx2(const uint8_t *bytes, size_t length, char *base64)
+{
+	const __m256i shuffle = _mm256_setr_epi8(
+			1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+			1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m256i offsets = _mm256_setr_epi8(
+			65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+			65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+	size_t i = 0, o = 0;
+
+	// Each step reads 16 bytes from 12 bytes in, so stop while that is still inside the input
+	for (; i + 28 <= length; i += 24, o += 32)
+	{
+		__m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(bytes + i))),
+				_mm_loadu_si128((const __m128i *)(bytes + i + 12)), 1);
+		in = _mm256_shuffle_epi8(in, shuffle);
+
+		// Split each 3 bytes into four 6 bit values, one per byte
+		__m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+		__m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+		__m256i values = _mm256_or_si256(t0, t1);
+
+		// Map each range of the alphabet with an offset looked up from the value
+		__m256i index = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+		index = _mm256_sub_epi8(index, _mm256_cmpgt_epi8(values, _mm256_set1_epi8(25)));
+		_mm256_storeu_si256((__m256i *)(base64 + o), _mm256_add_epi8(values, _mm256_shuffle_epi8(offsets, index)));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t byteCodec_base64DecodeAvx2(const char *base64, size_t length, uint8_t *bytes)
+{
+	// Classification of each character by its low and high nibble.  A character is valid when the two do not overlap.
+	const __m256i lutLo = _mm256_setr_epi8(
+			0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+			0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m256i lutHi = _mm256_setr_epi8(
+			0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+			0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lutRoll = _mm256_setr_epi8(
+			0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+			0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i mask2F = _mm256_set1_epi8(0x2F);
+	const __m256i pack = _mm256_setr_epi8(
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+			2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+	size_t i = 0, o = 0;
+	for (; i + 32 <= length; i += 32, o += 24)
+	{
+		__m256i in = _mm256_loadu_si256((const __m256i *)(base64 + i));
+		__m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask2F);
+		__m256i loNibbles = _mm256_and_si256(in, mask2F);
+
+		if (!_mm256_testz_si256(_mm256_shuffle_epi8(lutLo, loNibbles), _mm256_shuffle_epi8(lutHi, hiNibbles)))
+			break;
+
+		__m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask2F), hiNibbles));
+		__m256i values = _mm256_add_epi8(in, roll);
+
+		// Join four 6 bit values into 3 bytes in each 32 bit lane, then gather the bytes together
+		__m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+		merged = _mm256_shuffle_epi8(merged, pack);
+		merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+		_mm_storeu_si128((__m128i *)(bytes + o), _mm256_castsi256_si128(merged));
+		_mm_storel_epi64((__m128i *)(bytes + o + 16), _mm256_extracti128_si256(merged, 1));
+	}
+
+	return i;
+}
+
+static const ByteCodecKernels byteCodec_sse2Kernels = {
+	byteCodec_hexEncodeSse2,
+	byteCodec_hexDecodeSse2,
+	byteCodec_noEncodeKernel,
+	byteCodec_noDecodeKernel
+};
+
+static const ByteCodecKernels byteCodec_avx2Kernels = {
+	byteCodec_hexEncodeAvx2,
+	byteCodec_hexDecodeAvx2,
+	byteCodec_base64EncodeAvx2,
+	byteCodec_base64DecodeAvx2
+};
+
+#endif /* BYTE_CODEC_X86 */
+
+#ifdef BYTE_CODEC_NEON
+
+static size_t byteCodec_hexEncodeNeon(const uint8_t *bytes, size_t length, char *hex)
+{
+	const uint8x16_t digits = vld1q_u8((const uint8_t *)byteCodec_hexDigits);
+
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t v = vld1q_u8(bytes + i);
+		uint8x16x2_t out;
+		out.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+		out.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0F)));
+		vst2q_u8((uint8_t *)(hex + 2 * i), out);
+	}
+
+	return i;
+}
+
+static inline uint8x16_t byteCodec_hexValuesNeon(uint8x16_t c, uint8x16_t *valid)
+{
+	uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+	uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+	uint8x16_t isDigit = vcleq_u8(digit, vdupq_n_u8(9));
+	uint8x16_t isAlpha = vcleq_u8(alpha, vdupq_n_u8(5));
+
+	*valid = vorrq_u8(isDigit, isAlpha);
+	return vbslq_u8(isDigit, digit, vaddq_u8(alpha, vdupq_n_u8(10)));
+}
+
+static size_t byteCodec_hexDecodeNeon(const char *hex, size_t pairs, uint8_t *bytes)
+{
+	size_t i = 0;
+	for (; i + 16 <= pairs; i += 16)
+	{
+		uint8x16x2_t in = vld2q_u8((const uint8_t *)(hex + 2 * i));
+		uint8x16_t valid0, valid1;
+		uint8x16_t hi = byteCodec_hexValuesNeon(in.val[0], &valid0);
+		uint8x16_t lo = byteCodec_hexValuesNeon(in.val[1], &valid1);
+
+		if (vminvq_u8(vandq_u8(valid0, valid1)) != 0xFF)
+			break;
+
+		vst1q_u8(bytes + i, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+	}
+
+	return i;
+}
+
+static size_t byteCodec_base64EncodeNeon(const uint8_t *bytes, size_t length, char *base64)
+{
+	const uint8x16x4_t digits = vld1q_u8_x4((const uint8_t *)byteCodec_base64Digits);
+	const uint8x16_t mask = vdupq_n_u8(0x3F);
+
+	size_t i = 0, o = 0;
+	for (; i + 48 <= length; i += 48, o += 64)
+	{
+		uint8x16x3_t in = vld3q_u8(bytes + i);
+		uint8x16x4_t out;
+		out.val[0] = vshrq_n_u8(in.val[0], 2);
+		out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+		out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+		out.val[3] = vandq_u8(in.val[2], mask);
+
+		out.val[0] = vqtbl4q_u8(digits, out.val[0]);
+		out.val[1] = vqtbl4q_u8(digits, out.val[1]);
+		out.val[2] = vqtbl4q_u8(digits, out.val[2]);
+		out.val[3] = vqtbl4q_u8(digits, out.val[3]);
+		vst4q_u8((uint8_t *)(base64 + o), out);
+	}
+
+	return i;
+}
+
+static inline uint8x16_t byteCodec_base64ValuesNeon(uint8x16_t c, uint8x16_t *valid)
+{
+	uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+	uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+	uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+	uint8x16_t isUpper = vcltq_u8(upper, vdupq_n_u8(26));
+	uint8x16_t isLower = vcltq_u8(lower, vdupq_n_u8(26));
+	uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+	uint8x16_t isPlus = vceqq_u8(c, vdupq_n_u8('+'));
+	uint8x16_t isSlash = vceqq_u8(c, vdupq_n_u8('/'));
+
+	*valid = vorrq_u8(vorrq_u8(vorrq_u8(isUpper, isLower), vorrq_u8(isDigit, isPlus)), isSlash);
+
+	uint8x16_t v = vandq_u8(isUpper, upper);
+	v = vorrq_u8(v, vandq_u8(isLower, vaddq_u8(lower, vdupq_n_u8(26))));
+	v = vorrq_u8(v, vandq_u8(isDigit, vaddq_u8(digit, vdupq_n_u8(52))));
+	v = vorrq_u8(v, vandq_u8(isPlus, vdupq_n_u8(62)));
+	return vorrq_u8(v, vandq_u8(isSlash, vdupq_n_u8(63)));
+}
+
+static size_t byteCodec_base64DecodeNeon(const char *base64, size_t length, uint8_t *bytes)
+{
+	size_t i = 0, o = 0;
+	for (; i + 64 <= length; i += 64, o += 48)
+	{
+		uint8x16x4_t in = vld4q_u8((const uint8_t *)(base64 + i));
+		uint8x16_t valid0, valid1, valid2, valid3;
+		uint8x16_t a = byteCodec_base64ValuesNeon(in.val[0], &valid0);
+		uint8x16_t b = byteCodec_base64ValuesNeon(in.val[1], &valid1);
+		uint8x16_t c = byteCodec_base64ValuesNeon(in.val[2], &valid2);
+		uint8x16_t d = byteCodec_base64ValuesNeon(in.val[3], &valid3);
+
+		if (vminvq_u8(vandq_u8(vandq_u8(valid0, valid1), vandq_u8(valid2, valid3))) != 0xFF)
+			break;
+
+		uint8x16x3_t out;
+		out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+		out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+		out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+		vst3q_u8(bytes + o, out);
+	}
+
+	return i;
+}
+
+static const ByteCodecKernels byteCodec_neonKernels = {
+	byteCodec_hexEncodeNeon,
+	byteCodec_hexDecodeNeon,
+	byteCodec_base64EncodeNeon,
+	byteCodec_base64DecodeNeon
+};
+
+#endif /* BYTE_CODEC_NEON */
+
+static const ByteCodecKernels *byteCodec_getKernels(ByteCodecImpl impl)
+{
+	switch (impl)
+	{
+	case ByteCodecImpl_Scalar:
+		return &byteCodec_scalarKernels;
+#ifdef BYTE_CODEC_X86
+	case ByteCodecImpl_Sse2:
+		return &byteCodec_sse2Kernels;
+	case ByteCodecImpl_Avx2:
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") ? &byteCodec_avx2Kernels : NULL;
+#endif
+#ifdef BYTE_CODEC_NEON
+	case ByteCodecImpl_Neon:
+		return &byteCodec_neonKernels;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static void byteCodec_init()
+{
+	int i;
+
+	for (i = 0; i < 256; i++)
+	{
+		byteCodec_hexValues[i] = -1;
+		byteCodec_base64Values[i] = -1;
+	}
+
+	for (i = 0; i < 16; i++)
+	{
+		byteCodec_hexValues[(uint8_t)byteCodec_hexDigits[i]] = i;
+		if (i >= 10)
+			byteCodec_hexValues[(uint8_t)byteCodec_hexDigits[i] - 'a' + 'A'] = i;
+	}
+
+	for (i = 0; i < 64; i++)
+		byteCodec_base64Values[(uint8_t)byteCodec_base64Digits[i]] = i;
+
+	// Pick the best implementation the processor supports
+	ByteCodecImpl impl;
+	for (impl = ByteCodecImpl_Neon; impl > ByteCodecImpl_Scalar; impl--)
+	{
+		if (byteCodec_getKernels(impl) != NULL)
+			break;
+	}
+
+	byteCodec_impl = impl;
+	byteCodec_kernels = byteCodec_getKernels(impl);
+}
+
+static inline const ByteCodecKernels *byteCodec_kernelsInUse()
+{
+	pthread_once(&byteCodec_once, byteCodec_init);
+	return byteCodec_kernels;
+}
+
+ByteCodecImpl byteCodec_getImplementation(void)
+{
+	byteCodec_kernelsInUse();
+	return byteCodec_impl;
+}
+
+const char *byteCodec_getImplementationName(ByteCodecImpl impl)
+{
+	switch (impl)
+	{
+	case ByteCodecImpl_Scalar:
+		return "scalar";
+	case ByteCodecImpl_Sse2:
+		return "sse2";
+	case ByteCodecImpl_Avx2:
+		return "avx2";
+	case ByteCodecImpl_Neon:
+		return "neon";
+	default:
+		return "unknown";
+	}
+}
+
+int byteCodec_setImplementation(ByteCodecImpl impl)
+{
+	byteCodec_kernelsInUse();
+
+	const ByteCodecKernels *kernels = byteCodec_getKernels(impl);
+	if (kernels == NULL)
+		return 0;
+
+	byteCodec_impl = impl;
+	byteCodec_kernels = kernels;
+	return 1;
+}
+
+void byteCodec_hexEncode(const uint8_t *bytes, size_t length, char *hex)
+{
+	size_t i = byteCodec_kernelsInUse()->hexEncode(bytes, length, hex);
+
+	for (; i < length; i++)
+	{
+		hex[2 * i] = byteCodec_hexDigits[bytes[i] >> 4];
+		hex[2 * i + 1] = byteCodec_hexDigits[bytes[i] & 0x0F];
+	}
+}
+
+size_t byteCodec_hexDecode(const char *hex, size_t length, uint8_t *bytes)
+{
+	size_t pairs = length / 2;
+	size_t i = byteCodec_kernelsInUse()->hexDecode(hex, pairs, bytes);
+
+	for (; i < pairs; i++)
+	{
+		int hi = byteCodec_hexValues[(uint8_t)hex[2 * i]];
+		int lo = byteCodec_hexValues[(uint8_t)hex[2 * i + 1]];
+		if ((hi | lo) < 0)
+			break;
+
+		bytes[i] = (uint8_t)(hi << 4 | lo);
+	}
+
+	return i;
+}
+
+size_t byteCodec_base64EncodedLength(size_t length)
+{
+	return (length + 2) / 3 * 4;
+}
+
+size_t byteCodec_base64Encode(const uint8_t *bytes, size_t length, char *base64)
+{
+	size_t i = byteCodec_kernelsInUse()->base64Encode(bytes, length, base64);
+	size_t o = i / 3 * 4;
+
+	for (; i + 3 <= length; i += 3, o += 4)
+	{
+		uint32_t group = (uint32_t)bytes[i] << 16 | (uint32_t)bytes[i + 1] << 8 | bytes[i + 2];
+		base64[o] = byteCodec_base64Digits[group >> 18];
+		base64[o + 1] = byteCodec_base64Digits[(group >> 12) & 0x3F];
+		base64[o + 2] = byteCodec_base64Digits[(group >> 6) & 0x3F];
+		base64[o + 3] = byteCodec_base64Digits[group & 0x3F];
+	}
+
+	if (i < length)
+	{
+		uint32_t group = (uint32_t)bytes[i] << 16;
+		if (i + 1 < length)
+			group |= (uint32_t)bytes[i + 1] << 8;
+
+		base64[o] = byteCodec_base64Digits[group >> 18];
+		base64[o + 1] = byteCodec_base64Digits[(group >> 12) & 0x3F];
+		base64[o + 2] = i + 1 < length ? byteCodec_base64Digits[(group >> 6) & 0x3F] : '=';
+		base64[o + 3] = '=';
+		o += 4;
+	}
+
+	return o;
+}
+
+size_t byteCodec_base64Decode(const char *base64, size_t length, uint8_t *bytes)
+{
+	size_t i = byteCodec_kernelsInUse()->base64Decode(base64, length, bytes);
+	size_t o = i / 4 * 3;
+
+	uint32_t group = 0;
+	int count = 0;
+	for (; i < length; i++)
+	{
+		int value = byteCodec_base64Values[(uint8_t)base64[i]];
+		if (value < 0)
+			break;
+
+		group = group << 6 | (uint32_t)value;
+		if (++count == 4)
+		{
+			bytes[o++] = (uint8_t)(group >> 16);
+			bytes[o++] = (uint8_t)(group >> 8);
+			bytes[o++] = (uint8_t)group;
+			group = 0;
+			count = 0;
+		}
+	}
+
+	// A partial group holds one byte less than it has characters
+	if (count > 1)
+	{
+		group <<= 6 * (4 - count);
+		bytes[o++] = (uint8_t)(group >> 16);
+		if (count > 2)
+			bytes[o++] = (uint8_t)(group >> 8);
+	}
+
+	return o;
+}
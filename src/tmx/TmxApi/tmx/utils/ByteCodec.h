@@ -0,0 +1,103 @@
+/*
+ * ByteCodec.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef BYTECODEC_H_
+#define BYTECODEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * The implementations of the codec.  The best one supported by the processor is chosen the first time
+ * the codec is used.
+ */
+typedef enum {
+	ByteCodecImpl_Scalar = 0,
+	ByteCodecImpl_Sse2,
+	ByteCodecImpl_Avx2,
+	ByteCodecImpl_Neon
+} ByteCodecImpl;
+
+/*!
+ * @returns
+ * 		The implementation in use.
+ */
+ByteCodecImpl byteCodec_getImplementation(void);
+
+/*!
+ * @returns
+ * 		A printable name of the implementation.
+ */
+const char *byteCodec_getImplementationName(ByteCodecImpl impl);
+
+/*!
+ * Switches the implementation in use, for testing and benchmarking.  Not safe while other threads are using the codec.
+ *
+ * @returns
+ * 		1 if the implementation is now in use, or 0 if the processor does not support it.
+ */
+int byteCodec_setImplementation(ByteCodecImpl impl);
+
+/*!
+ * Encodes bytes as lower case hex.  The output is not null terminated.
+ *
+ * @param hex
+ * 		Room for 2 * length characters.
+ */
+void byteCodec_hexEncode(const uint8_t *bytes, size_t length, char *hex);
+
+/*!
+ * Decodes pairs of hex digits, either case, into bytes.  An odd last character is ignored.
+ * Decoding stops at the first pair that is not two hex digits.
+ *
+ * @param bytes
+ * 		Room for length / 2 bytes.
+ *
+ * @returns
+ * 		The number of bytes decoded, which is length / 2 if the whole string was valid.
+ */
+size_t byteCodec_hexDecode(const char *hex, size_t length, uint8_t *bytes);
+
+/*!
+ * @returns
+ * 		The number of characters needed to base64 encode length bytes, including padding.
+ */
+size_t byteCodec_base64EncodedLength(size_t length);
+
+/*!
+ * Encodes bytes as standard base64 with '=' padding.  The output is not null terminated.
+ *
+ * @param base64
+ * 		Room for byteCodec_base64EncodedLength(length) characters.
+ *
+ * @returns
+ * 		The number of characters written.
+ */
+size_t byteCodec_base64Encode(const uint8_t *bytes, size_t length, char *base64);
+
+/*!
+ * Decodes standard base64.  Decoding stops at the first '=' or other character that is not in the
+ * alphabet, and a partial group at the end is decoded as far as it goes.
+ *
+ * @param bytes
+ * 		Room for length / 4 * 3 + 2 bytes.
+ *
+ * @returns
+ * 		The number of bytes decoded.
+ */
+size_t byteCodec_base64Decode(const char *base64, size_t length, uint8_t *bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BYTECODEC_H_ */
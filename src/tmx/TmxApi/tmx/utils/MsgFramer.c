@@ -9,24 +9,98 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/uio.h>
 
-const MsgFramer MSG_FRAMER_INITIALIZER = { .bufpos = 0, .readpos = 0, .onMsgFound = NULL };
+const MsgFramer MSG_FRAMER_INITIALIZER = { .buf = NULL, .bufsize = 0, .bufpos = 0, .readpos = 0, .onMsgFound = NULL };
+
+static void msgFramer_reserve(MsgFramer *framer)
+{
+	if (framer->buf != NULL)
+		return;
+
+	framer->buf = malloc(MSG_FRAMER_INITIAL_BUF_SIZE + 1);
+	assert(framer->buf != NULL);
+	if (framer->buf != NULL)
+	{
+		framer->bufsize = MSG_FRAMER_INITIAL_BUF_SIZE;
+		framer->buf[0] = '\0';
+	}
+	framer->bufpos = 0;
+	framer->readpos = 0;
+}
+
+// Called when there are no more complete frames, so there are no views into the buffer to invalidate.
+// Moves the partial frame to the front of the buffer, and grows the buffer if there is still not enough space.
+static void msgFramer_makeSpace(MsgFramer *framer)
+{
+	if (framer->readpos != 0)
+	{
+		int shift = framer->readpos;
+		memmove(framer->buf, framer->buf + shift, framer->bufpos + 1 - shift);
+		framer->bufpos -= shift;
+		framer->readpos = 0;
+	}
+
+	if (framer->bufsize - framer->bufpos >= MSG_FRAMER_MIN_READ_SIZE)
+		return;
+
+	if (framer->bufsize >= MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE)
+	{
+		// A frame this large can only be the result of a corrupt stream.  Drop it all.
+		framer->bufpos = 0;
+		framer->buf[0] = '\0';
+		return;
+	}
+
+	int newSize = framer->bufsize * 2;
+	if (newSize > MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE)
+		newSize = MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE;
+
+	char *newBuf = realloc(framer->buf, newSize + 1);
+	assert(newBuf != NULL);
+	if (newBuf == NULL)
+	{
+		framer->bufpos = 0;
+		framer->buf[0] = '\0';
+		return;
+	}
+
+	framer->buf = newBuf;
+	framer->bufsize = newSize;
+}
+
+void msgFramer_destroy(MsgFramer *framer)
+{
+	if (framer->buf != NULL)
+		free(framer->buf);
+
+	framer->buf = NULL;
+	framer->bufsize = 0;
+	framer->bufpos = 0;
+	framer->readpos = 0;
+}
 
 char *msgFramer_getBuf(MsgFramer *framer)
 {
+	msgFramer_reserve(framer);
 	return framer->buf + framer->bufpos;
 }
 
 int msgFramer_getBufLength(MsgFramer *framer)
 {
-	return MSG_FRAMER_MAX_BUF_SIZE - framer->bufpos;
+	msgFramer_reserve(framer);
+	return framer->bufsize - framer->bufpos;
 }
 
 void msgFramer_incrementBufPos(MsgFramer *framer, int incLength)
 {
+	msgFramer_reserve(framer);
+
 	framer->bufpos += incLength;
-	assert(framer->bufpos <= MSG_FRAMER_MAX_BUF_SIZE);
-	if (framer->bufpos > MSG_FRAMER_MAX_BUF_SIZE)
+	assert(framer->bufpos <= framer->bufsize);
+	if (framer->bufpos > framer->bufsize)
 	{
 		framer->bufpos = 0;
 		framer->readpos = 0;
@@ -35,58 +109,85 @@ void msgFramer_incrementBufPos(MsgFramer *framer, int incLength)
 	framer->buf[framer->bufpos] = '\0';
 }
 
-
 char *msgFramer_getNextMsg(MsgFramer *framer)
+{
+	int length;
+	MsgFramer_FrameType frameType;
+	char *results;
+
+	// Callers of this function only understand JSON, so skip over any binary frames.
+	while ((results = msgFramer_getNextFrame(framer, &length, &frameType)) != NULL)
+	{
+		if (frameType == MsgFramer_FrameType_json)
+			break;
+	}
+
+	return results;
+}
+
+char *msgFramer_getNextFrame(MsgFramer *framer, int *outFrameLength, MsgFramer_FrameType *outFrameType)
 {
 	char *results = NULL;
 
-	if (framer->readpos != 0)
+	msgFramer_reserve(framer);
+
+	for (;;)
 	{
-		int shift = framer->readpos;
-		int i;
-		for(i = 0; i < framer->bufpos + 1 - shift; i++)
+		// Binary frames may contain any byte, including nulls, so the string functions can not be used.
+		int start;
+		for (start = framer->readpos; start < framer->bufpos; start++)
 		{
-			framer->buf[i] = framer->buf[i + shift];
+			if (framer->buf[start] == MSG_FRAMER_JSON_START || framer->buf[start] == MSG_FRAMER_BINARY_START)
+				break;
 		}
-		//memcpy(framer->buf, framer->buf + shift, framer->bufpos + 1 - shift);
-		framer->bufpos -= shift;
-		framer->readpos = 0;
-	}
 
-	char *msgStart = strstr(framer->buf, "\x02");
-	if (msgStart == NULL)
-	{
-		framer->bufpos = 0;
-	}
-	else
-	{
-		if(msgStart != framer->buf)
+		framer->readpos = start;
+		if (start == framer->bufpos)
+			break;
+
+		char *frame = framer->buf + start;
+		int available = framer->bufpos - start;
+
+		if (frame[0] == MSG_FRAMER_JSON_START)
 		{
-			int shift = (msgStart - framer->buf);
-			//memcpy(framer->buf, framer->buf + shift, framer->bufpos + 1 - shift);
-			int i;
-			for(i = 0; i < framer->bufpos + 1 - shift; i++)
+			char *msgEnd = memchr(frame, MSG_FRAMER_JSON_END, available);
+			if (msgEnd != NULL)
 			{
-				framer->buf[i] = framer->buf[i + shift];
+				*msgEnd = '\0';
+
+				results = frame + 1;
+				*outFrameLength = (msgEnd - frame) - 1;
+				*outFrameType = MsgFramer_FrameType_json;
+				framer->readpos = (msgEnd - framer->buf) + 1;
 			}
-			framer->bufpos -= shift;
+			break;
 		}
 
-		char *msgEnd = strstr(framer->buf, "\x03");
-		if(msgEnd != NULL)
+		if (available < MSG_FRAMER_BINARY_HEADER_SIZE)
+			break;
+
+		unsigned char *header = (unsigned char *)frame;
+		uint32_t length = ((uint32_t)header[1] << 24) | ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 8) | (uint32_t)header[4];
+
+		if (length > MSG_FRAMER_MAX_FRAME_SIZE)
 		{
-			*msgEnd = '\0';
+			// This frame is not allowed, so it must be a corrupt start byte.  Skip it and resync.
+			framer->readpos++;
+			continue;
+		}
 
-			results = framer->buf + 1;
-			framer->readpos = (msgEnd - framer->buf) + 1;
+		if (available >= MSG_FRAMER_BINARY_HEADER_SIZE + (int)length)
+		{
+			results = frame + MSG_FRAMER_BINARY_HEADER_SIZE;
+			*outFrameLength = length;
+			*outFrameType = MsgFramer_FrameType_binary;
+			framer->readpos = start + MSG_FRAMER_BINARY_HEADER_SIZE + length;
 		}
+		break;
 	}
 
-	if (framer->bufpos == MSG_FRAMER_MAX_BUF_SIZE && results == NULL)
-	{
-		framer->bufpos = 0;
-		framer->readpos = 0;
-	}
+	if (results == NULL)
+		msgFramer_makeSpace(framer);
 
 	return results;
 }
@@ -109,3 +210,100 @@ char *msgFramer_createFramedMsg(char *msg, int msgLength, int *outMsgLength)
 	}
 	return framedMsg;
 }
+
+static void msgFramer_setBinaryHeader(char *header, int msgLength)
+{
+	uint32_t length = (uint32_t)msgLength;
+
+	header[0] = MSG_FRAMER_BINARY_START;
+	header[1] = (char)(length >> 24);
+	header[2] = (char)(length >> 16);
+	header[3] = (char)(length >> 8);
+	header[4] = (char)length;
+}
+
+char *msgFramer_createFramedBinaryMsg(const char *msg, int msgLength, int *outMsgLength)
+{
+	assert(msg != NULL || msgLength == 0);
+
+	char *framedMsg = malloc(msgLength + MSG_FRAMER_BINARY_HEADER_SIZE);
+	*outMsgLength = 0;
+	if (framedMsg)
+	{
+		msgFramer_setBinaryHeader(framedMsg, msgLength);
+		if (msgLength > 0)
+			memcpy(framedMsg + MSG_FRAMER_BINARY_HEADER_SIZE, msg, msgLength);
+
+		*outMsgLength = msgLength + MSG_FRAMER_BINARY_HEADER_SIZE;
+	}
+	return framedMsg;
+}
+
+int msgFramer_writeFramedMsg(int fd, const char *msg, int msgLength, MsgFramer_FrameType frameType)
+{
+	assert(msg != NULL || msgLength == 0);
+
+	char header[MSG_FRAMER_BINARY_HEADER_SIZE];
+	char trailer = MSG_FRAMER_JSON_END;
+	struct iovec iov[3];
+	int iovcnt = 0;
+
+	if (frameType == MsgFramer_FrameType_binary)
+	{
+		msgFramer_setBinaryHeader(header, msgLength);
+		iov[iovcnt].iov_base = header;
+		iov[iovcnt++].iov_len = MSG_FRAMER_BINARY_HEADER_SIZE;
+	}
+	else
+	{
+		assert(memchr(msg, MSG_FRAMER_JSON_START, msgLength) == NULL);
+		assert(memchr(msg, MSG_FRAMER_JSON_END, msgLength) == NULL);
+
+		header[0] = MSG_FRAMER_JSON_START;
+		iov[iovcnt].iov_base = header;
+		iov[iovcnt++].iov_len = 1;
+	}
+
+	if (msgLength > 0)
+	{
+		iov[iovcnt].iov_base = (void *)msg;
+		iov[iovcnt++].iov_len = msgLength;
+	}
+
+	if (frameType == MsgFramer_FrameType_json)
+	{
+		iov[iovcnt].iov_base = &trailer;
+		iov[iovcnt++].iov_len = 1;
+	}
+
+	int total = 0;
+	struct iovec *next = iov;
+
+	while (iovcnt > 0)
+	{
+		ssize_t written = writev(fd, next, iovcnt);
+		if (written <= 0)
+		{
+			if (written < 0 && errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		total += written;
+
+		// Skip over whatever was written, in case the socket buffer only took part of the frame.
+		while (iovcnt > 0 && (size_t)written >= next->iov_len)
+		{
+			written -= next->iov_len;
+			next++;
+			iovcnt--;
+		}
+		if (iovcnt > 0)
+		{
+			next->iov_base = (char *)next->iov_base + written;
+			next->iov_len -= written;
+		}
+	}
+
+	return total;
+}
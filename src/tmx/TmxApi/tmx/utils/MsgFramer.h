@@ -13,10 +13,45 @@ extern "C"
 {
 #endif
 
-#define MSG_FRAMER_MAX_BUF_SIZE 20000
+/*!
+ * The framer buffer starts at this size and grows on demand, up to the maximum frame size.
+ */
+#define MSG_FRAMER_INITIAL_BUF_SIZE 20000
+#define MSG_FRAMER_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+/*!
+ * The smallest amount of free space given to a read into the buffer.
+ */
+#define MSG_FRAMER_MIN_READ_SIZE 4096
 
+/*!
+ * Start and end bytes of a JSON frame.
+ */
+#define MSG_FRAMER_JSON_START 0x02
+#define MSG_FRAMER_JSON_END 0x03
+
+/*!
+ * Start byte of a binary frame.  It is followed by the length of the frame contents
+ * as a 4 byte unsigned integer in network byte order, then the contents.
+ */
+#define MSG_FRAMER_BINARY_START 0x01
+#define MSG_FRAMER_BINARY_HEADER_SIZE 5
+
+typedef enum {
+	MsgFramer_FrameType_json,
+	MsgFramer_FrameType_binary
+} MsgFramer_FrameType;
+
+/*!
+ * Splits a stream of bytes into frames.
+ *
+ * Data from bufpos to the end of the buffer is free space for reading into.  Frames are handed out as views into
+ * the buffer between readpos and bufpos, so nothing is moved until the buffer needs the space for the next read.
+ * The buffer is allocated on first use and must be released with msgFramer_destroy.
+ */
 typedef struct {
-	char buf[MSG_FRAMER_MAX_BUF_SIZE + 1];
+	char *buf;
+	int bufsize;
 	int bufpos;
 	int readpos;
 	void (*onMsgFound)(char *);
@@ -24,12 +59,43 @@ typedef struct {
 
 extern const MsgFramer MSG_FRAMER_INITIALIZER;
 
+/*!
+ * Frees the buffer of the framer.  The framer can be used again afterwards.
+ */
+void msgFramer_destroy(MsgFramer *framer);
+
 char *msgFramer_getBuf(MsgFramer *framer);
 int msgFramer_getBufLength(MsgFramer *framer);
 void msgFramer_incrementBufPos(MsgFramer *framer, int incLength);
 char *msgFramer_getNextMsg(MsgFramer *framer);
 char *msgFramer_createFramedMsg(char *msg, int msgLength, int *outMsgLength);
 
+/*!
+ * Returns the contents of the next complete JSON or binary frame in the buffer, or NULL if there is none.
+ * The contents of a JSON frame are null terminated.  The pointer is valid until the next call into the framer.
+ *
+ * @param outFrameLength
+ * 		Set to the length of the frame contents.
+ *
+ * @param outFrameType
+ * 		Set to the type of frame found.
+ */
+char *msgFramer_getNextFrame(MsgFramer *framer, int *outFrameLength, MsgFramer_FrameType *outFrameType);
+
+/*!
+ * Creates a malloc'ed binary frame containing msgLength bytes of msg.
+ */
+char *msgFramer_createFramedBinaryMsg(const char *msg, int msgLength, int *outMsgLength);
+
+/*!
+ * Writes msg to the file descriptor as a single frame of the given type with writev, so the message
+ * does not have to be copied into a framed buffer first.
+ *
+ * @returns
+ * 		The number of bytes written, or -1 on error.
+ */
+int msgFramer_writeFramedMsg(int fd, const char *msg, int msgLength, MsgFramer_FrameType frameType);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,363 @@
+/*
+ * ShmRing.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "ShmRing.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHM_RING_MAGIC 0x544D5852
+#define SHM_RING_WRAP 0xFFFFFFFF
+#define SHM_RING_ALIGN(x) (((x) + 7) & ~((uint64_t)7))
+
+/*
+ * The layout of the shared memory segment.  The writer and reader fields are kept on separate
+ * cache lines so the two processes do not contend for them.
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t capacity;
+	uint32_t closed;
+	char pad0[52];
+
+	// Owned by the writer
+	uint64_t head;
+	uint32_t headSeq;
+	uint32_t readerWaiting;
+	char pad1[48];
+
+	// Owned by the reader
+	uint64_t tail;
+	uint32_t tailSeq;
+	uint32_t writerWaiting;
+	char pad2[48];
+} ShmRingHeader;
+
+struct ShmRing {
+	ShmRingHeader *header;
+	char *data;
+	size_t mappedSize;
+	char *name;
+	int owner;
+	uint32_t pendingRelease;
+	pthread_mutex_t writeLock;
+};
+
+static int shmRing_futexWait(uint32_t *addr, uint32_t value, int timeoutMs)
+{
+	struct timespec timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+
+	// The segment is shared between processes, so the private futex operations can not be used.
+	return syscall(SYS_futex, addr, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+static void shmRing_futexWake(uint32_t *addr)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static ShmRing *shmRing_map(const char *name, int fd, size_t size, int owner)
+{
+	void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return NULL;
+
+	ShmRing *ring = calloc(1, sizeof(ShmRing));
+	if (ring == NULL)
+	{
+		munmap(addr, size);
+		return NULL;
+	}
+
+	ring->header = (ShmRingHeader *)addr;
+	ring->data = (char *)addr + sizeof(ShmRingHeader);
+	ring->mappedSize = size;
+	ring->name = strdup(name);
+	ring->owner = owner;
+	pthread_mutex_init(&ring->writeLock, NULL);
+
+	return ring;
+}
+
+ShmRing *shmRing_create(const char *name, uint32_t capacity)
+{
+	assert(name != NULL);
+	if (name == NULL)
+		return NULL;
+
+	capacity = (uint32_t)SHM_RING_ALIGN(capacity);
+	if (capacity < 64)
+		return NULL;
+
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd < 0)
+		return NULL;
+
+	size_t size = sizeof(ShmRingHeader) + capacity;
+	if (ftruncate(fd, size) < 0)
+	{
+		close(fd);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	ShmRing *ring = shmRing_map(name, fd, size, 1);
+	if (ring == NULL)
+	{
+		shm_unlink(name);
+		return NULL;
+	}
+
+	// ftruncate zero fills the segment, so only the fixed fields need to be set.
+	ring->header->capacity = capacity;
+	__atomic_store_n(&ring->header->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+	return ring;
+}
+
+ShmRing *shmRing_open(const char *name)
+{
+	assert(name != NULL);
+	if (name == NULL)
+		return NULL;
+
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size <= sizeof(ShmRingHeader))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	ShmRing *ring = shmRing_map(name, fd, st.st_size, 0);
+	if (ring == NULL)
+		return NULL;
+
+	if (__atomic_load_n(&ring->header->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC
+			|| sizeof(ShmRingHeader) + ring->header->capacity > ring->mappedSize)
+	{
+		shmRing_close(ring);
+		return NULL;
+	}
+
+	return ring;
+}
+
+void shmRing_shutdown(ShmRing *ring)
+{
+	assert(ring != NULL);
+	if (ring == NULL)
+		return;
+
+	ShmRingHeader *header = ring->header;
+
+	__atomic_store_n(&header->closed, 1, __ATOMIC_SEQ_CST);
+	__atomic_fetch_add(&header->headSeq, 1, __ATOMIC_SEQ_CST);
+	__atomic_fetch_add(&header->tailSeq, 1, __ATOMIC_SEQ_CST);
+	shmRing_futexWake(&header->headSeq);
+	shmRing_futexWake(&header->tailSeq);
+}
+
+void shmRing_close(ShmRing *ring)
+{
+	assert(ring != NULL);
+	if (ring == NULL)
+		return;
+
+	munmap(ring->header, ring->mappedSize);
+	if (ring->owner)
+		shm_unlink(ring->name);
+
+	pthread_mutex_destroy(&ring->writeLock);
+	free(ring->name);
+	free(ring);
+}
+
+uint32_t shmRing_getMaxLength(ShmRing *ring)
+{
+	assert(ring != NULL);
+	if (ring == NULL)
+		return 0;
+
+	// A record is never split, so it has to fit either before the end of the ring or at its start.  Where
+	// the head is when the ring empties is not known, but one of the two always has half the capacity.
+	return (uint32_t)((ring->header->capacity / 2) & ~((uint64_t)7)) - sizeof(uint32_t);
+}
+
+int shmRing_write(ShmRing *ring, const char *data, uint32_t length, int timeoutMs)
+{
+	assert(ring != NULL);
+	assert(data != NULL || length == 0);
+	if (ring == NULL)
+		return -1;
+
+	ShmRingHeader *header = ring->header;
+	uint64_t capacity = header->capacity;
+	uint64_t recordSize = SHM_RING_ALIGN(sizeof(uint32_t) + (uint64_t)length);
+	if (recordSize > capacity || length == SHM_RING_WRAP)
+		return -1;
+
+	pthread_mutex_lock(&ring->writeLock);
+
+	uint64_t head = header->head;
+	uint64_t offset;
+	uint64_t toEnd;
+
+	for (;;)
+	{
+		if (__atomic_load_n(&header->closed, __ATOMIC_SEQ_CST))
+		{
+			pthread_mutex_unlock(&ring->writeLock);
+			return -1;
+		}
+
+		uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+		offset = head % capacity;
+		toEnd = capacity - offset;
+
+		// A record is never split, so one that does not fit before the end also uses up the rest of the ring.
+		uint64_t needed = recordSize + (recordSize > toEnd ? toEnd : 0);
+		if (capacity - (head - tail) >= needed)
+			break;
+
+		if (timeoutMs <= 0)
+		{
+			pthread_mutex_unlock(&ring->writeLock);
+			return 0;
+		}
+
+		uint32_t seq = __atomic_load_n(&header->tailSeq, __ATOMIC_SEQ_CST);
+		__atomic_store_n(&header->writerWaiting, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&header->tail, __ATOMIC_SEQ_CST) == tail)
+		{
+			if (shmRing_futexWait(&header->tailSeq, seq, timeoutMs) < 0 && errno == ETIMEDOUT)
+			{
+				__atomic_store_n(&header->writerWaiting, 0, __ATOMIC_SEQ_CST);
+				pthread_mutex_unlock(&ring->writeLock);
+				return 0;
+			}
+		}
+		__atomic_store_n(&header->writerWaiting, 0, __ATOMIC_SEQ_CST);
+	}
+
+	if (recordSize > toEnd)
+	{
+		*(uint32_t *)(ring->data + offset) = SHM_RING_WRAP;
+		head += toEnd;
+		offset = 0;
+	}
+
+	if (length > 0)
+		memcpy(ring->data + offset + sizeof(uint32_t), data, length);
+	*(uint32_t *)(ring->data + offset) = length;
+
+	__atomic_store_n(&header->head, head + recordSize, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&header->headSeq, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&header->readerWaiting, __ATOMIC_SEQ_CST))
+		shmRing_futexWake(&header->headSeq);
+
+	pthread_mutex_unlock(&ring->writeLock);
+	return 1;
+}
+
+static void shmRing_advanceTail(ShmRing *ring, uint64_t tail)
+{
+	ShmRingHeader *header = ring->header;
+
+	__atomic_store_n(&header->tail, tail, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&header->tailSeq, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&header->writerWaiting, __ATOMIC_SEQ_CST))
+		shmRing_futexWake(&header->tailSeq);
+}
+
+int shmRing_read(ShmRing *ring, const char **outData, uint32_t *outLength, int timeoutMs)
+{
+	assert(ring != NULL);
+	assert(outData != NULL);
+	assert(outLength != NULL);
+	if (ring == NULL || outData == NULL || outLength == NULL)
+		return -1;
+
+	ShmRingHeader *header = ring->header;
+	uint64_t capacity = header->capacity;
+
+	// Only one record can be outstanding at a time.
+	if (ring->pendingRelease)
+		shmRing_release(ring);
+
+	for (;;)
+	{
+		uint64_t tail = header->tail;
+		uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+		if (head != tail)
+		{
+			uint64_t offset = tail % capacity;
+			uint32_t length = *(uint32_t *)(ring->data + offset);
+
+			if (length == SHM_RING_WRAP)
+			{
+				shmRing_advanceTail(ring, tail + (capacity - offset));
+				continue;
+			}
+
+			if (SHM_RING_ALIGN(sizeof(uint32_t) + (uint64_t)length) > capacity - offset)
+			{
+				// The writer would never do this, so the segment is corrupt.
+				return -1;
+			}
+
+			*outData = ring->data + offset + sizeof(uint32_t);
+			*outLength = length;
+			ring->pendingRelease = (uint32_t)SHM_RING_ALIGN(sizeof(uint32_t) + (uint64_t)length);
+			return 1;
+		}
+
+		if (__atomic_load_n(&header->closed, __ATOMIC_SEQ_CST))
+			return -1;
+
+		if (timeoutMs <= 0)
+			return 0;
+
+		uint32_t seq = __atomic_load_n(&header->headSeq, __ATOMIC_SEQ_CST);
+		__atomic_store_n(&header->readerWaiting, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&header->head, __ATOMIC_SEQ_CST) == head)
+		{
+			if (shmRing_futexWait(&header->headSeq, seq, timeoutMs) < 0 && errno == ETIMEDOUT)
+			{
+				__atomic_store_n(&header->readerWaiting, 0, __ATOMIC_SEQ_CST);
+				return 0;
+			}
+		}
+		__atomic_store_n(&header->readerWaiting, 0, __ATOMIC_SEQ_CST);
+	}
+}
+
+void shmRing_release(ShmRing *ring)
+{
+	assert(ring != NULL);
+	if (ring == NULL || ring->pendingRelease == 0)
+		return;
+
+	shmRing_advanceTail(ring, ring->header->tail + ring->pendingRelease);
+	ring->pendingRelease = 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * ShmRing.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef SHMRING_H_
+#define SHMRING_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*!
+ * Default size of the data area of a ring.
+ */
+#define SHM_RING_DEFAULT_CAPACITY (4 * 1024 * 1024)
+
+/*!
+ * A ring of variable length records in a POSIX shared memory segment, used to pass messages
+ * between two processes on the same host without a system call per message.
+ *
+ * There is one reading process and one writing process.  Threads within the writing process may
+ * write concurrently, they are serialized by a lock that is local to the process.
+ * A reader that finds the ring empty sleeps on a futex in the segment, and is woken by the next write.
+ */
+typedef struct ShmRing ShmRing;
+
+/*!
+ * Creates a new shared memory segment and initializes the ring in it.
+ *
+ * @param name
+ * 		The POSIX shared memory name, starting with '/'.
+ *
+ * @param capacity
+ * 		The number of bytes available for records.
+ *
+ * @returns
+ * 		The ring, or NULL if it could not be created.
+ */
+ShmRing *shmRing_create(const char *name, uint32_t capacity);
+
+/*!
+ * Opens a ring that was created by another process with shmRing_create.
+ *
+ * @returns
+ * 		The ring, or NULL if it does not exist or is not a valid ring.
+ */
+ShmRing *shmRing_open(const char *name);
+
+/*!
+ * Marks the ring as closed and wakes up both sides.  Any further reads or writes fail.
+ */
+void shmRing_shutdown(ShmRing *ring);
+
+/*!
+ * Unmaps the ring.  The process that created the ring also removes the shared memory segment.
+ */
+void shmRing_close(ShmRing *ring);
+
+/*!
+ * @returns
+ * 		The length of the largest record that is sure to fit in the ring once the reader has caught up, which is
+ * 		a little under half of its capacity.  A larger message has to be sent some other way.
+ */
+uint32_t shmRing_getMaxLength(ShmRing *ring);
+
+/*!
+ * Writes one record to the ring, waiting for space if the reader is behind.
+ *
+ * @param timeoutMs
+ * 		The time to wait for space, or 0 to not wait.
+ *
+ * @returns
+ * 		1 if the record was written, 0 if there was no space in time, or -1 if the ring is closed or the record
+ * 		is longer than shmRing_getMaxLength.
+ */
+int shmRing_write(ShmRing *ring, const char *data, uint32_t length, int timeoutMs);
+
+/*!
+ * Reads the next record from the ring, waiting for one if the ring is empty.
+ * The data points into the shared memory, and stays valid until shmRing_release is called.
+ *
+ * @param timeoutMs
+ * 		The time to wait for a record, or 0 to not wait.
+ *
+ * @returns
+ * 		1 if a record was read, 0 if there was no record in time, or -1 if the ring is closed.
+ */
+int shmRing_read(ShmRing *ring, const char **outData, uint32_t *outLength, int timeoutMs);
+
+/*!
+ * Releases the record returned by the last shmRing_read, giving its space back to the writer.
+ */
+void shmRing_release(ShmRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHMRING_H_ */
@@ -0,0 +1,166 @@
+/*
+ * ConfigCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef __CYGWIN__
+#include <sys/prctl.h>
+#endif
+#include "ConfigCache.h"
+#include "Plugin.h"
+#include "logger.h"
+
+using namespace std;
+
+ConfigCache *ConfigCache::instance = NULL;
+std::atomic<unsigned int> ConfigCache::PollIntervalMs(CONFIG_CACHE_POLL_MS);
+
+// Returns the cache, creating it and starting its thread on the first call.
+ConfigCache *ConfigCache::getInstance()
+{
+	static pthread_mutex_t instanceLock = PTHREAD_MUTEX_INITIALIZER;
+
+	pthread_mutex_lock(&instanceLock);
+	if (instance == NULL)
+		instance = new ConfigCache(&ConfigCache::openDatabase);
+	pthread_mutex_unlock(&instanceLock);
+
+	return instance;
+}
+
+ConfigCache::ConfigCache(SourceFactory openSource) : mReloadCount(0), mRunning(true), mOpenSource(openSource),
+	mChecksum(0), mLoaded(false)
+{
+	pthread_mutex_init(&this->mPluginLock, NULL);
+
+	this->mMonitorThread = boost::thread(&ConfigCache::monitorThreadEntry, this);
+}
+
+ConfigCache::~ConfigCache()
+{
+	this->mRunning = false;
+	this->invalidate();
+	this->mMonitorThread.join();
+
+	pthread_mutex_destroy(&this->mPluginLock);
+}
+
+PluginConfigSource *ConfigCache::openDatabase()
+{
+	return new ConfigContext();
+}
+
+void ConfigCache::addPlugin(Plugin *plugin, unsigned int pluginId)
+{
+	pthread_mutex_lock(&this->mPluginLock);
+	this->mPlugins[plugin] = pluginId;
+	pthread_mutex_unlock(&this->mPluginLock);
+
+	// Registration writes the plugin's parameters, so check for anything that changed in the meantime.
+	this->invalidate();
+}
+
+void ConfigCache::removePlugin(Plugin *plugin)
+{
+	pthread_mutex_lock(&this->mPluginLock);
+	this->mPlugins.erase(plugin);
+	pthread_mutex_unlock(&this->mPluginLock);
+}
+
+void ConfigCache::invalidate()
+{
+	this->mEventInvalidated.Set();
+}
+
+uint64_t ConfigCache::getReloadCount()
+{
+	return this->mReloadCount;
+}
+
+void ConfigCache::monitorThreadEntry()
+{
+#ifndef __CYGWIN__
+	prctl(PR_SET_NAME, "ConfigCache", 0, 0, 0);
+#endif
+
+	while (this->mRunning)
+	{
+		unsigned int waitMs = PollIntervalMs;
+
+		try
+		{
+			if (this->reloadIfChanged())
+			{
+				pthread_mutex_lock(&this->mPluginLock);
+				for (map<Plugin *, unsigned int>::iterator itr = this->mPlugins.begin(); itr != this->mPlugins.end(); itr++)
+				{
+					try
+					{
+						this->pushToPlugin(itr->first, itr->second);
+					}
+					catch (std::exception &e)
+					{
+						LOG_ERROR("<Config Cache> Unable to update the configuration of plugin " << itr->second << " [" << e.what() << "]");
+					}
+				}
+				pthread_mutex_unlock(&this->mPluginLock);
+			}
+		}
+		catch (DbException &e)
+		{
+			LOG_ERROR("<Config Cache> MySQL: Unable to get configuration information [" << e.what() << "]");
+
+			// The connection may have been lost, so have the pool check it before it is used again.
+			if (this->mContext)
+				this->mContext->reportFailure();
+			this->mContext.reset();
+			waitMs = CONFIG_CACHE_RETRY_MS;
+		}
+
+		this->mEventInvalidated.WaitOne(waitMs);
+	}
+
+	// The connection goes back to the pool from the thread that acquired it.
+	this->mContext.reset();
+}
+
+// Reads all of the parameters if the table has changed since they were last read.
+// Returns true if they were read.
+bool ConfigCache::reloadIfChanged()
+{
+	if (!this->mContext)
+		this->mContext.reset(this->mOpenSource());
+
+	uint64_t checksum = this->mContext->getPluginConfigChecksum();
+	if (this->mLoaded && checksum == this->mChecksum)
+		return false;
+
+	this->mValues = this->mContext->getAllPluginConfigParameters();
+	this->mChecksum = checksum;
+	this->mLoaded = true;
+	this->mReloadCount++;
+
+	return true;
+}
+
+// Hands the plugin its parameters, which are the global parameters along with its own.
+// Called with mPluginLock held.
+void ConfigCache::pushToPlugin(Plugin *plugin, unsigned int pluginId)
+{
+	map<string, PluginConfigurationParameterEntry> configMap;
+
+	map<unsigned int, map<string, PluginConfigurationParameterEntry> >::iterator values = this->mValues.find(0);
+	if (values != this->mValues.end())
+		configMap = values->second;
+
+	values = this->mValues.find(pluginId);
+	if (values != this->mValues.end())
+	{
+		for (map<string, PluginConfigurationParameterEntry>::iterator itr = values->second.begin(); itr != values->second.end(); itr++)
+			configMap[itr->first] = itr->second;
+	}
+
+	plugin->updateConfigValues(configMap);
+}
@@ -0,0 +1,119 @@
+/*
+ * ConfigCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef CONFIGCACHE_H_
+#define CONFIGCACHE_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <pthread.h>
+#include "boost/thread.hpp"
+#include "database/ConfigContext.h"
+#include "utils/AutoResetEvent.h"
+
+// How often the configuration table is checked for changes made outside of the core, unless set by the
+// CONFIG_CACHE_POLL_MS system parameter.
+#define CONFIG_CACHE_POLL_MS 1000
+// How long to wait before reconnecting after a database error.
+#define CONFIG_CACHE_RETRY_MS 2000
+
+class Plugin;
+
+/**
+ * \ingroup IVPCore
+ *
+ * A core wide copy of the plugin configuration parameters, which pushes changes to the registered plugins.
+ *
+ * -A single thread keeps one database connection open for the life of the core, however many plugins are connected.
+ * -Every PollIntervalMs, the thread compares the checksum of the configuration table.  The parameters are only
+ *  read when it has changed, so changes made by the admin pages or tmxctl reach the plugins within one interval.
+ *  CHECKSUM TABLE reads the whole table, so the interval is kept long.
+ * -Writes that go through the core call invalidate(), which checks the table right away, so those changes reach
+ *  the plugins within 100 ms.  Changes made directly in the database are only seen at the next check.
+ * -Each plugin is handed the global parameters along with its own, on the cache thread.
+ */
+class ConfigCache
+{
+public:
+	/*!
+	 * Opens the source the parameters are read from.  Called on the cache thread, again after each DbException.
+	 */
+	typedef std::function<PluginConfigSource *()> SourceFactory;
+
+	static ConfigCache *getInstance();
+
+	/*!
+	 * Creates a cache that reads the parameters from the sources it opens, rather than the database.  The core
+	 * uses the instance from getInstance().
+	 */
+	explicit ConfigCache(SourceFactory openSource);
+
+	/*!
+	 * Stops the cache thread, after any change being handed to a plugin has completed.
+	 */
+	~ConfigCache();
+
+	/*!
+	 * How often, in milliseconds, the configuration table is checked for changes made outside of the core.
+	 */
+	static std::atomic<unsigned int> PollIntervalMs;
+
+	/*!
+	 * Start pushing configuration changes to the plugin.
+	 */
+	void addPlugin(Plugin *plugin, unsigned int pluginId);
+
+	/*!
+	 * Stop pushing configuration changes to the plugin.  Waits for any change being handed to the plugin to complete.
+	 */
+	void removePlugin(Plugin *plugin);
+
+	/*!
+	 * Check the configuration table for changes now, instead of waiting for the next interval.
+	 */
+	void invalidate();
+
+	/*!
+	 * @return The number of times the parameters have been read from the database.
+	 */
+	uint64_t getReloadCount();
+
+private:
+	ConfigCache(const ConfigCache&);
+	ConfigCache& operator=(const ConfigCache&); // non-copyable
+
+	void monitorThreadEntry();
+	bool reloadIfChanged();
+	void pushToPlugin(Plugin *plugin, unsigned int pluginId);
+	static PluginConfigSource *openDatabase();
+
+	static ConfigCache *instance;
+
+	/*!
+	 * Guards mPlugins, and is held while changes are handed to the plugins.
+	 */
+	pthread_mutex_t mPluginLock;
+	std::map<Plugin *, unsigned int> mPlugins;
+
+	AutoResetEvent mEventInvalidated;
+	std::atomic<uint64_t> mReloadCount;
+	std::atomic<bool> mRunning;
+
+	// Only used by the cache thread
+	SourceFactory mOpenSource;
+	std::unique_ptr<PluginConfigSource> mContext;
+	uint64_t mChecksum;
+	bool mLoaded;
+	std::map<unsigned int, std::map<std::string, PluginConfigurationParameterEntry> > mValues;
+
+	boost::thread mMonitorThread;
+};
+
+#endif /* CONFIGCACHE_H_ */
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <string.h>
 #include <time.h>
+#include <unordered_map>
 #include "version.h"
 #include "logger.h"
 #include "database/PluginContext.h"
@@ -26,7 +27,7 @@
 
 using namespace std;
 
-MessageProfiler::MessageProfiler(MessageRouter *messageRouter) : Plugin(messageRouter)
+MessageProfiler::MessageProfiler(MessageRouter *messageRouter) : Plugin(messageRouter), mShardCount(0), mThreadCount(0)
 {
 	RegistrationInformation info;
 	info.pluginInfo.name = "ivpcore.MessageProfiler";
@@ -34,7 +35,7 @@ MessageProfiler::MessageProfiler(MessageRouter *messageRouter) : Plugin(messageR
 	info.pluginInfo.version = IVPCORE_VERSION;
 
 	info.configDefaultEntries.push_back(PluginConfigurationParameterEntry(MSGPROFILER_CONFIGKEY_DB_RFRSH_INTERVAL, "2000", "The interval (in milliseconds) between uploads of message statistics to the database."));
-	info.configDefaultEntries.push_back(PluginConfigurationParameterEntry(MSGPROFILER_CONFIGKEY_AVERAGINGWINDOW, "20000", "The averaging window (in milliseconds) that the profiler measures average interval."));
+	info.configDefaultEntries.push_back(PluginConfigurationParameterEntry(MSGPROFILER_CONFIGKEY_AVERAGINGWINDOW, "20000", "The averaging window (in milliseconds) that the profiler measures average interval, up to 32000."));
 
 	try
 	{
@@ -70,9 +71,20 @@ MessageProfiler::MessageProfiler(MessageRouter *messageRouter) : Plugin(messageR
 	this->mDbRefreshThread = boost::thread(&MessageProfiler::dbRefreshThreadEntry, this);
 }
 
-MessageProfiler::~MessageProfiler()
+MessageProfiler::MessageProfiler(MessageRouter *messageRouter, const std::set<MessageTypeEntry> &messageTypes) :
+	Plugin(messageRouter), mMessageTypes(messageTypes), mShardCount(0), mThreadCount(0)
 {
+	pthread_mutex_init(&this->mLock, NULL);
+}
 
+MessageProfiler::~MessageProfiler()
+{
+	// The refresh thread reads the shards, so it must be done before they are released.
+	if (mDbRefreshThread.joinable())
+	{
+		mDbRefreshThread.interrupt();
+		mDbRefreshThread.join();
+	}
 }
 
 void MessageProfiler::onConfigChanged(std::string key, std::string value)
@@ -100,6 +112,75 @@ void MessageProfiler::onMessageReceived(IvpMessage *msg)
 
 	uint64_t rxTime = TimeUtils::getSystemMillis();
 
+	unsigned int messageTypeId = this->getMessageTypeId(msg->type, msg->subtype != NULL ? msg->subtype : "");
+	if (messageTypeId == 0)
+	{
+		LOG_ERROR("Message type id is zero.  Something when wrong.");
+		return;
+	}
+
+	// Form a key from the source plugin id and the message type.
+	this->recordMessage(this->getShard(), ((uint64_t)msg->sourceId << 32) | messageTypeId, rxTime);
+}
+
+// Returns the shard the calling thread records its statistics in, creating one the first time the thread
+// calls it.  Once MSGPROFILER_MAX_SHARDS shards exist, new threads share the existing shards.
+MessageProfiler::ProfileShard *MessageProfiler::getShard()
+{
+	static thread_local MessageProfiler *owner = NULL;
+	static thread_local ProfileShard *shard = NULL;
+
+	if (owner != this)
+	{
+		pthread_mutex_lock(&this->mLock);
+
+		unsigned int index = this->mThreadCount++;
+		if (index < MSGPROFILER_MAX_SHARDS)
+		{
+			this->mShards[index].reset(new ProfileShard());
+			this->mShardCount.store(index + 1, std::memory_order_release);
+		}
+		shard = this->mShards[index % MSGPROFILER_MAX_SHARDS].get();
+
+		pthread_mutex_unlock(&this->mLock);
+
+		owner = this;
+	}
+
+	return shard;
+}
+
+// Returns the database id for the message type.  Each thread caches the ids it has already looked up,
+// so the set of known message types and the database are only consulted for the first message of a type.
+unsigned int MessageProfiler::getMessageTypeId(const char *type, const char *subtype)
+{
+	struct CachedMessageType {
+		std::string type;
+		std::string subtype;
+		unsigned int id;
+	};
+
+	static thread_local MessageProfiler *owner = NULL;
+	static thread_local std::unordered_map<uint64_t, CachedMessageType> cache;
+
+	if (owner != this)
+	{
+		cache.clear();
+		owner = this;
+	}
+
+	// FNV-1a hash of the type and subtype.
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char *c = type; *c; c++)
+		hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+	hash = (hash ^ '|') * 1099511628211ULL;
+	for (const char *c = subtype; *c; c++)
+		hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+
+	std::unordered_map<uint64_t, CachedMessageType>::iterator cached = cache.find(hash);
+	if (cached != cache.end() && cached->second.type == type && cached->second.subtype == subtype)
+		return cached->second.id;
+
 	pthread_mutex_lock(&this->mLock);
 
 	// Determine if this message type is already in the mMessageTypes set.  If not, then add it.
@@ -107,7 +188,7 @@ void MessageProfiler::onMessageReceived(IvpMessage *msg)
 	// Since it only writes to the database when a new message type is encountered, it will not
 	// cause latency for subsequent messages of the same type.
 
-	MessageTypeEntry messageType(string(msg->type), string(msg->subtype != NULL ? msg->subtype : ""));
+	MessageTypeEntry messageType(type, subtype);
 	set<MessageTypeEntry>::iterator localMsgType = this->mMessageTypes.find(messageType);
 
 	if (localMsgType == this->mMessageTypes.end())
@@ -130,35 +211,57 @@ void MessageProfiler::onMessageReceived(IvpMessage *msg)
 		messageType = *localMsgType;
 	}
 
-	assert(messageType.id != 0);
-	if (messageType.id == 0)
-		LOG_ERROR("Message type id is zero.  Something when wrong.");
+	pthread_mutex_unlock(&this->mLock);
 
-	// Form a key from the source plugin id and the message type.
-	// Doing it this way instead of using [] operator because it should be much faster.
-	PluginIdMessageTypeKey pluginIdMsgType(msg->sourceId, messageType);
+	// A hash collision leaves the earlier entry in place, and the later type always takes this path.
+	if (messageType.id != 0 && cached == cache.end())
+		cache[hash] = CachedMessageType { messageType.type, messageType.subtype, messageType.id };
 
-	// Add the data from this message to the corresponding ProfileData entry in the mProfileData map.
-	map<PluginIdMessageTypeKey, ProfileData>::iterator entry = this->mProfileData.find(pluginIdMsgType);
-	if (entry != this->mProfileData.end())
-	{
-		entry->second.lastReceivedTime = rxTime;
-		entry->second.messageCounts++;
-		entry->second.receiveTimeForAveraging.push_back(rxTime);
-	}
-	else
+	return messageType.id;
+}
+
+// Adds the message to the statistics for its key in the shard.  The slot for a key is found by open addressing,
+// and claimed with a compare and swap the first time the key is seen.  The counters are only ever updated
+// atomically, so shards can be shared between threads and read by the refresh thread without a lock.
+void MessageProfiler::recordMessage(ProfileShard *shard, uint64_t key, uint64_t rxTime)
+{
+	unsigned int start = (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32) % MSGPROFILER_SHARD_SLOTS;
+
+	for (unsigned int i = 0; i < MSGPROFILER_SHARD_SLOTS; i++)
 	{
-		// This is a new entry, add it to the map.
-		ProfileData profileData;
-		profileData.lastReceivedTime = rxTime;
-		profileData.messageCounts = 1;
-		profileData.receiveTimeForAveraging.push_back(rxTime);
-		this->mProfileData[pluginIdMsgType] = profileData;
-	}
+		ProfileSlot &slot = shard->slots[(start + i) % MSGPROFILER_SHARD_SLOTS];
 
-	//cout << this->mProfileData.size() << endl;
+		uint64_t slotKey = slot.key.load(std::memory_order_acquire);
+		if (slotKey == 0 && !slot.key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel))
+		{
+			// Another thread sharing this shard claimed the slot first.
+			if (slotKey != key)
+				continue;
+		}
+		else if (slotKey != 0 && slotKey != key)
+		{
+			continue;
+		}
 
-	pthread_mutex_unlock(&this->mLock);
+		slot.messageCounts.fetch_add(1, std::memory_order_relaxed);
+		slot.lastReceivedTime.store(rxTime, std::memory_order_relaxed);
+
+		// Count the message in the bucket for the current interval, resetting the bucket if it was last used
+		// for an earlier pass around the ring.
+		uint64_t interval = rxTime / MSGPROFILER_RATE_BUCKET_MS;
+		std::atomic<uint64_t> &bucket = slot.receiveBuckets[interval % MSGPROFILER_RATE_BUCKETS];
+		uint64_t value = bucket.load(std::memory_order_relaxed);
+		uint64_t updated;
+		do
+		{
+			updated = (value >> 24) == interval ? value + 1 : (interval << 24) | 1;
+		} while (!bucket.compare_exchange_weak(value, updated, std::memory_order_relaxed));
+
+		return;
+	}
+
+	if (!shard->overflowReported.exchange(true))
+		LOG_WARN("Message profiler shard is full.  Some message statistics will not be recorded.");
 }
 
 void MessageProfiler::dbRefreshThreadEntry()
@@ -167,7 +270,7 @@ void MessageProfiler::dbRefreshThreadEntry()
 	prctl(PR_SET_NAME, "MsgProfiler", 0, 0, 0);
 #endif
 
-	vector<MessageActivityEntry> activityEntries;
+	map<uint64_t, MessageActivityEntry> activityEntries;
 
 	boost::this_thread::disable_interruption di;
 
@@ -183,9 +286,13 @@ void MessageProfiler::dbRefreshThreadEntry()
 				char *tailptr;
 				sleepTime = strtoimax(this->getConfigValue(MSGPROFILER_CONFIGKEY_DB_RFRSH_INTERVAL).c_str(), &tailptr, 10);
 
-			} while(TimeUtils::getSystemMillis() < startTime + (sleepTime == 0 ? 3000 : sleepTime));
+			} while(TimeUtils::getSystemMillis() < startTime + (sleepTime == 0 ? 3000 : sleepTime) &&
+					!boost::this_thread::interruption_requested());
 		}
 
+		if (boost::this_thread::interruption_requested())
+			break;
+
 		// Get the purge window configuration value.
 		char *tailptr;
 		unsigned int purgeWindow = strtoul(this->getConfigValue(MSGPROFILER_CONFIGKEY_AVERAGINGWINDOW).c_str(), &tailptr, 10);
@@ -194,55 +301,77 @@ void MessageProfiler::dbRefreshThreadEntry()
 
 		uint64_t currentTime = TimeUtils::getSystemMillis();
 
+		// The averaging window is measured in whole buckets, up to the length of the ring.
+		uint64_t windowBuckets = (purgeWindow + MSGPROFILER_RATE_BUCKET_MS - 1) / MSGPROFILER_RATE_BUCKET_MS;
+		if (windowBuckets > MSGPROFILER_RATE_BUCKETS)
+		{
+			windowBuckets = MSGPROFILER_RATE_BUCKETS;
+			purgeWindow = MSGPROFILER_RATE_BUCKETS * MSGPROFILER_RATE_BUCKET_MS;
+		}
+		uint64_t currentInterval = currentTime / MSGPROFILER_RATE_BUCKET_MS;
+
 		// Clear any old activty entries from last time.
 		activityEntries.clear();
+		map<uint64_t, uint64_t> windowCounts;
 
-		pthread_mutex_lock(&this->mLock);
-
-		// Iterate over all ProfileData (one per plugin id / message type) and store the message activity in the activityEntries array.
-		for (map<PluginIdMessageTypeKey, ProfileData>::iterator itr = this->mProfileData.begin(); itr != this->mProfileData.end(); itr++)
+		// Add up the statistics for each plugin id / message type across all the shards.
+		// The counters are atomic, so this does not hold up the threads routing messages.
+		unsigned int shardCount = this->mShardCount.load(std::memory_order_acquire);
+		for (unsigned int i = 0; i < shardCount; i++)
 		{
-			// Iterate over the array of receive times.
-			// Purge any data that is outside the time window used for calculating the average.
-			for (std::vector<uint64_t>::iterator rxTimeItr = itr->second.receiveTimeForAveraging.begin(); rxTimeItr != itr->second.receiveTimeForAveraging.end(); )
+			ProfileShard *shard = this->mShards[i].get();
+
+			for (int j = 0; j < MSGPROFILER_SHARD_SLOTS; j++)
 			{
-				if (purgeWindow + *rxTimeItr < currentTime)
-					rxTimeItr = itr->second.receiveTimeForAveraging.erase(rxTimeItr);
-				else
-					rxTimeItr++;
+				ProfileSlot &slot = shard->slots[j];
+
+				uint64_t key = slot.key.load(std::memory_order_acquire);
+				uint64_t count = slot.messageCounts.load(std::memory_order_relaxed);
+				if (key == 0 || count == 0)
+					continue;
+
+				MessageActivityEntry &entry = activityEntries[key];
+				entry.pluginId = (unsigned int)(key >> 32);
+				entry.messageTypeId = (unsigned int)(key & 0xFFFFFFFF);
+				entry.count += count;
+
+				time_t lastReceived = slot.lastReceivedTime.load(std::memory_order_relaxed) / 1000;
+				if (lastReceived > entry.lastReceivedTimestamp)
+					entry.lastReceivedTimestamp = lastReceived;
+
+				// Only the buckets whose interval falls within the averaging window count toward the rate.
+				uint64_t &windowCount = windowCounts[key];
+				for (int k = 0; k < MSGPROFILER_RATE_BUCKETS; k++)
+				{
+					uint64_t value = slot.receiveBuckets[k].load(std::memory_order_relaxed);
+					uint64_t interval = value >> 24;
+					if (interval <= currentInterval && interval + windowBuckets > currentInterval)
+						windowCount += value & 0xFFFFFF;
+				}
 			}
+		}
 
-			assert(itr->first.messageType.id != 0);
-			assert(itr->first.pluginId != 0);
+		for (map<uint64_t, MessageActivityEntry>::iterator itr = activityEntries.begin(); itr != activityEntries.end(); itr++)
+		{
+			assert(itr->second.messageTypeId != 0);
+			assert(itr->second.pluginId != 0);
 
-			MessageActivityEntry entry;
-			entry.messageTypeId = itr->first.messageType.id;
-			entry.pluginId = itr->first.pluginId;
-			entry.count = itr->second.messageCounts;
-			entry.lastReceivedTimestamp = itr->second.lastReceivedTime / 1000;
-			if (itr->second.receiveTimeForAveraging.size() == 0)
-				entry.averageInterval = 0;
+			uint64_t windowCount = windowCounts[itr->first];
+			if (windowCount == 0)
+				itr->second.averageInterval = 0;
 			else
-				entry.averageInterval = (uint64_t)((double)purgeWindow / itr->second.receiveTimeForAveraging.size());
-
-			// The activity is stored in an array for now.
-			// This allows the mutex to be unlocked while the database is updated.
-			// Otherwise the onMessageReceived method must wait for the database writes to complete,
-			// which introduces latency into the message routing functionality of the system.
-			activityEntries.push_back(entry);
+				itr->second.averageInterval = (uint64_t)((double)purgeWindow / windowCount);
 		}
 
-		pthread_mutex_unlock(&this->mLock);
-
 		// Update the database.
 
 		MessageContext context;
 
-		for (std::vector<MessageActivityEntry>::iterator entryItr = activityEntries.begin(); entryItr != activityEntries.end(); entryItr++)
+		for (map<uint64_t, MessageActivityEntry>::iterator entryItr = activityEntries.begin(); entryItr != activityEntries.end(); entryItr++)
 		{
 			try
 			{
-				context.insertOrUpdateMessageActivity(*entryItr);
+				context.insertOrUpdateMessageActivity(entryItr->second);
 			}
 			catch (const DbException &e)
 			{
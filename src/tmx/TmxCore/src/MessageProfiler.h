@@ -9,14 +9,30 @@
 #define MESSAGEPROFILER_H_
 
 #include "Plugin.h"
+#include <atomic>
 #include <map>
-#include <sstream>
+#include <memory>
+#include <string>
 #include <boost/thread.hpp>
 #include <time.h>
 #include "database/MessageContext.h"
 
+/// The most distinct plugin id / message type pairs that one shard can track.
+#define MSGPROFILER_SHARD_SLOTS 128
+/// The most shards.  Additional threads share the existing shards.
+#define MSGPROFILER_MAX_SHARDS 32
+/// The width of one rate bucket.
+#define MSGPROFILER_RATE_BUCKET_MS 500
+/// The number of rate buckets, which limits the averaging window to 32 seconds.
+#define MSGPROFILER_RATE_BUCKETS 64
+
 /**
  * A plugin that receives all the messages sent in the IVP System and keeps statistics for messasges sent by each plugin.
+ *
+ * The statistics are kept in shards, one per receiving thread, so that the threads routing messages do not contend
+ * with each other or with the database refresh thread.  Each shard is a fixed size table of atomic counters keyed on
+ * the plugin id and message type id, and the receive rate is estimated from a ring of per interval counts, so no
+ * locks are taken and nothing is allocated once a thread has seen a given plugin and message type.
  * \ingroup IVPCore
  */
 class MessageProfiler : public Plugin
@@ -28,48 +44,46 @@ public:
 	virtual void onConfigChanged(std::string key, std::string value);
 	virtual void onMessageReceived(IvpMessage *msg);
 
-private:
-	struct PluginIdMessageTypeKey {
-		unsigned int pluginId;
-		MessageTypeEntry messageType;
-
-		PluginIdMessageTypeKey(unsigned int pluginId, MessageTypeEntry messageTypeId)
-		{
-			this->pluginId = pluginId;
-			this->messageType = messageTypeId;
-		}
+protected:
+	/*!
+	 * Creates a profiler that is not registered, and only knows the given message types, so it does not use the
+	 * database.  The statistics are kept but never written.  Used by the unit tests.
+	 */
+	MessageProfiler(MessageRouter *messageRouter, const std::set<MessageTypeEntry> &messageTypes);
 
-		bool operator== (const PluginIdMessageTypeKey &cmp) const
-		{
-			return this->pluginId == cmp.pluginId && this->messageType == cmp.messageType;
-		}
+private:
+	struct ProfileSlot {
+		/// (plugin id << 32) | message type id, or 0 if the slot is unused
+		std::atomic<uint64_t> key;
+		std::atomic<uint64_t> messageCounts;
+		std::atomic<uint64_t> lastReceivedTime;
+		/// The number of messages received in each interval, as (interval number << 24) | count
+		std::atomic<uint64_t> receiveBuckets[MSGPROFILER_RATE_BUCKETS];
 
-		bool operator< (const PluginIdMessageTypeKey &cmp) const
+		ProfileSlot() : key(0), messageCounts(0), lastReceivedTime(0)
 		{
-			std::stringstream ss1, ss2;
-			ss1 << this->pluginId << "||" << this->messageType.type << "||" << this->messageType.subtype;
-			ss2 << cmp.pluginId << "||" << cmp.messageType.type << "||" << cmp.messageType.subtype;
-			return ss1.str() < ss2.str();
+			for (int i = 0; i < MSGPROFILER_RATE_BUCKETS; i++)
+				receiveBuckets[i] = 0;
 		}
 	};
 
-	struct ProfileData {
-		unsigned int messageCounts;
-		uint64_t lastReceivedTime;
-		std::vector<uint64_t> receiveTimeForAveraging;
+	struct ProfileShard {
+		ProfileSlot slots[MSGPROFILER_SHARD_SLOTS];
+		std::atomic<bool> overflowReported;
 
-		ProfileData()
-		{
-			messageCounts = 0;
-			lastReceivedTime = 0;
-		}
+		ProfileShard() : overflowReported(false) {}
 	};
 
 	std::set<MessageTypeEntry> mMessageTypes;
-	std::map<PluginIdMessageTypeKey, ProfileData> mProfileData;
 	pthread_mutex_t mLock;
+	std::unique_ptr<ProfileShard> mShards[MSGPROFILER_MAX_SHARDS];
+	std::atomic<unsigned int> mShardCount;
+	unsigned int mThreadCount;
 	boost::thread mDbRefreshThread;
 
+	ProfileShard *getShard();
+	unsigned int getMessageTypeId(const char *type, const char *subtype);
+	void recordMessage(ProfileShard *shard, uint64_t key, uint64_t rxTime);
 	void dbRefreshThreadEntry();
 };
 
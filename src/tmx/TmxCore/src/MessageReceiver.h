@@ -10,6 +10,7 @@
 
 #include <stdlib.h>
 #include "tmx/IvpMessage.h"
+#include "utils/EncodedMessage.h"
 
 /*!
  * An interface for receiving messages.
@@ -23,6 +24,12 @@ public:
 	 */
 	virtual void receiveMessage(IvpMessage *msg) = 0;
 
+	/*!
+	 * Called by the router instead of receiveMessage(msg), so receivers that write the message out can reuse
+	 * the frames already encoded for the other receivers of the broadcast.
+	 */
+	virtual void receiveMessage(IvpMessage *msg, EncodedMessage &encoded) { receiveMessage(msg); }
+
 	std::string pluginName;
 };
 
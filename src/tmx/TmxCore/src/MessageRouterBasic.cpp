@@ -8,21 +8,23 @@
 #include "MessageRouterBasic.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <chrono>
 #include <iostream>
 #include "logger.h"
 #include "utils/PerformanceTimer.h"
 
 using namespace std;
 
+std::atomic<unsigned int> MessageRouterBasic::UnregisterWarnMs(MESSAGE_ROUTER_UNREGISTER_WARN_MS);
+
 MessageRouterBasic::MessageRouterBasic()
 {
 	pthread_mutexattr_t lockAttr;
 	pthread_mutexattr_init(&lockAttr);
 	pthread_mutexattr_settype(&lockAttr, PTHREAD_MUTEX_RECURSIVE);
-	pthread_mutex_init(&this->mMapLock, &lockAttr);
-	pthread_mutex_init(&this->mActiveBroadcastsLock, &lockAttr);
+	pthread_mutex_init(&this->mWriterLock, &lockAttr);
 
-	mActiveBroadcasts = 0;
+	mSnapshot = std::make_shared<const DispatchSnapshot>();
 	/*
 	 * Nothing to do.  Just has to wait for clients to register.
 	 */
@@ -50,68 +52,30 @@ void MessageRouterBasic::broadcastMessage(MessageReceiver *sender, IvpMessage *m
 
 	//PerformanceTimer timer;
 
-	pthread_mutex_lock(&this->mMapLock);
-	pthread_mutex_lock(&this->mActiveBroadcastsLock);
-	this->mActiveBroadcasts++;
-	pthread_mutex_unlock(&this->mActiveBroadcastsLock);
-	pthread_mutex_unlock(&this->mMapLock);
+	// Hold a reference to the snapshot for the duration of the broadcast.  An unregistered receiver
+	// is not released until all broadcasts using this or any older snapshot have completed.
+	std::shared_ptr<const DispatchSnapshot> snapshot = std::atomic_load(&this->mSnapshot);
 
 	int broadcastCount = 0;
 
-	for(std::map<MessageReceiver *, std::vector<MessageFilterEntry> >::iterator mapIter = this->mReceiverMessageFilterEntryMap.begin(); mapIter != this->mReceiverMessageFilterEntryMap.end(); mapIter++)
+	// Encoded at most once per format, however many plugin connections receive it.
+	EncodedMessage encoded(msg);
+
+	const DispatchList &recipients = snapshot->lookupRecipients(msg->type, msg->subtype);
+
+	for (DispatchList::const_iterator iter = recipients.begin(); iter != recipients.end(); iter++)
 	{
 		// Do not send to self.
-		if (sender == mapIter->first)
+		if (sender == iter->receiver)
 			continue;
 
-		for(std::vector<MessageFilterEntry>::iterator filterIter = mapIter->second.begin(); filterIter != mapIter->second.end(); filterIter++)
+		if (!iter->flagmask || (iter->flagmask & msg->flags) > 0)
 		{
-			//std::string pluginName = mapIter->first->pluginName.empty() ? "unknown plugin" : mapIter->first->pluginName;
-
-			if (filterIter->type.compare("*") == 0)
-			{
-				if (!filterIter->flagmask || (filterIter->flagmask & msg->flags) > 0)
-				{
-
-					//if (timer.Elapsed_Ms() > 0.2)
-					//	cout << "MessageRouterBasic::broadcastMessage, " << pluginName << ", 1: " << timer.Elapsed_Ms() << " ms" << endl;
-
-					mapIter->first->receiveMessage(msg);
-
-					//if (timer.Elapsed_Ms() > 0.2)
-					//	cout << "MessageRouterBasic::broadcastMessage, " << pluginName << ", 2: " << timer.Elapsed_Ms() << " ms" << endl;
-
-					broadcastCount++;
-					break;
-				}
-			}
-			else if(msg->type != NULL && filterIter->type.compare(msg->type) == 0)
-			{
-				if (filterIter->subtype.compare("*") == 0
-						|| (msg->subtype != NULL && filterIter->subtype.compare(msg->subtype) == 0))
-				{
-					if (!filterIter->flagmask || (filterIter->flagmask & msg->flags) > 0)
-					{
-						//if (timer.Elapsed_Ms() > 0.2)
-						//	cout << "MessageRouterBasic::broadcastMessage, " << pluginName << ", 3: " << timer.Elapsed_Ms() << " ms" << endl;
-
-						mapIter->first->receiveMessage(msg);
-
-						//if (timer.Elapsed_Ms() > 0.2)
-						//	cout << "MessageRouterBasic::broadcastMessage, " << pluginName << ", 4: " << timer.Elapsed_Ms() << " ms" << endl;
-
-						broadcastCount++;
-						break;
-					}
-				}
-			}
+			iter->receiver->receiveMessage(msg, encoded);
+			broadcastCount++;
 		}
 	}
 
-	pthread_mutex_lock(&this->mActiveBroadcastsLock);
-	this->mActiveBroadcasts--;
-	pthread_mutex_unlock(&this->mActiveBroadcastsLock);
-
 	//LOG_DEBUG("MessageRouterBasic::broadcastMessage for " << msg->subtype << " from "<< sender->pluginName << " Time (ms) "<<timer_ms);
 
 	//char *jsonmsg = ivpMsg_createJsonString(msg, IvpMsg_FormatOptions_none);
@@ -124,22 +88,148 @@ void MessageRouterBasic::registerReceiver(MessageReceiver *receiver, const std::
 {
 	assert(receiver != NULL);
 
-	pthread_mutex_lock(&this->mMapLock);
-	while(this->mActiveBroadcasts > 0) { sleep(0); }
+	pthread_mutex_lock(&this->mWriterLock);
+
+	std::shared_ptr<DispatchSnapshot> snapshot = std::make_shared<DispatchSnapshot>();
+	snapshot->receiverFilters = std::atomic_load(&this->mSnapshot)->receiverFilters;
+	snapshot->receiverFilters[receiver] = filters;
+	snapshot->buildIndex();
 
-	mReceiverMessageFilterEntryMap[receiver] = filters;
+	publishSnapshot(snapshot);
 
-	pthread_mutex_unlock(&this->mMapLock);
+	pthread_mutex_unlock(&this->mWriterLock);
 }
 
 void MessageRouterBasic::unregisterReceiver(MessageReceiver *receiver)
 {
 	assert(receiver != NULL);
 
-	pthread_mutex_lock(&this->mMapLock);
-	while(this->mActiveBroadcasts > 0) { sleep(0); }
+	pthread_mutex_lock(&this->mWriterLock);
+
+	std::shared_ptr<DispatchSnapshot> snapshot = std::make_shared<DispatchSnapshot>();
+	snapshot->receiverFilters = std::atomic_load(&this->mSnapshot)->receiverFilters;
+	snapshot->receiverFilters.erase(receiver);
+	snapshot->buildIndex();
+
+	std::promise<void> released;
+	std::future<void> done = released.get_future();
+
+	std::shared_ptr<const DispatchSnapshot> oldSnapshot = publishSnapshot(snapshot);
+	oldSnapshot->released = &released;
+	oldSnapshot.reset();
+
+	pthread_mutex_unlock(&this->mWriterLock);
+
+	// The receiver is usually destroyed right after it unregisters, so wait for every broadcast that
+	// could still reach it.  Those hold the old snapshot, or an older one that keeps the old snapshot
+	// alive, so the old snapshot is destroyed once they have all completed.  New broadcasts already
+	// use the new snapshot, so this only waits on the messages that were in flight.
+	while (done.wait_for(std::chrono::milliseconds(UnregisterWarnMs)) != std::future_status::ready)
+	{
+		LOG_WARN("<Message Router> Still waiting for broadcasts to finish after unregistering " << receiver->pluginName);
+	}
+}
+
+std::shared_ptr<const MessageRouterBasic::DispatchSnapshot> MessageRouterBasic::publishSnapshot(std::shared_ptr<const DispatchSnapshot> snapshot)
+{
+	std::shared_ptr<const DispatchSnapshot> oldSnapshot = std::atomic_exchange(&this->mSnapshot, snapshot);
+	oldSnapshot->successor = snapshot;
+	return oldSnapshot;
+}
+
+MessageRouterBasic::DispatchSnapshot::~DispatchSnapshot()
+{
+	if (released)
+		released->set_value();
+}
+
+const MessageRouterBasic::DispatchList &MessageRouterBasic::DispatchSnapshot::lookupRecipients(const char *type, const char *subtype) const
+{
+	if (type == NULL)
+		return wildcardDispatch;
+
+	std::unordered_map<std::string, TypeDispatch>::const_iterator typeIter = typeDispatch.find(type);
+	if (typeIter == typeDispatch.end())
+		return wildcardDispatch;
+
+	if (subtype != NULL)
+	{
+		std::unordered_map<std::string, DispatchList>::const_iterator subtypeIter = typeIter->second.bySubtype.find(subtype);
+		if (subtypeIter != typeIter->second.bySubtype.end())
+			return subtypeIter->second;
+	}
 
-	mReceiverMessageFilterEntryMap.erase(receiver);
+	return typeIter->second.anySubtype;
+}
+
+void MessageRouterBasic::addRecipient(DispatchList &list, MessageReceiver *receiver, IvpMsgFlags flagmask)
+{
+	// Receivers are added in map order, so a receiver with several matching filters is always the last entry.
+	if (!list.empty() && list.back().receiver == receiver)
+	{
+		// A message goes through if any filter allows it, so a 0 (allow all) mask wins.
+		if (list.back().flagmask != 0)
+			list.back().flagmask = (flagmask == 0) ? 0 : (list.back().flagmask | flagmask);
+		return;
+	}
 
-	pthread_mutex_unlock(&this->mMapLock);
+	DispatchEntry entry;
+	entry.receiver = receiver;
+	entry.flagmask = flagmask;
+	list.push_back(entry);
+}
+
+void MessageRouterBasic::DispatchSnapshot::buildIndex()
+{
+	std::map<MessageReceiver *, std::vector<MessageFilterEntry> >::const_iterator mapIter;
+	std::vector<MessageFilterEntry>::const_iterator filterIter;
+
+	// First create an entry for every type and subtype that is subscribed to, so that
+	// wildcard filters can be added to all of them below.
+	for (mapIter = receiverFilters.begin(); mapIter != receiverFilters.end(); mapIter++)
+	{
+		for (filterIter = mapIter->second.begin(); filterIter != mapIter->second.end(); filterIter++)
+		{
+			if (filterIter->type.compare("*") == 0)
+				continue;
+
+			TypeDispatch &typeEntry = typeDispatch[filterIter->type];
+			if (filterIter->subtype.compare("*") != 0)
+				typeEntry.bySubtype[filterIter->subtype];
+		}
+	}
+
+	for (mapIter = receiverFilters.begin(); mapIter != receiverFilters.end(); mapIter++)
+	{
+		MessageReceiver *receiver = mapIter->first;
+
+		for (filterIter = mapIter->second.begin(); filterIter != mapIter->second.end(); filterIter++)
+		{
+			if (filterIter->type.compare("*") == 0)
+			{
+				// Subscribed to all messages, regardless of subtype.
+				addRecipient(wildcardDispatch, receiver, filterIter->flagmask);
+
+				for (std::unordered_map<std::string, TypeDispatch>::iterator typeIter = typeDispatch.begin(); typeIter != typeDispatch.end(); typeIter++)
+				{
+					addRecipient(typeIter->second.anySubtype, receiver, filterIter->flagmask);
+					for (std::unordered_map<std::string, DispatchList>::iterator subtypeIter = typeIter->second.bySubtype.begin(); subtypeIter != typeIter->second.bySubtype.end(); subtypeIter++)
+						addRecipient(subtypeIter->second, receiver, filterIter->flagmask);
+				}
+			}
+			else if (filterIter->subtype.compare("*") == 0)
+			{
+				// Subscribed to all subtypes of the type.
+				TypeDispatch &typeEntry = typeDispatch[filterIter->type];
+
+				addRecipient(typeEntry.anySubtype, receiver, filterIter->flagmask);
+				for (std::unordered_map<std::string, DispatchList>::iterator subtypeIter = typeEntry.bySubtype.begin(); subtypeIter != typeEntry.bySubtype.end(); subtypeIter++)
+					addRecipient(subtypeIter->second, receiver, filterIter->flagmask);
+			}
+			else
+			{
+				addRecipient(typeDispatch[filterIter->type].bySubtype[filterIter->subtype], receiver, filterIter->flagmask);
+			}
+		}
+	}
 }
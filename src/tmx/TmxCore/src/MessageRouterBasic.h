@@ -9,17 +9,35 @@
 #define MESSAGEROUTERBASIC_H_
 
 #include "MessageRouter.h"
+#include <atomic>
+#include <future>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <pthread.h>
+
+// How often unregisterReceiver warns that it is still waiting for the broadcasts using the receiver, unless
+// changed by MessageRouterBasic::UnregisterWarnMs.
+#define MESSAGE_ROUTER_UNREGISTER_WARN_MS 5000
 
 /**
  * \ingroup IVPCore
  *
  * -Basic implementation of searching through filters to send messages.
- * -Single threaded, the sender is blocked until the receivers are completed.
+ * -Single threaded, the sender is blocked until the receivers are completed.  Plugin connections only queue
+ *  the message for their own sender thread, so a plugin that is slow to read only delays itself.
+ * -The message is encoded at most once per frame format for each broadcast, and the encoded frame is shared by
+ *  the send queues of every plugin connection that receives it.
  * -The message should be destroyed by the sender after it is sent to the router.
  * 		-Implies that the message receivers can't hold onto the message, they either need to copy it or
  * 		 be done with it by the time they return from onMessageReceived()
  * -Allows concurrent broadcast to happen at the same time.
+ * -Filters are compiled into a dispatch index whenever a receiver registers or unregisters, so a
+ *  broadcast only looks up the message type and subtype instead of comparing against every filter.
+ * -The index is published as an immutable snapshot.  Broadcasts take a reference to the current snapshot
+ *  without locking, and register/unregister build a new snapshot and swap it in.
+ * -Unregister does not return until every broadcast that could still reach the receiver has completed, so
+ *  receivers must not block in receiveMessage(), and must not unregister from within it.
  */
 class MessageRouterBasic : public MessageRouter
 {
@@ -31,33 +49,116 @@ public:
 	virtual void registerReceiver(MessageReceiver *receiver, const std::vector<MessageFilterEntry> &filters);
 	virtual void unregisterReceiver(MessageReceiver *receiver);
 
+	/*!
+	 * How long unregisterReceiver waits for broadcasts in flight to finish with the receiver before it logs
+	 * a warning.  A receiver should never block that long.  The wait continues after the warning, since the
+	 * receiver may be destroyed as soon as unregisterReceiver returns.
+	 */
+	static std::atomic<unsigned int> UnregisterWarnMs;
+
 private:
 
-	uint64_t GetMsTimeSinceEpoch();
 	/*!
-	 * Map stores each receiver's list of message filters that it's last subscribed with.
+	 * A receiver that is to be sent a message, along with the combined flag mask of all of its
+	 * matching filters.  A flagmask of 0 allows all messages through.
 	 */
-	std::map<MessageReceiver *, std::vector<MessageFilterEntry> > mReceiverMessageFilterEntryMap;
+	struct DispatchEntry
+	{
+		MessageReceiver *receiver;
+		IvpMsgFlags flagmask;
+	};
+
+	typedef std::vector<DispatchEntry> DispatchList;
 
 	/*!
-	 * Lock for the map.  Map can not have keys (MessageReceivers) added or removed while inside broadcasting.
+	 * Recipients of a single message type.
+	 */
+	struct TypeDispatch
+	{
+		/*!
+		 * Receivers for a subtype that has no explicit filter, i.e. those subscribed to
+		 * all of the subtypes of this type, plus the full wildcard subscribers.
+		 */
+		DispatchList anySubtype;
+
+		/*!
+		 * Receivers for each subtype that appears in a filter.
+		 */
+		std::unordered_map<std::string, DispatchList> bySubtype;
+	};
+
+	/*!
+	 * An immutable copy of the receivers and their filters, along with the dispatch index built from them.
+	 * Once published, a snapshot is never modified, so any number of broadcasts may read it concurrently.
+	 */
+	struct DispatchSnapshot
+	{
+		/*!
+		 * Map stores each receiver's list of message filters that it's last subscribed with.
+		 */
+		std::map<MessageReceiver *, std::vector<MessageFilterEntry> > receiverFilters;
+
+		/*!
+		 * Receivers that subscribed to all messages (a type of '*').  Used for any message type not in typeDispatch.
+		 */
+		DispatchList wildcardDispatch;
+
+		/*!
+		 * Dispatch index by message type that is built from receiverFilters.
+		 * Each list contains the exact receivers for that type and subtype, in receiver order.
+		 */
+		std::unordered_map<std::string, TypeDispatch> typeDispatch;
+
+		/*!
+		 * Build the dispatch index from receiverFilters.
+		 */
+		void buildIndex();
+
+		/*!
+		 * Find the list of recipients for the message type and subtype.
+		 */
+		const DispatchList &lookupRecipients(const char *type, const char *subtype) const;
+
+		/*!
+		 * The snapshot that replaced this one, set when it is published.  Each snapshot keeps its successor
+		 * alive, so a snapshot is only destroyed after every older snapshot, and therefore after every broadcast
+		 * that started before it was replaced.  Broadcasts never read it.
+		 */
+		mutable std::shared_ptr<const DispatchSnapshot> successor;
+
+		/*!
+		 * Set by unregisterReceiver to be fulfilled when this snapshot is destroyed.
+		 */
+		mutable std::promise<void> *released = NULL;
+
+		~DispatchSnapshot();
+	};
+
+	uint64_t GetMsTimeSinceEpoch();
+
+	/*!
+	 * Atomically replace the current snapshot, and link it as the successor of the snapshot it replaces.
+	 * Must be called with mWriterLock held.
 	 *
-	 * Map can not have values(list of MessageFilterEntries) changed while inside broadcasting except for on the same thread.
-	 * This is because by the time that the broadcast function run's any callbacks, it's already completed with that list of MessageFilterEntries but has not yet
-	 * started using the next list of entries.
+	 * @return The snapshot that was replaced.
+	 */
+	std::shared_ptr<const DispatchSnapshot> publishSnapshot(std::shared_ptr<const DispatchSnapshot> snapshot);
+
+	/*!
+	 * Add the receiver to the list, or merge the flagmask if the receiver is already there.
 	 */
-	pthread_mutex_t mMapLock;
+	static void addRecipient(DispatchList &list, MessageReceiver *receiver, IvpMsgFlags flagmask);
 
 	/*!
-	 * Keeps track of how many threads are actively inside the broadcast method in a thread safe manner (using mActiveBroadcastsLock).
-	 * This is to allow concurrent execution of the broadcast, but give the register and unregister methods a way to tell when broadcasts are inactive.
+	 * The current snapshot.  Only accessed through std::atomic_load and std::atomic_exchange.
 	 */
-	volatile int mActiveBroadcasts;
+	std::shared_ptr<const DispatchSnapshot> mSnapshot;
 
 	/*!
-	 * Used to keep the mActiveBroadcast count accurate since multiple thread's may be accessing.
+	 * Serializes the register and unregister methods, which copy the current snapshot, modify the copy and then publish it.
+	 * Broadcasts never take this lock.
 	 */
-	pthread_mutex_t mActiveBroadcastsLock;
+	pthread_mutex_t mWriterLock;
 };
 
 #endif /* MESSAGEROUTERBASIC_H_ */
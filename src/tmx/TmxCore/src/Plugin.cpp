@@ -5,9 +5,6 @@
  *      Author: ivp
  */
 
-#ifndef __CYGWIN__
-#include <sys/prctl.h>
-#endif
 #include "Plugin.h"
 #include <assert.h>
 #include <string.h>
@@ -26,8 +23,6 @@ Plugin::Plugin(MessageRouter *messageRouter) : MessageRouterClient(messageRouter
 	pthread_mutexattr_init(&lockAttr);
 	pthread_mutexattr_settype(&lockAttr, PTHREAD_MUTEX_RECURSIVE);
 	pthread_mutex_init(&this->mConfigValueLock, &lockAttr);
-
-	this->mConfigMonitorThread = boost::thread(&Plugin::configMonitorThreadEntry, this);
 }
 
 Plugin::~Plugin()
@@ -36,8 +31,7 @@ Plugin::~Plugin()
 	clientNames.erase(this->mInfo.pluginInfo.name);
 	pthread_mutex_unlock(&clientLock);
 
-	this->mConfigMonitorThread.interrupt();
-	this->mConfigMonitorThread.join();
+	ConfigCache::getInstance()->removePlugin(this);
 
 	if (this->mRegistered)
 		this->addEventLogEntry(LogLevel_Warning, "Plugin deconstructing");
@@ -110,6 +104,8 @@ void Plugin::registerPlugin(RegistrationInformation info)
 	this->addEventLogEntry(LogLevel_Info, "Plugin registered");
 	this->setPluginStatus(IVP_STATUS_RUNNING);
 
+	ConfigCache::getInstance()->addPlugin(this, this->mInfo.pluginInfo.id);
+
 	IvpMessage *msg = ivpMsg_create(NULL, NULL, NULL, IvpMsgFlags_None, NULL);
 	if (msg != NULL)
 		this->sendMessageToRouter(msg);
@@ -150,17 +146,30 @@ void Plugin::setPluginStatus(std::string status)
 }
 
 void Plugin::setStatusItems(std::map<std::string, std::string> statusItems)
+{
+	this->updateStatusItems(statusItems, vector<string>());
+}
+
+void Plugin::removeStatusItems(std::vector<std::string> itemKeys)
+{
+	this->updateStatusItems(map<string, string>(), itemKeys);
+}
+
+void Plugin::updateStatusItems(const std::map<std::string, std::string> &statusItems, const std::vector<std::string> &itemKeys)
 {
 	if (!this->mRegistered)
 	{
-		string what = "Unable to set plugin status items, plugin is not registered";
+		string what = "Unable to update plugin status items, plugin is not registered";
 		LOG_WARN("<" << string(this->mRegistered ? this->mInfo.pluginInfo.name : "Unknown") << "> " << what);
 		throw PluginNotRegisteredException(what);
 	}
 
+	if (statusItems.empty() && itemKeys.empty())
+		return;
+
 	vector<PluginStatusItem> dbEntries;
 
-	for(map<std::string, std::string>::iterator itr = statusItems.begin(); itr != statusItems.end(); itr++)
+	for(map<std::string, std::string>::const_iterator itr = statusItems.begin(); itr != statusItems.end(); itr++)
 	{
 		PluginStatusItem entry;
 		entry.key = itr->first;
@@ -171,27 +180,10 @@ void Plugin::setStatusItems(std::map<std::string, std::string> statusItems)
 	try {
 		PluginContext context;
 		context.setPluginStatusItems(this->mInfo.pluginInfo.id, dbEntries);
-	} catch (DbException &e) {
-		LOG_WARN("<" << this->mInfo.pluginInfo.name << "> MySQL: Unable to status entries [" << e.what() << "]");
-		throw PluginException("Error setting status entries [" + string(e.what()) + "]");
-	}
-}
-
-void Plugin::removeStatusItems(std::vector<std::string> itemKeys)
-{
-	if (!this->mRegistered)
-	{
-		string what = "Unable to remove plugin status items, plugin is not registered";
-		LOG_WARN("<" << string(this->mRegistered ? this->mInfo.pluginInfo.name : "Unknown") << "> " << what);
-		throw PluginNotRegisteredException(what);
-	}
-
-	try {
-		PluginContext context;
 		context.removePluginStatusItems(this->mInfo.pluginInfo.id, itemKeys);
 	} catch (DbException &e) {
-		LOG_WARN("<" << this->mInfo.pluginInfo.name << "> MySQL: Unable to remove status items [" << e.what() << "]");
-		throw PluginException("Error setting status entries [" + string(e.what()) + "]");
+		LOG_WARN("<" << this->mInfo.pluginInfo.name << "> MySQL: Unable to update status items [" << e.what() << "]");
+		throw PluginException("Error updating status entries [" + string(e.what()) + "]");
 	}
 }
 
@@ -292,78 +284,48 @@ void Plugin::setConfigValue(std::string key, std::string value)
 	try {
 		ConfigContext ccontext;
 		ccontext.updatePluginConfigParameterValue(newEntry);
+		ConfigCache::getInstance()->invalidate();
 	} catch (DbException &e) {
 		LOG_ERROR("<" << string(this->mRegistered ? this->mInfo.pluginInfo.name : "Unknown") << "> MySQL: Unable to update configuration value for key '" << key << "' [" << e.what() << "]");
 	}
 }
 
-void Plugin::configMonitorThreadEntry()
+void Plugin::updateConfigValues(std::map<std::string, PluginConfigurationParameterEntry> configMap)
 {
-#ifndef __CYGWIN__
-	prctl(PR_SET_NAME, "PluginCnfgMntr", 0, 0, 0);
-#endif
+	pthread_mutex_lock(&this->mConfigValueLock);
 
-	while(1)
+	for(map<string, PluginConfigurationParameterEntry>::iterator itr = this->mConfigValues.begin(); itr != this->mConfigValues.end(); itr++)
 	{
-		if (boost::this_thread::interruption_requested())
-			throw boost::thread_interrupted();
-
-		boost::this_thread::sleep(boost::posix_time::seconds(2));
-		if (!this->mRegistered)
+		map<string, PluginConfigurationParameterEntry>::iterator newEntry = configMap.find(itr->first);
+		if (newEntry == configMap.end())
+		{
+			//bad fatal not good...
 			continue;
+		}
 
-		boost::this_thread::disable_interruption di;
+		if (newEntry->second.value != itr->second.value)
 		{
-			std::map<string, PluginConfigurationParameterEntry> configMap;
-			try {
-				ConfigContext ccontext;
-
-				configMap = ccontext.getPluginConfigParameters(this->mInfo.pluginInfo.id);
-
-
-			} catch (DbException &e) {
-				LOG_ERROR("<" << this->mInfo.pluginInfo.name << "> MySQL: Unable to get configuration information [" << e.what() << "]");
-				continue;
-			}
-
-			pthread_mutex_lock(&this->mConfigValueLock);
-
-			for(map<string, PluginConfigurationParameterEntry>::iterator itr = this->mConfigValues.begin(); itr != this->mConfigValues.end(); itr++)
-			{
-				map<string, PluginConfigurationParameterEntry>::iterator newEntry = configMap.find(itr->first);
-				if (newEntry == configMap.end())
-				{
-					//bad fatal not good...
-					continue;
-				}
-
-				if (newEntry->second.value != itr->second.value)
-				{
-					itr->second = newEntry->second;
-					this->onConfigChanged(itr->second.key, itr->second.value);
-				}
-
-				configMap.erase(newEntry);
-			}
-
-			for (map<string, PluginConfigurationParameterEntry>::iterator itr = configMap.begin(); itr != configMap.end(); itr++)
-			{
-				// Some new config discovered that was not registered.  Add it as an acceptable value.
-				try
-				{
-					this->mConfigValues[itr->first] = itr->second;
-					this->onConfigChanged(itr->second.key, itr->second.value);
-				}
-				catch (UnknownConfigurationKeyException &ex)
-				{
-					// Some plugins may not like this
-					LOG_ERROR("<" << this->mInfo.pluginInfo.name << "> Exception from handling new config parameter " << itr->second.key << " [" << ex.what() << "]");
-				}
-			}
-
-			pthread_mutex_unlock(&this->mConfigValueLock);
+			itr->second = newEntry->second;
+			this->onConfigChanged(itr->second.key, itr->second.value);
+		}
 
+		configMap.erase(newEntry);
+	}
+
+	for (map<string, PluginConfigurationParameterEntry>::iterator itr = configMap.begin(); itr != configMap.end(); itr++)
+	{
+		// Some new config discovered that was not registered.  Add it as an acceptable value.
+		try
+		{
+			this->mConfigValues[itr->first] = itr->second;
+			this->onConfigChanged(itr->second.key, itr->second.value);
+		}
+		catch (UnknownConfigurationKeyException &ex)
+		{
+			// Some plugins may not like this
+			LOG_ERROR("<" << this->mInfo.pluginInfo.name << "> Exception from handling new config parameter " << itr->second.key << " [" << ex.what() << "]");
 		}
 	}
-}
 
+	pthread_mutex_unlock(&this->mConfigValueLock);
+}
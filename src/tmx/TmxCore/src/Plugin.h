@@ -17,6 +17,7 @@
 #include "database/PluginContext.h"
 #include "database/ConfigContext.h"
 #include "database/MessageContext.h"
+#include "ConfigCache.h"
 #include "logger.h"
 #include "boost/thread.hpp"
 
@@ -124,6 +125,19 @@ protected:
 	 */
 	void removeStatusItems(std::vector<std::string> itemKeys);
 
+	/*!
+	 * Sets and removes custom status items using one database connection.
+	 * Nothing is written when both are empty.
+	 *
+	 * throws: PluginNotRegisteredException
+	 *
+	 * @params statusItems
+	 * 		'key' / 'status' pairs of custom status items.
+	 * @params itemKeys
+	 * 		keys of the items to remove
+	 */
+	void updateStatusItems(const std::map<std::string, std::string> &statusItems, const std::vector<std::string> &itemKeys);
+
 	/*!
 	 *
 	 * throws: PluginNotRegisteredException
@@ -176,12 +190,16 @@ private:
 
 	pthread_mutex_t mConfigValueLock;
 	std::map<std::string, PluginConfigurationParameterEntry> mConfigValues;
-	boost::thread mConfigMonitorThread;
 
 	static std::set<std::string> clientNames;
 	static pthread_mutex_t clientLock;
 
-	void configMonitorThreadEntry();
+	friend class ConfigCache;
+
+	/*!
+	 * Called by the ConfigCache with the latest parameters for this plugin.  Calls onConfigChanged for each value that changed.
+	 */
+	void updateConfigValues(std::map<std::string, PluginConfigurationParameterEntry> configMap);
 };
 
 #endif /* PLUGINCLIENT_H_ */
@@ -13,20 +13,48 @@
 #include "tmx/IvpPlugin.h"
 #include "tmx/utils/MsgFramer.h"
 #include "utils/PerformanceTimer.h"
+#include "utils/TimeUtils.h"
 #include <assert.h>
+#include <sstream>
 using namespace std;
 
+// How long to wait for space in a shared memory ring before dropping the message.
+#define SHARED_MEMORY_WRITE_TIMEOUT_MS 1000
+// How long the shared memory receiver waits for a message before checking if it should exit.
+#define SHARED_MEMORY_POLL_MS 100
+// How often the send queue statistics are published as status items, while messages are being sent.
+#define SEND_QUEUE_STATUS_INTERVAL_MS 5000
+#define SEND_QUEUE_STATUS_DEPTH "Core Send Queue Depth"
+#define SEND_QUEUE_STATUS_DROPS "Core Send Queue Drops"
+#define SHARED_MEMORY_STATUS_DROPS "Core Shared Memory Drops"
+#define STATUS_MESSAGES_STATUS "Core Status Messages"
+#define STATUS_WRITES_STATUS "Core Status Writes"
+
+std::atomic<bool> PluginConnection::SharedMemoryEnabled(false);
+std::atomic<unsigned int> PluginConnection::SharedMemoryCount(0);
+std::atomic<size_t> PluginConnection::SendQueueCapacity(1024);
+std::set<std::string> PluginConnection::SendQueueNeverDropTypes;
+
 // The PluginConnection class is instantiated by ivpcore when a Plugin opens a socket to ivpcore
 // using the ivpapi library.
 // The receiver thread then listens for messages over the socket.
 // When a message is received it is placed on a queue for processing by the processor threads.
+// Messages routed to the plugin are placed on the send queue, and written to the plugin by the sender thread.
 
-PluginConnection::PluginConnection(MessageRouter *router, int socket) : Plugin(router)
+PluginConnection::PluginConnection(MessageRouter *router, int socket) : Plugin(router),
+	mSendQueue(SendQueueCapacity)
 {
 	assert(socket != (int) NULL);
 
 	this->mSocket = socket;
-
+	this->mBinaryFraming = false;
+	this->mSendQueueStatusPending = false;
+	this->mLastSendQueueStatus = 0;
+	this->mSharedMemoryDrops = 0;
+	this->mStatusMessageCount = 0;
+	this->mStatusWriteCount = 0;
+
+	mSenderThread = boost::thread(&PluginConnection::senderThread, this);
 	mReceiverThread = boost::thread(&PluginConnection::receiverThread, this);
 	mFastProcessorThread = boost::thread(&PluginConnection::fastProcessorThread, this);
 	mSlowProcessorThread = boost::thread(&PluginConnection::slowProcessorThread, this);
@@ -56,38 +84,115 @@ void PluginConnection::onConfigChanged(string key, string value)
 // onMessageReceived.
 void PluginConnection::onMessageReceived(IvpMessage *msg)
 {
-	struct pollfd poll_data;
+	EncodedMessage encoded(msg);
+	queueOutgoingMessage(encoded);
+}
+
+// Messages routed to this plugin arrive here, along with the frames already encoded for the other plugins.
+void PluginConnection::receiveMessage(IvpMessage *msg, EncodedMessage &encoded)
+{
+	queueOutgoingMessage(encoded);
+}
+
+// The message is only encoded and queued here, since this is called on the thread routing the message.
+void PluginConnection::queueOutgoingMessage(EncodedMessage &encoded)
+{
+	IvpMessage *msg = encoded.getMessage();
+
+	OutgoingFrame frame;
+	frame.frame = encoded.getFrame(mBinaryFraming ? MsgFramer_FrameType_binary : MsgFramer_FrameType_json);
+	if (!frame.frame)
+		return;
 
-	char *jsonmsg = ivpMsg_createJsonString(msg, IvpMsg_FormatOptions_none);
-	if (jsonmsg)
+	if (frame.frame->frameType == MsgFramer_FrameType_binary)
 	{
-		int framedMsgLength;
-		char *framedMsg = msgFramer_createFramedMsg(jsonmsg, strlen(jsonmsg), &framedMsgLength);
+		// A message too large for the ring is sent over the socket, which the plugin still reads.
+		frame.sharedMemory = std::atomic_load(&mSharedMemorySend);
+		if (frame.sharedMemory && (uint32_t)frame.frame->length > shmRing_getMaxLength(frame.sharedMemory.get()))
+			frame.sharedMemory.reset();
+	}
 
-		if (framedMsg)
-		{
-			if (mSocket != (int) NULL)
-			{
-				poll_data.fd = mSocket;
-				poll_data.events = POLLOUT;
+	// API messages, such as configuration and errors, are never dropped.  Everything else is dropped oldest first
+	// once the plugin falls too far behind.
+	frame.droppable = SendQueue::isDroppable(msg->type, SendQueueNeverDropTypes);
 
-				poll(&poll_data,1,1);
+	mSendQueue.push(frame);
 
-				if(!(poll_data.revents & POLLHUP))
-				{
-					int retvalue = write(mSocket,framedMsg,framedMsgLength);
-					if (retvalue < 0)
-						shutdown(mSocket, SHUT_RDWR);
-				}
-			}
+	uint64_t now = TimeUtils::getSystemMillis();
+	if (now >= mLastSendQueueStatus + SEND_QUEUE_STATUS_INTERVAL_MS && !mSendQueueStatusPending.exchange(true))
+	{
+		mLastSendQueueStatus = now;
+		mEventContinueSlowProcessor.Set();
+	}
+}
 
-			free(framedMsg);
-		}
+// The sender thread writes the queued messages to the plugin, in the order they were queued.
+void PluginConnection::senderThread()
+{
+#ifndef __CYGWIN__
+	prctl(PR_SET_NAME, "PluginConSender", 0, 0, 0);
+#endif
+
+	std::deque<OutgoingFrame> frames;
 
-		free(jsonmsg);
+	while (mSendQueue.popAll(frames))
+	{
+		for (std::deque<OutgoingFrame>::iterator itr = frames.begin(); itr != frames.end(); itr++)
+			writeFrame(*itr);
+
+		frames.clear();
 	}
 }
 
+void PluginConnection::writeFrame(OutgoingFrame &frame)
+{
+	struct pollfd poll_data;
+
+	if (frame.sharedMemory)
+	{
+		// A full ring means the plugin is not keeping up, so the message is dropped after the timeout.
+		// The write only fails once the ring has been closed, since frames that do not fit go to the socket.
+		int result = shmRing_write(frame.sharedMemory.get(), frame.frame->data, frame.frame->length, SHARED_MEMORY_WRITE_TIMEOUT_MS);
+		if (result < 0)
+			shutdown(mSocket, SHUT_RDWR);
+		else if (result == 0)
+			mSharedMemoryDrops++;
+	}
+	else if (mSocket != (int) NULL)
+	{
+		poll_data.fd = mSocket;
+		poll_data.events = POLLOUT;
+
+		poll(&poll_data,1,1);
+
+		if(!(poll_data.revents & POLLHUP))
+		{
+			// The frame markers are written along with the message, without copying it into a framed buffer.
+			int retvalue = msgFramer_writeFramedMsg(mSocket, frame.frame->data, frame.frame->length, frame.frame->frameType);
+			if (retvalue < 0)
+				shutdown(mSocket, SHUT_RDWR);
+		}
+	}
+}
+
+// Adds the depth of the send queue, the number of messages dropped from it or from the shared memory ring, and
+// the number of status messages and status writes to the status items of the plugin.  The write count is of the
+// writes that have succeeded, so it does not include the write these items are about to be part of.
+void PluginConnection::addCoreStatusItems(map<string, string> &updateItems, set<string> &removeItems)
+{
+	updateItems[SEND_QUEUE_STATUS_DEPTH] = to_string(mSendQueue.getDepth());
+	updateItems[SEND_QUEUE_STATUS_DROPS] = to_string(mSendQueue.getDrops());
+	updateItems[SHARED_MEMORY_STATUS_DROPS] = to_string(mSharedMemoryDrops);
+	updateItems[STATUS_MESSAGES_STATUS] = to_string(mStatusMessageCount);
+	updateItems[STATUS_WRITES_STATUS] = to_string(mStatusWriteCount);
+
+	removeItems.erase(SEND_QUEUE_STATUS_DEPTH);
+	removeItems.erase(SEND_QUEUE_STATUS_DROPS);
+	removeItems.erase(SHARED_MEMORY_STATUS_DROPS);
+	removeItems.erase(STATUS_MESSAGES_STATUS);
+	removeItems.erase(STATUS_WRITES_STATUS);
+}
+
 // The receiver thread reads messages sent from a plugin to ivpcore over a socket.
 // Each message received is placed on a queue that is handled by one of the two processor threads.
 void PluginConnection::receiverThread()
@@ -108,6 +213,13 @@ void PluginConnection::receiverThread()
 		if (recvcount <= 0)	//connection has been closed
 		{
 			cout << "GUI connection closing..." << recvcount << endl;
+			msgFramer_destroy(&framer);
+			closeSharedMemory();
+
+			// Stop the sender before the socket is closed, so it can not write to a reused descriptor.
+			shutdown(mSocket, SHUT_RDWR);
+			mSendQueue.close();
+			mSenderThread.join();
 			close(mSocket);
 
 			mFastProcessorThread.interrupt();
@@ -124,11 +236,17 @@ void PluginConnection::receiverThread()
 		msgFramer_incrementBufPos(&framer, recvcount);
 
 		char *rawMessage = NULL;
+		int rawMessageLength;
+		MsgFramer_FrameType frameType;
 
-		while ((rawMessage = msgFramer_getNextMsg(&framer)) != NULL)
+		while ((rawMessage = msgFramer_getNextFrame(&framer, &rawMessageLength, &frameType)) != NULL)
 		{
 			// Create an IvpMessage from the raw message.
-			IvpMessage *msg = ivpMsg_parse(rawMessage);
+			IvpMessage *msg = NULL;
+			if (frameType == MsgFramer_FrameType_binary)
+				msg = ivpMsg_parseBinary(rawMessage, rawMessageLength);
+			else
+				msg = ivpMsg_parse(rawMessage);
 
 			// If the message could not be parsed, send an error message back to the plugin.
 			if (msg == NULL)
@@ -142,28 +260,149 @@ void PluginConnection::receiverThread()
 				continue;
 			}
 
-			// Place the message on the appropriate queue for processing by another thread.
-			// Non-critical messages that are slower to process are placed on the slow processor thread
-			// and the others are placed on the fast processor thread.
-			// For instance, in one case, writing of status messages to the database was taking 9 ms.
-			// That is why status messages and event messages are processed in their own thread.
-			// Note that the IvpMessage is freed in the processor threads.
+			queueMessage(msg);
+		}
+	}
+}
 
-			if (ivpPluginStatus_isStatusMsg(msg) ||	ivpEventLog_isEventLogMsg(msg))
-			{
-				mMutexSlowMessageQueue.lock();
-				mSlowMessageQueue.push(msg);
-				mMutexSlowMessageQueue.unlock();
-				mEventContinueSlowProcessor.Set();
-			}
-			else
+void PluginConnection::queueMessage(IvpMessage *msg)
+{
+	// Place the message on the appropriate queue for processing by another thread.
+	// Non-critical messages that are slower to process are placed on the slow processor thread
+	// and the others are placed on the fast processor thread.
+	// For instance, in one case, writing of status messages to the database was taking 9 ms.
+	// That is why status messages and event messages are processed in their own thread.
+	// Note that the IvpMessage is freed in the processor threads.
+
+	if (ivpPluginStatus_isStatusMsg(msg) ||	ivpEventLog_isEventLogMsg(msg))
+	{
+		mMutexSlowMessageQueue.lock();
+		mSlowMessageQueue.push(msg);
+		mMutexSlowMessageQueue.unlock();
+		mEventContinueSlowProcessor.Set();
+	}
+	else
+	{
+		mMutexFastMessageQueue.lock();
+		mFastMessageQueue.push(msg);
+		mMutexFastMessageQueue.unlock();
+		mEventContinueFastProcessor.Set();
+	}
+}
+
+// Once a plugin has been moved to shared memory, this thread reads the messages it sends to ivpcore.
+// The socket is still used to detect that the plugin has disconnected.
+void PluginConnection::sharedMemoryReceiverThread()
+{
+#ifndef __CYGWIN__
+	prctl(PR_SET_NAME, "PluginConShmReceiver", 0, 0, 0);
+#endif
+
+	std::shared_ptr<ShmRing> sharedMemory = std::atomic_load(&mSharedMemoryReceive);
+	if (!sharedMemory)
+		return;
+
+	boost::this_thread::disable_interruption di;
+
+	while (!boost::this_thread::interruption_requested())
+	{
+		const char *data;
+		uint32_t length;
+
+		int result = shmRing_read(sharedMemory.get(), &data, &length, SHARED_MEMORY_POLL_MS);
+		if (result < 0)
+			break;
+		if (result == 0)
+			continue;
+
+		IvpMessage *msg = ivpMsg_parseBinary(data, length);
+		shmRing_release(sharedMemory.get());
+
+		if (msg == NULL)
+		{
+			IvpMessage *errMsg = ivpError_createMsg(ivpError_createError(IvpLogLevel_warn, IvpError_messageParse, 0));
+			if (errMsg)
 			{
-				mMutexFastMessageQueue.lock();
-				mFastMessageQueue.push(msg);
-				mMutexFastMessageQueue.unlock();
-				mEventContinueFastProcessor.Set();
+				this->onMessageReceived(errMsg);
+				ivpMsg_destroy(errMsg);
 			}
+			continue;
 		}
+
+		queueMessage(msg);
+	}
+}
+
+bool PluginConnection::isLocalConnection()
+{
+	struct sockaddr_storage addr;
+	socklen_t addrLength = sizeof(addr);
+
+	if (getpeername(mSocket, (struct sockaddr *)&addr, &addrLength) != 0)
+		return false;
+
+	if (addr.ss_family == AF_UNIX)
+		return true;
+
+	if (addr.ss_family == AF_INET)
+		return (ntohl(((struct sockaddr_in *)&addr)->sin_addr.s_addr) >> 24) == 127;
+
+	if (addr.ss_family == AF_INET6)
+		return IN6_IS_ADDR_LOOPBACK(&((struct sockaddr_in6 *)&addr)->sin6_addr);
+
+	return false;
+}
+
+void PluginConnection::openSharedMemory()
+{
+	unsigned int id = SharedMemoryCount++;
+
+	ostringstream sendName;
+	sendName << "/tmx-" << getpid() << "-" << id << "-plugin-receive";
+	ostringstream receiveName;
+	receiveName << "/tmx-" << getpid() << "-" << id << "-plugin-send";
+
+	std::shared_ptr<ShmRing> sendRing(shmRing_create(sendName.str().c_str(), SHM_RING_DEFAULT_CAPACITY), shmRing_close);
+	std::shared_ptr<ShmRing> receiveRing(shmRing_create(receiveName.str().c_str(), SHM_RING_DEFAULT_CAPACITY), shmRing_close);
+
+	if (!sendRing.get() || !receiveRing.get())
+	{
+		LOG_WARN("<" << mInfo.pluginInfo.name << "> Unable to create shared memory rings, using the socket");
+		return;
+	}
+
+	// Tell the plugin over the socket, then switch.  Anything sent after this goes through the ring, so the plugin
+	// reads it after this message.  If the plugin can not open the rings, it reconnects without asking for them.
+	IvpMessage *msg = ivpTransport_createSharedMemoryMsg(sendName.str().c_str(), receiveName.str().c_str());
+	if (msg == NULL)
+		return;
+
+	this->onMessageReceived(msg);
+	ivpMsg_destroy(msg);
+
+	std::atomic_store(&mSharedMemoryReceive, receiveRing);
+	std::atomic_store(&mSharedMemorySend, sendRing);
+
+	mSharedMemoryReceiverThread = boost::thread(&PluginConnection::sharedMemoryReceiverThread, this);
+
+	LOG_INFO("<" << mInfo.pluginInfo.name << "> Using shared memory transport");
+}
+
+void PluginConnection::closeSharedMemory()
+{
+	std::shared_ptr<ShmRing> sendRing = std::atomic_exchange(&mSharedMemorySend, std::shared_ptr<ShmRing>());
+	std::shared_ptr<ShmRing> receiveRing = std::atomic_exchange(&mSharedMemoryReceive, std::shared_ptr<ShmRing>());
+
+	// Wake up anything waiting on the rings.  They are unmapped and removed once the last reference is gone.
+	if (sendRing)
+		shmRing_shutdown(sendRing.get());
+	if (receiveRing)
+		shmRing_shutdown(receiveRing.get());
+
+	if (mSharedMemoryReceiverThread.joinable())
+	{
+		mSharedMemoryReceiverThread.interrupt();
+		mSharedMemoryReceiverThread.join();
 	}
 }
 
@@ -258,8 +497,9 @@ void PluginConnection::slowProcessorThread()
 	prctl(PR_SET_NAME, "PluginConSlowProcessor", 0, 0, 0);
 #endif
 
-	bool messageWaiting = false;
-	IvpMessage *msg = NULL;
+	std::queue<IvpMessage*> messages;
+	map<string, string> updateItems;
+	set<string> removeItems;
 
 	// Disable interruption of this thread (as long as the variable below is in scope).
 	// This allows the thread to exit gracefully by checking interruption_requested().
@@ -267,44 +507,61 @@ void PluginConnection::slowProcessorThread()
 
 	while (!boost::this_thread::interruption_requested())
 	{
-		// If a message is not already waiting, sleep so this thread does not consume the CPU.
-		if (!messageWaiting)
-			mEventContinueSlowProcessor.WaitOne();
+		// Sleep until there is something to do, so this thread does not consume the CPU.
+		mEventContinueSlowProcessor.WaitOne();
 
-		// Lock the queue and retrieve the message.
+		// Take every waiting message at once.  A plugin that sets its status for each message it handles can queue
+		// many status messages while the previous ones are written, and only the latest value of each item is written.
 
 		mMutexSlowMessageQueue.lock();
+		messages.swap(mSlowMessageQueue);
+		mMutexSlowMessageQueue.unlock();
 
-		if (!mSlowMessageQueue.empty())
+		while (!messages.empty())
 		{
-			msg = mSlowMessageQueue.front();
-			mSlowMessageQueue.pop();
-			messageWaiting = !mSlowMessageQueue.empty();
-		}
-		else
-		{
-			msg = NULL;
-		}
-
-		mMutexSlowMessageQueue.unlock();
+			IvpMessage *msg = messages.front();
+			messages.pop();
 
-		if (msg == NULL) continue;
+			if (ivpPluginStatus_isStatusMsg(msg))
+			{
+				mergeStatusMessage(msg, updateItems, removeItems);
+				mStatusMessageCount++;
+			}
+			else if (ivpEventLog_isEventLogMsg(msg))
+			{
+				processEventLogMessage(msg);
+			}
 
-		if (ivpPluginStatus_isStatusMsg(msg))
-		{
-			processStatusMessage(msg);
+			ivpMsg_destroy(msg);
 		}
-		else if (ivpEventLog_isEventLogMsg(msg))
+
+		if (mSendQueueStatusPending.exchange(false))
+			addCoreStatusItems(updateItems, removeItems);
+
+		if (!updateItems.empty() || !removeItems.empty())
 		{
-			processEventLogMessage(msg);
-		}
+			try
+			{
+				this->updateStatusItems(updateItems, vector<string>(removeItems.begin(), removeItems.end()));
+				mStatusWriteCount++;
+			}
+			catch(PluginException &e)
+			{
+				LOG_WARN(e.what());
+			}
 
-		ivpMsg_destroy(msg);
+			updateItems.clear();
+			removeItems.clear();
+		}
 	}
 }
 
 void PluginConnection::processRegistrationMessage(IvpMessage *msg)
 {
+	// Plugins that can receive binary frames say so when registering.  The configuration message sent below
+	// is then the first binary frame, which tells the plugin it can send binary frames as well.
+	mBinaryFraming = (msg->flags & IvpMsgFlags_BinaryFraming) != 0;
+
 	IvpManifest *manifest = ivpRegister_getManifest(msg);
 
 	if (manifest)
@@ -356,6 +613,11 @@ void PluginConnection::processRegistrationMessage(IvpMessage *msg)
 					if (itr->second.value != itr->second.defaultValue)
 						collection = ivpConfig_addItemToCollection(collection, itr->second.key.c_str(), itr->second.value.c_str(), NULL);
 				}
+
+				// Move plugins on this host off of the socket before sending anything else.
+				if (SharedMemoryEnabled && mBinaryFraming && (msg->flags & IvpMsgFlags_SharedMemory) && isLocalConnection())
+					openSharedMemory();
+
 				IvpMessage *msg = ivpConfig_createMsg(collection);
 				if (msg)
 				{
@@ -464,6 +726,7 @@ void PluginConnection::processConfigMessage(IvpMessage *msg)
 	try
 	{
 		ccontext.initializePluginConfigParameters(0, globalParams);
+		ConfigCache::getInstance()->invalidate();
 	}
 	catch (DbException &e)
 	{
@@ -472,11 +735,11 @@ void PluginConnection::processConfigMessage(IvpMessage *msg)
 	}
 }
 
-void PluginConnection::processStatusMessage(IvpMessage *msg)
+// Merges the items of a status message into the items to be written, so a later set or remove of a key
+// replaces any earlier one.
+void PluginConnection::mergeStatusMessage(IvpMessage *msg, map<string, string> &updateItems, set<string> &removeItems)
 {
 	int arraySize = ivpPluginStatus_getItemCount(msg->payload);
-	vector<string> removeItems;
-	map<string, string> updateItems;
 
 	for (int i = 0; i < arraySize; i++)
 	{
@@ -487,26 +750,20 @@ void PluginConnection::processStatusMessage(IvpMessage *msg)
 		{
 			assert(item->key);
 			if (item->key && strlen(item->key) > 0)
-				removeItems.push_back(string(item->key));
+			{
+				updateItems.erase(string(item->key));
+				removeItems.insert(string(item->key));
+			}
 		}
 		else
 		{
 			string key;
 			if (item->key)
 				key = string(item->key);
+			removeItems.erase(key);
 			updateItems[key] = string(item->value);
 		}
 	}
-
-	try
-	{
-		this->setStatusItems(updateItems);
-		this->removeStatusItems(removeItems);
-	}
-	catch(PluginException &e)
-	{
-		LOG_WARN(e.what());
-	}
 }
 
 void PluginConnection::processEventLogMessage(IvpMessage *msg)
@@ -23,9 +23,13 @@
 #include <string.h>
 #include <iostream>
 #include <queue>
+#include <atomic>
+#include <memory>
 
 #include <boost/thread.hpp>
 #include "utils/AutoResetEvent.h"
+#include "utils/SendQueue.h"
+#include "tmx/utils/ShmRing.h"
 
 #include "Plugin.h"
 #include <set>
@@ -36,19 +40,53 @@ public:
 	PluginConnection(MessageRouter *router, int socket);
 	~PluginConnection();
 
+	/*!
+	 * Whether plugins on the same host that ask for it are moved to shared memory rings after they register.
+	 */
+	static std::atomic<bool> SharedMemoryEnabled;
+
+	/*!
+	 * The most droppable messages that may be waiting to be sent to each plugin.
+	 */
+	static std::atomic<size_t> SendQueueCapacity;
+
+	/*!
+	 * Message types, in addition to the API reserved types, that are never dropped when a plugin falls behind.
+	 * Only set at startup, before any connections are made.
+	 */
+	static std::set<std::string> SendQueueNeverDropTypes;
+
+	using Plugin::receiveMessage;
+	virtual void receiveMessage(IvpMessage *msg, EncodedMessage &encoded);
+
 protected:
 	virtual void onConfigChanged(std::string key, std::string value);
 	virtual void onMessageReceived(IvpMessage *msg);
 
+	/*!
+	 * Adds the status items the core keeps for the plugin, such as the depth of its send queue and the number
+	 * of messages dropped from it, to the items about to be written.
+	 */
+	void addCoreStatusItems(std::map<std::string, std::string> &updateItems, std::set<std::string> &removeItems);
+
 private:
 	void receiverThread(void);
+	void sharedMemoryReceiverThread(void);
 	void fastProcessorThread(void);
 	void slowProcessorThread(void);
+	void senderThread(void);
+
+	void queueMessage(IvpMessage *msg);
+	void queueOutgoingMessage(EncodedMessage &encoded);
+	bool isLocalConnection();
+	void openSharedMemory();
+	void closeSharedMemory();
+	void writeFrame(OutgoingFrame &frame);
 
 	void processRegistrationMessage(IvpMessage *msg);
 	void processSubscribeMessage(IvpMessage *msg);
 	void processConfigMessage(IvpMessage *msg);
-	void processStatusMessage(IvpMessage *msg);
+	void mergeStatusMessage(IvpMessage *msg, std::map<std::string, std::string> &updateItems, std::set<std::string> &removeItems);
 	void processEventLogMessage(IvpMessage *msg);
 
 	boost::thread mReceiverThread;
@@ -56,6 +94,30 @@ private:
 	boost::thread mSlowProcessorThread;
 	int mSocket;
 
+	/*!
+	 * Set when the plugin registered with IvpMsgFlags_BinaryFraming, so messages are sent to it
+	 * as binary frames instead of JSON.
+	 */
+	std::atomic<bool> mBinaryFraming;
+
+	/*!
+	 * The rings used instead of the socket once the plugin has been moved to shared memory.
+	 * Only accessed with std::atomic_load and std::atomic_store, since messages are sent from any router thread.
+	 */
+	std::shared_ptr<ShmRing> mSharedMemorySend;
+	std::shared_ptr<ShmRing> mSharedMemoryReceive;
+	boost::thread mSharedMemoryReceiverThread;
+
+	/*!
+	 * Used to give each pair of rings a unique name.
+	 */
+	static std::atomic<unsigned int> SharedMemoryCount;
+
+	/*!
+	 * The number of messages dropped because the plugin did not make room for them in the send ring in time.
+	 */
+	std::atomic<uint64_t> mSharedMemoryDrops;
+
 	AutoResetEvent mEventContinueFastProcessor;
 	boost::mutex mMutexFastMessageQueue;
 	std::queue<IvpMessage*> mFastMessageQueue;
@@ -64,6 +126,26 @@ private:
 	std::queue<IvpMessage*> mSlowMessageQueue;
 
 	AutoResetEvent mEventContinueSlowProcessor;
+
+	/*!
+	 * Messages routed to the plugin are encoded and queued here, then written by the sender thread,
+	 * so a plugin that is slow to read does not hold up the threads routing messages.
+	 */
+	SendQueue mSendQueue;
+	boost::thread mSenderThread;
+
+	/*!
+	 * Set when the slow processor thread should publish the send queue statistics as status items.
+	 */
+	std::atomic<bool> mSendQueueStatusPending;
+	std::atomic<uint64_t> mLastSendQueueStatus;
+
+	/*!
+	 * The number of status messages received from the plugin, and the number of times the status items merged
+	 * from them were written to the database.  Only used by the slow processor thread.
+	 */
+	uint64_t mStatusMessageCount;
+	uint64_t mStatusWriteCount;
 };
 
 #endif /* PLUGINCONNECTION_H_ */
@@ -170,27 +170,50 @@ std::map<std::string, PluginConfigurationParameterEntry> ConfigContext::getPlugi
 	return results;
 }
 
-void ConfigContext::updatePluginConfigParameterValue(const PluginConfigurationParameterEntry &entry)
+// Returns the parameters of every plugin, keyed by plugin id.  The global parameters are under plugin id 0.
+std::map<unsigned int, std::map<std::string, PluginConfigurationParameterEntry> > ConfigContext::getAllPluginConfigParameters()
 {
+	map<unsigned int, map<string, PluginConfigurationParameterEntry> > results;
+
 	std::unique_ptr<sql::Statement> stmt(this->getStatement());
 
-	//affected_rows = stmt->executeUpdate("UPDATE test SET label = 'y' WHERE id = 100");
+	std::unique_ptr< sql::ResultSet > rset(stmt->executeQuery("SELECT * FROM `pluginConfigurationParameter`;"));
+	while(rset->next())
+	{
+		PluginConfigurationParameterEntry entry;
 
-	stringstream query;
-	query << "UPDATE `pluginConfigurationParameter` SET `value` = '";
-	query << DbContext::formatStringValue(entry.value);
-	query << "' WHERE `id` = '";
-	query << entry.id;
-	query << "';";
-	/*
-	query << "' WHERE `pluginId` = '";
-	query << entry.pluginId;
-	query << "' AND `key` = '";
-	query << entry.key;
-	query << "';";
-	 */
+		entry.id = rset->getUInt("id");
+		entry.pluginId = rset->getUInt("pluginId");
+		entry.key = rset->getString("key");
+		entry.value = rset->getString("value");
+		entry.defaultValue = rset->getString("defaultValue");
+
+		results[entry.pluginId][entry.key] = entry;
+	}
+
+	return results;
+}
+
+// Returns a checksum of the contents of the plugin configuration table, which changes whenever
+// any parameter is added, removed or updated, by the core or any other tool.
+uint64_t ConfigContext::getPluginConfigChecksum()
+{
+	std::unique_ptr<sql::Statement> stmt(this->getStatement());
+
+	std::unique_ptr< sql::ResultSet > rset(stmt->executeQuery("CHECKSUM TABLE `pluginConfigurationParameter`;"));
+	if (rset->next())
+		return rset->getUInt64("Checksum");
+
+	return 0;
+}
+
+void ConfigContext::updatePluginConfigParameterValue(const PluginConfigurationParameterEntry &entry)
+{
+	sql::PreparedStatement *stmt = this->getPreparedStatement("UPDATE `pluginConfigurationParameter` SET `value` = ? WHERE `id` = ?;");
 
-	stmt->executeUpdate(query.str());
+	stmt->setString(1, entry.value);
+	stmt->setUInt(2, entry.id);
+	stmt->executeUpdate();
 }
 
 
@@ -55,8 +55,25 @@ struct PluginConfigurationParameterEntry {
 	}
 };
 
+/*!
+ * Where the ConfigCache reads the plugin configuration parameters from.  Implemented by ConfigContext, and by a
+ * stub in the unit tests.
+ */
+class PluginConfigSource
+{
+public:
+	virtual ~PluginConfigSource() {}
+
+	virtual std::map<unsigned int, std::map<std::string, PluginConfigurationParameterEntry> > getAllPluginConfigParameters() = 0;
+	virtual uint64_t getPluginConfigChecksum() = 0;
+
+	/*!
+	 * Called after a DbException has been handled, before the source is destroyed.
+	 */
+	virtual void reportFailure() = 0;
+};
 
-class ConfigContext : public DbContext
+class ConfigContext : public DbContext, public PluginConfigSource
 {
 public:
 	ConfigContext();
@@ -68,8 +85,11 @@ public:
 
 	void initializePluginConfigParameters(unsigned int pluginId, std::vector<PluginConfigurationParameterEntry> &entries);
 	std::map<std::string, PluginConfigurationParameterEntry> getPluginConfigParameters(unsigned int pluginId);
+	std::map<unsigned int, std::map<std::string, PluginConfigurationParameterEntry> > getAllPluginConfigParameters();
+	uint64_t getPluginConfigChecksum();
 	void updatePluginConfigParameterValue(const PluginConfigurationParameterEntry &entry);
 
+	void reportFailure() { DbContext::reportFailure(); }
 
 };
 
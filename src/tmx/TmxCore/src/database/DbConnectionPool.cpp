@@ -0,0 +1,205 @@
+/*
+ * DbConnectionPool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "DbConnectionPool.h"
+#include "DbContext.h"
+#include <time.h>
+
+pthread_mutex_t DbConnectionPool::lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t DbConnectionPool::released = PTHREAD_COND_INITIALIZER;
+std::vector<PooledDbConnection *> DbConnectionPool::idle;
+size_t DbConnectionPool::size = 0;
+uint64_t DbConnectionPool::connectCount = 0;
+
+/*!
+ * The connection in use by the calling thread, and the number of its contexts using it.
+ */
+struct ThreadConnection
+{
+	PooledDbConnection *conn;
+	unsigned int refs;
+	bool failed;
+};
+
+static thread_local ThreadConnection threadConnection = { NULL, 0, false };
+
+PooledDbConnection *DbConnectionPool::acquire()
+{
+	// Contexts nested on the same thread share its connection, so a thread never waits on the pool while
+	// it is holding a connection.
+	if (threadConnection.conn)
+	{
+		threadConnection.refs++;
+		return threadConnection.conn;
+	}
+
+	threadConnection.conn = acquireIdleOrNew();
+	threadConnection.refs = 1;
+	threadConnection.failed = false;
+	return threadConnection.conn;
+}
+
+PooledDbConnection *DbConnectionPool::acquireIdleOrNew()
+{
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += DB_POOL_ACQUIRE_TIMEOUT_MS / 1000;
+
+	pthread_mutex_lock(&lock);
+
+	while (1)
+	{
+		if (!idle.empty())
+		{
+			PooledDbConnection *conn = idle.back();
+			idle.pop_back();
+			pthread_mutex_unlock(&lock);
+
+			// Checked outside of the lock, since it may go to the database.
+			if (isHealthy(conn, getMonotonicMillis()))
+				return conn;
+
+			discard(conn);
+			pthread_mutex_lock(&lock);
+			continue;
+		}
+
+		if (size < DB_POOL_MAX_CONNECTIONS)
+		{
+			// Reserve the slot, then connect outside of the lock.
+			size++;
+			pthread_mutex_unlock(&lock);
+
+			try
+			{
+				return connect();
+			}
+			catch (...)
+			{
+				pthread_mutex_lock(&lock);
+				size--;
+				pthread_mutex_unlock(&lock);
+				pthread_cond_signal(&released);
+				throw;
+			}
+		}
+
+		if (pthread_cond_timedwait(&released, &lock, &deadline) != 0 && idle.empty() && size >= DB_POOL_MAX_CONNECTIONS)
+		{
+			pthread_mutex_unlock(&lock);
+			throw DbException("Timed out waiting for a database connection");
+		}
+	}
+}
+
+void DbConnectionPool::release(PooledDbConnection *conn, bool failed)
+{
+	if (conn == NULL || conn != threadConnection.conn)
+		return;
+
+	threadConnection.failed = threadConnection.failed || failed;
+	if (--threadConnection.refs > 0)
+		return;
+
+	failed = threadConnection.failed;
+	threadConnection.conn = NULL;
+
+	conn->lastUsedMs = getMonotonicMillis();
+	conn->suspect = conn->suspect || failed;
+
+	pthread_mutex_lock(&lock);
+	idle.push_back(conn);
+	pthread_mutex_unlock(&lock);
+	pthread_cond_signal(&released);
+}
+
+size_t DbConnectionPool::getSize()
+{
+	pthread_mutex_lock(&lock);
+	size_t result = size;
+	pthread_mutex_unlock(&lock);
+
+	return result;
+}
+
+uint64_t DbConnectionPool::getConnectCount()
+{
+	pthread_mutex_lock(&lock);
+	uint64_t result = connectCount;
+	pthread_mutex_unlock(&lock);
+
+	return result;
+}
+
+PooledDbConnection *DbConnectionPool::connect()
+{
+	std::unique_ptr<PooledDbConnection> conn(new PooledDbConnection());
+
+	sql::Driver *driver = sql::mysql::get_driver_instance();
+	conn->connection.reset(driver->connect(DbContext::ConnectionInformation.url,
+			DbContext::ConnectionInformation.username, DbContext::ConnectionInformation.password));
+
+	std::unique_ptr<sql::Statement> stmt(conn->connection->createStatement());
+	stmt->execute("USE " + DbContext::ConnectionInformation.db);
+
+	conn->lastUsedMs = getMonotonicMillis();
+	conn->suspect = false;
+
+	pthread_mutex_lock(&lock);
+	connectCount++;
+	pthread_mutex_unlock(&lock);
+
+	return conn.release();
+}
+
+bool DbConnectionPool::isHealthy(PooledDbConnection *conn, uint64_t now)
+{
+	if (!conn->suspect && now < conn->lastUsedMs + DB_POOL_VALIDATE_IDLE_MS)
+		return true;
+
+	try
+	{
+		if (conn->connection->isValid())
+		{
+			conn->suspect = false;
+			return true;
+		}
+	}
+	catch (DbException &e)
+	{
+	}
+
+	return false;
+}
+
+// Closes the connection and frees its slot, so the next acquire opens a new one.
+void DbConnectionPool::discard(PooledDbConnection *conn)
+{
+	try
+	{
+		// The statements have to be released before their connection.
+		conn->statements.clear();
+		conn->connection.reset();
+	}
+	catch (DbException &e)
+	{
+	}
+
+	delete conn;
+
+	pthread_mutex_lock(&lock);
+	size--;
+	pthread_mutex_unlock(&lock);
+	pthread_cond_signal(&released);
+}
+
+uint64_t DbConnectionPool::getMonotonicMillis()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,100 @@
+/*
+ * DbConnectionPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef DBCONNECTIONPOOL_H_
+#define DBCONNECTIONPOOL_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <cppconn/connection.h>
+#include <cppconn/prepared_statement.h>
+
+// The most connections the core keeps open to the database.
+#define DB_POOL_MAX_CONNECTIONS 8
+// How long to wait for a connection to be returned when all of them are in use.
+#define DB_POOL_ACQUIRE_TIMEOUT_MS 10000
+// Connections idle for longer than this are checked before being handed out.
+#define DB_POOL_VALIDATE_IDLE_MS 5000
+
+/*!
+ * An open connection owned by the pool, along with the statements prepared on it.
+ */
+struct PooledDbConnection
+{
+	std::unique_ptr<sql::Connection> connection;
+
+	/*!
+	 * Prepared statements by their SQL.  They are only valid on this connection.
+	 */
+	std::map<std::string, std::unique_ptr<sql::PreparedStatement> > statements;
+
+	uint64_t lastUsedMs;
+
+	/*!
+	 * Set when a statement failed while the connection was in use, so it is checked before it is used again.
+	 */
+	bool suspect;
+};
+
+/**
+ * \ingroup IVPCore
+ *
+ * A bounded pool of database connections shared by all of the database contexts in the core.
+ *
+ * -Connections are opened the first time they are needed and kept open, up to DB_POOL_MAX_CONNECTIONS.
+ *  Once they are all in use, acquire() waits for one to be released.
+ * -The most recently released connection is handed out first, so the extra connections are only used under load.
+ * -A thread holds one connection at a time.  Contexts created while another context is open on the same thread
+ *  share its connection, which goes back to the pool when the last of them is destroyed.
+ * -A connection that is suspect, or has been idle for DB_POOL_VALIDATE_IDLE_MS, is pinged before it is handed out,
+ *  and replaced with a new connection if the ping fails.
+ */
+class DbConnectionPool
+{
+public:
+	/*!
+	 * throws: DbException if a connection could not be opened, or none was released in time.
+	 */
+	static PooledDbConnection *acquire();
+
+	/*!
+	 * Return the connection to the pool, once every context on the thread using it has released it.
+	 *
+	 * @param failed True if a statement failed on the connection.
+	 */
+	static void release(PooledDbConnection *conn, bool failed);
+
+	/*!
+	 * @return The number of connections that are open, both idle and in use.
+	 */
+	static size_t getSize();
+
+	/*!
+	 * @return The number of times a connection has been opened to the database.
+	 */
+	static uint64_t getConnectCount();
+
+private:
+	static PooledDbConnection *acquireIdleOrNew();
+	static PooledDbConnection *connect();
+	static bool isHealthy(PooledDbConnection *conn, uint64_t now);
+	static void discard(PooledDbConnection *conn);
+	static uint64_t getMonotonicMillis();
+
+	static pthread_mutex_t lock;
+	static pthread_cond_t released;
+	static std::vector<PooledDbConnection *> idle;
+	static size_t size;
+	static uint64_t connectCount;
+};
+
+#endif /* DBCONNECTIONPOOL_H_ */
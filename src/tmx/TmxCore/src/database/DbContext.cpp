@@ -6,28 +6,39 @@
  */
 
 #include "DbContext.h"
+#include <exception>
 #include <sstream>
 
 DbConnectionInformation DbContext::ConnectionInformation;
 
-DbContext::DbContext()
+DbContext::DbContext() : mFailed(false)
 {
-	mDriver = sql::mysql::get_driver_instance();
-	mCon = std::unique_ptr< sql::Connection >(mDriver->connect(ConnectionInformation.url, ConnectionInformation.username, ConnectionInformation.password));
-
-	std::unique_ptr< sql::Statement > stmt(mCon->createStatement());
-
-	stmt->execute("USE " + ConnectionInformation.db);
+	mConnection = DbConnectionPool::acquire();
 }
 
 DbContext::~DbContext()
 {
+	// A context destroyed while an exception is propagating most likely had a statement fail.
+	DbConnectionPool::release(mConnection, mFailed || std::uncaught_exception());
+}
 
+void DbContext::reportFailure()
+{
+	mFailed = true;
 }
 
 sql::Statement *DbContext::getStatement()
 {
-	return mCon->createStatement();
+	return mConnection->connection->createStatement();
+}
+
+sql::PreparedStatement *DbContext::getPreparedStatement(const std::string &sql)
+{
+	std::unique_ptr<sql::PreparedStatement> &stmt = mConnection->statements[sql];
+	if (!stmt)
+		stmt.reset(mConnection->connection->prepareStatement(sql));
+
+	return stmt.get();
 }
 
 
@@ -20,6 +20,7 @@
 #include <cppconn/statement.h>
 #include "mysql_driver.h"
 #include "mysql_connection.h"
+#include "DbConnectionPool.h"
 
 
 struct DbConnectionInformation {
@@ -31,21 +32,40 @@ struct DbConnectionInformation {
 
 typedef sql::SQLException DbException;
 
+/*!
+ * Base class of the database contexts.  A context borrows a connection from the DbConnectionPool for its
+ * lifetime, so contexts are meant to be short lived.
+ */
 class DbContext {
 public:
 	virtual ~DbContext();
 
+	/*!
+	 * Mark the connection to be checked before it is used again, after a DbException has been handled.
+	 * Not needed when the context is destroyed by the exception unwinding.
+	 */
+	void reportFailure();
+
 	static DbConnectionInformation ConnectionInformation;
 protected:
 	DbContext();
 
 	sql::Statement *getStatement();
 
+	/*!
+	 * Returns a statement prepared from the SQL, which is kept with the connection and reused by later contexts.
+	 * The statement is owned by the connection and must not be deleted.
+	 */
+	sql::PreparedStatement *getPreparedStatement(const std::string &sql);
+
 	static std::string formatStringValue(std::string str);
 
 private:
-	sql::Driver *mDriver;
-	std::unique_ptr< sql::Connection > mCon;
+	DbContext(const DbContext&);
+	DbContext& operator=(const DbContext&); // non-copyable
+
+	PooledDbConnection *mConnection;
+	bool mFailed;
 };
 
 
@@ -26,14 +26,17 @@ void MessageContext::insertOrUpdateMessageActivity(MessageActivityEntry &entry)
 
 	// Insert or update messageActivity row.
 
-	std::unique_ptr<sql::Statement> stmt(this->getStatement());
-
-	stringstream query;
-	query << "INSERT INTO messageActivity (messageTypeId, pluginId, count, lastReceivedTimestamp, averageInterval)";
-	query << " VALUES ('" << entry.messageTypeId << "','" << entry.pluginId << "','" << entry.count << "','" << timestamp.str() << "','" << entry.averageInterval << "')";
-	query << " ON DUPLICATE KEY UPDATE count = VALUES(count), lastReceivedTimestamp = VALUES(lastReceivedTimestamp), averageInterval = VALUES(averageInterval)";
-
-	stmt->execute(query.str());
+	sql::PreparedStatement *stmt = this->getPreparedStatement(
+			"INSERT INTO messageActivity (messageTypeId, pluginId, count, lastReceivedTimestamp, averageInterval)"
+			" VALUES (?, ?, ?, ?, ?)"
+			" ON DUPLICATE KEY UPDATE count = VALUES(count), lastReceivedTimestamp = VALUES(lastReceivedTimestamp), averageInterval = VALUES(averageInterval)");
+
+	stmt->setUInt(1, entry.messageTypeId);
+	stmt->setUInt(2, entry.pluginId);
+	stmt->setUInt(3, entry.count);
+	stmt->setString(4, timestamp.str());
+	stmt->setUInt64(5, entry.averageInterval);
+	stmt->execute();
 
 	if (entry.pluginId != 0 && entry.messageTypeId != 0)
 		this->mapPluginToMessageType(entry.pluginId, entry.messageTypeId);
@@ -41,12 +44,13 @@ void MessageContext::insertOrUpdateMessageActivity(MessageActivityEntry &entry)
 	//TODO: this might not be required... make it optional?
 	// Query for id of row that was just inserted/updated.
 
-	query.clear();
-	query.str("");
-	query << "SELECT `id` FROM `messageActivity`";
-	query << " WHERE `messageActivity`.`messageTypeId` = '" << entry.messageTypeId << "' AND `messageActivity`.`pluginId` = '" << entry.pluginId << "'";
+	stmt = this->getPreparedStatement("SELECT `id` FROM `messageActivity`"
+			" WHERE `messageActivity`.`messageTypeId` = ? AND `messageActivity`.`pluginId` = ?");
 
-	std::unique_ptr<sql::ResultSet> rset(stmt->executeQuery(query.str()));
+	stmt->setUInt(1, entry.messageTypeId);
+	stmt->setUInt(2, entry.pluginId);
+
+	std::unique_ptr<sql::ResultSet> rset(stmt->executeQuery());
 	if (rset->next())
 	{
 		entry.id = rset->getUInt("id");
@@ -86,14 +90,12 @@ void MessageContext::insertMessageType(MessageTypeEntry &entry, bool updateDescr
 
 void MessageContext::mapPluginToMessageType(unsigned int pluginId, unsigned int messageTypeId)
 {
-	std::unique_ptr<sql::Statement> stmt(this->getStatement());
+	sql::PreparedStatement *stmt = this->getPreparedStatement(
+			"INSERT IGNORE INTO `pluginMessageMap` (`pluginId`, `messageTypeId`) VALUES (?, ?);");
 
-	stringstream query;
-	query << "INSERT IGNORE INTO `pluginMessageMap` (`pluginId`, `messageTypeId`)";
-	query << " VALUES ('" << pluginId << "','" << messageTypeId << "')";
-	query << ";";
-
-	stmt->execute(query.str());
+	stmt->setUInt(1, pluginId);
+	stmt->setUInt(2, messageTypeId);
+	stmt->execute();
 }
 
 std::set<MessageTypeEntry> MessageContext::getAllMessageTypes()
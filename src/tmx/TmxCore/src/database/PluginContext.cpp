@@ -101,46 +101,70 @@ void PluginContext::setStatusForAllPlugins(std::string status)
 
 void PluginContext::setPluginStatus(unsigned int pluginId, std::string status)
 {
-	std::unique_ptr<sql::Statement> stmt(this->getStatement());
+	sql::PreparedStatement *stmt = this->getPreparedStatement(
+			"INSERT INTO `pluginStatus` (`pluginId`,`key`,`value`) VALUES (?, '', ?) ON DUPLICATE KEY UPDATE value = VALUES(value);");
 
-	stringstream query;
-	query << "INSERT INTO `pluginStatus` (`pluginId`,`key`,`value`) VALUES ('" << pluginId << "', '', '" << DbContext::formatStringValue(status) << "') ON DUPLICATE KEY UPDATE value = VALUES(value);";
-	stmt->execute(query.str());
+	stmt->setUInt(1, pluginId);
+	stmt->setString(2, status);
+	stmt->execute();
 }
 
 void PluginContext::setPluginStatusItems(unsigned int pluginId, std::vector<PluginStatusItem> statusItems)
 {
-	std::unique_ptr<sql::Statement> stmt(this->getStatement());
-
 	if (statusItems.size() > 0)
 	{
+		// One statement is prepared for each number of items, which only varies by plugin.
 		stringstream query;
 		query << "INSERT INTO `pluginStatus` (`pluginId`,`key`,`value`) VALUES ";
 
-		bool first = true;
-		for(vector<PluginStatusItem>::iterator itr = statusItems.begin(); itr != statusItems.end(); itr++)
+		for (size_t i = 0; i < statusItems.size(); i++)
 		{
-			if (!first)
+			if (i > 0)
 				query << ", ";
-			query << "('" << pluginId << "', '" << DbContext::formatStringValue(itr->key) << "', '" << DbContext::formatStringValue(itr->value) << "')";
-			first = false;
+			query << "(?, ?, ?)";
 		}
 
 		query << " ON DUPLICATE KEY UPDATE value = VALUES(value);";
 
-		stmt->execute(query.str());
+		sql::PreparedStatement *stmt = this->getPreparedStatement(query.str());
+
+		unsigned int param = 1;
+		for(vector<PluginStatusItem>::iterator itr = statusItems.begin(); itr != statusItems.end(); itr++)
+		{
+			stmt->setUInt(param++, pluginId);
+			stmt->setString(param++, itr->key);
+			stmt->setString(param++, itr->value);
+		}
+
+		stmt->execute();
 	}
 }
 
 void PluginContext::removePluginStatusItems(unsigned int pluginId, std::vector<std::string> itemKeys)
 {
-	std::unique_ptr<sql::Statement> stmt(this->getStatement());
-
-	for(vector<string>::iterator itr = itemKeys.begin(); itr != itemKeys.end(); itr++)
+	if (itemKeys.size() > 0)
 	{
+		// All keys are removed in one statement, prepared for each number of keys.
 		stringstream query;
-		query << "DELETE FROM `pluginStatus` WHERE `pluginId` = '" << pluginId << "' AND `key` = '" << DbContext::formatStringValue(*itr) << "';";
-		stmt->execute(query.str());
+		query << "DELETE FROM `pluginStatus` WHERE `pluginId` = ? AND `key` IN (";
+
+		for (size_t i = 0; i < itemKeys.size(); i++)
+		{
+			if (i > 0)
+				query << ", ";
+			query << "?";
+		}
+
+		query << ");";
+
+		sql::PreparedStatement *stmt = this->getPreparedStatement(query.str());
+
+		unsigned int param = 1;
+		stmt->setUInt(param++, pluginId);
+		for(vector<string>::iterator itr = itemKeys.begin(); itr != itemKeys.end(); itr++)
+			stmt->setString(param++, *itr);
+
+		stmt->execute();
 	}
 }
 
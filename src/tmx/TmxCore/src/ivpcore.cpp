@@ -9,10 +9,12 @@
 #include "MessageRouterBasic.h"
 #include "PluginServer.h"
 #include "PluginConnection.h"
+#include "ConfigCache.h"
 #include "PluginMonitor.h"
 #include "MessageProfiler.h"
 #include "logger.h"
 #include "HistoryManager.h"
+#include "utils/StringUtils.h"
 
 #include "database/PluginContext.h"
 #include "database/ConfigContext.h"
@@ -31,6 +33,10 @@
 #include <boost/process.hpp>
 
 #define CONFIGKEY_LOG_FILE_NAME "LOG_FILE_NAME"
+#define CONFIGKEY_SHARED_MEMORY_TRANSPORT "SHARED_MEMORY_TRANSPORT"
+#define CONFIGKEY_SEND_QUEUE_CAPACITY "SEND_QUEUE_CAPACITY"
+#define CONFIGKEY_SEND_QUEUE_NEVER_DROP "SEND_QUEUE_NEVER_DROP"
+#define CONFIGKEY_CONFIG_CACHE_POLL_MS "CONFIG_CACHE_POLL_MS"
 
 sighandler_t oldsig_int;
 sighandler_t oldsig_kill;
@@ -167,10 +173,18 @@ int main()
 	oldsig_segv = signal(SIGSEGV, sig);
 
 	SystemConfigurationParameterEntry logFileName = SystemConfigurationParameterEntry(CONFIGKEY_LOG_FILE_NAME, "ivpcore.log");
+	SystemConfigurationParameterEntry sharedMemoryTransport = SystemConfigurationParameterEntry(CONFIGKEY_SHARED_MEMORY_TRANSPORT, "true");
+	SystemConfigurationParameterEntry sendQueueCapacity = SystemConfigurationParameterEntry(CONFIGKEY_SEND_QUEUE_CAPACITY, "1024");
+	SystemConfigurationParameterEntry sendQueueNeverDrop = SystemConfigurationParameterEntry(CONFIGKEY_SEND_QUEUE_NEVER_DROP, "");
+	SystemConfigurationParameterEntry configCachePollMs = SystemConfigurationParameterEntry(CONFIGKEY_CONFIG_CACHE_POLL_MS, std::to_string(CONFIG_CACHE_POLL_MS));
 
 	try {
 		ConfigContext ccontext;
 		ccontext.initializeSystemConfigParameter(&logFileName);
+		ccontext.initializeSystemConfigParameter(&sharedMemoryTransport);
+		ccontext.initializeSystemConfigParameter(&sendQueueCapacity);
+		ccontext.initializeSystemConfigParameter(&sendQueueNeverDrop);
+		ccontext.initializeSystemConfigParameter(&configCachePollMs);
 	} catch (DbException &e) {
 		dhlogging::Logger::getInstance(logFileName.value);
 		LOG_ERROR("Unable to initialize core configuration values [" << e.what() << "]");
@@ -195,6 +209,22 @@ int main()
 
 	addSystemDefinedMessageTypes();
 
+	PluginConnection::SharedMemoryEnabled = (sharedMemoryTransport.value == "true" || sharedMemoryTransport.value == "1");
+
+	// Messages waiting for each plugin are dropped oldest first past this capacity, except for the API messages
+	// and any of the comma separated message types listed as never to be dropped.
+	unsigned long capacity = strtoul(sendQueueCapacity.value.c_str(), NULL, 10);
+	if (capacity > 0)
+		PluginConnection::SendQueueCapacity = capacity;
+
+	std::vector<std::string> neverDropTypes = StringUtils::tokenize(sendQueueNeverDrop.value, ", ", true);
+	PluginConnection::SendQueueNeverDropTypes.insert(neverDropTypes.begin(), neverDropTypes.end());
+
+	// Changes to the plugin parameters made outside of the core are picked up within this interval.
+	unsigned long pollMs = strtoul(configCachePollMs.value.c_str(), NULL, 10);
+	if (pollMs > 0)
+		ConfigCache::PollIntervalMs = pollMs;
+
 	MessageRouterBasic messageRouter;
 	PluginServer pluginServer(&messageRouter);
 	PluginMonitor pluginMonitor(&messageRouter);
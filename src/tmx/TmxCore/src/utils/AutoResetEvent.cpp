@@ -6,6 +6,8 @@
  */
 
 #include "AutoResetEvent.h"
+#include <errno.h>
+#include <time.h>
 
 AutoResetEvent::AutoResetEvent(bool initial)
 	: _flag(initial)
@@ -39,6 +41,28 @@ bool AutoResetEvent::WaitOne()
 	return true;
 }
 
+bool AutoResetEvent::WaitOne(unsigned int timeoutMs)
+{
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeoutMs / 1000;
+	deadline.tv_nsec += (long)(timeoutMs % 1000) * 1000000;
+	if (deadline.tv_nsec >= 1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&_protect);
+	int result = 0;
+	while (!_flag && result != ETIMEDOUT)
+		result = pthread_cond_timedwait(&_signal, &_protect, &deadline);
+	bool signaled = _flag;
+	_flag = false;
+	pthread_mutex_unlock(&_protect);
+	return signaled;
+}
+
 AutoResetEvent::~AutoResetEvent()
 {
 	pthread_mutex_destroy(&_protect);
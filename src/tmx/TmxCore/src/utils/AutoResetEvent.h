@@ -21,6 +21,13 @@ public:
 	void Reset();
 	bool WaitOne();
 
+	/*!
+	 * Wait until the event is set or the timeout expires.
+	 *
+	 * @return False if the timeout expired first.
+	 */
+	bool WaitOne(unsigned int timeoutMs);
+
 private:
 	AutoResetEvent(const AutoResetEvent&);
 	AutoResetEvent& operator=(const AutoResetEvent&); // non-copyable
@@ -0,0 +1,55 @@
+/*
+ * EncodedMessage.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "EncodedMessage.h"
+#include <stdlib.h>
+#include <string.h>
+
+EncodedFrame::EncodedFrame(char *data, int length, MsgFramer_FrameType frameType) :
+	data(data), length(length), frameType(frameType)
+{
+}
+
+EncodedFrame::~EncodedFrame()
+{
+	if (data)
+		free(data);
+}
+
+EncodedMessage::EncodedMessage(IvpMessage *msg) :
+	mMessage(msg), mJsonEncoded(false), mBinaryEncoded(false)
+{
+}
+
+std::shared_ptr<const EncodedFrame> EncodedMessage::getFrame(MsgFramer_FrameType frameType)
+{
+	if (frameType == MsgFramer_FrameType_binary)
+	{
+		if (!mBinaryEncoded)
+		{
+			mBinaryEncoded = true;
+
+			int length = 0;
+			char *data = ivpMsg_createBinary(mMessage, &length);
+			if (data)
+				mBinaryFrame = std::make_shared<const EncodedFrame>(data, length, MsgFramer_FrameType_binary);
+		}
+
+		return mBinaryFrame;
+	}
+
+	if (!mJsonEncoded)
+	{
+		mJsonEncoded = true;
+
+		char *data = ivpMsg_createJsonString(mMessage, IvpMsg_FormatOptions_none);
+		if (data)
+			mJsonFrame = std::make_shared<const EncodedFrame>(data, strlen(data), MsgFramer_FrameType_json);
+	}
+
+	return mJsonFrame;
+}
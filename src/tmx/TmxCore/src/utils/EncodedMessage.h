@@ -0,0 +1,63 @@
+/*
+ * EncodedMessage.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef ENCODEDMESSAGE_H_
+#define ENCODEDMESSAGE_H_
+
+#include <memory>
+#include "tmx/IvpMessage.h"
+#include "tmx/utils/MsgFramer.h"
+
+/*!
+ * A message encoded in one of the frame formats.  Immutable once built, so it can be shared by any number of
+ * senders.  The data is freed when the last reference is released.
+ */
+struct EncodedFrame
+{
+	char *data;
+	int length;
+	MsgFramer_FrameType frameType;
+
+	EncodedFrame(char *data, int length, MsgFramer_FrameType frameType);
+	~EncodedFrame();
+
+private:
+	EncodedFrame(const EncodedFrame&);
+	EncodedFrame& operator=(const EncodedFrame&); // non-copyable
+};
+
+/*!
+ * A message being broadcast, along with its encoded frames.
+ *
+ * Each frame format is encoded the first time it is asked for, and the same frame is handed to every
+ * receiver after that, so a message sent to many plugins is only serialized once per format.
+ * Only used by the thread doing the broadcast, while the message is still valid.
+ */
+class EncodedMessage
+{
+public:
+	explicit EncodedMessage(IvpMessage *msg);
+
+	IvpMessage *getMessage() const { return mMessage; }
+
+	/*!
+	 * @return The message encoded in the frame format, or empty if it could not be encoded.
+	 */
+	std::shared_ptr<const EncodedFrame> getFrame(MsgFramer_FrameType frameType);
+
+private:
+	EncodedMessage(const EncodedMessage&);
+	EncodedMessage& operator=(const EncodedMessage&); // non-copyable
+
+	IvpMessage *mMessage;
+	std::shared_ptr<const EncodedFrame> mJsonFrame;
+	std::shared_ptr<const EncodedFrame> mBinaryFrame;
+	bool mJsonEncoded;
+	bool mBinaryEncoded;
+};
+
+#endif /* ENCODEDMESSAGE_H_ */
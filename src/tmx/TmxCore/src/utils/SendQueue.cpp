@@ -0,0 +1,114 @@
+/*
+ * SendQueue.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "SendQueue.h"
+#include <string.h>
+
+SendQueue::SendQueue(size_t capacity) :
+	mCapacity(capacity > 0 ? capacity : 1), mDrops(0), mClosed(false)
+{
+	pthread_mutex_init(&mLock, NULL);
+	pthread_cond_init(&mSignal, NULL);
+}
+
+SendQueue::~SendQueue()
+{
+	close();
+
+	pthread_cond_destroy(&mSignal);
+	pthread_mutex_destroy(&mLock);
+}
+
+bool SendQueue::push(const OutgoingFrame &frame)
+{
+	// Released after the lock, since it may be the last reference to the frame.
+	OutgoingFrame dropped = OutgoingFrame();
+	bool queued = true;
+
+	pthread_mutex_lock(&mLock);
+
+	if (mClosed)
+	{
+		queued = false;
+	}
+	else if (frame.droppable && mFrames.size() >= mCapacity)
+	{
+		// Make room by dropping the oldest frame that is allowed to be dropped.
+		std::deque<OutgoingFrame>::iterator oldest = mFrames.begin();
+		while (oldest != mFrames.end() && !oldest->droppable)
+			oldest++;
+
+		if (oldest != mFrames.end())
+		{
+			dropped = *oldest;
+			mFrames.erase(oldest);
+			mFrames.push_back(frame);
+		}
+
+		mDrops++;
+		queued = false;
+	}
+	else
+	{
+		mFrames.push_back(frame);
+	}
+
+	pthread_mutex_unlock(&mLock);
+	pthread_cond_signal(&mSignal);
+
+	return queued;
+}
+
+bool SendQueue::popAll(std::deque<OutgoingFrame> &frames)
+{
+	pthread_mutex_lock(&mLock);
+
+	while (mFrames.empty() && !mClosed)
+		pthread_cond_wait(&mSignal, &mLock);
+
+	frames.swap(mFrames);
+	bool open = !mClosed || !frames.empty();
+
+	pthread_mutex_unlock(&mLock);
+
+	return open;
+}
+
+void SendQueue::close()
+{
+	std::deque<OutgoingFrame> frames;
+
+	pthread_mutex_lock(&mLock);
+	mClosed = true;
+	frames.swap(mFrames);
+	pthread_mutex_unlock(&mLock);
+	pthread_cond_broadcast(&mSignal);
+}
+
+size_t SendQueue::getDepth()
+{
+	pthread_mutex_lock(&mLock);
+	size_t depth = mFrames.size();
+	pthread_mutex_unlock(&mLock);
+
+	return depth;
+}
+
+uint64_t SendQueue::getDrops()
+{
+	pthread_mutex_lock(&mLock);
+	uint64_t drops = mDrops;
+	pthread_mutex_unlock(&mLock);
+
+	return drops;
+}
+
+bool SendQueue::isDroppable(const char *type, const std::set<std::string> &neverDropTypes)
+{
+	return type != NULL && strncmp(type, "__", 2) != 0 &&
+			(neverDropTypes.empty() || neverDropTypes.count(type) == 0);
+}
@@ -0,0 +1,96 @@
+/*
+ * SendQueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef SENDQUEUE_H_
+#define SENDQUEUE_H_
+
+#include <deque>
+#include <memory>
+#include <pthread.h>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include "tmx/utils/ShmRing.h"
+#include "EncodedMessage.h"
+
+/*!
+ * A frame that has been encoded for a plugin and is waiting to be written to it.
+ */
+struct OutgoingFrame
+{
+	/*!
+	 * The encoded message, which may be shared with the queues of other plugins.
+	 */
+	std::shared_ptr<const EncodedFrame> frame;
+
+	/*!
+	 * The ring to write the frame to, or empty to write it to the socket.
+	 * Chosen when the frame is queued, so frames queued before a switch to shared memory still go out on the socket.
+	 */
+	std::shared_ptr<ShmRing> sharedMemory;
+
+	/*!
+	 * Whether the frame may be dropped to make room when the queue is full.
+	 */
+	bool droppable;
+};
+
+/*!
+ * A bounded queue of frames for one plugin, filled by any number of router threads and drained by
+ * the connection's sender thread.
+ *
+ * When the queue is at capacity, the oldest droppable frame is discarded to make room for a new droppable
+ * frame, so a plugin that falls behind gets the most recent data.  Frames that are not droppable, such as
+ * configuration and other API messages, are always queued, even past the capacity.
+ */
+class SendQueue
+{
+public:
+	explicit SendQueue(size_t capacity);
+	~SendQueue();
+
+	/*!
+	 * Add the frame to the end of the queue.  Once the queue is closed, the frame is released instead.
+	 *
+	 * @return False if the frame or an older frame was dropped.
+	 */
+	bool push(const OutgoingFrame &frame);
+
+	/*!
+	 * Wait for frames, then move everything that is queued into frames.
+	 *
+	 * @return False once the queue is closed and empty.
+	 */
+	bool popAll(std::deque<OutgoingFrame> &frames);
+
+	/*!
+	 * Stop accepting frames, release the ones still queued, and wake up popAll.
+	 */
+	void close();
+
+	size_t getDepth();
+	uint64_t getDrops();
+
+	/*!
+	 * Whether messages of the type may be dropped when a queue is full.  API messages, whose types start with
+	 * the reserved "__" prefix, and the never drop types are always queued.
+	 */
+	static bool isDroppable(const char *type, const std::set<std::string> &neverDropTypes);
+
+private:
+	SendQueue(const SendQueue&);
+	SendQueue& operator=(const SendQueue&); // non-copyable
+
+	const size_t mCapacity;
+	std::deque<OutgoingFrame> mFrames;
+	uint64_t mDrops;
+	bool mClosed;
+	pthread_mutex_t mLock;
+	pthread_cond_t mSignal;
+};
+
+#endif /* SENDQUEUE_H_ */
@@ -0,0 +1,178 @@
+/*
+ * ConfigCacheTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "ConfigCache.h"
+#include "MessageRouterBasic.h"
+#include "Plugin.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+/**
+ * Stands in for the configuration table.  Each source the cache opens on it counts as a database connection.
+ */
+class StubConfigDatabase {
+public:
+	PluginConfigSource *Open() {
+		connections++;
+		return new Source(*this);
+	}
+
+	void Set(unsigned int pluginId, const string &key, const string &value) {
+		lock_guard<mutex> lock(_lock);
+		PluginConfigurationParameterEntry entry(key, value);
+		entry.pluginId = pluginId;
+		_values[pluginId][key] = entry;
+		_checksum++;
+	}
+
+	atomic<unsigned int> connections { 0 };
+	atomic<uint64_t> checksumQueries { 0 };
+	atomic<uint64_t> reads { 0 };
+
+private:
+	class Source : public PluginConfigSource {
+	public:
+		Source(StubConfigDatabase &database) : _database(database) { }
+
+		map<unsigned int, map<string, PluginConfigurationParameterEntry> > getAllPluginConfigParameters() override {
+			lock_guard<mutex> lock(_database._lock);
+			_database.reads++;
+			return _database._values;
+		}
+
+		uint64_t getPluginConfigChecksum() override {
+			lock_guard<mutex> lock(_database._lock);
+			_database.checksumQueries++;
+			return _database._checksum;
+		}
+
+		void reportFailure() override { }
+
+	private:
+		StubConfigDatabase &_database;
+	};
+
+	mutex _lock;
+	map<unsigned int, map<string, PluginConfigurationParameterEntry> > _values;
+	uint64_t _checksum = 1;
+};
+
+/**
+ * Records the configuration values handed to it by the cache.
+ */
+class RecordingPlugin : public Plugin {
+public:
+	RecordingPlugin(MessageRouter *router) : Plugin(router) { }
+
+	bool WaitForValue(const string &key, const string &value, milliseconds timeout) {
+		unique_lock<mutex> lock(_lock);
+		return _changed.wait_for(lock, timeout, [&]() { return _values[key] == value; });
+	}
+
+protected:
+	void onConfigChanged(string key, string value) override {
+		lock_guard<mutex> lock(_lock);
+		_values[key] = value;
+		_changed.notify_all();
+	}
+
+private:
+	mutex _lock;
+	condition_variable _changed;
+	map<string, string> _values;
+};
+
+class ConfigCacheTest : public testing::Test {
+protected:
+	void SetUp() override {
+		_pollIntervalMs = ConfigCache::PollIntervalMs;
+	}
+
+	void TearDown() override {
+		ConfigCache::PollIntervalMs = _pollIntervalMs;
+	}
+
+	// Creates the plugins and waits until each has been handed its parameters
+	void AddPlugins(ConfigCache &cache, size_t count) {
+		for (unsigned int id = 1; id <= count; id++) {
+			_database.Set(id, "Id", to_string(id));
+			_plugins.emplace_back(new RecordingPlugin(&_router));
+			cache.addPlugin(_plugins.back().get(), id);
+		}
+
+		for (unsigned int id = 1; id <= count; id++)
+			ASSERT_TRUE(_plugins[id - 1]->WaitForValue("Id", to_string(id), seconds(2)));
+	}
+
+	ConfigCache::SourceFactory Factory() {
+		return [this]() { return _database.Open(); };
+	}
+
+	MessageRouterBasic _router;
+	StubConfigDatabase _database;
+	vector<unique_ptr<RecordingPlugin>> _plugins;
+	unsigned int _pollIntervalMs;
+};
+
+TEST_F(ConfigCacheTest, CoreChangesReachThePluginsWithin100Ms) {
+	ConfigCache::PollIntervalMs = CONFIG_CACHE_POLL_MS;
+	ConfigCache cache(Factory());
+	AddPlugins(cache, 25);
+
+	for (int i = 0; i < 20; i++) {
+		// A value set through the core invalidates the cache, as Plugin::setConfigValue does
+		string value = to_string(i);
+		steady_clock::time_point start = steady_clock::now();
+		_database.Set(0, "Global", value);
+		_database.Set(7, "Local", value);
+		cache.invalidate();
+
+		for (auto &plugin : _plugins)
+			ASSERT_TRUE(plugin->WaitForValue("Global", value, milliseconds(100))) << "change " << i;
+		ASSERT_TRUE(_plugins[6]->WaitForValue("Local", value, milliseconds(100))) << "change " << i;
+		EXPECT_LT(steady_clock::now() - start, milliseconds(100)) << "change " << i;
+	}
+
+	// A single connection served every plugin and change, and the parameters were only read when they changed
+	EXPECT_EQ(1u, _database.connections);
+	EXPECT_LE(_database.reads, 1u + 25 + 20);
+}
+
+TEST_F(ConfigCacheTest, DatabaseChangesAreSeenAtTheNextPoll) {
+	ConfigCache::PollIntervalMs = 100;
+	ConfigCache cache(Factory());
+	AddPlugins(cache, 5);
+
+	// A value changed outside of the core, without invalidating the cache
+	_database.Set(0, "Global", "external");
+	for (auto &plugin : _plugins)
+		EXPECT_TRUE(plugin->WaitForValue("Global", "external", milliseconds(100 + 100)));
+
+	// Polling an unchanged table does not read the parameters, or open another connection
+	uint64_t reads = _database.reads;
+	uint64_t queries = _database.checksumQueries;
+	this_thread::sleep_for(milliseconds(350));
+	EXPECT_GE(_database.checksumQueries, queries + 2);
+	EXPECT_EQ(reads, _database.reads);
+	EXPECT_EQ(1u, _database.connections);
+}
+
+} /* namespace unit_test */
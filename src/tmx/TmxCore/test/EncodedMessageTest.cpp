@@ -0,0 +1,111 @@
+/*
+ * EncodedMessageTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "utils/EncodedMessage.h"
+#include "utils/SendQueue.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+class EncodedMessageTest : public testing::Test {
+protected:
+	void SetUp() override {
+		// A BSM as the DSRC plugins forward it, with the UPER encoded message as a hex string
+		_bsm = ivpMsg_create("J2735", "BSM", "asn.1-uper/hexstring", IvpMsgFlags_RouteDSRC,
+				cJSON_CreateString("00142500400000000f0e35a4e900eb49d20000007fffffff8ffff080fdfa1fa1007fff8000960fa0"));
+		_bsm->source = strdup("DSRCImmediateForward");
+		_bsm->sourceId = 12;
+	}
+
+	void TearDown() override {
+		ivpMsg_destroy(_bsm);
+	}
+
+	IvpMessage *_bsm = NULL;
+};
+
+TEST_F(EncodedMessageTest, EachFormatIsEncodedOnce) {
+	EncodedMessage encoded(_bsm);
+
+	shared_ptr<const EncodedFrame> json = encoded.getFrame(MsgFramer_FrameType_json);
+	ASSERT_TRUE(json != NULL);
+	EXPECT_EQ(json, encoded.getFrame(MsgFramer_FrameType_json));
+
+	char *expected = ivpMsg_createJsonString(_bsm, IvpMsg_FormatOptions_none);
+	EXPECT_EQ(string(expected), string(json->data, json->length));
+	free(expected);
+
+	shared_ptr<const EncodedFrame> binary = encoded.getFrame(MsgFramer_FrameType_binary);
+	ASSERT_TRUE(binary != NULL);
+	EXPECT_EQ(binary, encoded.getFrame(MsgFramer_FrameType_binary));
+	EXPECT_EQ(MsgFramer_FrameType_binary, binary->frameType);
+	EXPECT_NE(json, binary);
+}
+
+/**
+ * The cost on the routing thread of handing a BSM to 1 to 20 plugin connections, when each connection encodes
+ * the message itself and when it is encoded once and the frame shared.  Disabled by default, run with
+ * --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+class EncodedMessageBenchmark : public EncodedMessageTest {
+protected:
+	static constexpr int Broadcasts = 20000;
+
+	// Returns the average time to queue one message for every subscriber, in nanoseconds
+	double Run(size_t subscribers, bool encodeOnce) {
+		vector<unique_ptr<SendQueue>> queues;
+		for (size_t i = 0; i < subscribers; i++)
+			queues.emplace_back(new SendQueue(1024));
+
+		deque<OutgoingFrame> sent;
+		auto start = steady_clock::now();
+		for (int i = 0; i < Broadcasts; i++) {
+			unique_ptr<EncodedMessage> shared(new EncodedMessage(_bsm));
+			for (auto &queue : queues) {
+				unique_ptr<EncodedMessage> own;
+				if (!encodeOnce)
+					own.reset(new EncodedMessage(_bsm));
+
+				OutgoingFrame frame;
+				frame.frame = (encodeOnce ? shared : own)->getFrame(MsgFramer_FrameType_json);
+				queue->push(frame);
+			}
+
+			// Stands in for the sender threads, so the queues do not fill up
+			if (i % 64 == 63) {
+				for (auto &queue : queues) {
+					queue->popAll(sent);
+					sent.clear();
+				}
+			}
+		}
+		return (double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / Broadcasts;
+	}
+};
+
+TEST_F(EncodedMessageBenchmark, DISABLED_FanOut) {
+	printf("  %-12s %18s %18s %8s\n", "subscribers", "per connection ns", "encode once ns", "speedup");
+	for (size_t subscribers : { 1, 5, 10, 20 }) {
+		double perConnection = Run(subscribers, false);
+		double once = Run(subscribers, true);
+		printf("  %-12zu %18.0f %18.0f %7.1fx\n", subscribers, perConnection, once, perConnection / once);
+		EXPECT_GT(once, 0);
+	}
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,126 @@
+/*
+ * MessageProfilerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "MessageProfiler.h"
+#include "MessageRouterBasic.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+/**
+ * A profiler that knows the BSM message type, so it does not go to the database.
+ */
+class UnregisteredProfiler : public MessageProfiler {
+public:
+	UnregisteredProfiler(MessageRouter *router) : MessageProfiler(router, MessageTypes()) { }
+
+private:
+	static set<MessageTypeEntry> MessageTypes() {
+		MessageTypeEntry bsm("J2735", "BSM");
+		bsm.id = 1;
+		return set<MessageTypeEntry> { bsm };
+	}
+};
+
+/**
+ * Hands every message to the profiler, as the router does once the profiler has subscribed to all messages.
+ */
+class ProfilerReceiver : public MessageReceiver {
+public:
+	ProfilerReceiver(MessageProfiler &profiler) : _profiler(profiler) { }
+
+	void receiveMessage(IvpMessage *msg) override {
+		_profiler.onMessageReceived(msg);
+	}
+
+private:
+	MessageProfiler &_profiler;
+};
+
+class NullReceiver : public MessageReceiver {
+public:
+	void receiveMessage(IvpMessage *msg) override { }
+};
+
+/**
+ * The cost of broadcasting a BSM to five plugins, with and without the profiler receiving every message, from one
+ * and from several threads.  Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+class MessageProfilerBenchmark : public testing::Test {
+protected:
+	static constexpr int Broadcasts = 500000;
+
+	// Returns the average time of one broadcast, in nanoseconds
+	static double Run(bool profilerEnabled, int threadCount) {
+		MessageRouterBasic router;
+		UnregisteredProfiler profiler(&router);
+		ProfilerReceiver profilerReceiver(profiler);
+
+		MessageFilterEntry bsmFilter;
+		bsmFilter.type = "J2735";
+		bsmFilter.subtype = "BSM";
+		vector<unique_ptr<NullReceiver>> plugins;
+		for (int i = 0; i < 5; i++) {
+			plugins.emplace_back(new NullReceiver());
+			router.registerReceiver(plugins.back().get(), vector<MessageFilterEntry> { bsmFilter });
+		}
+
+		MessageFilterEntry allFilter;
+		allFilter.type = "*";
+		if (profilerEnabled)
+			router.registerReceiver(&profilerReceiver, vector<MessageFilterEntry> { allFilter });
+
+		atomic<int64_t> totalNs(0);
+		vector<thread> threads;
+		for (int t = 0; t < threadCount; t++) {
+			threads.emplace_back([&, t]() {
+				IvpMessage *msg = ivpMsg_create("J2735", "BSM", IVP_ENCODING_JSON, IvpMsgFlags_None, NULL);
+				msg->source = strdup("Publisher");
+				msg->sourceId = 2 + t;
+
+				auto start = steady_clock::now();
+				for (int i = 0; i < Broadcasts / threadCount; i++)
+					router.broadcastMessage(NULL, msg);
+				totalNs += duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+				ivpMsg_destroy(msg);
+			});
+		}
+		for (auto &thread : threads)
+			thread.join();
+
+		if (profilerEnabled)
+			router.unregisterReceiver(&profilerReceiver);
+		for (auto &plugin : plugins)
+			router.unregisterReceiver(plugin.get());
+
+		return (double)totalNs / (Broadcasts / threadCount * threadCount);
+	}
+};
+
+TEST_F(MessageProfilerBenchmark, DISABLED_BroadcastCostWithAndWithoutProfiler) {
+	printf("  %-8s %16s %16s %10s\n", "threads", "disabled ns", "enabled ns", "overhead");
+	for (int threadCount : { 1, 4 }) {
+		double disabled = Run(false, threadCount);
+		double enabled = Run(true, threadCount);
+		printf("  %-8d %16.0f %16.0f %9.0f%%\n", threadCount, disabled, enabled, (enabled / disabled - 1) * 100);
+		EXPECT_GT(enabled, 0);
+	}
+}
+
+} /* namespace unit_test */
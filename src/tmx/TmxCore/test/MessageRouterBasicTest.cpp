@@ -0,0 +1,565 @@
+/*
+ * MessageRouterBasicTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "MessageRouterBasic.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+/**
+ * Counts the messages it receives.  Once told it has been unregistered, any message that still arrives is counted
+ * as late, so receivers are kept alive until the end of a test rather than deleted.
+ */
+class CountingReceiver : public MessageReceiver {
+public:
+	void receiveMessage(IvpMessage *msg) override {
+		received++;
+		if (unregistered)
+			late++;
+	}
+
+	atomic<uint64_t> received { 0 };
+	atomic<uint64_t> late { 0 };
+	atomic<bool> unregistered { false };
+};
+
+/**
+ * Blocks in receiveMessage until released.
+ */
+class BlockingReceiver : public MessageReceiver {
+public:
+	void receiveMessage(IvpMessage *msg) override {
+		unique_lock<mutex> lock(_lock);
+		_entered = true;
+		_changed.notify_all();
+		_changed.wait(lock, [this]() { return _released; });
+	}
+
+	void WaitUntilEntered() {
+		unique_lock<mutex> lock(_lock);
+		_changed.wait(lock, [this]() { return _entered; });
+	}
+
+	void Release() {
+		lock_guard<mutex> lock(_lock);
+		_released = true;
+		_changed.notify_all();
+	}
+
+private:
+	mutex _lock;
+	condition_variable _changed;
+	bool _entered = false;
+	bool _released = false;
+};
+
+class MessageRouterBasicTest : public testing::Test {
+protected:
+	void SetUp() override {
+		_bsm = ivpMsg_create("J2735", "BSM", "bytearray/hexstring", IvpMsgFlags_None, NULL);
+	}
+
+	void TearDown() override {
+		ivpMsg_destroy(_bsm);
+	}
+
+	static vector<MessageFilterEntry> Filters(const vector<pair<string, string>> &types) {
+		vector<MessageFilterEntry> filters;
+		for (auto &type : types) {
+			MessageFilterEntry filter;
+			filter.type = type.first;
+			filter.subtype = type.second;
+			filters.push_back(filter);
+		}
+		return filters;
+	}
+
+	static MessageFilterEntry Filter(const string &type, const string &subtype, IvpMsgFlags flagmask = 0) {
+		MessageFilterEntry filter;
+		filter.type = type;
+		filter.subtype = subtype;
+		filter.flagmask = flagmask;
+		return filter;
+	}
+
+	static vector<unique_ptr<CountingReceiver>> Receivers(size_t count) {
+		vector<unique_ptr<CountingReceiver>> receivers(count);
+		for (auto &receiver : receivers)
+			receiver.reset(new CountingReceiver());
+		return receivers;
+	}
+
+	// Broadcasts one message and returns which of the receivers got it, as letters
+	static string Recipients(MessageRouter &router, const vector<unique_ptr<CountingReceiver>> &receivers,
+			const char *type, const char *subtype, IvpMsgFlags flags = IvpMsgFlags_None, MessageReceiver *sender = NULL) {
+		vector<uint64_t> before;
+		for (auto &receiver : receivers)
+			before.push_back(receiver->received);
+
+		IvpMessage *msg = ivpMsg_create(type, subtype, "json", flags, NULL);
+		router.broadcastMessage(sender, msg);
+		ivpMsg_destroy(msg);
+
+		string recipients;
+		for (size_t i = 0; i < receivers.size(); i++) {
+			EXPECT_LE(receivers[i]->received - before[i], 1u) << "receiver " << i;
+			if (receivers[i]->received != before[i])
+				recipients += (char)('A' + i);
+		}
+		return recipients;
+	}
+
+	// The values must be sorted
+	static double Percentile(const vector<double> &values, double percent) {
+		if (values.empty())
+			return 0;
+		return values[min(values.size() - 1, (size_t)(values.size() * percent / 100))];
+	}
+
+	IvpMessage *_bsm = NULL;
+};
+
+TEST_F(MessageRouterBasicTest, UnregisterWaitsForBroadcastsInFlight) {
+	MessageRouterBasic router;
+	BlockingReceiver receiver;
+	router.registerReceiver(&receiver, Filters({ { "J2735", "BSM" } }));
+
+	thread broadcaster([&]() { router.broadcastMessage(NULL, _bsm); });
+	receiver.WaitUntilEntered();
+
+	atomic<bool> returned(false);
+	thread unregister([&]() {
+		router.unregisterReceiver(&receiver);
+		returned = true;
+	});
+
+	this_thread::sleep_for(milliseconds(50));
+	EXPECT_FALSE(returned);
+
+	receiver.Release();
+	unregister.join();
+	broadcaster.join();
+	EXPECT_TRUE(returned);
+}
+
+TEST_F(MessageRouterBasicTest, UnregisterKeepsWaitingAfterTheWarning) {
+	MessageRouterBasic::UnregisterWarnMs = 20;
+	MessageRouterBasic router;
+	BlockingReceiver receiver;
+	router.registerReceiver(&receiver, Filters({ { "J2735", "BSM" } }));
+
+	thread broadcaster([&]() { router.broadcastMessage(NULL, _bsm); });
+	receiver.WaitUntilEntered();
+
+	atomic<bool> returned(false);
+	thread unregister([&]() {
+		router.unregisterReceiver(&receiver);
+		returned = true;
+	});
+
+	this_thread::sleep_for(milliseconds(200));
+	EXPECT_FALSE(returned);
+
+	receiver.Release();
+	unregister.join();
+	broadcaster.join();
+	MessageRouterBasic::UnregisterWarnMs = MESSAGE_ROUTER_UNREGISTER_WARN_MS;
+	EXPECT_TRUE(returned);
+}
+
+/**
+ * The broadcast in flight uses a snapshot from before another receiver registered, so it is not the snapshot
+ * that the unregister replaces.  It can still reach the receiver, so the unregister must wait for it too.
+ */
+TEST_F(MessageRouterBasicTest, UnregisterWaitsForBroadcastsOnOlderSnapshots) {
+	MessageRouterBasic router;
+	BlockingReceiver receiver;
+	CountingReceiver other;
+	router.registerReceiver(&receiver, Filters({ { "J2735", "BSM" } }));
+
+	thread broadcaster([&]() { router.broadcastMessage(NULL, _bsm); });
+	receiver.WaitUntilEntered();
+	router.registerReceiver(&other, Filters({ { "J2735", "BSM" } }));
+
+	atomic<bool> returned(false);
+	thread unregister([&]() {
+		router.unregisterReceiver(&receiver);
+		returned = true;
+	});
+
+	this_thread::sleep_for(milliseconds(50));
+	EXPECT_FALSE(returned);
+
+	receiver.Release();
+	unregister.join();
+	broadcaster.join();
+	EXPECT_TRUE(returned);
+}
+
+/**
+ * Plugins register and unregister in a loop while BSMs are broadcast, as plugins restarting or changing their
+ * subscriptions would under load.  No message may reach a receiver after its unregister returns, and the receivers
+ * that stay registered must see every message.
+ */
+class MessageRouterBasicChurnTest : public MessageRouterBasicTest {
+protected:
+	static constexpr int Broadcasters = 2;
+	static constexpr int Churners = 2;
+
+	void Run(int ratePerBroadcaster, double seconds, bool print);
+};
+
+void MessageRouterBasicChurnTest::Run(int ratePerBroadcaster, double seconds, bool print) {
+	const int broadcastsEach = (int)(ratePerBroadcaster * seconds);
+
+	MessageRouterBasic router;
+	vector<unique_ptr<CountingReceiver>> steady(5);
+	for (auto &receiver : steady) {
+		receiver.reset(new CountingReceiver());
+		router.registerReceiver(receiver.get(), Filters({ { "J2735", "BSM" }, { "J2735", "SPAT-P" } }));
+	}
+
+	atomic<bool> broadcasting(true);
+	vector<vector<double>> broadcastUs(Broadcasters);
+	vector<thread> threads;
+	for (int b = 0; b < Broadcasters; b++) {
+		threads.emplace_back([&, b]() {
+			IvpMessage *msg = ivpMsg_create("J2735", "BSM", "bytearray/hexstring", IvpMsgFlags_None, NULL);
+			auto start = steady_clock::now();
+			for (int i = 0; i < broadcastsEach; i++) {
+				this_thread::sleep_until(start + nanoseconds(1000000000LL / ratePerBroadcaster) * i);
+				auto before = steady_clock::now();
+				router.broadcastMessage(NULL, msg);
+				broadcastUs[b].push_back(duration<double, micro>(steady_clock::now() - before).count());
+			}
+			ivpMsg_destroy(msg);
+		});
+	}
+
+	vector<vector<double>> registerUs(Churners), unregisterUs(Churners);
+	vector<vector<unique_ptr<CountingReceiver>>> churned(Churners);
+	for (int c = 0; c < Churners; c++) {
+		threads.emplace_back([&, c]() {
+			while (broadcasting) {
+				CountingReceiver *receiver = new CountingReceiver();
+				churned[c].emplace_back(receiver);
+
+				auto before = steady_clock::now();
+				router.registerReceiver(receiver, Filters({ { "J2735", "*" }, { "Decoded", "Location" } }));
+				registerUs[c].push_back(duration<double, micro>(steady_clock::now() - before).count());
+
+				this_thread::sleep_for(microseconds(200));
+
+				before = steady_clock::now();
+				router.unregisterReceiver(receiver);
+				unregisterUs[c].push_back(duration<double, micro>(steady_clock::now() - before).count());
+				receiver->unregistered = true;
+			}
+		});
+	}
+
+	for (int b = 0; b < Broadcasters; b++)
+		threads[b].join();
+	broadcasting = false;
+	for (size_t t = Broadcasters; t < threads.size(); t++)
+		threads[t].join();
+
+	vector<double> broadcasts, registers, unregisters;
+	for (int b = 0; b < Broadcasters; b++)
+		broadcasts.insert(broadcasts.end(), broadcastUs[b].begin(), broadcastUs[b].end());
+	uint64_t late = 0, churnedCount = 0, churnedReceived = 0;
+	for (int c = 0; c < Churners; c++) {
+		registers.insert(registers.end(), registerUs[c].begin(), registerUs[c].end());
+		unregisters.insert(unregisters.end(), unregisterUs[c].begin(), unregisterUs[c].end());
+		for (auto &receiver : churned[c]) {
+			late += receiver->late;
+			churnedReceived += receiver->received;
+			churnedCount++;
+		}
+	}
+
+	EXPECT_EQ(0u, late);
+	EXPECT_GT(churnedCount, 0u);
+	for (auto &receiver : steady)
+		EXPECT_EQ((uint64_t)Broadcasters * broadcastsEach, receiver->received);
+
+	if (!print)
+		return;
+
+	printf("  %d broadcasts at %d/s, %lu register/unregister cycles, %lu messages to the cycling receivers\n",
+			Broadcasters * broadcastsEach, Broadcasters * ratePerBroadcaster,
+			(unsigned long)churnedCount, (unsigned long)churnedReceived);
+	for (auto latencies : { make_pair("broadcast", &broadcasts), make_pair("register", &registers), make_pair("unregister", &unregisters) }) {
+		sort(latencies.second->begin(), latencies.second->end());
+		printf("  %-12s p50 %7.2f us  p99 %7.2f us  p99.9 %7.2f us  max %8.2f us\n", latencies.first,
+				Percentile(*latencies.second, 50), Percentile(*latencies.second, 99), Percentile(*latencies.second, 99.9),
+				Percentile(*latencies.second, 100));
+	}
+}
+
+TEST_F(MessageRouterBasicChurnTest, RegisterAndUnregisterDuringBroadcasts) {
+	Run(5000, 0.25, false);
+}
+
+/**
+ * 50,000 messages a second for 2 seconds, with the latency of each operation.  Disabled by default, run with
+ * --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+TEST_F(MessageRouterBasicChurnTest, DISABLED_BenchmarkRegisterAndUnregisterDuringBroadcasts) {
+	Run(25000, 2, true);
+}
+
+TEST_F(MessageRouterBasicTest, MessagesGoToTheirTypeAndSubtype) {
+	MessageRouterBasic router;
+	auto receivers = Receivers(4);
+	router.registerReceiver(receivers[0].get(), Filters({ { "J2735", "BSM" } }));
+	router.registerReceiver(receivers[1].get(), Filters({ { "J2735", "SPAT-P" }, { "Decoded", "Location" } }));
+	router.registerReceiver(receivers[2].get(), Filters({ { "J2735", "*" } }));
+	router.registerReceiver(receivers[3].get(), Filters({ { "*", "*" } }));
+
+	EXPECT_EQ("ACD", Recipients(router, receivers, "J2735", "BSM"));
+	EXPECT_EQ("BCD", Recipients(router, receivers, "J2735", "SPAT-P"));
+	EXPECT_EQ("CD", Recipients(router, receivers, "J2735", "TIM"));
+	EXPECT_EQ("BD", Recipients(router, receivers, "Decoded", "Location"));
+	EXPECT_EQ("D", Recipients(router, receivers, "Decoded", "Other"));
+	EXPECT_EQ("D", Recipients(router, receivers, "Unknown", "BSM"));
+
+	// A message without a type or subtype only matches the wildcards that cover it
+	EXPECT_EQ("D", Recipients(router, receivers, NULL, "BSM"));
+	EXPECT_EQ("CD", Recipients(router, receivers, "J2735", NULL));
+}
+
+TEST_F(MessageRouterBasicTest, MessagesAreNotSentBackToTheSender) {
+	MessageRouterBasic router;
+	auto receivers = Receivers(2);
+	router.registerReceiver(receivers[0].get(), Filters({ { "J2735", "BSM" } }));
+	router.registerReceiver(receivers[1].get(), Filters({ { "*", "*" } }));
+
+	EXPECT_EQ("B", Recipients(router, receivers, "J2735", "BSM", IvpMsgFlags_None, receivers[0].get()));
+	EXPECT_EQ("A", Recipients(router, receivers, "J2735", "BSM", IvpMsgFlags_None, receivers[1].get()));
+}
+
+TEST_F(MessageRouterBasicTest, OverlappingFiltersDeliverOnceAndCombineFlags) {
+	MessageRouterBasic router;
+	auto receivers = Receivers(4);
+
+	// Every filter matches, but the message is only delivered once
+	router.registerReceiver(receivers[0].get(), Filters({ { "J2735", "BSM" }, { "J2735", "*" }, { "*", "*" } }));
+
+	// Either flag lets the message through
+	router.registerReceiver(receivers[1].get(), { Filter("J2735", "BSM", 0x01), Filter("J2735", "*", 0x02) });
+
+	// A filter without flags lets everything through
+	router.registerReceiver(receivers[2].get(), { Filter("J2735", "BSM", 0x01), Filter("*", "*") });
+	router.registerReceiver(receivers[3].get(), { Filter("*", "*", 0x04) });
+
+	EXPECT_EQ("AC", Recipients(router, receivers, "J2735", "BSM", 0x00));
+	EXPECT_EQ("ABC", Recipients(router, receivers, "J2735", "BSM", 0x01));
+	EXPECT_EQ("ABC", Recipients(router, receivers, "J2735", "BSM", 0x02));
+	EXPECT_EQ("ABCD", Recipients(router, receivers, "J2735", "BSM", 0x06));
+	EXPECT_EQ("ABC", Recipients(router, receivers, "J2735", "TIM", 0x02));
+	EXPECT_EQ("AC", Recipients(router, receivers, "J2735", "TIM", 0x01));
+}
+
+TEST_F(MessageRouterBasicTest, RegisteringAgainReplacesTheFilters) {
+	MessageRouterBasic router;
+	auto receivers = Receivers(1);
+	router.registerReceiver(receivers[0].get(), Filters({ { "J2735", "BSM" } }));
+	EXPECT_EQ("A", Recipients(router, receivers, "J2735", "BSM"));
+
+	router.registerReceiver(receivers[0].get(), Filters({ { "J2735", "SPAT-P" } }));
+	EXPECT_EQ("", Recipients(router, receivers, "J2735", "BSM"));
+	EXPECT_EQ("A", Recipients(router, receivers, "J2735", "SPAT-P"));
+
+	router.unregisterReceiver(receivers[0].get());
+	EXPECT_EQ("", Recipients(router, receivers, "J2735", "SPAT-P"));
+}
+
+/**
+ * The broadcast loop of the router before subscriptions were indexed: every filter of every receiver is compared
+ * against the message, with the register/unregister lock taken to count the broadcast in and out.
+ */
+class FilterScanRouter : public MessageRouter {
+public:
+	FilterScanRouter() {
+		pthread_mutexattr_t lockAttr;
+		pthread_mutexattr_init(&lockAttr);
+		pthread_mutexattr_settype(&lockAttr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&mMapLock, &lockAttr);
+		pthread_mutex_init(&mActiveBroadcastsLock, &lockAttr);
+	}
+
+	void broadcastMessage(MessageReceiver *sender, IvpMessage *msg) override {
+		pthread_mutex_lock(&mMapLock);
+		pthread_mutex_lock(&mActiveBroadcastsLock);
+		mActiveBroadcasts++;
+		pthread_mutex_unlock(&mActiveBroadcastsLock);
+		pthread_mutex_unlock(&mMapLock);
+
+		for (auto &receiverFilters : mReceiverMessageFilterEntryMap) {
+			if (sender == receiverFilters.first)
+				continue;
+
+			for (auto &filter : receiverFilters.second) {
+				bool matches = filter.type.compare("*") == 0 ||
+						(msg->type != NULL && filter.type.compare(msg->type) == 0 && (filter.subtype.compare("*") == 0
+								|| (msg->subtype != NULL && filter.subtype.compare(msg->subtype) == 0)));
+				if (matches && (!filter.flagmask || (filter.flagmask & msg->flags) > 0)) {
+					receiverFilters.first->receiveMessage(msg);
+					break;
+				}
+			}
+		}
+
+		pthread_mutex_lock(&mActiveBroadcastsLock);
+		mActiveBroadcasts--;
+		pthread_mutex_unlock(&mActiveBroadcastsLock);
+	}
+
+	void registerReceiver(MessageReceiver *receiver, const vector<MessageFilterEntry> &filters) override {
+		pthread_mutex_lock(&mMapLock);
+		mReceiverMessageFilterEntryMap[receiver] = filters;
+		pthread_mutex_unlock(&mMapLock);
+	}
+
+	void unregisterReceiver(MessageReceiver *receiver) override {
+		pthread_mutex_lock(&mMapLock);
+		mReceiverMessageFilterEntryMap.erase(receiver);
+		pthread_mutex_unlock(&mMapLock);
+	}
+
+private:
+	map<MessageReceiver *, vector<MessageFilterEntry> > mReceiverMessageFilterEntryMap;
+	pthread_mutex_t mMapLock;
+	pthread_mutex_t mActiveBroadcastsLock;
+	int mActiveBroadcasts = 0;
+};
+
+/**
+ * Random subscriptions, including wildcards and flag masks, must reach the same receivers through the index
+ * as through the filter scan.
+ */
+TEST_F(MessageRouterBasicTest, IndexMatchesTheFilterScan) {
+	static const vector<string> types = { "J2735", "Decoded", "Application", "*" };
+	static const vector<string> subtypes = { "BSM", "SPAT-P", "MAP-P", "Location", "*" };
+
+	mt19937 random(2026);
+	for (int round = 0; round < 50; round++) {
+		FilterScanRouter scanRouter;
+		MessageRouterBasic indexedRouter;
+		auto scanReceivers = Receivers(10);
+		auto indexedReceivers = Receivers(10);
+
+		for (size_t r = 0; r < scanReceivers.size(); r++) {
+			vector<MessageFilterEntry> filters;
+			for (int f = random() % 4; f > 0; f--)
+				filters.push_back(Filter(types[random() % types.size()], subtypes[random() % subtypes.size()], random() % 4));
+			scanRouter.registerReceiver(scanReceivers[r].get(), filters);
+			indexedRouter.registerReceiver(indexedReceivers[r].get(), filters);
+		}
+
+		for (size_t type = 0; type < types.size() - 1; type++) {
+			for (size_t subtype = 0; subtype < subtypes.size() - 1; subtype++) {
+				for (IvpMsgFlags flags = 0; flags < 4; flags++) {
+					EXPECT_EQ(Recipients(scanRouter, scanReceivers, types[type].c_str(), subtypes[subtype].c_str(), flags),
+							Recipients(indexedRouter, indexedReceivers, types[type].c_str(), subtypes[subtype].c_str(), flags))
+							<< "round " << round << ", " << types[type] << "/" << subtypes[subtype] << ", flags " << flags;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Broadcasts per second of a BSM through the filter scan and through the index.  Disabled by default, run with
+ * --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+class MessageRouterBasicBenchmark : public MessageRouterBasicTest {
+protected:
+	static constexpr int Broadcasts = 200000;
+
+	static double Run(MessageRouter &router, const vector<vector<pair<string, string>>> &subscriptions, IvpMessage *msg,
+			int broadcasts = Broadcasts) {
+		auto receivers = Receivers(subscriptions.size());
+		for (size_t i = 0; i < subscriptions.size(); i++)
+			router.registerReceiver(receivers[i].get(), Filters(subscriptions[i]));
+
+		auto start = steady_clock::now();
+		for (int i = 0; i < broadcasts; i++)
+			router.broadcastMessage(NULL, msg);
+		double seconds = duration<double>(steady_clock::now() - start).count();
+
+		for (auto &receiver : receivers)
+			router.unregisterReceiver(receiver.get());
+		return broadcasts / seconds;
+	}
+};
+
+/**
+ * 5, 25 and 100 plugins registered, each subscribed to four of the message types that the V2X Hub plugins
+ * commonly ask for, so about half of the plugins receive the BSM.
+ */
+TEST_F(MessageRouterBasicBenchmark, DISABLED_BroadcastsPerSecond) {
+	static const vector<pair<string, string>> types = { { "J2735", "SPAT-P" }, { "J2735", "MAP-P" }, { "J2735", "BSM" },
+			{ "Decoded", "Location" }, { "Application", "EventLog" }, { "J2735", "TIM" }, { "SIGCONT", "Status" }, { "J2735", "PSM" } };
+
+	printf("  %-10s %16s %16s %8s\n", "receivers", "filter scan/s", "indexed/s", "speedup");
+	for (int receiverCount : { 5, 25, 100 }) {
+		vector<vector<pair<string, string>>> subscriptions(receiverCount);
+		for (int i = 0; i < receiverCount; i++) {
+			for (int j = 0; j < 4; j++)
+				subscriptions[i].push_back(types[(i + j * 3) % types.size()]);
+		}
+
+		FilterScanRouter scanRouter;
+		MessageRouterBasic indexedRouter;
+		double scan = Run(scanRouter, subscriptions, _bsm);
+		double indexed = Run(indexedRouter, subscriptions, _bsm);
+		printf("  %-10d %16.0f %16.0f %7.1fx\n", receiverCount, scan, indexed, indexed / scan);
+		EXPECT_GT(indexed, 0);
+	}
+}
+
+/**
+ * 25 plugins with 1 to 50 filters each, on subtypes that no other plugin uses, and one plugin subscribed to BSMs.
+ * The filter scan compares the BSM with every filter, while the index only looks up the BSM.
+ */
+TEST_F(MessageRouterBasicBenchmark, DISABLED_BroadcastsPerSecondByFilterCount) {
+	printf("  %-18s %16s %16s %8s\n", "filters/receiver", "filter scan/s", "indexed/s", "speedup");
+	for (int filterCount : { 1, 10, 50 }) {
+		vector<vector<pair<string, string>>> subscriptions(25);
+		for (size_t i = 0; i < subscriptions.size(); i++) {
+			for (int j = 0; j < filterCount; j++)
+				subscriptions[i].push_back(make_pair("J2735", "Subtype" + to_string(i) + "_" + to_string(j)));
+		}
+		subscriptions[0].push_back(make_pair("J2735", "BSM"));
+
+		FilterScanRouter scanRouter;
+		MessageRouterBasic indexedRouter;
+		double scan = Run(scanRouter, subscriptions, _bsm, Broadcasts / 10);
+		double indexed = Run(indexedRouter, subscriptions, _bsm, Broadcasts / 10);
+		printf("  %-18d %16.0f %16.0f %7.1fx\n", filterCount, scan, indexed, indexed / scan);
+		EXPECT_GT(indexed, 0);
+	}
+}
+
+} /* namespace unit_test */
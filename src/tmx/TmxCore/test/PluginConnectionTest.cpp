@@ -0,0 +1,232 @@
+/*
+ * PluginConnectionTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "MessageRouterBasic.h"
+#include "PluginConnection.h"
+#include "utils/EncodedMessage.h"
+#include "tmx/utils/MsgFramer.h"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+/**
+ * Counts the connections that have deleted themselves, which they do once their socket is closed.  Each
+ * connection unregisters from its router as it is deleted.
+ */
+class DeletionCountingRouter : public MessageRouterBasic {
+public:
+	void unregisterReceiver(MessageReceiver *receiver) override {
+		MessageRouterBasic::unregisterReceiver(receiver);
+
+		lock_guard<mutex> lock(_lock);
+		_unregistered++;
+		_changed.notify_all();
+	}
+
+	bool WaitForUnregistered(unsigned int count, milliseconds timeout) {
+		unique_lock<mutex> lock(_lock);
+		return _changed.wait_for(lock, timeout, [&]() { return _unregistered >= count; });
+	}
+
+private:
+	mutex _lock;
+	condition_variable _changed;
+	unsigned int _unregistered = 0;
+};
+
+/**
+ * Exposes the status items the core keeps for the plugin.
+ */
+class StatusConnection : public PluginConnection {
+public:
+	StatusConnection(MessageRouter *router, int socket) : PluginConnection(router, socket) { }
+
+	map<string, string> CoreStatus() {
+		map<string, string> updateItems;
+		set<string> removeItems;
+		addCoreStatusItems(updateItems, removeItems);
+		return updateItems;
+	}
+};
+
+/**
+ * Reads the frames a connection sends to its plugin, and records the sequence number in each.
+ */
+class FrameReader {
+public:
+	FrameReader(int socket) : _socket(socket) { }
+
+	~FrameReader() {
+		msgFramer_destroy(&_framer);
+	}
+
+	// Reads until the socket has nothing more after the timeout, or is closed.
+	void ReadAll(milliseconds idleTimeout, function<void(int)> onSequence) {
+		struct timeval tv = { 0, (suseconds_t)duration_cast<microseconds>(idleTimeout).count() };
+		setsockopt(_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+		while (true) {
+			int count = recv(_socket, msgFramer_getBuf(&_framer), msgFramer_getBufLength(&_framer), 0);
+			if (count <= 0)
+				return;
+
+			msgFramer_incrementBufPos(&_framer, count);
+
+			char *frame;
+			int length;
+			MsgFramer_FrameType frameType;
+			while ((frame = msgFramer_getNextFrame(&_framer, &length, &frameType)) != NULL) {
+				IvpMessage *msg = ivpMsg_parse(frame);
+				ASSERT_TRUE(msg != NULL);
+				ASSERT_TRUE(msg->payload != NULL);
+				onSequence(msg->payload->valueint);
+				ivpMsg_destroy(msg);
+			}
+		}
+	}
+
+private:
+	int _socket;
+	MsgFramer _framer = MSG_FRAMER_INITIALIZER;
+};
+
+class PluginConnectionTest : public testing::Test {
+protected:
+	static void SetUpTestCase() {
+		// The connections write to sockets the test closes.
+		signal(SIGPIPE, SIG_IGN);
+	}
+
+	void SetUp() override {
+		_capacity = PluginConnection::SendQueueCapacity;
+		PluginConnection::SendQueueCapacity = SendQueueCapacity;
+	}
+
+	void TearDown() override {
+		PluginConnection::SendQueueCapacity = _capacity;
+	}
+
+	// Connects a plugin to the router over a socket pair, and returns the plugin's end.
+	StatusConnection *Connect(int &pluginSocket, int sendBufferSize = 0) {
+		int sockets[2];
+		EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+		if (sendBufferSize > 0)
+			setsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+
+		StatusConnection *connection = new StatusConnection(&_router, sockets[0]);
+		_connections.push_back(connection);
+
+		pluginSocket = sockets[1];
+		return connection;
+	}
+
+	// Hands a message to every connection, sharing the encoded frames between them as the router does
+	void Broadcast(int sequence) {
+		IvpMessage *msg = ivpMsg_create("Test", "Sequence", IVP_ENCODING_JSON, IvpMsgFlags_None, cJSON_CreateNumber(sequence));
+		EncodedMessage encoded(msg);
+		for (auto connection : _connections)
+			connection->receiveMessage(msg, encoded);
+		ivpMsg_destroy(msg);
+	}
+
+	static const size_t SendQueueCapacity = 64;
+
+	DeletionCountingRouter _router;
+	vector<StatusConnection *> _connections;
+	size_t _capacity;
+};
+
+TEST_F(PluginConnectionTest, StalledPluginDoesNotDelayTheOthers) {
+	const int count = 5000;
+
+	int stalledSocket, normalSocket;
+	StatusConnection *stalled = Connect(stalledSocket, 4096);
+	StatusConnection *normal = Connect(normalSocket);
+
+	vector<steady_clock::time_point> sentAt(count);
+	atomic<int> sent(0);
+	vector<int> normalReceived;
+	microseconds maxLatency(0);
+
+	thread reader([&]() {
+		FrameReader framer(normalSocket);
+		framer.ReadAll(milliseconds(500), [&](int sequence) {
+			ASSERT_LT(sequence, sent.load());
+			maxLatency = max(maxLatency, duration_cast<microseconds>(steady_clock::now() - sentAt[sequence]));
+			normalReceived.push_back(sequence);
+		});
+	});
+
+	// Paced so that the normal plugin keeps up, while the stalled plugin's socket and queue fill up
+	microseconds maxBroadcast(0);
+	for (int i = 0; i < count; i++) {
+		sentAt[i] = steady_clock::now();
+		sent = i + 1;
+		Broadcast(i);
+		maxBroadcast = max(maxBroadcast, duration_cast<microseconds>(steady_clock::now() - sentAt[i]));
+		this_thread::sleep_for(microseconds(50));
+	}
+
+	reader.join();
+
+	// Every message reached the normal plugin, in order, without waiting on the stalled one
+	ASSERT_EQ((size_t)count, normalReceived.size());
+	for (int i = 0; i < count; i++)
+		ASSERT_EQ(i, normalReceived[i]);
+	EXPECT_LT(maxBroadcast.count(), 20000);
+	EXPECT_LT(maxLatency.count(), 100000);
+	EXPECT_EQ("0", normal->CoreStatus()["Core Send Queue Drops"]);
+	EXPECT_EQ("0", normal->CoreStatus()["Core Send Queue Depth"]);
+
+	// The stalled plugin's queue stayed within its capacity, with the messages past it dropped
+	map<string, string> status = stalled->CoreStatus();
+	size_t depth = stoul(status["Core Send Queue Depth"]);
+	uint64_t drops = stoull(status["Core Send Queue Drops"]);
+	EXPECT_GT(depth, 0u);
+	EXPECT_LE(depth, (size_t)SendQueueCapacity);
+	EXPECT_GT(drops, 0u);
+
+	// Once the plugin reads again, it gets the oldest messages that were already written to the socket and the
+	// newest ones that were still queued, and the ones dropped in between are gone
+	vector<int> stalledReceived;
+	FrameReader(stalledSocket).ReadAll(milliseconds(500), [&](int sequence) {
+		stalledReceived.push_back(sequence);
+	});
+
+	ASSERT_FALSE(stalledReceived.empty());
+	EXPECT_EQ(0, stalledReceived.front());
+	EXPECT_EQ(count - 1, stalledReceived.back());
+	EXPECT_TRUE(is_sorted(stalledReceived.begin(), stalledReceived.end()));
+	EXPECT_EQ(count - drops, stalledReceived.size());
+	EXPECT_EQ("0", stalled->CoreStatus()["Core Send Queue Depth"]);
+
+	// Closing the plugin's end of the socket deletes the connection
+	close(stalledSocket);
+	close(normalSocket);
+	EXPECT_TRUE(_router.WaitForUnregistered(2, seconds(5)));
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,163 @@
+/*
+ * SendQueueTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include "utils/SendQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+class SendQueueTest : public testing::Test {
+protected:
+	// A frame whose contents are its name, so the order of the queue can be checked
+	static OutgoingFrame Frame(const string &name, bool droppable = true) {
+		OutgoingFrame frame;
+		frame.frame = make_shared<const EncodedFrame>(strdup(name.c_str()), name.size(), MsgFramer_FrameType_json);
+		frame.droppable = droppable;
+		return frame;
+	}
+
+	static string Names(const deque<OutgoingFrame> &frames) {
+		string names;
+		for (auto &frame : frames)
+			names += (names.empty() ? "" : " ") + string(frame.frame->data, frame.frame->length);
+		return names;
+	}
+
+	static string PopAll(SendQueue &queue) {
+		deque<OutgoingFrame> frames;
+		EXPECT_TRUE(queue.popAll(frames));
+		return Names(frames);
+	}
+};
+
+TEST_F(SendQueueTest, OldestFramesAreDroppedPastCapacity) {
+	SendQueue queue(3);
+	EXPECT_TRUE(queue.push(Frame("1")));
+	EXPECT_TRUE(queue.push(Frame("2")));
+	EXPECT_TRUE(queue.push(Frame("3")));
+	EXPECT_EQ(3u, queue.getDepth());
+	EXPECT_EQ(0u, queue.getDrops());
+
+	EXPECT_FALSE(queue.push(Frame("4")));
+	EXPECT_FALSE(queue.push(Frame("5")));
+	EXPECT_EQ(3u, queue.getDepth());
+	EXPECT_EQ(2u, queue.getDrops());
+
+	EXPECT_EQ("3 4 5", PopAll(queue));
+	EXPECT_EQ(0u, queue.getDepth());
+
+	// The drop count is the total for the life of the queue
+	EXPECT_TRUE(queue.push(Frame("6")));
+	EXPECT_EQ(2u, queue.getDrops());
+}
+
+TEST_F(SendQueueTest, NeverDropFramesAreQueuedPastCapacity) {
+	SendQueue queue(2);
+	EXPECT_TRUE(queue.push(Frame("config1", false)));
+	EXPECT_TRUE(queue.push(Frame("config2", false)));
+	EXPECT_TRUE(queue.push(Frame("config3", false)));
+	EXPECT_EQ(3u, queue.getDepth());
+	EXPECT_EQ(0u, queue.getDrops());
+
+	// With nothing that can be dropped to make room, a droppable frame is dropped itself
+	EXPECT_FALSE(queue.push(Frame("bsm")));
+	EXPECT_EQ(3u, queue.getDepth());
+	EXPECT_EQ(1u, queue.getDrops());
+
+	EXPECT_EQ("config1 config2 config3", PopAll(queue));
+}
+
+TEST_F(SendQueueTest, DroppingSkipsOverNeverDropFrames) {
+	SendQueue queue(4);
+	queue.push(Frame("config1", false));
+	queue.push(Frame("bsm1"));
+	queue.push(Frame("config2", false));
+	queue.push(Frame("bsm2"));
+
+	EXPECT_FALSE(queue.push(Frame("bsm3")));
+	EXPECT_TRUE(queue.push(Frame("config3", false)));
+	EXPECT_EQ(1u, queue.getDrops());
+
+	EXPECT_EQ("config1 config2 bsm2 bsm3 config3", PopAll(queue));
+}
+
+TEST_F(SendQueueTest, DroppedFramesAreReleased) {
+	SendQueue queue(1);
+	OutgoingFrame first = Frame("1");
+	queue.push(first);
+	EXPECT_EQ(2, first.frame.use_count());
+
+	queue.push(Frame("2"));
+	EXPECT_EQ(1, first.frame.use_count());
+}
+
+TEST_F(SendQueueTest, ApiAndNeverDropTypesAreNotDroppable) {
+	set<string> none;
+	EXPECT_TRUE(SendQueue::isDroppable("J2735", none));
+	EXPECT_TRUE(SendQueue::isDroppable("_J2735", none));
+	EXPECT_FALSE(SendQueue::isDroppable("__config", none));
+	EXPECT_FALSE(SendQueue::isDroppable("__error", none));
+	EXPECT_FALSE(SendQueue::isDroppable(NULL, none));
+
+	set<string> neverDrop = { "SIGCONT", "Application" };
+	EXPECT_FALSE(SendQueue::isDroppable("SIGCONT", neverDrop));
+	EXPECT_FALSE(SendQueue::isDroppable("Application", neverDrop));
+	EXPECT_FALSE(SendQueue::isDroppable("__config", neverDrop));
+	EXPECT_TRUE(SendQueue::isDroppable("J2735", neverDrop));
+	EXPECT_TRUE(SendQueue::isDroppable("SIGCONTROL", neverDrop));
+}
+
+TEST_F(SendQueueTest, CloseWakesTheSender) {
+	SendQueue queue(4);
+
+	atomic<bool> waiting(true), open(true);
+	thread sender([&]() {
+		deque<OutgoingFrame> frames;
+		open = queue.popAll(frames);
+		waiting = false;
+	});
+
+	this_thread::sleep_for(milliseconds(20));
+	EXPECT_TRUE(waiting);
+
+	queue.close();
+	sender.join();
+	EXPECT_FALSE(open);
+}
+
+TEST_F(SendQueueTest, CloseReleasesTheQueuedFrames) {
+	SendQueue queue(4);
+	OutgoingFrame frame = Frame("1");
+	queue.push(frame);
+	queue.push(Frame("2", false));
+	EXPECT_EQ(2, frame.frame.use_count());
+
+	queue.close();
+	EXPECT_EQ(1, frame.frame.use_count());
+	EXPECT_EQ(0u, queue.getDepth());
+
+	// Nothing is queued after the close
+	EXPECT_FALSE(queue.push(frame));
+	EXPECT_EQ(1, frame.frame.use_count());
+
+	deque<OutgoingFrame> frames;
+	EXPECT_FALSE(queue.popAll(frames));
+	EXPECT_TRUE(frames.empty());
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,312 @@
+/*
+ * AsyncLog.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "AsyncLog.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <boost/lockfree/spsc_queue.hpp>
+
+namespace tmx {
+namespace utils {
+
+struct AsyncLog::Record
+{
+	Record(FILE *stream, LogMessage &msg): msg(std::move(msg)), stream(stream) { }
+
+	LogMessage msg;
+	FILE *stream;
+};
+
+struct AsyncLog::Buffer
+{
+	Buffer(size_t capacity): queue(capacity) { }
+
+	boost::lockfree::spsc_queue<Record *> queue;
+
+	// Set when the logging thread exits, after which nothing more is pushed
+	std::atomic<bool> closed{false};
+};
+
+// The buffers of the current thread in each log, closed when the thread exits
+struct AsyncLog::ThreadBuffers
+{
+	~ThreadBuffers()
+	{
+		for (auto &entry : buffers)
+			entry.second->closed = true;
+	}
+
+	std::vector<std::pair<uint64_t, std::shared_ptr<Buffer>>> buffers;
+};
+
+static std::atomic<uint64_t> nextLogId{0};
+
+AsyncLog::AsyncLog(size_t capacity, OverflowPolicy policy, std::chrono::milliseconds interval):
+		_id(++nextLogId), _capacity(capacity > 0 ? capacity : 1), _policy(policy), _interval(interval)
+{
+}
+
+AsyncLog::~AsyncLog()
+{
+	Stop();
+
+	std::lock_guard<std::mutex> lock(_buffersLock);
+	for (auto &buffer : _buffers)
+		buffer->queue.consume_all([](Record *record) { delete record; });
+}
+
+AsyncLog &AsyncLog::Instance()
+{
+	// Never destroyed, since other static objects may still log while the process exits
+	static AsyncLog *instance = []()
+	{
+		AsyncLog *log = new AsyncLog();
+		log->Start();
+		atexit([]() { AsyncLog::Instance().Stop(); });
+		return log;
+	}();
+
+	return *instance;
+}
+
+void AsyncLog::Start()
+{
+	Stop();
+
+	_running = true;
+	_thread = new std::thread(&AsyncLog::DoWork, this);
+}
+
+void AsyncLog::Stop()
+{
+	if (!_running.exchange(false))
+		return;
+
+	Wake();
+
+	_thread->join();
+	delete _thread;
+	_thread = NULL;
+
+	// Anything pushed while the thread was finishing
+	WritePending();
+}
+
+bool AsyncLog::IsRunning()
+{
+	return _running;
+}
+
+bool AsyncLog::Write(FILE *stream, LogMessage &msg)
+{
+	if (!_running)
+		return false;
+
+	LogLevel level = msg.level;
+	Record *record = new Record(stream, msg);
+
+	if (!Push(ThreadBuffer(), record))
+	{
+		delete record;
+		_drops++;
+		return false;
+	}
+
+	if (level <= logERROR)
+		Flush();
+
+	return true;
+}
+
+AsyncLog::Buffer &AsyncLog::ThreadBuffer()
+{
+	static thread_local ThreadBuffers local;
+
+	for (auto &entry : local.buffers)
+	{
+		if (entry.first == _id)
+			return *entry.second;
+	}
+
+	std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>(_capacity);
+	{
+		std::lock_guard<std::mutex> lock(_buffersLock);
+		_buffers.push_back(buffer);
+	}
+
+	local.buffers.emplace_back(_id, buffer);
+	return *buffer;
+}
+
+bool AsyncLog::Push(Buffer &buffer, Record *record)
+{
+	if (buffer.queue.push(record))
+	{
+		// Let messages collect into a batch until the interval is up, unless the queue is filling
+		if (_parked && buffer.queue.write_available() <= _capacity / 2)
+			Wake();
+
+		return true;
+	}
+
+	OverflowPolicy policy = _policy;
+	if (policy == Drop || (policy == DropDebug && record->msg.level >= logDEBUG))
+		return false;
+
+	// Apply back pressure until the background thread makes room
+	while (_running)
+	{
+		Wake();
+		std::this_thread::yield();
+
+		if (buffer.queue.push(record))
+			return true;
+	}
+
+	return false;
+}
+
+void AsyncLog::Wake()
+{
+	std::lock_guard<std::mutex> lock(_wakeLock);
+	_wake.notify_one();
+}
+
+void AsyncLog::Flush()
+{
+	if (!_running || !_thread || std::this_thread::get_id() == _thread->get_id())
+		return;
+
+	// A pass that is under way may have missed the latest messages, but the one after it will not
+	uint64_t target = _passes + 2;
+
+	std::unique_lock<std::mutex> lock(_wakeLock);
+	while (_passes < target && _running)
+	{
+		_wake.notify_one();
+		_written.wait_for(lock, std::chrono::milliseconds(10));
+	}
+}
+
+void AsyncLog::SetOverflowPolicy(OverflowPolicy policy)
+{
+	_policy = policy;
+}
+
+AsyncLog::OverflowPolicy AsyncLog::GetOverflowPolicy()
+{
+	return _policy;
+}
+
+uint64_t AsyncLog::GetWriteCount()
+{
+	return _writes;
+}
+
+uint64_t AsyncLog::GetDropCount()
+{
+	return _drops;
+}
+
+void AsyncLog::FormatLine(std::ostream &os, const LogMessage &msg)
+{
+	_logtime(os, msg.timestamp);
+	_logsource(os, msg.file, msg.line);
+	_loglevel(os, msg.level);
+	os << msg.log << '\n';
+}
+
+void AsyncLog::DoWork()
+{
+	while (_running)
+	{
+		if (WritePending())
+			continue;
+
+		std::unique_lock<std::mutex> lock(_wakeLock);
+		if (!_running)
+			break;
+
+		_parked = true;
+		_wake.wait_for(lock, _interval);
+		_parked = false;
+	}
+}
+
+bool AsyncLog::WritePending()
+{
+	std::vector<std::shared_ptr<Buffer>> buffers;
+	{
+		std::lock_guard<std::mutex> lock(_buffersLock);
+		buffers = _buffers;
+	}
+
+	std::vector<Record *> records;
+	bool removeClosed = false;
+
+	for (auto &buffer : buffers)
+	{
+		// Checked first, so that a closed buffer is known to be empty once it is consumed
+		bool closed = buffer->closed;
+		buffer->queue.consume_all([&records](Record *record) { records.push_back(record); });
+		removeClosed |= closed;
+	}
+
+	if (removeClosed)
+	{
+		std::lock_guard<std::mutex> lock(_buffersLock);
+		_buffers.erase(std::remove_if(_buffers.begin(), _buffers.end(),
+				[](const std::shared_ptr<Buffer> &buffer) { return buffer->closed && buffer->queue.read_available() == 0; }),
+				_buffers.end());
+	}
+
+	// Each thread's messages are already in order, so interleave the threads by time
+	std::stable_sort(records.begin(), records.end(),
+			[](const Record *a, const Record *b) { return a->msg.timestamp < b->msg.timestamp; });
+
+	uint64_t drops = _drops;
+	if (drops > _reportedDrops && !records.empty())
+	{
+		LogMessage notice(NULL, logWARNING, "", __FILE__, __LINE__);
+		notice.log = "Dropped " + std::to_string(drops - _reportedDrops) + " log messages";
+		records.insert(records.begin(), new Record(records.front()->stream, notice));
+		_reportedDrops = drops;
+	}
+
+	// Write a batch to each file in turn, flushing once at the end of each
+	for (size_t i = 0; i < records.size(); )
+	{
+		FILE *stream = records[i]->stream;
+
+		_batch.clear();
+		for (; i < records.size() && records[i]->stream == stream; i++)
+		{
+			_format.str("");
+			FormatLine(_format, records[i]->msg);
+			_batch.append(_format.str());
+		}
+
+		fwrite(_batch.data(), 1, _batch.size(), stream);
+		fflush(stream);
+	}
+
+	for (Record *record : records)
+		delete record;
+
+	_writes += records.size();
+
+	{
+		std::lock_guard<std::mutex> lock(_wakeLock);
+		_passes++;
+		_written.notify_all();
+	}
+
+	return !records.empty();
+}
+
+}} // namespace tmx::utils
@@ -0,0 +1,150 @@
+/*
+ * AsyncLog.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef SRC_ASYNCLOG_H_
+#define SRC_ASYNCLOG_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Logger.h"
+
+namespace tmx {
+namespace utils {
+
+/**
+ * Writes log messages to their files from a background thread, so that logging does not block the caller.
+ *
+ * Each logging thread gets its own lock-free queue, so callers never contend with each other or with the
+ * writer.  The caller only hands off the message.  The time, source and level prefix is formatted on the
+ * background thread, which writes everything queued since its last pass with one flush per file.
+ *
+ * Error messages are written before the call returns, so they are not lost if the process dies.
+ */
+class AsyncLog
+{
+public:
+	/**
+	 * What to do when the queue of a logging thread is full.
+	 */
+	enum OverflowPolicy
+	{
+		/// Wait for the background thread to make room
+		Block,
+		/// Drop the new message
+		Drop,
+		/// Drop new debug messages, wait for room for anything more important
+		DropDebug
+	};
+
+	/**
+	 * @param capacity The number of messages that can be queued by each logging thread.
+	 * @param policy What to do when the queue of a thread is full.
+	 * @param interval The longest time a message waits before being written, when the process is not busy logging.
+	 */
+	AsyncLog(size_t capacity = 8192, OverflowPolicy policy = DropDebug,
+			std::chrono::milliseconds interval = std::chrono::milliseconds(50));
+	virtual ~AsyncLog();
+
+	AsyncLog(const AsyncLog &) = delete;
+	AsyncLog &operator=(const AsyncLog &) = delete;
+
+	/**
+	 * @return The process wide instance used by FILE_LOG, which is started on first use and stopped at exit.
+	 */
+	static AsyncLog &Instance();
+
+	void Start();
+
+	/**
+	 * Write all queued messages and stop the background thread.  Messages written after this fail.
+	 */
+	void Stop();
+
+	/**
+	 * @return True if the background thread is running and messages can be written.
+	 */
+	bool IsRunning();
+
+	/**
+	 * Queue a message to be written to the given file.  The contents of the message are moved into the queue.
+	 *
+	 * @return False if the message was dropped, or the log is stopped.
+	 */
+	bool Write(FILE *stream, LogMessage &msg);
+
+	/**
+	 * Wait until everything queued so far has been written.
+	 */
+	void Flush();
+
+	void SetOverflowPolicy(OverflowPolicy policy);
+	OverflowPolicy GetOverflowPolicy();
+
+	/**
+	 * @return The number of messages written since the log was created.
+	 */
+	uint64_t GetWriteCount();
+
+	/**
+	 * @return The number of messages dropped since the log was created.
+	 */
+	uint64_t GetDropCount();
+
+	/**
+	 * Format the prefixed line for a message, as it is written to the log.
+	 */
+	static void FormatLine(std::ostream &os, const LogMessage &msg);
+
+private:
+	struct Record;
+	struct Buffer;
+	struct ThreadBuffers;
+
+	Buffer &ThreadBuffer();
+	bool Push(Buffer &buffer, Record *record);
+	void Wake();
+	void DoWork();
+	bool WritePending();
+
+	const uint64_t _id;
+	const size_t _capacity;
+	std::atomic<OverflowPolicy> _policy;
+	const std::chrono::milliseconds _interval;
+
+	// Only held to register the buffer of a new logging thread, and by the background thread to find them
+	std::mutex _buffersLock;
+	std::vector<std::shared_ptr<Buffer>> _buffers;
+
+	std::mutex _wakeLock;
+	std::condition_variable _wake;
+	std::condition_variable _written;
+	std::atomic<bool> _parked{false};
+	std::atomic<bool> _running{false};
+	std::thread *_thread = NULL;
+
+	std::atomic<uint64_t> _passes{0};
+	std::atomic<uint64_t> _writes{0};
+	std::atomic<uint64_t> _drops{0};
+	uint64_t _reportedDrops = 0;
+
+	// Used only by the background thread
+	std::ostringstream _format;
+	std::string _batch;
+};
+
+}} // namespace tmx::utils
+
+#endif /* SRC_ASYNCLOG_H_ */
@@ -1,9 +1,9 @@
-//
-//  base64 encoding and decoding with C++.
-//  Version: 1.01.00
-//
-//  Modified to add namespaces and convert to class
-//
+/*
+ * Base64.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
 
 #ifndef BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
 #define BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
@@ -13,15 +13,19 @@
 namespace tmx {
 namespace utils {
 
+/**
+ * Standard base64 encoding and decoding, using the vectorized codec from the API.
+ */
 class Base64
 {
-private:
-	static const std::string base64_chars;
 public:
 	static inline bool IsBase64(unsigned char c) {
 	  return (isalnum(c) || (c == '+') || (c == '/'));
 	}
 	static std::string Encode(unsigned char const* , unsigned int len);
+	/**
+	 * Decodes up to the first '=' or other character that is not in the alphabet.
+	 */
 	static std::string Decode(std::string const& s);
 };
 
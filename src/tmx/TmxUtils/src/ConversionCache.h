@@ -0,0 +1,317 @@
+/*
+ * ConversionCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef SRC_CONVERSIONCACHE_H_
+#define SRC_CONVERSIONCACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#define CONVERSION_CACHE_DEFAULT_CAPACITY 16
+#define CONVERSION_CACHE_DEFAULT_TTL_MS 10000
+
+namespace tmx {
+namespace utils {
+
+/**
+ * Remembers what an encoded message was converted to, such as its JSON or decoded structure,
+ * so that the conversion is not repeated for a message that is received again unchanged.
+ *
+ * Entries are found by the message type and the bytes of the encoded message, using a hash
+ * of the bytes.  The bytes are kept with each entry and compared on a lookup, so a hash
+ * collision is only a miss.  The least recently used entry is evicted once the cache is full,
+ * and each entry expires a fixed time after it was converted, which can be set per message
+ * type.  A time to live of zero turns off caching for that type.
+ *
+ * The cache may be shared between threads.  Converted values are handed out as shared
+ * pointers, which remain valid after their entry is evicted.
+ */
+template <typename Value, typename Clock = std::chrono::steady_clock>
+class ConversionCache
+{
+public:
+	typedef std::shared_ptr<const Value> ValuePtr;
+
+	/**
+	 * @param capacity The most entries to keep
+	 * @param ttl How long an entry is used for, for any type without its own time to live
+	 */
+	ConversionCache(size_t capacity = CONVERSION_CACHE_DEFAULT_CAPACITY,
+			std::chrono::milliseconds ttl = std::chrono::milliseconds(CONVERSION_CACHE_DEFAULT_TTL_MS)):
+		_capacity(capacity), _ttl(ttl) { }
+
+	/**
+	 * Find the value converted from the given bytes, if it has not expired.
+	 *
+	 * @param type The type of the message, such as its subtype
+	 * @param bytes The encoded message
+	 * @param length The number of bytes
+	 * @return The converted value, or an empty pointer if there is none
+	 */
+	ValuePtr Find(const std::string &type, const char *bytes, size_t length)
+	{
+		uint64_t hash = Hash(bytes, length, Hash(type.data(), type.size()));
+
+		std::lock_guard<std::mutex> lock(_lock);
+
+		auto it = _index.find(hash);
+		if (it != _index.end())
+		{
+			Entry &entry = *it->second;
+			if (entry.type == type && entry.bytes.size() == length && memcmp(entry.bytes.data(), bytes, length) == 0)
+			{
+				if (Clock::now() < entry.expires)
+				{
+					_entries.splice(_entries.begin(), _entries, it->second);
+					_hits++;
+					return entry.value;
+				}
+
+				_entries.erase(it->second);
+				_index.erase(it);
+			}
+		}
+
+		_misses++;
+		return ValuePtr();
+	}
+
+	/**
+	 * Remember the value converted from the given bytes, replacing any earlier value.
+	 *
+	 * @return The value to use
+	 */
+	ValuePtr Insert(const std::string &type, const char *bytes, size_t length, Value value)
+	{
+		ValuePtr converted = std::make_shared<const Value>(std::move(value));
+		uint64_t hash = Hash(bytes, length, Hash(type.data(), type.size()));
+
+		std::lock_guard<std::mutex> lock(_lock);
+
+		std::chrono::milliseconds ttl = FindTtl(type);
+		if (ttl.count() <= 0 || _capacity == 0)
+			return converted;
+
+		auto it = _index.find(hash);
+		if (it != _index.end())
+		{
+			_entries.erase(it->second);
+			_index.erase(it);
+		}
+
+		while (_entries.size() >= _capacity)
+		{
+			_index.erase(_entries.back().hash);
+			_entries.pop_back();
+			_evictions++;
+		}
+
+		_entries.push_front(Entry { hash, type, std::string(bytes, length), converted, Clock::now() + ttl });
+		_index[hash] = _entries.begin();
+
+		return converted;
+	}
+
+	/**
+	 * Find the value converted from the given bytes, or convert them and remember the result.
+	 * The conversion runs without the cache locked.
+	 *
+	 * @param convert A function that takes no arguments and returns the converted value
+	 * @param hit Set to whether the value was found
+	 * @return The converted value
+	 */
+	template <typename Converter>
+	ValuePtr Get(const std::string &type, const char *bytes, size_t length, Converter convert, bool *hit = NULL)
+	{
+		ValuePtr value = Find(type, bytes, length);
+		if (hit)
+			*hit = (bool)value;
+
+		if (value)
+			return value;
+
+		return Insert(type, bytes, length, convert());
+	}
+
+	/**
+	 * Set how long an entry is used for, for any type without its own time to live.
+	 */
+	void SetTtl(std::chrono::milliseconds ttl)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_ttl = ttl;
+	}
+
+	/**
+	 * Set how long an entry of the given type is used for.  Entries already in the cache
+	 * keep the time they were given.
+	 */
+	void SetTtl(const std::string &type, std::chrono::milliseconds ttl)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_typeTtl[type] = ttl;
+	}
+
+	std::chrono::milliseconds GetTtl(const std::string &type)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return FindTtl(type);
+	}
+
+	/**
+	 * Set the most entries to keep, evicting the least recently used until they fit.
+	 */
+	void SetCapacity(size_t capacity)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_capacity = capacity;
+
+		while (_entries.size() > _capacity)
+		{
+			_index.erase(_entries.back().hash);
+			_entries.pop_back();
+			_evictions++;
+		}
+	}
+
+	size_t GetCapacity()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _capacity;
+	}
+
+	size_t GetSize()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _entries.size();
+	}
+
+	/**
+	 * Remove all entries.  The counts are kept.
+	 */
+	void Clear()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_entries.clear();
+		_index.clear();
+	}
+
+	uint64_t GetHitCount()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _hits;
+	}
+
+	uint64_t GetMissCount()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _misses;
+	}
+
+	/**
+	 * @return The number of entries removed to make room for others
+	 */
+	uint64_t GetEvictionCount()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _evictions;
+	}
+
+	/**
+	 * @return The percentage of lookups that found a value, or 0 if there were none
+	 */
+	double GetHitRate()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		uint64_t lookups = _hits + _misses;
+		return lookups ? 100.0 * _hits / lookups : 0.0;
+	}
+
+	/**
+	 * A 64-bit hash of the bytes, using MurmurHash64A, which reads eight bytes at a time.
+	 */
+	static uint64_t Hash(const char *bytes, size_t length, uint64_t seed = 0)
+	{
+		static constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+		static constexpr int r = 47;
+
+		uint64_t h = seed ^ (length * m);
+
+		const char *end = bytes + (length & ~(size_t)7);
+		for (; bytes != end; bytes += 8)
+		{
+			uint64_t k;
+			memcpy(&k, bytes, sizeof(k));
+
+			k *= m;
+			k ^= k >> r;
+			k *= m;
+
+			h ^= k;
+			h *= m;
+		}
+
+		const unsigned char *tail = (const unsigned char *)bytes;
+		switch (length & 7)
+		{
+		case 7: h ^= (uint64_t)tail[6] << 48; // fall through
+		case 6: h ^= (uint64_t)tail[5] << 40; // fall through
+		case 5: h ^= (uint64_t)tail[4] << 32; // fall through
+		case 4: h ^= (uint64_t)tail[3] << 24; // fall through
+		case 3: h ^= (uint64_t)tail[2] << 16; // fall through
+		case 2: h ^= (uint64_t)tail[1] << 8;  // fall through
+		case 1: h ^= (uint64_t)tail[0];
+			h *= m;
+		}
+
+		h ^= h >> r;
+		h *= m;
+		h ^= h >> r;
+
+		return h;
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t hash;
+		std::string type;
+		std::string bytes;
+		ValuePtr value;
+		typename Clock::time_point expires;
+	};
+
+	std::chrono::milliseconds FindTtl(const std::string &type) const
+	{
+		auto it = _typeTtl.find(type);
+		return it == _typeTtl.end() ? _ttl : it->second;
+	}
+
+	std::mutex _lock;
+	size_t _capacity;
+	std::chrono::milliseconds _ttl;
+	std::map<std::string, std::chrono::milliseconds> _typeTtl;
+
+	// Most recently used first
+	std::list<Entry> _entries;
+	std::unordered_map<uint64_t, typename std::list<Entry>::iterator> _index;
+
+	uint64_t _hits = 0;
+	uint64_t _misses = 0;
+	uint64_t _evictions = 0;
+};
+
+}} // namespace tmx::utils
+
+#endif /* SRC_CONVERSIONCACHE_H_ */
@@ -0,0 +1,543 @@
+/*
+ * HttpClient.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "HttpClient.h"
+#include "PluginLog.h"
+
+#include <algorithm>
+#include <future>
+#include <curl/curl.h>
+
+namespace tmx {
+namespace utils {
+
+/**
+ * A reusable libcurl easy handle, along with the request it is currently working on.
+ * Keeping the easy handles around lets libcurl reuse the connection and DNS caches.
+ */
+struct HttpClient::Transfer
+{
+	CURL *Easy = NULL;
+	struct curl_slist *Headers = NULL;
+	Request Req;
+	HttpResponse Response;
+};
+
+static size_t WriteBody(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	static_cast<std::string *>(userdata)->append(ptr, size * nmemb);
+	return size * nmemb;
+}
+
+/**
+ * \brief Initialize the HTTP client and start the background transfer thread.
+ *
+ * \exception HttpClientRuntimeError
+ * The libcurl multi handle could not be created.
+ *
+ * \param[in] maxInFlight  The most requests that may be queued or in flight at once.
+ * \param[in] timeoutMs  The time allowed for each attempt at a request to complete, in milliseconds.
+ * \param[in] retryPolicy  When to send a failed request again.
+ */
+HttpClient::HttpClient(size_t maxInFlight, long timeoutMs, HttpRetryPolicy retryPolicy):
+	_maxInFlight(maxInFlight > 0 ? maxInFlight : 1),
+	_timeoutMs(timeoutMs),
+	_retryPolicy(retryPolicy),
+	_jitter(std::random_device()())
+{
+	static std::once_flag curlInit;
+	std::call_once(curlInit, []() { curl_global_init(CURL_GLOBAL_ALL); });
+
+	_multi = curl_multi_init();
+	if (!_multi)
+		throw HttpClientRuntimeError("Unable to create the curl multi handle");
+
+	curl_multi_setopt(_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+	curl_multi_setopt(_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)_maxInFlight);
+	curl_multi_setopt(_multi, CURLMOPT_MAXCONNECTS, (long)_maxInFlight);
+
+	_thread = std::thread(&HttpClient::Run, this);
+}
+
+HttpClient::ActiveCall::ActiveCall(HttpClient &client): _client(client)
+{
+	std::lock_guard<std::mutex> lock(_client._lock);
+	_client._activeCalls++;
+}
+
+HttpClient::ActiveCall::~ActiveCall()
+{
+	// Notified under the lock, since the destructor may free the client as soon as it is released
+	std::lock_guard<std::mutex> lock(_client._lock);
+	_client._activeCalls--;
+	_client._windowCond.notify_all();
+}
+
+/**
+ * \brief Stop the transfer thread and close all connections.
+ *
+ * Requests that have not completed, including those waiting to be retried, are dropped
+ * without invoking their callbacks.  Callers blocked in Send(), Execute() or Flush() are
+ * woken, and the client is not destroyed until they have returned.
+ */
+HttpClient::~HttpClient()
+{
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		_run = false;
+		curl_multi_wakeup(_multi);
+		_windowCond.notify_all();
+		_windowCond.wait(lock, [this]() { return _activeCalls == 0; });
+	}
+
+	if (_thread.joinable())
+		_thread.join();
+
+	for (Transfer *transfer : _transfers)
+	{
+		curl_multi_remove_handle(_multi, transfer->Easy);
+		curl_easy_cleanup(transfer->Easy);
+		curl_slist_free_all(transfer->Headers);
+		delete transfer;
+	}
+
+	curl_multi_cleanup(_multi);
+	_retries.clear();
+	_pending.clear();
+}
+
+/**
+ * \brief Queue a request.
+ *
+ * The request is sent on the background thread, and the callback is invoked there
+ * once the response arrives or the last attempt fails.  If the in flight window is
+ * full, then this blocks until another request completes, unless it is called from a
+ * completion callback.
+ *
+ * \param[in] method  The HTTP method.
+ * \param[in] url  The full URL to send to.
+ * \param[in] body  The request body, which is not sent for a GET.
+ * \param[in] callback  The function to invoke with the response.
+ * \param[in] contentType  The content type of the request body.
+ */
+void HttpClient::Send(const std::string &method, const std::string &url, const std::string &body,
+		Callback callback, const std::string &contentType)
+{
+	ActiveCall active(*this);
+	std::unique_lock<std::mutex> lock(_lock);
+
+	// Only the transfer thread makes room in the window, so a callback does not wait for it
+	if (std::this_thread::get_id() != _thread.get_id())
+		_windowCond.wait(lock, [this]() { return _inFlight < _maxInFlight || !_run; });
+
+	if (!_run)
+		return;
+
+	Queue(method, url, body, std::move(callback), contentType);
+}
+
+/**
+ * \brief Queue a request, unless the in flight window is full.
+ *
+ * This never blocks, so it suits callers that would rather drop a request than fall
+ * behind, such as those forwarding a message stream.  It may be called from a completion
+ * callback, but the window still applies there.
+ *
+ * \return True if the request was queued, or false if it was dropped and counted.
+ */
+bool HttpClient::TrySend(const std::string &method, const std::string &url, const std::string &body,
+		Callback callback, const std::string &contentType)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	if (!_run || _inFlight >= _maxInFlight)
+	{
+		_droppedCount++;
+		return false;
+	}
+
+	Queue(method, url, body, std::move(callback), contentType);
+	return true;
+}
+
+/**
+ * Add a request to the pending queue and wake up the transfer thread.  Must be called
+ * with _lock held, so the destructor can not have cleaned up the multi handle.
+ */
+void HttpClient::Queue(const std::string &method, const std::string &url, const std::string &body,
+		Callback callback, const std::string &contentType)
+{
+	_inFlight++;
+
+	Request request;
+	request.Method = method;
+	request.Url = url;
+	request.Body = body;
+	request.ContentType = contentType;
+	request.OnComplete = std::move(callback);
+	_pending.push_back(std::move(request));
+
+	curl_multi_wakeup(_multi);
+}
+
+void HttpClient::Post(const std::string &url, const std::string &body, Callback callback,
+		const std::string &contentType)
+{
+	Send("POST", url, body, std::move(callback), contentType);
+}
+
+void HttpClient::Get(const std::string &url, Callback callback)
+{
+	Send("GET", url, "", std::move(callback));
+}
+
+/**
+ * \brief Send a request and wait for its response.
+ *
+ * This must not be called from a completion callback, since the response could
+ * never arrive.
+ *
+ * \exception HttpClientRuntimeError
+ * Called from a completion callback.
+ *
+ * \return The response to the last attempt.  If the client is destroyed first, then
+ * the response has an error.
+ */
+HttpResponse HttpClient::Execute(const std::string &method, const std::string &url,
+		const std::string &body, const std::string &contentType)
+{
+	if (std::this_thread::get_id() == _thread.get_id())
+		throw HttpClientRuntimeError("Unable to wait for an HTTP response on the transfer thread");
+
+	ActiveCall active(*this);
+	auto promise = std::make_shared<std::promise<HttpResponse>>();
+	std::future<HttpResponse> result = promise->get_future();
+
+	Send(method, url, body, [promise](const HttpResponse &response) { promise->set_value(response); },
+			contentType);
+
+	// Wait in steps, so a request dropped at shutdown is not waited on forever
+	while (result.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready)
+	{
+		if (!_run)
+		{
+			HttpResponse response;
+			response.Error = "The HTTP client was stopped";
+			return response;
+		}
+	}
+
+	return result.get();
+}
+
+/**
+ * \return The number of requests that are queued or in flight.
+ */
+size_t HttpClient::GetInFlight()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _inFlight;
+}
+
+/**
+ * \return The most requests that may be queued or in flight at once.
+ */
+size_t HttpClient::GetMaxInFlight() const
+{
+	return _maxInFlight;
+}
+
+HttpRetryPolicy HttpClient::GetRetryPolicy() const
+{
+	return _retryPolicy;
+}
+
+uint64_t HttpClient::GetRetryCount() const
+{
+	return _retryCount;
+}
+
+uint64_t HttpClient::GetDroppedCount() const
+{
+	return _droppedCount;
+}
+
+void HttpClient::SetMinTlsVersion(HttpTlsVersion version)
+{
+	_minTlsVersion = version;
+}
+
+/**
+ * \exception HttpClientRuntimeError
+ * Called from a completion callback, where the requests could never complete.
+ */
+void HttpClient::Flush()
+{
+	if (std::this_thread::get_id() == _thread.get_id())
+		throw HttpClientRuntimeError("Unable to wait for HTTP requests on the transfer thread");
+
+	ActiveCall active(*this);
+	std::unique_lock<std::mutex> lock(_lock);
+	_windowCond.wait(lock, [this]() { return _inFlight == 0 || !_run; });
+}
+
+void HttpClient::Run()
+{
+	int running = 0;
+
+	while (_run)
+	{
+		StartTransfers();
+
+		curl_multi_perform(_multi, &running);
+
+		CURLMsg *msg;
+		int remaining;
+		while ((msg = curl_multi_info_read(_multi, &remaining)) != NULL)
+		{
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+
+			CURL *easy = msg->easy_handle;
+			int result = msg->data.result;
+
+			Transfer *transfer = NULL;
+			curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer);
+			curl_multi_remove_handle(_multi, easy);
+
+			if (transfer)
+				FinishTransfer(transfer, result);
+		}
+
+		curl_multi_poll(_multi, NULL, 0, PollTimeout(), NULL);
+	}
+}
+
+/**
+ * \return How long the transfer thread may wait for activity, in milliseconds, before
+ * the next retry is due.
+ */
+long HttpClient::PollTimeout() const
+{
+	static constexpr long idle = 100;
+
+	if (_retries.empty())
+		return idle;
+
+	auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+			_retries.begin()->first - std::chrono::steady_clock::now()).count();
+	return std::max(0L, std::min(idle, (long)wait));
+}
+
+/**
+ * Move the pending requests, and the retries that are due, onto easy handles and add
+ * them to the multi handle.  Only called from the transfer thread.
+ */
+void HttpClient::StartTransfers()
+{
+	std::deque<Request> requests;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		requests.swap(_pending);
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	while (!_retries.empty() && _retries.begin()->first <= now)
+	{
+		requests.push_back(std::move(_retries.begin()->second));
+		_retries.erase(_retries.begin());
+	}
+
+	for (Request &request : requests)
+		StartTransfer(request);
+}
+
+void HttpClient::StartTransfer(Request &request)
+{
+	Transfer *transfer;
+	if (_idle.empty())
+	{
+		transfer = new Transfer();
+		transfer->Easy = curl_easy_init();
+		if (!transfer->Easy)
+		{
+			delete transfer;
+
+			HttpResponse response;
+			response.Error = "Unable to create a curl easy handle";
+			response.Attempts = request.Attempts;
+			Complete(request, response);
+			return;
+		}
+
+		_transfers.push_back(transfer);
+	}
+	else
+	{
+		transfer = _idle.back();
+		_idle.pop_back();
+	}
+
+	request.Attempts++;
+	transfer->Req = std::move(request);
+	transfer->Response = HttpResponse();
+
+	CURL *easy = transfer->Easy;
+	const Request &req = transfer->Req;
+
+	// The easy handles are reused, so every option that differs between requests is set each time
+	if (req.Method == "GET")
+	{
+		curl_easy_setopt(easy, CURLOPT_HTTPGET, 1L);
+		curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, NULL);
+		transfer->Headers = NULL;
+	}
+	else
+	{
+		curl_easy_setopt(easy, CURLOPT_POSTFIELDS, req.Body.c_str());
+		curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, (long)req.Body.size());
+		curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, req.Method == "POST" ? NULL : req.Method.c_str());
+		transfer->Headers = curl_slist_append(NULL, ("Content-Type: " + req.ContentType).c_str());
+		transfer->Headers = curl_slist_append(transfer->Headers, "Expect:");
+	}
+
+	curl_easy_setopt(easy, CURLOPT_URL, req.Url.c_str());
+	curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->Headers);
+	curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, _timeoutMs);
+	curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+	curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+	switch (_minTlsVersion)
+	{
+	case HttpTlsVersion::TLSv1_2:
+		curl_easy_setopt(easy, CURLOPT_SSLVERSION, (long)CURL_SSLVERSION_TLSv1_2);
+		break;
+	case HttpTlsVersion::TLSv1_3:
+		curl_easy_setopt(easy, CURLOPT_SSLVERSION, (long)CURL_SSLVERSION_TLSv1_3);
+		break;
+	default:
+		curl_easy_setopt(easy, CURLOPT_SSLVERSION, (long)CURL_SSLVERSION_DEFAULT);
+		break;
+	}
+	curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteBody);
+	curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->Response.Body);
+	curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer);
+
+	curl_multi_add_handle(_multi, easy);
+}
+
+/**
+ * Complete the transfer, or schedule its retry, then return the easy handle to the idle list.
+ * Only called from the transfer thread.
+ */
+void HttpClient::FinishTransfer(Transfer *transfer, int result)
+{
+	HttpResponse &response = transfer->Response;
+	response.Attempts = transfer->Req.Attempts;
+
+	if (result == CURLE_OK)
+		curl_easy_getinfo(transfer->Easy, CURLINFO_RESPONSE_CODE, &response.Status);
+	else
+		response.Error = curl_easy_strerror((CURLcode)result);
+
+	curl_off_t retryAfter = 0;
+	if (result == CURLE_OK)
+		curl_easy_getinfo(transfer->Easy, CURLINFO_RETRY_AFTER, &retryAfter);
+
+	long requestSize = 0;
+	curl_easy_getinfo(transfer->Easy, CURLINFO_REQUEST_SIZE, &requestSize);
+
+	curl_slist_free_all(transfer->Headers);
+	transfer->Headers = NULL;
+
+	Request request = std::move(transfer->Req);
+	HttpResponse completed = std::move(response);
+	transfer->Req = Request();
+	transfer->Response = HttpResponse();
+	_idle.push_back(transfer);
+
+	if (ShouldRetry(request, result, completed.Status, requestSize > 0))
+	{
+		auto wait = Backoff(request.Attempts, std::chrono::seconds(retryAfter));
+		PLOG(logDEBUG) << request.Method << " " << request.Url << " attempt " << request.Attempts << " failed ("
+				<< (completed.Error.empty() ? std::to_string(completed.Status) : completed.Error)
+				<< "), retrying in " << wait.count() << " ms";
+
+		_retryCount++;
+		_retries.emplace(std::chrono::steady_clock::now() + wait, std::move(request));
+		return;
+	}
+
+	Complete(request, completed);
+}
+
+/**
+ * Invoke the callback of a request that is done, and free its place in the window.
+ * Only called from the transfer thread.
+ */
+void HttpClient::Complete(Request &request, const HttpResponse &response)
+{
+	try
+	{
+		if (request.OnComplete)
+			request.OnComplete(response);
+	}
+	catch (std::exception &ex)
+	{
+		PLOG(logERROR) << "HTTP completion for " << request.Url << " failed: " << ex.what();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_inFlight--;
+	}
+	_windowCond.notify_all();
+}
+
+bool HttpClient::ShouldRetry(const Request &request, int result, long status, bool sent) const
+{
+	if (request.Attempts >= _retryPolicy.MaxAttempts || !_run)
+		return false;
+
+	// The server may have acted on a request that was sent, even without answering it
+	if (sent && (request.Method == "POST" || request.Method == "PATCH"))
+		return false;
+
+	switch (result)
+	{
+	case CURLE_OK:
+		return status == 408 || status == 429 || status >= 500;
+	// Retrying cannot fix the request itself
+	case CURLE_UNSUPPORTED_PROTOCOL:
+	case CURLE_URL_MALFORMAT:
+	case CURLE_OUT_OF_MEMORY:
+	case CURLE_TOO_MANY_REDIRECTS:
+		return false;
+	default:
+		return true;
+	}
+}
+
+/**
+ * \return How long to wait before the next attempt, given the attempts made so far.
+ * Half of the wait is fixed, and the other half random.
+ */
+std::chrono::milliseconds HttpClient::Backoff(unsigned int attempts, std::chrono::milliseconds retryAfter)
+{
+	auto wait = _retryPolicy.InitialBackoff;
+	for (unsigned int i = 1; i < attempts && wait < _retryPolicy.MaxBackoff; i++)
+		wait *= 2;
+	wait = std::min(wait, _retryPolicy.MaxBackoff);
+
+	auto half = wait / 2;
+	wait = half + std::chrono::milliseconds(
+			std::uniform_int_distribution<long>(0, (wait - half).count())(_jitter));
+
+	return std::min(std::max(wait, retryAfter), _retryPolicy.MaxBackoff);
+}
+
+} /* namespace utils */
+} /* namespace tmx */
@@ -0,0 +1,224 @@
+/*
+ * HttpClient.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef HTTPCLIENT_H_
+#define HTTPCLIENT_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <tmx/TmxException.hpp>
+
+#define HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT 16
+#define HTTP_CLIENT_DEFAULT_TIMEOUT_MS 5000
+
+namespace tmx::utils {
+
+	class HttpClientRuntimeError : public tmx::TmxException
+	{
+	public:
+		HttpClientRuntimeError(const char *w) : tmx::TmxException(w) {}
+	};
+
+	/**
+	 * The result of a completed HTTP request.
+	 */
+	struct HttpResponse
+	{
+		/// The HTTP status code, or 0 if no response was received
+		long Status = 0;
+		/// The response body
+		std::string Body;
+		/// A description of the transport error, or empty if the request completed
+		std::string Error;
+		/// The number of times the request was sent
+		unsigned int Attempts = 0;
+	};
+
+	/**
+	 * When and how often a failed request is sent again.
+	 *
+	 * A request is retried if it could not be sent or no response arrived, or if the
+	 * server answered 408, 429 or 5xx.  A POST or PATCH is not idempotent, so it is only
+	 * retried if none of it was sent, such as when the connection could not be made.
+	 * Each retry waits twice as long as the one before, up to the maximum, with a random
+	 * part so that clients do not retry in lock step.  A Retry-After from the server
+	 * lengthens the wait, but not past the maximum.
+	 */
+	struct HttpRetryPolicy
+	{
+		/// The most times a request is sent, including the first.  1 never retries.
+		unsigned int MaxAttempts = 1;
+		/// The wait before the first retry
+		std::chrono::milliseconds InitialBackoff { 100 };
+		/// The longest wait between retries
+		std::chrono::milliseconds MaxBackoff { 5000 };
+	};
+
+	/**
+	 * The lowest TLS version an HttpClient accepts from an HTTPS server.
+	 */
+	enum class HttpTlsVersion
+	{
+		/// Whatever libcurl accepts by default
+		Default,
+		TLSv1_2,
+		TLSv1_3
+	};
+
+	/**
+	 * An asynchronous HTTP client that keeps its connections open between requests.
+	 *
+	 * Requests are handed to a single background thread that drives all transfers
+	 * through one libcurl multi handle, so connections to the same host are kept alive
+	 * and reused, and HTTP/2 servers get the requests multiplexed on one connection.
+	 * The number of requests queued, in flight or waiting to be retried is bounded, and
+	 * Send() blocks the caller once that window is full.
+	 *
+	 * The completion callbacks are invoked on the background thread, in the order the
+	 * responses complete, which is not necessarily the order of the requests.  A callback
+	 * is invoked once per request, after the last attempt.  A callback may send another
+	 * request, which is queued past the window rather than waiting for it, since only the
+	 * background thread makes room in the window.
+	 *
+	 * The destructor waits for the callers blocked in Send(), Execute() or Flush() to
+	 * return before it closes the connections.
+	 */
+	class HttpClient
+	{
+	public:
+		typedef std::function<void(const HttpResponse &)> Callback;
+
+		HttpClient(size_t maxInFlight = HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT,
+				long timeoutMs = HTTP_CLIENT_DEFAULT_TIMEOUT_MS,
+				HttpRetryPolicy retryPolicy = HttpRetryPolicy());
+		virtual ~HttpClient();
+
+		/**
+		 * Queue a request with the given method, such as GET, POST or PUT.
+		 */
+		virtual void Send(const std::string &method, const std::string &url, const std::string &body,
+				Callback callback, const std::string &contentType = "application/json");
+
+		/**
+		 * Queue a request if there is room in the window, without waiting for it.
+		 *
+		 * @return False if the request was dropped, in which case its callback is never invoked.
+		 */
+		virtual bool TrySend(const std::string &method, const std::string &url, const std::string &body,
+				Callback callback, const std::string &contentType = "application/json");
+
+		virtual void Post(const std::string &url, const std::string &body, Callback callback,
+				const std::string &contentType = "application/json");
+
+		virtual void Get(const std::string &url, Callback callback);
+
+		/**
+		 * Send a request and wait for its response, including any retries.
+		 */
+		virtual HttpResponse Execute(const std::string &method, const std::string &url,
+				const std::string &body = "", const std::string &contentType = "application/json");
+
+		virtual size_t GetInFlight();
+		virtual size_t GetMaxInFlight() const;
+
+		virtual HttpRetryPolicy GetRetryPolicy() const;
+
+		/**
+		 * @return The number of retries sent since the client was created.
+		 */
+		virtual uint64_t GetRetryCount() const;
+
+		/**
+		 * @return The number of requests that TrySend() dropped since the client was created.
+		 */
+		virtual uint64_t GetDroppedCount() const;
+
+		/**
+		 * Set the lowest TLS version accepted, for the requests sent after this.
+		 */
+		virtual void SetMinTlsVersion(HttpTlsVersion version);
+
+		/**
+		 * Block until all queued and in flight requests have completed.
+		 */
+		virtual void Flush();
+
+	private:
+		struct Request
+		{
+			std::string Method;
+			std::string Url;
+			std::string Body;
+			std::string ContentType;
+			Callback OnComplete;
+			unsigned int Attempts = 0;
+		};
+
+		struct Transfer;
+
+		/**
+		 * Counts a caller of Send(), Execute() or Flush() for as long as it is in the
+		 * call, so the destructor can wait for it to leave.
+		 */
+		class ActiveCall
+		{
+		public:
+			ActiveCall(HttpClient &client);
+			~ActiveCall();
+		private:
+			HttpClient &_client;
+		};
+
+		void Queue(const std::string &method, const std::string &url, const std::string &body,
+				Callback callback, const std::string &contentType);
+		void Run();
+		void StartTransfers();
+		void StartTransfer(Request &request);
+		void FinishTransfer(Transfer *transfer, int result);
+		void Complete(Request &request, const HttpResponse &response);
+		bool ShouldRetry(const Request &request, int result, long status, bool sent) const;
+		std::chrono::milliseconds Backoff(unsigned int attempts, std::chrono::milliseconds retryAfter);
+		long PollTimeout() const;
+
+		const size_t _maxInFlight;
+		const long _timeoutMs;
+		const HttpRetryPolicy _retryPolicy;
+
+		std::mutex _lock;
+		std::condition_variable _windowCond;
+		std::deque<Request> _pending;
+		size_t _inFlight = 0;
+		size_t _activeCalls = 0;
+
+		void *_multi;
+		std::vector<Transfer *> _transfers;
+		std::vector<Transfer *> _idle;
+		// Only set to false with _lock held, so a caller that saw it true under the lock
+		// may still use the multi handle until it releases the lock.
+		std::atomic<bool> _run{true};
+		std::thread _thread;
+
+		// Used only by the transfer thread
+		std::multimap<std::chrono::steady_clock::time_point, Request> _retries;
+		std::minstd_rand _jitter;
+		std::atomic<uint64_t> _retryCount{0};
+		std::atomic<uint64_t> _droppedCount{0};
+		std::atomic<HttpTlsVersion> _minTlsVersion{HttpTlsVersion::Default};
+	};
+
+} // namespace tmx::utils
+
+#endif /* HTTPCLIENT_H_ */
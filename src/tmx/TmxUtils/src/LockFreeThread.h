@@ -10,6 +10,9 @@
 
 #include <atomic>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 namespace tmx {
@@ -18,6 +21,9 @@ namespace utils {
 /**
  * A class that uses single-producer and single-consumer lock-free queues in order for optimal throughput.  The
  * capacity of each queue can be set, but it defaults to 2K.
+ *
+ * When the incoming queue is empty, the idle() function is invoked.  An implementation may either sleep on its
+ * own, or call park() to wait until the next item is pushed.
  */
 template <typename InQueueT, typename OutQueueT = InQueueT, typename Capacity = boost::lockfree::capacity<20480> >
 class LockFreeThread {
@@ -43,6 +49,13 @@ public:
 	bool push(const incoming_item &item) {
 		if (_inQ.push(item)) {
 			_inSize++;
+
+			// Only take the lock if the worker is actually parked
+			if (_parked) {
+				std::lock_guard<std::mutex> lock(_parkLock);
+				_parkCond.notify_one();
+			}
+
 			return true;
 		}
 
@@ -92,6 +105,12 @@ public:
 	 */
 	void stop() {
 		_active = false;
+
+		{
+			std::lock_guard<std::mutex> lock(_parkLock);
+			_parkCond.notify_one();
+		}
+
 		join();
 	}
 
@@ -148,6 +167,35 @@ protected:
 	 * A function that idlles the processor when there is nothing to process
 	 */
 	virtual void idle() = 0;
+
+	/**
+	 * Wait for the next incoming item.  The thread first spins for a short while, since items
+	 * often arrive in bursts, and then parks until an item is pushed, the thread is stopped, or
+	 * the timeout expires.  The spin time adapts to whether or not spinning has been paying off.
+	 *
+	 * This should only be called from idle().
+	 *
+	 * @param timeout The longest time to remain parked
+	 */
+	void park(std::chrono::microseconds timeout = std::chrono::milliseconds(100)) {
+		for (uint32_t i = 0; i < _spinLimit; i++) {
+			if (_inSize > 0 || !_active) {
+				if (_spinLimit < maxSpin)
+					_spinLimit *= 2;
+				return;
+			}
+
+			std::this_thread::yield();
+		}
+
+		if (_spinLimit > minSpin)
+			_spinLimit /= 2;
+
+		std::unique_lock<std::mutex> lock(_parkLock);
+		_parked = true;
+		_parkCond.wait_for(lock, timeout, [this]() { return _inSize > 0 || !_active; });
+		_parked = false;
+	}
 private:
 	void process() {
 		while (_active) {
@@ -169,6 +217,14 @@ private:
 	boost::lockfree::spsc_queue<outgoing_item, Capacity> _outQ;
 	std::atomic<uint64_t> _inSize;
 	std::atomic<uint64_t> _outSize;
+
+	// For parking the thread when idle.  Only the processing thread touches the spin limit.
+	static constexpr uint32_t minSpin = 16;
+	static constexpr uint32_t maxSpin = 4096;
+	uint32_t _spinLimit = minSpin;
+	std::atomic<bool> _parked {false};
+	std::mutex _parkLock;
+	std::condition_variable _parkCond;
 };
 
 }} // namespace tmx::utils
@@ -10,6 +10,7 @@
 #include "Logger.h"
 
 #include <cstring>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <sys/time.h>
@@ -46,15 +47,71 @@ LogMessage::LogMessage(Logger *logger, LogLevel level, std::string component, st
 {
 }
 
-Logger::Logger(): message(0)
+namespace {
+
+// A stack of streams for each thread, so that a statement that logs while building another log message gets its own
+struct StreamPool
+{
+	~StreamPool()
+	{
+		for (std::ostringstream *stream : streams)
+			delete stream;
+		destroyed = true;
+	}
+
+	std::vector<std::ostringstream *> streams;
+	static thread_local bool destroyed;
+};
+
+thread_local bool StreamPool::destroyed = false;
+thread_local StreamPool streamPool;
+
+std::ostringstream &AcquireStream()
+{
+	if (StreamPool::destroyed || streamPool.streams.empty())
+	{
+		std::ostringstream *stream = new std::ostringstream();
+		stream->setf(std::ios::boolalpha);
+		return *stream;
+	}
+
+	std::ostringstream *stream = streamPool.streams.back();
+	streamPool.streams.pop_back();
+	return *stream;
+}
+
+void ReleaseStream(std::ostringstream &stream)
+{
+	// Logging while the thread exits, after the pool is gone
+	if (StreamPool::destroyed)
+	{
+		delete &stream;
+		return;
+	}
+
+	// Put back the state of a new stream, in case the statement changed it
+	stream.str("");
+	stream.clear();
+	stream.flags(std::ios::dec | std::ios::skipws | std::ios::boolalpha);
+	stream.precision(6);
+	stream.width(0);
+	stream.fill(' ');
+
+	streamPool.streams.push_back(&stream);
+}
+
+}
+
+Logger::Logger(): message(0), os(AcquireStream())
 {
-	os.setf(std::ios::boolalpha);
 }
 
 Logger::~Logger()
 {
 	delete message;
 	message = 0;
+
+	ReleaseStream(os);
 }
 
 std::ostream &Logger::Get(LogLevel level, std::string file, unsigned int line, std::string component)
@@ -107,7 +164,8 @@ std::ostream &_logtime(std::ostream &os, uint64_t timestamp)
 {
 	struct timeval tv;
 
-	if (timestamp == 0)
+	// Messages may be written some time after they were logged, so use their own time when it is known
+	if (timestamp != 0)
 	{
 		tv.tv_sec = timestamp / 1000;
 		tv.tv_usec = timestamp % 1000 * 1000;
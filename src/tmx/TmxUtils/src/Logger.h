@@ -30,6 +30,9 @@ class Logger;
 struct LogMessage {
 	LogMessage();
 	LogMessage(const LogMessage &);
+	LogMessage(LogMessage &&) = default;
+	LogMessage &operator=(const LogMessage &) = default;
+	LogMessage &operator=(LogMessage &&) = default;
 	LogMessage(Logger *logger, LogLevel level, std::string component, std::string file, uint32_t line);
 
 	LogLevel level;
@@ -70,7 +73,9 @@ public:
 protected:
 	Logger();
 	LogMessage *message;
-	std::ostringstream os;
+
+	// Taken from a pool for the thread, since constructing a stream costs more than most log statements
+	std::ostringstream &os;
 };
 
 std::ostream & _logtime(std::ostream &os, uint64_t timestamp);
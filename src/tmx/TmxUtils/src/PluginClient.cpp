@@ -24,6 +24,9 @@
 
 #define BT_BUFFER_SIZE 100
 
+#define MUTE_STATUS_CFG "MuteStatus"
+#define STATUS_FLUSH_INTERVAL_CFG "StatusFlushInterval"
+
 using namespace std;
 using namespace tmx;
 
@@ -39,7 +42,8 @@ PluginClient::PluginClient(std::string name) :
 	_name(name),
 	_logPrefix(name + " - "),
 	_msgFilter(NULL),
-	_sysConfig(NULL)
+	_sysConfig(NULL),
+	_statusCache(std::bind(&PluginClient::SendStatus, this, std::placeholders::_1))
 {
 	PLOG(logDEBUG2) << "Constructing the plugin";
 
@@ -148,6 +152,16 @@ void PluginClient::StaticOnConfigChanged(IvpPlugin *plugin, const char *key, con
 	{
 		PluginClient::_sysContext.setDbUpdateFrequency(value);
 	}
+	else if (p && strcmp(MUTE_STATUS_CFG, key) == 0)
+	{
+		p->_muteStatus = (boost::iequals(value, "true") || strcmp(value, "1") == 0);
+	}
+	else if (p && strcmp(STATUS_FLUSH_INTERVAL_CFG, key) == 0)
+	{
+		// 0 sends each status item as soon as it is set
+		long interval = strtol(value, NULL, 10);
+		p->_statusCache.SetInterval(chrono::milliseconds(interval > 0 ? interval : 0));
+	}
 }
 
 void PluginClient::StaticOnConfigChanged(PluginClient *plugin, const char *key, const char *value)
@@ -321,8 +335,29 @@ void PluginClient::OnStateChange(IvpPluginState state)
 
 void PluginClient::RemoveStatus(const char *key)
 {
-	if (_plugin)
-		ivp_removeStatusItem(_plugin, key);
+	if (key && key[0] != '\0')
+		_statusCache.Remove(key);
+}
+
+// Send the status items that changed since the last flush as one status message.
+void PluginClient::SendStatus(const StatusCache::Changes &changes)
+{
+	if (!_plugin)
+		return;
+
+	IvpPluginStatusCollection *collection = NULL;
+	for (StatusCache::Changes::const_iterator i = changes.begin(); i != changes.end(); i++)
+	{
+		// A NULL value removes the item
+		collection = ivpPluginStatus_addStatusItem(collection, i->first.c_str(),
+				i->second.first ? i->second.second.c_str() : NULL);
+	}
+
+	if (collection != NULL)
+	{
+		ivp_setStatusItems(_plugin, collection);
+		ivpPluginStatus_destroyCollection(collection);
+	}
 }
 
 void PluginClient::SetStartTimeStatus()
@@ -29,6 +29,7 @@
 #include "PluginLog.h"
 #include "PluginException.h"
 #include "PluginKeepAlive.h"
+#include "StatusCache.h"
 #include "database/DbConnectionPool.h"
 #include "database/SystemContext.h"
 
@@ -288,7 +289,8 @@ public:
 	/**
 	 * Set a status item.
 	 * The status is only set if the string representation of the value is not the same as the last
-	 * time this method was called.
+	 * time this method was called.  New values are sent to the core in a batch every StatusFlushInterval
+	 * milliseconds, so only the latest value of a key set within one interval is sent.
 	 * @param key The key of the status item.
 	 * @param value The value of the status item.
 	 * @param prependTime When true, the current time is prepended to the value of the status item.
@@ -298,10 +300,7 @@ public:
 	template<typename T>
 	bool SetStatus(const char *key, T value, bool prependTime = false, std::streamsize precision = 2)
 	{
-		bool mute = false;
-		GetConfigValue("MuteStatus", mute);
-
-		if (mute)
+		if (_muteStatus)
 			return false;
 
 		std::ostringstream ss;
@@ -313,26 +312,11 @@ public:
 		ss.precision(precision);
 		ss << std::fixed << value;
 
-		bool isNewValue = false;
-
-		if (_statusMap.count(key) == 0)
-		{
-			_statusMap[key] = ss.str();
-			isNewValue = true;
-		}
-		else
-		{
-			if (ss.str().compare(_statusMap[key]) != 0)
-			{
-				_statusMap[key] = ss.str();
-				isNewValue = true;
-			}
-		}
+		bool isNewValue = _statusCache.Set(key, ss.str());
 
 		if (isNewValue)
 		{
 			PLOG(logDEBUG1) << "New Status. " << key << ": " << ss.str();
-			ivp_setStatusItem(_plugin, key, ss.str().c_str());
 		}
 
 		return isNewValue;
@@ -374,14 +358,17 @@ protected:
 
 private:
 	void SetStartTimeStatus();
+	void SendStatus(const StatusCache::Changes &changes);
 
 	IvpMsgFilter* _msgFilter;
 	IvpConfigCollection *_sysConfig;
 	PluginKeepAlive *_keepAlive;
 	std::chrono::system_clock::time_point _startTime;
 
-	// Map a plugin status key to the last value set for that key.
-	std::map<std::string, std::string> _statusMap;
+	// Coalesces the status items set between flushes, and holds the last value set for each key.
+	StatusCache _statusCache;
+	// Cached copy of the MuteStatus configuration value, since status is set from the message handlers.
+	std::atomic<bool> _muteStatus {false};
 
 	// Code for message handler registration and invoking
 	struct handler_allocator {
@@ -6,6 +6,7 @@
  */
 
 #include "PluginLog.h"
+#include "AsyncLog.h"
 
 #include <atomic>
 #include <sstream>
@@ -32,6 +33,12 @@ bool &Output2FILE::Enable()
 	return enable;
 }
 
+bool &Output2FILE::Async()
+{
+	static bool async = true;
+	return async;
+}
+
 void Output2FILE::Output(LogMessage &msg)
 {
 	if (!Enable())
@@ -41,11 +48,15 @@ void Output2FILE::Output(LogMessage &msg)
     if (!pStream)
         return;
 
+    // Once the asynchronous log is stopped at exit, fall back to writing directly
+    if (Async() && AsyncLog::Instance().IsRunning())
+    {
+    	AsyncLog::Instance().Write(pStream, msg);
+    	return;
+    }
+
     std::stringstream ss;
-	_logtime(ss, msg.timestamp);
-	_logsource(ss, msg.file, msg.line);
-	_loglevel(ss, msg.level);
-	ss << msg.log << std::endl;
+    AsyncLog::FormatLine(ss, msg);
 
     fprintf(pStream, "%s", ss.str().c_str());
     fflush(pStream);
@@ -143,22 +154,22 @@ bool &Output2Eventlog::Enable()
 
 void Output2Eventlog::Output(LogMessage &msg)
 {
-	// For backward compatibility, always log with file log first
-	Output2FILE fileLog;
-	fileLog.Output(msg);
-
-	if (!Enable())
-		return;
+	if (Enable())
+	{
+		static bool started = false;
 
-	static bool started = false;
+		if (!started)
+		{
+			_eventThread.start();
+			started = true;
+		}
 
-	if (!started)
-	{
-		_eventThread.start();
-		started = true;
+		_eventThread.push(msg);
 	}
 
-	_eventThread.push(msg);
+	// For backward compatibility, always log with file log as well.  This is last, since it may move the message.
+	Output2FILE fileLog;
+	fileLog.Output(msg);
 }
 
 void TmxEventLogThread::doWork(LogMessage &message)
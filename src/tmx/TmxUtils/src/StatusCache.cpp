@@ -0,0 +1,148 @@
+/*
+ * StatusCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include "StatusCache.h"
+#include "PluginLog.h"
+
+namespace tmx::utils {
+
+/**
+ * \param[in] handler  The function called with the changes to send, on the flushing thread.
+ * \param[in] interval  How often to send the changes.
+ */
+StatusCache::StatusCache(FlushHandler handler, std::chrono::milliseconds interval):
+	_handler(handler),
+	_interval(interval)
+{
+	_thread = std::thread(&StatusCache::Run, this);
+}
+
+/**
+ * \brief Send any pending changes, then stop the flushing thread.
+ */
+StatusCache::~StatusCache()
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_run = false;
+	}
+	_cond.notify_all();
+
+	if (_thread.joinable())
+		_thread.join();
+
+	Flush();
+}
+
+bool StatusCache::Set(const std::string &key, const std::string &value)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	auto last = _values.find(key);
+	if (last != _values.end() && last->second == value)
+		return false;
+
+	_values[key] = value;
+	_pending[key] = std::make_pair(true, value);
+	_updates++;
+
+	if (_interval.count() <= 0)
+		Send(lock);
+
+	return true;
+}
+
+void StatusCache::Remove(const std::string &key)
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	_values.erase(key);
+	_pending[key] = std::make_pair(false, std::string());
+	_updates++;
+
+	if (_interval.count() <= 0)
+		Send(lock);
+}
+
+void StatusCache::Flush()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+	Send(lock);
+}
+
+void StatusCache::SetInterval(std::chrono::milliseconds interval)
+{
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_interval = interval;
+	}
+	_cond.notify_all();
+}
+
+std::chrono::milliseconds StatusCache::GetInterval()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _interval;
+}
+
+uint64_t StatusCache::GetUpdateCount()
+{
+	return _updates;
+}
+
+uint64_t StatusCache::GetFlushCount()
+{
+	return _flushes;
+}
+
+void StatusCache::Run()
+{
+	std::unique_lock<std::mutex> lock(_lock);
+
+	while (_run)
+	{
+		if (_interval.count() > 0)
+			_cond.wait_for(lock, _interval);
+		else
+			_cond.wait(lock);
+
+		Send(lock);
+	}
+}
+
+/**
+ * Hand the pending changes to the handler, outside of the lock so the plugin can keep setting values.
+ * Called with the lock held, and returns with it held.  Batches are sent one at a time, in order.
+ */
+void StatusCache::Send(std::unique_lock<std::mutex> &lock)
+{
+	if (_pending.empty())
+		return;
+
+	Changes changes;
+	changes.swap(_pending);
+
+	// Taken before the lock is released, so a later batch can not be sent ahead of this one.
+	std::unique_lock<std::mutex> sendLock(_sendLock);
+	lock.unlock();
+
+	try
+	{
+		if (_handler)
+			_handler(changes);
+		_flushes++;
+	}
+	catch (std::exception &ex)
+	{
+		PLOG(logERROR) << "Unable to send status: " << ex.what();
+	}
+
+	sendLock.unlock();
+	lock.lock();
+}
+
+} /* namespace tmx::utils */
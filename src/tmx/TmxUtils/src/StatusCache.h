@@ -0,0 +1,100 @@
+/*
+ * StatusCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#ifndef STATUSCACHE_H_
+#define STATUSCACHE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define STATUS_CACHE_DEFAULT_FLUSH_INTERVAL_MS 1000
+
+namespace tmx::utils {
+
+	/**
+	 * Coalesces the status items set by a plugin, and sends the changes as one batch.
+	 *
+	 * Only the latest value of each key is kept until the next flush, so a status item updated for
+	 * every message costs one item per flush interval instead of one status message per update.
+	 * A background thread flushes the pending changes every interval.  With an interval of 0,
+	 * every change is sent as soon as it is set.
+	 */
+	class StatusCache
+	{
+	public:
+		/**
+		 * The changes to send.  A key with no value is to be removed.
+		 */
+		typedef std::map<std::string, std::pair<bool, std::string> > Changes;
+		typedef std::function<void(const Changes &)> FlushHandler;
+
+		StatusCache(FlushHandler handler,
+				std::chrono::milliseconds interval = std::chrono::milliseconds(STATUS_CACHE_DEFAULT_FLUSH_INTERVAL_MS));
+		virtual ~StatusCache();
+
+		/**
+		 * \brief Set the value of a status item.
+		 *
+		 * \return True if the value differs from the last value set for the key.
+		 */
+		bool Set(const std::string &key, const std::string &value);
+
+		/**
+		 * \brief Remove a status item.
+		 */
+		void Remove(const std::string &key);
+
+		/**
+		 * \brief Send any pending changes now.
+		 */
+		void Flush();
+
+		void SetInterval(std::chrono::milliseconds interval);
+		std::chrono::milliseconds GetInterval();
+
+		/**
+		 * \return The number of changed values that were set, which is the number of status messages that
+		 * would have been sent without the cache.
+		 */
+		uint64_t GetUpdateCount();
+
+		/**
+		 * \return The number of batches that were sent.
+		 */
+		uint64_t GetFlushCount();
+
+	private:
+		void Run();
+		void Send(std::unique_lock<std::mutex> &lock);
+
+		FlushHandler _handler;
+		std::chrono::milliseconds _interval;
+
+		std::mutex _lock;
+		std::condition_variable _cond;
+		std::mutex _sendLock;
+
+		/// The last value set for each key, used to skip unchanged values
+		std::map<std::string, std::string> _values;
+		/// The changes since the last flush
+		Changes _pending;
+
+		std::atomic<uint64_t> _updates {0};
+		std::atomic<uint64_t> _flushes {0};
+		bool _run = true;
+		std::thread _thread;
+	};
+
+} /* namespace tmx::utils */
+
+#endif /* STATUSCACHE_H_ */
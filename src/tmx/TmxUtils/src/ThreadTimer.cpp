@@ -6,6 +6,7 @@
  */
 
 #include "ThreadTimer.h"
+#include <algorithm>
 #include <chrono>
 
 #include "PluginLog.h"
@@ -24,6 +25,7 @@ ThreadTimer::ThreadTimer(std::chrono::milliseconds precision) :
 
 ThreadTimer::~ThreadTimer()
 {
+	Stop();
 }
 
 uint ThreadTimer::AddPeriodicTick(const std::function<void(void)> &periodicTick,
@@ -37,108 +39,151 @@ uint ThreadTimer::AddPeriodicTick(const std::function<void(void)> &periodicTick,
 	tick.StartDelay = startDelay;
 
 	_periodicTicks.push_back(tick);
+	uint id = _periodicTicks.size() - 1;
 
-	return _periodicTicks.size() - 1;
+	if (_running)
+	{
+		steady_clock::time_point startTime = steady_clock::now();
+		_periodicTicks[id].LastTickTime = startTime - frequency + startDelay;
+
+		if (frequency > milliseconds(0))
+			Schedule(id, startTime + startDelay);
+	}
+
+	return id;
 }
 
 void ThreadTimer::ChangeFrequency(uint id, std::chrono::milliseconds frequency)
 {
 	lock_guard<mutex> lock(_lock);
 
-	if (id >= _periodicTicks.size())
-	{
-		PLOG(logERROR) << "ChangeFrequency: Invalid ID.";
-		throw tmx::TmxException("ChangeFrequency: Invalid ID");
-	}
+	PeriodicTickData &tick = GetTick(id, "ChangeFrequency");
+	tick.Frequency = frequency;
 
-	_periodicTicks[id].Frequency = frequency;
+	if (_running && tick.Active && frequency > milliseconds(0))
+		Schedule(id, std::max(tick.LastTickTime + frequency, steady_clock::now()));
 }
 
 void ThreadTimer::TriggerNow(uint id)
 {
 	lock_guard<mutex> lock(_lock);
 
-	if (id >= _periodicTicks.size())
+	PeriodicTickData &tick = GetTick(id, "TriggerNow");
+	steady_clock::time_point now = steady_clock::now();
+	tick.LastTickTime = now - tick.Frequency;
+
+	if (_running && tick.Active && tick.Frequency > milliseconds(0))
+		Schedule(id, now);
+}
+
+void ThreadTimer::RemovePeriodicTick(uint id)
+{
+	lock_guard<mutex> lock(_lock);
+
+	// The deadline is left in the heap, and dropped once it is found to be stale
+	GetTick(id, "RemovePeriodicTick").Active = false;
+}
+
+PeriodicTickData &ThreadTimer::GetTick(uint id, const char *caller)
+{
+	if (id >= _periodicTicks.size() || !_periodicTicks[id].Active)
 	{
-		PLOG(logERROR) << "ChangeFrequency: Invalid ID.";
-		throw tmx::TmxException("ChangeFrequency: Invalid ID");
+		PLOG(logERROR) << caller << ": Invalid ID.";
+		throw tmx::TmxException(string(caller) + ": Invalid ID");
 	}
-	_periodicTicks[id].LastTickTime = steady_clock::now() - _periodicTicks[id].Frequency;
-
-//	if (!_stopThread)
-//	{
-//		for (uint index = 0; true; index++)
-//		{
-//			// Get a copy of the data for the current function to call.
-//			// A copy is obtained so that the lock is not held while the PeriodicTick function is called.
-//			PeriodicTickData tick;
-//			{
-//				lock_guard<mutex> lock(_lock);
-//
-//				if (index >= _periodicTicks.size())
-//					break;
-//
-//				tick = _periodicTicks[index];
-//			}
-//
-//			// Call the function.
-//			tick.PeriodicTick();
-//		}
-//	}
+
+	return _periodicTicks[id];
+}
+
+void ThreadTimer::Schedule(uint id, std::chrono::steady_clock::time_point deadline)
+{
+	_periodicTicks[id].NextTickTime = deadline;
+
+	// Rebuild the heap without the stale entries once they outnumber the live ones
+	if (_deadlines.size() > 2 * _periodicTicks.size() + 16)
+	{
+		vector<Deadline> live;
+		for (const Deadline &entry: _deadlines)
+		{
+			const PeriodicTickData &tick = _periodicTicks[entry.second];
+			if (tick.Active && tick.NextTickTime == entry.first)
+				live.push_back(entry);
+		}
+
+		_deadlines.swap(live);
+		make_heap(_deadlines.begin(), _deadlines.end(), greater<Deadline>());
+	}
+
+	_deadlines.emplace_back(deadline, id);
+	push_heap(_deadlines.begin(), _deadlines.end(), greater<Deadline>());
+
+	_wake.notify_one();
 }
 
 void ThreadTimer::DoWork()
 {
+	unique_lock<mutex> lock(_lock);
+
 	steady_clock::time_point startTime = steady_clock::now();
 
+	_running = true;
+	_deadlines.clear();
+
+	for (uint id = 0; id < _periodicTicks.size(); id++)
 	{
-		lock_guard<mutex> lock(_lock);
+		PeriodicTickData &tick = _periodicTicks[id];
+		tick.LastTickTime = startTime - tick.Frequency + tick.StartDelay;
 
-		for (PeriodicTickData &tick: _periodicTicks)
-		{
-			tick.LastTickTime = startTime - tick.Frequency + tick.StartDelay;
-		}
+		if (tick.Active && tick.Frequency > milliseconds(0))
+			Schedule(id, startTime + tick.StartDelay);
 	}
 
 	while (!_stopThread)
 	{
-		for (uint index = 0; true; index++)
-		{
-			// Get a copy of the data for the current function to call.
-			// A copy is obtained so that the lock is not held while the PeriodicTick function is called.
-			PeriodicTickData tick;
-			{
-				lock_guard<mutex> lock(_lock);
+		steady_clock::time_point now = steady_clock::now();
 
-				if (index >= _periodicTicks.size())
-					break;
+		if (_deadlines.empty())
+		{
+			_wake.wait_for(lock, _precision);
+			continue;
+		}
 
-				tick = _periodicTicks[index];
-			}
+		Deadline next = _deadlines.front();
+		PeriodicTickData &tick = _periodicTicks[next.second];
 
-			// Call the function if the frequency has arrived.
+		if (!tick.Active || tick.Frequency <= milliseconds(0) || tick.NextTickTime != next.first)
+		{
+			pop_heap(_deadlines.begin(), _deadlines.end(), greater<Deadline>());
+			_deadlines.pop_back();
+			continue;
+		}
 
-			steady_clock::time_point now = steady_clock::now();
+		if (next.first > now)
+		{
+			// Woken early by a new deadline, or to check whether the thread has been stopped
+			_wake.wait_until(lock, std::min(next.first, now + _precision));
+			continue;
+		}
 
-			milliseconds period = duration_cast<milliseconds> (now - tick.LastTickTime);
+		pop_heap(_deadlines.begin(), _deadlines.end(), greater<Deadline>());
+		_deadlines.pop_back();
 
-			if (tick.Frequency > milliseconds(0) && period >= tick.Frequency)
-			{
-				// Call the function.
-				tick.PeriodicTick();
+		// The next deadline follows from this one, skipping any that have already been missed
+		steady_clock::time_point due = next.first + tick.Frequency;
+		if (due <= now)
+			due += ((now - due) / tick.Frequency + 1) * tick.Frequency;
 
-				// Update the last time the function was called.
-				// Assume that elements are never removed from the _periodicTicks vector and that
-				// they are never rearranged (i.e. index still refers to the same element).
-				{
-					lock_guard<mutex> lock(_lock);
-					_periodicTicks[index].LastTickTime = now;
-				}
-			}
-		}
+		tick.LastTickTime = now;
+		Schedule(next.second, due);
 
-		std::this_thread::sleep_for(_precision);
+		// Call the function without the lock.  The element stays in place, since the deque is only appended to.
+		PeriodicTickData *called = &tick;
+		lock.unlock();
+		called->PeriodicTick();
+		lock.lock();
 	}
+
+	_running = false;
 }
 
 } /* namespace utils */
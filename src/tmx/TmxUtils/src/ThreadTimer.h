@@ -9,8 +9,11 @@
 #define SRC_THREADTIMER_H_
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "ThreadWorker.h"
@@ -24,15 +27,26 @@ struct PeriodicTickData
 	std::chrono::milliseconds Frequency;
 	std::chrono::milliseconds StartDelay;
 	std::chrono::steady_clock::time_point LastTickTime;
+	std::chrono::steady_clock::time_point NextTickTime;
+	bool Active = true;
 };
 
+/**
+ * Calls periodic tick functions from a separate thread.
+ *
+ * The deadlines are kept in a min-heap, and the thread sleeps until exactly the next one.
+ * Each tick is scheduled from the previous deadline rather than from when the function returned,
+ * so periodic ticks do not drift.  If a function runs so long that deadlines are missed, the missed
+ * ticks are skipped rather than called back to back.
+ */
 class ThreadTimer : public ThreadWorker
 {
 public:
 	/**
 	 * Construct a new timer that runs in a separate thread.
 	 *
-	 * @param precision The amount of time the thread will sleep between checks to call periodic tick functions.
+	 * @param precision The longest the thread will sleep before checking whether it has been stopped.
+	 * Tick functions are called at their deadlines regardless of the precision.
 	 */
 	ThreadTimer(std::chrono::milliseconds precision = std::chrono::milliseconds(100));
 	virtual ~ThreadTimer();
@@ -45,8 +59,9 @@ public:
 	 * is used to call each function.
 	 *
 	 * @param periodicTick The function to call.
-	 * @param frequency The interval that the function is called.
-	 * @param startDelay The time to wait before calling the function the first time.
+	 * @param frequency The interval that the function is called.  A zero interval pauses the function.
+	 * @param startDelay The time to wait before calling the function the first time, from when the timer
+	 * is started, or from now if it is already running.
 	 * @return An ID that can be used to later change the frequency.
 	 */
 	uint AddPeriodicTick(const std::function<void(void)> &periodicTick,
@@ -66,17 +81,35 @@ public:
 	*/
 	void TriggerNow(uint id);
 
+	/**
+	 * Stop calling a previously added tick function.  If the function is running on the timer thread
+	 * at the time, it is allowed to finish.  The ID is not reused.
+	 *
+	 * @param id The ID of the tick function returned by AddPeroidicTick.
+	 */
+	void RemovePeriodicTick(uint id);
+
 private:
+	typedef std::pair<std::chrono::steady_clock::time_point, uint> Deadline;
+
 	// Override of DoWork from BackgroundWorker.
 	void DoWork();
 
+	PeriodicTickData &GetTick(uint id, const char *caller);
+	void Schedule(uint id, std::chrono::steady_clock::time_point deadline);
+
 	std::mutex _lock;
+	std::condition_variable _wake;
 	std::chrono::milliseconds _precision;
+	bool _running = false;
+
+	// Elements are never removed, so an ID is always the index of its element.  A deque is used
+	// so that an element stays in place while its function is called without the lock.
+	std::deque<PeriodicTickData> _periodicTicks;
 
-	// Note that the internal code assumes that elements are never removed from this vector!
-	// If a RemovePeriodicTick is ever written, a flag should just be added to PeriodicTickData
-	// to show that it is no longer in use.  The index of each element must never change.
-	std::vector<PeriodicTickData> _periodicTicks;
+	// Min-heap of the next deadline of each tick.  An entry whose time no longer matches the
+	// NextTickTime of its tick is stale, and is dropped when it reaches the top.
+	std::vector<Deadline> _deadlines;
 };
 
 class ThreadTimerClient
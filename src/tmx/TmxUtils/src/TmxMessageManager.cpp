@@ -50,9 +50,23 @@ protected:
 private:
 	// Each thread keeps its own additive increasing, multiplicative decreasing sleep time
 	double usecSleep = 0;
+
+	// Each thread keeps its own factory, since the last error is held in the factory
+	tmx::messages::J2735MessageFactory factory;
+};
+
+/**
+ * How the worker threads wait for new messages, either:
+ * 		Sleep - Sleep for an additive increasing, multiplicative decreasing time
+ * 		Park - Spin briefly, then block until the next message is queued
+ */
+enum idleStrategy {
+	idle_Sleep = 0,
+	idle_Park
 };
 
 static std::atomic<uint16_t> overflow {DEFAULT_OVERFLOW_CAPACITY};
+static std::atomic<idleStrategy> idling {idle_Park};
 static constexpr uint8_t sleepInc = 10;
 static constexpr double sleepDec = 1.0 / sleepInc;
 
@@ -67,9 +81,6 @@ static std::thread *outThread;
 std::mutex _threadLock;
 std::mutex _waitLock;
 
-// This static factory initializes the map data for future use
-static tmx::messages::J2735MessageFactory factory;
-
 static std::condition_variable cv;
 
 bool IsByteHexEncoded(const char *encoding)
@@ -127,16 +138,13 @@ void RxThread::doWork(rawIncomingMessage &msg) {
 			bytes = static_cast<tmx::byte_stream *>(msg.message);
 			if (bytes) {
 				if (IsByteHexEncoded(msg.encoding)) {
-					// New factory needed to avoid race conditions
-					tmx::messages::J2735MessageFactory myFactory;
-
 					FILE_LOG(logDEBUG4) << this->get_id() << " Decoding from bytes " << *bytes;
 
 					// Bytes are encoded.  First try to convert to a J2735 message
-					routeableMsg = myFactory.NewMessage(*bytes);
+					routeableMsg = factory.NewMessage(*bytes);
 
 					if (!routeableMsg) {
-						FILE_LOG(logDEBUG4) << "Not a J2735 message: " << myFactory.get_event();
+						FILE_LOG(logDEBUG4) << "Not a J2735 message: " << factory.get_event();
 
 						// Set the bytes directly as unknown type
 						routeableMsg = new routeable_message();
@@ -210,6 +218,11 @@ void RxThread::doWork(rawIncomingMessage &msg) {
 }
 
 void RxThread::idle() {
+	if (idling == idle_Park) {
+		this->park();
+		return;
+	}
+
 	this_thread::yield();
 
 	usleep((uint32_t)usecSleep);
@@ -220,6 +233,13 @@ void RxThread::idle() {
 		usecSleep += sleepInc;
 }
 
+void set_idle_strategy(const std::string &strategy) {
+	if (boost::iequals("Sleep", strategy))
+		idling = idle_Sleep;
+	else if (boost::iequals("Park", strategy))
+		idling = idle_Park;
+}
+
 bool available_messages() {
 	for (size_t i = 0; i < workerThreads.size(); i++)
 		if (workerThreads[i].outQueueSize()) return true;
@@ -393,6 +413,8 @@ void TmxMessageManager::OnConfigChanged(const char *key, const char *value) {
 		uint16_t n = strtoul(value, NULL, 0);
 		if (n != overflow)
 			overflow = n;
+	} else if (strcmp(IDLE_STRATEGY_CFG, key) == 0) {
+		set_idle_strategy(value);
 	} else {
 		// Not my key
 		PluginClient::OnConfigChanged(key, value);
@@ -413,6 +435,10 @@ void TmxMessageManager::OnStateChange(IvpPluginState state) {
 
 		GetConfigValue(OVERFLOW_CAPACITY_CFG, overflow);
 
+		s = DEFAULT_IDLE_STRATEGY;
+		GetConfigValue(IDLE_STRATEGY_CFG, s);
+		set_idle_strategy(s);
+
 		// Start the new threads
 		Start();
 	}
@@ -17,10 +17,12 @@
 #define NUMBER_WORKER_THREADS_CFG "MessageManagerThreads"
 #define ASSIGNMENT_STRATEGY_CFG "MessageManagerStrategy"
 #define OVERFLOW_CAPACITY_CFG "MessageManagerQueueOverflow"
+#define IDLE_STRATEGY_CFG "MessageManagerIdleStrategy"
 
 #define DEFAULT_NUMBER_WORKER_THREADS 3
 #define DEFAULT_ASSIGNENT_STRATEGY "Random"
 #define DEFAULT_OVERFLOW_CAPACITY 0
+#define DEFAULT_IDLE_STRATEGY "Park"
 
 namespace tmx {
 namespace utils {
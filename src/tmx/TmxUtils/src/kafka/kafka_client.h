@@ -14,6 +14,11 @@ namespace tmx::utils
     public:
         std::shared_ptr<kafka_consumer_worker> create_consumer(const std::string &broker_str, const std::string &topic_str,
                                                                               const std::string &group_id_str) const;
+        /**
+         * @brief Create one consumer for several topics, to consume them all from a single thread with consume_batch.
+         */
+        std::shared_ptr<kafka_consumer_worker> create_consumer(const std::string &broker_str, const std::vector<std::string> &topics,
+                                                                              const std::string &group_id_str) const;
         std::shared_ptr<kafka_producer_worker> create_producer(const std::string &broker_str, const std::string &topic_str) const;
         std::shared_ptr<kafka_producer_worker> create_producer(const std::string &bootstrap_server) const;
     };
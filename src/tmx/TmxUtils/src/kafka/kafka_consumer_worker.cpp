@@ -1,13 +1,60 @@
 #include "kafka_consumer_worker.h"
+#include <librdkafka/rdkafka.h>
 
 namespace tmx::utils
 {
+    kafka_message_batch::kafka_message_batch(std::vector<kafka_message_view> views)
+        : _views(std::move(views))
+    {
+    }
+
+    kafka_message_batch::~kafka_message_batch()
+    {
+        release();
+    }
+
+    kafka_message_batch::kafka_message_batch(kafka_message_batch &&other) noexcept
+        : _views(std::move(other._views)), _messages(std::move(other._messages))
+    {
+        other._views.clear();
+        other._messages.clear();
+    }
+
+    kafka_message_batch &kafka_message_batch::operator=(kafka_message_batch &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            _views = std::move(other._views);
+            _messages = std::move(other._messages);
+            other._views.clear();
+            other._messages.clear();
+        }
+        return *this;
+    }
+
+    void kafka_message_batch::release()
+    {
+        for (auto message : _messages)
+            rd_kafka_message_destroy(message);
+        _messages.clear();
+        _views.clear();
+    }
+
     kafka_consumer_worker::kafka_consumer_worker(const std::string &broker_str, const std::string &topic_str,
                                                 const std::string &group_id_str, int64_t cur_offset, int32_t partition)
-        :_topics_str(topic_str), _broker_str(broker_str), _group_id_str(group_id_str), _cur_offset(cur_offset),
+        :_topics_str(topic_str), _topics{topic_str}, _broker_str(broker_str), _group_id_str(group_id_str), _cur_offset(cur_offset),
         _partition(partition)
     {
     }
+
+    kafka_consumer_worker::kafka_consumer_worker(const std::string &broker_str, const std::vector<std::string> &topics,
+                                                const std::string &group_id_str, int64_t cur_offset)
+        :_topics(topics), _broker_str(broker_str), _group_id_str(group_id_str), _cur_offset(cur_offset)
+    {
+        for (const auto &topic : _topics)
+            _topics_str += (_topics_str.empty() ? "" : ",") + topic;
+    }
     kafka_consumer_worker::~kafka_consumer_worker() {
         stop();
         FILE_LOG(logWARNING) << "Kafka consumer destroyed!" << std::endl;
@@ -64,6 +111,15 @@ namespace tmx::utils
             FILE_LOG(logWARNING) << "RDKafka cof set max.partition failed: " << errstr.c_str() << std::endl;
         }
 
+        // where to start when the group has no committed offset
+        if (_cur_offset == RdKafka::Topic::OFFSET_BEGINNING || _cur_offset == RdKafka::Topic::OFFSET_END)
+        {
+            if (conf->set(AUTO_OFFSET_RESET, _cur_offset == RdKafka::Topic::OFFSET_BEGINNING ? "earliest" : "latest", errstr) != RdKafka::Conf::CONF_OK)
+            {
+                FILE_LOG(logWARNING) << "RDKafka conf set auto offset reset failed: " << errstr.c_str() << std::endl;
+            }
+        }
+
         // create consumer
         _consumer = RdKafka::KafkaConsumer::create(conf, errstr);
         if (!_consumer)
@@ -75,6 +131,13 @@ namespace tmx::utils
         FILE_LOG(logINFO) << "Created consumer: " << _consumer->name() << std::endl;
         delete conf;
 
+        // A topic handle is only needed for a single topic
+        if (_topics.size() != 1)
+        {
+            printCurrConf();
+            return true;
+        }
+
         // create kafka topic
         RdKafka::Conf *tconf = RdKafka::Conf::create(RdKafka::Conf::CONF_TOPIC);
         if (!tconf)
@@ -107,16 +170,14 @@ namespace tmx::utils
 
     void kafka_consumer_worker::subscribe()
     {
-        std::vector<std::string> _topics_str_list;
-        _topics_str_list.push_back(_topics_str);
-        RdKafka::ErrorCode err = _consumer->subscribe(_topics_str_list);
+        RdKafka::ErrorCode err = _consumer->subscribe(_topics);
         if (err)
         {
-            FILE_LOG(logWARNING) <<  _consumer->name() << " failed to subscribe to " <<  _topics_str_list.size() << " topics: " <<  RdKafka::err2str(err).c_str() << std::endl;
+            FILE_LOG(logWARNING) <<  _consumer->name() << " failed to subscribe to " <<  _topics.size() << " topics: " <<  RdKafka::err2str(err).c_str() << std::endl;
             _run = false;
             exit(1);
         } else {
-            FILE_LOG(logINFO) <<  _consumer->name() <<  " successfully to subscribe to " << _topics_str_list.size() << " topics " 
+            FILE_LOG(logINFO) <<  _consumer->name() <<  " successfully to subscribe to " << _topics.size() << " topics " 
                 << RdKafka::err2str(err).c_str() << std::endl;
             _run = true;
         }
@@ -124,12 +185,71 @@ namespace tmx::utils
 
     const char *kafka_consumer_worker::consume(int timeout_ms)
     {
-        const RdKafka::Message *msg = nullptr;
-        msg = _consumer->consume(timeout_ms);
-        const char *msg_str = msg_consume(msg);
+        // Keep the message until the next call, since the caller reads the payload in place
+        _last_message.reset(_consumer->consume(timeout_ms));
+        const char *msg_str = msg_consume(_last_message.get());
         return msg_str;
     }
 
+    kafka_message_batch kafka_consumer_worker::consume_batch(size_t max_msgs, int timeout_ms)
+    {
+        kafka_message_batch batch;
+        if (max_msgs == 0)
+            return batch;
+
+        std::vector<rd_kafka_message_t *> messages(max_msgs);
+        rd_kafka_queue_t *queue = rd_kafka_queue_get_consumer(_consumer->c_ptr());
+        if (!queue)
+        {
+            FILE_LOG(logWARNING) << _consumer->name() << " has no consumer queue to consume from" << std::endl;
+            return batch;
+        }
+        /* rd_kafka_consume_batch_queue waits until the batch is full or the timeout passes, so a
+         * partial batch would always wait the whole timeout. Take what is queued without waiting,
+         * and only if there is nothing, wait for the first message and then take the rest. */
+        ssize_t count = rd_kafka_consume_batch_queue(queue, 0, messages.data(), max_msgs);
+        if (count == 0 && timeout_ms != 0)
+        {
+            count = rd_kafka_consume_batch_queue(queue, timeout_ms, messages.data(), 1);
+            if (count == 1 && max_msgs > 1)
+            {
+                ssize_t more = rd_kafka_consume_batch_queue(queue, 0, messages.data() + 1, max_msgs - 1);
+                if (more > 0)
+                    count += more;
+            }
+        }
+        rd_kafka_queue_destroy(queue);
+
+        if (count < 0)
+        {
+            msg_error(static_cast<RdKafka::ErrorCode>(rd_kafka_last_error()), rd_kafka_err2str(rd_kafka_last_error()));
+            return batch;
+        }
+
+        batch._messages.assign(messages.begin(), messages.begin() + count);
+        batch._views.reserve(count);
+        for (auto message : batch._messages)
+        {
+            if (message->err)
+            {
+                msg_error(static_cast<RdKafka::ErrorCode>(message->err), rd_kafka_message_errstr(message));
+                continue;
+            }
+
+            kafka_message_view view;
+            view.payload = static_cast<const char *>(message->payload);
+            view.len = message->len;
+            view.topic = message->rkt ? rd_kafka_topic_name(message->rkt) : "";
+            view.partition = message->partition;
+            view.offset = message->offset;
+            batch._views.push_back(view);
+            _cur_offset = message->offset;
+        }
+
+        FILE_LOG(logDEBUG1) << _consumer->name() << " consumed a batch of " << batch.size() << " messages" << std::endl;
+        return batch;
+    }
+
     bool kafka_consumer_worker::is_running() const
     {
         return _run;
@@ -144,35 +264,44 @@ namespace tmx::utils
     const char *kafka_consumer_worker::msg_consume(const RdKafka::Message *message)
     {
         const char *return_msg_str = "";
-        switch (message->err())
+        if (message->err() == RdKafka::ERR_NO_ERROR)
         {
-        case RdKafka::ERR__TIMED_OUT:
-            FILE_LOG(logDEBUG4) << _consumer->name() << " consume failed: " <<  message->errstr() << std::endl;
-            break;
-        case RdKafka::ERR_NO_ERROR:
             FILE_LOG(logDEBUG1) << _consumer->name() << " read message at offset " <<  message->offset() << std::endl;
             FILE_LOG(logDEBUG1) << _consumer->name() << " message Consumed: " << static_cast<int>(message->len())  << " bytes : " << static_cast<const char *>(message->payload()) << std::endl;
             _cur_offset = message->offset();
             return_msg_str = static_cast<const char *>(message->payload());
+        }
+        else
+        {
+            msg_error(message->err(), message->errstr());
+        }
+        return return_msg_str;
+    }
+
+    void kafka_consumer_worker::msg_error(RdKafka::ErrorCode err, const std::string &errstr)
+    {
+        switch (err)
+        {
+        case RdKafka::ERR__TIMED_OUT:
+            FILE_LOG(logDEBUG4) << _consumer->name() << " consume failed: " <<  errstr << std::endl;
             break;
         case RdKafka::ERR__PARTITION_EOF:
             FILE_LOG(logWARNING) << _consumer->name() << " reached the end of the queue, offset : " <<  _cur_offset << std::endl;
             break;
         case RdKafka::ERR__UNKNOWN_TOPIC:
-            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " <<  message->errstr() << std::endl;
+            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " <<  errstr << std::endl;
             break;
         case RdKafka::ERR__UNKNOWN_PARTITION:
-            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " << message->errstr() << std::endl;
+            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " << errstr << std::endl;
             stop();
             break;
 
         default:
             /* Errors */
-            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " << message->errstr() << std::endl;
+            FILE_LOG(logWARNING) << _consumer->name() << " consume failed: " << errstr << std::endl;
             stop();
             break;
         }
-        return return_msg_str;
     }
 
     void consumer_rebalance_cb::part_list_print(const std::vector<RdKafka::TopicPartition*>&partitions)
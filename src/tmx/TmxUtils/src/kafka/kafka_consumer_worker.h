@@ -7,9 +7,13 @@
 #include <cstdio>
 #include <csignal>
 #include <cstring>
+#include <memory>
+#include <vector>
 #include <PluginLog.h>
 #include <librdkafka/rdkafkacpp.h>
 
+struct rd_kafka_message_s;
+
 namespace tmx::utils {
     static int partition_cnt = 0;
     static int eof_cnt = 0;
@@ -31,6 +35,57 @@ namespace tmx::utils {
             void event_cb (RdKafka::Event &event) override ;
     };
         
+    /**
+     * @brief A message consumed from Kafka. The payload and topic point into the message held by
+     * librdkafka, and are valid for as long as the kafka_message_batch the view came from.
+     */
+    struct kafka_message_view
+    {
+        const char *payload = nullptr;
+        size_t len = 0;
+        const char *topic = "";
+        int32_t partition = 0;
+        int64_t offset = 0;
+
+        /**
+         * @brief Copy the payload into a string.
+         */
+        std::string str() const { return std::string(payload, len); }
+    };
+
+    /**
+     * @brief The messages returned by one call to kafka_consumer_worker::consume_batch. The messages
+     * are released back to librdkafka when the batch is destroyed.
+     */
+    class kafka_message_batch
+    {
+        public:
+            kafka_message_batch() = default;
+            /**
+             * @brief Construct a batch of messages that do not belong to librdkafka, such as in tests.
+             * The caller keeps the payloads valid for as long as the batch.
+             */
+            explicit kafka_message_batch(std::vector<kafka_message_view> views);
+            ~kafka_message_batch();
+            kafka_message_batch(kafka_message_batch &&other) noexcept;
+            kafka_message_batch &operator=(kafka_message_batch &&other) noexcept;
+            kafka_message_batch(const kafka_message_batch &other) = delete;
+            kafka_message_batch &operator=(const kafka_message_batch &other) = delete;
+
+            size_t size() const { return _views.size(); }
+            bool empty() const { return _views.empty(); }
+            const kafka_message_view &operator[](size_t i) const { return _views[i]; }
+            std::vector<kafka_message_view>::const_iterator begin() const { return _views.begin(); }
+            std::vector<kafka_message_view>::const_iterator end() const { return _views.end(); }
+
+        private:
+            friend class kafka_consumer_worker;
+            void release();
+
+            std::vector<kafka_message_view> _views;
+            std::vector<rd_kafka_message_s *> _messages;
+    };
+
     class kafka_consumer_worker
     {
         private:
@@ -41,11 +96,13 @@ namespace tmx::utils {
             const std::string MAX_PARTITION_FETCH_SIZE="max.partition.fetch.bytes";
             const std::string ENABLE_PARTITION_END_OF="enable.partition.eof";
             const std::string ENABLE_AUTO_COMMIT="enable.auto.commit";
+            const std::string AUTO_OFFSET_RESET="auto.offset.reset";
 
             //maximum size for pulling message from a single partition at a time
             std::string STR_FETCH_NUM = "10240000";
             
             std::string _topics_str = "";
+            std::vector<std::string> _topics;
             std::string _broker_str = "";
             std::string _group_id_str = "";
             RdKafka::KafkaConsumer *_consumer = nullptr;
@@ -55,7 +112,10 @@ namespace tmx::utils {
             bool _run = false;
             consumer_event_cb _consumer_event_cb;
             consumer_rebalance_cb _consumer_rebalance_cb;
+            // The last message returned by consume, whose payload the caller may still be reading
+            std::unique_ptr<RdKafka::Message> _last_message;
             const char* msg_consume(const RdKafka::Message *message);
+            void msg_error(RdKafka::ErrorCode err, const std::string &errstr);
 
         public:
             /**
@@ -68,6 +128,17 @@ namespace tmx::utils {
              * @param partition partition consumer should be assigned to.
              */
             kafka_consumer_worker(const std::string &broker_str, const std::string &topic_str, const std::string & group_id, int64_t cur_offset = 0, int32_t partition = 0);
+            /**
+             * @brief Construct a new kafka consumer worker object that consumes from several topics at once.
+             * 
+             * @param broker_str network adress of kafka broker.
+             * @param topics topics consumer should consume from.
+             * @param group_id consumer group id.
+             * @param cur_offset offset to start event consuming at, when the group has no committed offset.
+             * RdKafka::Topic::OFFSET_BEGINNING starts from the earliest message, and RdKafka::Topic::OFFSET_END
+             * from the next message produced.
+             */
+            kafka_consumer_worker(const std::string &broker_str, const std::vector<std::string> &topics, const std::string & group_id, int64_t cur_offset = 0);
             /**
              * @brief Destroy the kafka consumer worker object. Calls stop on consumer to clean up resources.
              */
@@ -95,6 +166,16 @@ namespace tmx::utils {
              * @return const char* of payload consumed.
              */
             virtual const char* consume(int timeout_ms);
+            /**
+             * @brief Consume up to max_msgs messages from the subscribed topics in one call, without copying them.
+             * Returns as soon as any messages are available, or after the timeout if there are none.
+             * End of partition events are not returned, and errors are handled as in consume.
+             * 
+             * @param max_msgs the most messages to return.
+             * @param timeout_ms timeout in milliseconds to wait for the first message.
+             * @return the messages consumed, in the order they were received for each partition.
+             */
+            virtual kafka_message_batch consume_batch(size_t max_msgs, int timeout_ms);
             /**
              * @brief Subscribe consumer to topic
              */
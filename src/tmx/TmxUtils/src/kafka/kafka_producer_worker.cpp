@@ -1,9 +1,20 @@
 
 #include "kafka_producer_worker.h"
+#include <chrono>
 namespace tmx::utils
 {
     void producer_delivery_report_cb::dr_cb (RdKafka::Message &message) 
     {
+        if (message.err() == RdKafka::ERR_NO_ERROR)
+        {
+            delivered++;
+            delivered_bytes += message.len();
+        }
+        else
+        {
+            failed++;
+            FILE_LOG(logDEBUG) << "Message delivery to " << message.topic_name() << " failed: " << message.errstr() << std::endl;
+        }
         FILE_LOG(logDEBUG) << "Message delivery length : " << message.len() << " content: " <<  message.errstr().c_str() << std::endl;
         if(message.key())                 
             FILE_LOG(logDEBUG) << " Key:  " << message.key() << std::endl;
@@ -83,6 +94,15 @@ namespace tmx::utils
             return false;
         }
 
+        for (const auto &property : _conf)
+        {
+            if (conf->set(property.first, property.second, errstr) != RdKafka::Conf::CONF_OK)
+            {
+                FILE_LOG(logWARNING) << "RdKafka conf set " << property.first << " failed: " << errstr.c_str() << std::endl;
+                return false;
+            }
+        }
+
         // create producer using accumulated global configuration.
         _producer = RdKafka::Producer::create(conf, errstr);
         if (!_producer)
@@ -117,6 +137,22 @@ namespace tmx::utils
         return _run;
     }
 
+    void kafka_producer_worker::set_conf(const std::string &name, const std::string &value)
+    {
+        _conf[name] = value;
+    }
+
+    void kafka_producer_worker::set_max_spill(size_t max_spill)
+    {
+        std::lock_guard<std::mutex> lock(_spill_lock);
+        _max_spill = max_spill;
+        while (_spill.size() > _max_spill)
+        {
+            _spill.pop_front();
+            _dropped++;
+        }
+    }
+
     void kafka_producer_worker::send(const std::string &msg)
     {
 
@@ -125,46 +161,90 @@ namespace tmx::utils
 
         if (msg.empty())
         {
-            _producer->poll(0);
+            poll(0);
             return;
         }
-        // produce messages
-        while (true)
-        {
-            RdKafka::ErrorCode resp = _producer->produce(_topic,
-                                                         _partition,
-                                                         RdKafka::Producer::RK_MSG_COPY,
-                                                         const_cast<char *>(msg.c_str()),
-                                                         msg.size(),
-                                                         nullptr,
-                                                         nullptr);
-            if (resp != RdKafka::ERR_NO_ERROR)
+
+        produce_or_spill("", msg);
+    }
+
+    void kafka_producer_worker::send(const std::string& message, const std::string& topic_name ) const
+    {
+        produce_or_spill(topic_name, message);
+    }
+
+    RdKafka::ErrorCode kafka_producer_worker::produce(const std::string &topic, const std::string &payload) const
+    {
+        RdKafka::ErrorCode resp;
+        if (topic.empty())
+        {
+            resp = _producer->produce(_topic,
+                                      _partition,
+                                      RdKafka::Producer::RK_MSG_COPY,
+                                      const_cast<char *>(payload.c_str()),
+                                      payload.size(),
+                                      nullptr,
+                                      nullptr);
+        }
+        else
+        {
+            resp = _producer->produce(topic,
+                                      RdKafka::Topic::PARTITION_UA,
+                                      RdKafka::Producer::RK_MSG_COPY,
+                                      const_cast<char *>(payload.c_str()),
+                                      payload.size(),
+                                      nullptr, 0, 0, nullptr);
+        }
+
+        if (resp == RdKafka::ERR_NO_ERROR)
+        {
+            _queued++;
+            FILE_LOG(logDEBUG) << _producer->name()  << " produced message size: " <<  payload.size() 
+                << " message content: " << payload.c_str() << std::endl;
+        }
+        else if (resp != RdKafka::ERR__QUEUE_FULL)
+        {
+            _failed++;
+            FILE_LOG(logERROR) << _producer->name() << " failed to queue message for " << (topic.empty() ? _topics_str : topic)
+                << ": " << RdKafka::err2str(resp) << std::endl;
+        }
+        return resp;
+    }
+
+    void kafka_producer_worker::produce_or_spill(const std::string &topic, const std::string &payload) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(_spill_lock);
+
+            // Older messages go first
+            drain_spill();
+
+            if (!_spill.empty() || produce(topic, payload) == RdKafka::ERR__QUEUE_FULL)
             {
-                FILE_LOG(logWARNING) <<  _producer->name() << " produce failed: " <<  RdKafka::err2str(resp) << std::endl;
-                if (resp == RdKafka::ERR__QUEUE_FULL)
+                /* The internal queue is full until messages are delivered and their
+                 * delivery reports served. Rather than block the caller, hold the
+                 * message until there is room. The internal queue is limited by the
+                 * configuration property queue.buffering.max.messages */
+                if (_spill.size() >= _max_spill)
                 {
-                    /* If the internal queue is full, wait for
-                     * messages to be delivered and then retry.
-                     * The internal queue represents both
-                     * messages to be sent and messages that have
-                     * been sent or failed, awaiting their
-                     * delivery report callback to be called.
-                     *
-                     * The internal queue is limited by the
-                     * configuration property
-                     * queue.buffering.max.messages */
-                    _producer->poll(1000 /*block for max 1000ms*/);
-                    continue;
+                    if (_spill.empty())
+                    {
+                        _dropped++;
+                        FILE_LOG(logWARNING) << _producer->name() << " queue is full, dropped message" << std::endl;
+                    }
+                    else
+                    {
+                        _spill.pop_front();
+                        _dropped++;
+                        FILE_LOG(logWARNING) << _producer->name() << " spill queue is full, dropped oldest message" << std::endl;
+                    }
+                }
+                if (_spill.size() < _max_spill)
+                {
+                    _spill.push_back(spilled_message{topic, payload});
+                    _spilled++;
                 }
             }
-            else
-            {
-                FILE_LOG(logDEBUG) << _producer->name()  << " produced message size: " <<  msg.size() 
-                    << " message content: " << msg.c_str() << std::endl;
-            }
-
-            // break the loop regardless of sucessfully sent or failed
-            break;
         }
 
         /* A producer application should continually serve
@@ -180,36 +260,42 @@ namespace tmx::utils
         _producer->poll(0);
     }
 
-    void kafka_producer_worker::send(const std::string& message, const std::string& topic_name ) const
+    void kafka_producer_worker::drain_spill() const
     {
-        bool retry = true;
-        while (retry) 
+        while (!_spill.empty())
         {
-            RdKafka::ErrorCode produce_error = _producer->produce(topic_name, 
-                                                                        RdKafka::Topic::PARTITION_UA,
-                                                                        RdKafka::Producer::RK_MSG_COPY, 
-                                                                        const_cast<char *>(message.c_str()),
-                                                                        message.size(), 
-                                                                        nullptr, 0, 0, nullptr);
+            const auto &message = _spill.front();
+            if (produce(message.topic, message.payload) == RdKafka::ERR__QUEUE_FULL)
+                break;
+            _spill.pop_front();
+        }
+    }
 
-            if (produce_error == RdKafka::ERR_NO_ERROR) {
-                PLOG(logDEBUG) <<"Queued message:" << message;
-                retry = false;
-            }
-            else 
-            {
-                PLOG(logERROR) <<"Failed to queue message:" << message <<" with error:" << RdKafka::err2str(produce_error);
-                if (produce_error == RdKafka::ERR__QUEUE_FULL) {
-                    PLOG(logERROR) <<"Message queue full...retrying...";
-                    _producer->poll(500);  /* ms */
-                    retry = true;
-                }
-                else {
-                    PLOG(logERROR) <<"Unhandled error in queue_kafka_message:" << RdKafka::err2str(produce_error);
-                    retry = false;
-                }
-            }	
+    void kafka_producer_worker::poll(int timeout_ms)
+    {
+        if (!_producer)
+            return;
+
+        _producer->poll(timeout_ms);
+
+        std::lock_guard<std::mutex> lock(_spill_lock);
+        drain_spill();
+    }
+
+    kafka_producer_metrics kafka_producer_worker::get_metrics() const
+    {
+        kafka_producer_metrics metrics;
+        metrics.queued = _queued;
+        metrics.delivered = _producer_delivery_report_cb.delivered;
+        metrics.delivered_bytes = _producer_delivery_report_cb.delivered_bytes;
+        metrics.failed = _failed + _producer_delivery_report_cb.failed;
+        metrics.spilled = _spilled;
+        metrics.dropped = _dropped;
+        {
+            std::lock_guard<std::mutex> lock(_spill_lock);
+            metrics.spill_depth = _spill.size();
         }
+        return metrics;
     }
 
     void kafka_producer_worker::stop()
@@ -223,6 +309,13 @@ namespace tmx::utils
         {
             if (_producer)
             {
+                // Hand any held messages to librdkafka as room is made for them
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                while (get_metrics().spill_depth > 0 && std::chrono::steady_clock::now() < deadline)
+                    poll(100);
+                if (get_metrics().spill_depth > 0)
+                    FILE_LOG(logERROR) << _producer->name() << " " << get_metrics().spill_depth << " held message(s) were not sent." << std::endl;
+
                 auto error =_producer->flush(10 * 1000 /* wait for max 10 seconds */);
                 if (error == RdKafka::ERR__TIMED_OUT)
                     FILE_LOG(logERROR) << "Flush attempt timed out!" << std::endl;
@@ -7,6 +7,10 @@
 #include <cstdio>
 #include <csignal>
 #include <cstring>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <PluginLog.h>
 #include <TmxLog.h>
 
@@ -14,12 +18,36 @@
 
 namespace tmx::utils
 {  
+    /**
+     * @brief Counts of the messages sent by a kafka_producer_worker.
+     */
+    struct kafka_producer_metrics
+    {
+        // Messages handed to librdkafka to deliver
+        uint64_t queued = 0;
+        // Messages the broker acknowledged
+        uint64_t delivered = 0;
+        uint64_t delivered_bytes = 0;
+        // Messages that could not be queued or were not delivered
+        uint64_t failed = 0;
+        // Messages held in the spill queue because the librdkafka queue was full
+        uint64_t spilled = 0;
+        // Messages discarded because the spill queue was full
+        uint64_t dropped = 0;
+        // Messages waiting in the spill queue now
+        size_t spill_depth = 0;
+    };
+
     class producer_delivery_report_cb : public RdKafka::DeliveryReportCb
     {
         public:
             producer_delivery_report_cb() = default;
             ~producer_delivery_report_cb() override = default;
             void dr_cb (RdKafka::Message &message) override;
+
+            std::atomic<uint64_t> delivered{0};
+            std::atomic<uint64_t> delivered_bytes{0};
+            std::atomic<uint64_t> failed{0};
     };
     class producer_event_cb:public RdKafka::EventCb
     {
@@ -36,6 +64,13 @@ namespace tmx::utils
             const std::string DR_CB="dr_cb";
             const std::string EVENT_CB="event_cb";
 
+            // A message waiting for room in the librdkafka queue. An empty topic is the topic of the worker.
+            struct spilled_message
+            {
+                std::string topic;
+                std::string payload;
+            };
+
             RdKafka::Producer *_producer = nullptr;
             RdKafka::Topic *_topic = nullptr;
             std::string _topics_str = "";
@@ -44,8 +79,23 @@ namespace tmx::utils
             int _partition = 0;
             producer_delivery_report_cb _producer_delivery_report_cb;
             producer_event_cb _producer_event_cb;
+            std::map<std::string, std::string> _conf;
+
+            // Messages that did not fit in the librdkafka queue, sent before any newer message
+            mutable std::mutex _spill_lock;
+            mutable std::deque<spilled_message> _spill;
+            size_t _max_spill = DEFAULT_MAX_SPILL;
+            mutable std::atomic<uint64_t> _queued{0};
+            mutable std::atomic<uint64_t> _failed{0};
+            mutable std::atomic<uint64_t> _spilled{0};
+            mutable std::atomic<uint64_t> _dropped{0};
+
+            RdKafka::ErrorCode produce(const std::string &topic, const std::string &payload) const;
+            void produce_or_spill(const std::string &topic, const std::string &payload) const;
+            void drain_spill() const;
 
         public:
+            static constexpr size_t DEFAULT_MAX_SPILL = 10000;
             /**
              * @brief Construct a new kafka producer worker object
              * 
@@ -92,17 +142,44 @@ namespace tmx::utils
              * @return false if unsuccessful.
              */
             virtual bool init_producer();
+            /**
+             * @brief Set a librdkafka configuration property, such as linger.ms or queue.buffering.max.messages,
+             * to apply when the producer is initialized.
+             * @param name property name.
+             * @param value property value.
+             */
+            void set_conf(const std::string &name, const std::string &value);
+            /**
+             * @brief Set the most messages to hold while the librdkafka queue is full. Once the spill queue is
+             * full, the oldest message in it is dropped to make room. 0 drops any message that does not fit.
+             * @param max_spill the most messages to hold.
+             */
+            void set_max_spill(size_t max_spill);
             /**
              * @brief Produce to topic. Will result in segmentation fault if init() is not called on producer first.
+             * Does not wait: a message that does not fit in the librdkafka queue is held in the spill queue
+             * and sent by a later call.
              * @param msg message to produce.
              */
             virtual void send(const std::string &msg);
             /**
              * @brief Produce to a specific topic. Will result in segmentation fault if init() is not called on producer first.
+             * Does not wait: a message that does not fit in the librdkafka queue is held in the spill queue
+             * and sent by a later call.
              * @param msg message to produce.
              * @param topic_name topic to send the message to.
              */
             virtual void send(const std::string& message, const std::string& topic_name ) const;
+            /**
+             * @brief Serve delivery reports and send any messages held in the spill queue. Call periodically
+             * while not sending, so that held messages are not kept waiting for the next send.
+             * @param timeout_ms timeout in milliseconds to wait for delivery reports.
+             */
+            virtual void poll(int timeout_ms = 0);
+            /**
+             * @brief Get the counts of messages sent, delivered, failed and held so far.
+             */
+            kafka_producer_metrics get_metrics() const;
             /**
              * @brief Is kafka_producer_worker still running?
              * 
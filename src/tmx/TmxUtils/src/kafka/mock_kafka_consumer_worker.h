@@ -30,6 +30,7 @@ namespace tmx::utils {
 
             MOCK_METHOD(bool, init,(),(override));
             MOCK_METHOD(const char*, consume, (int timeout_ms), (override));
+            MOCK_METHOD(kafka_message_batch, consume_batch, (size_t max_msgs, int timeout_ms), (override));
             MOCK_METHOD(void, subscribe, (), (override));
             MOCK_METHOD(void, printCurrConf, (), (override));
             MOCK_METHOD(bool, is_running, (), (const override));
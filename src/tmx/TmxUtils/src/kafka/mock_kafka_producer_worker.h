@@ -25,6 +25,8 @@ namespace tmx::utils {
             ~mock_kafka_producer_worker() = default;
             MOCK_METHOD(bool, init,(),(override));
             MOCK_METHOD(void, send, (const std::string &msg), (override));
+            MOCK_METHOD(void, send, (const std::string &msg, const std::string &topic_name), (const, override));
+            MOCK_METHOD(void, poll, (int timeout_ms), (override));
             MOCK_METHOD(bool, is_running, (), (const, override));
             MOCK_METHOD(void, printCurrConf, (), (override));
     };
@@ -0,0 +1,245 @@
+/*
+ * AsyncLogTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <AsyncLog.h>
+#include <PluginLog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+using namespace std::chrono;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+class AsyncLogTest : public testing::Test {
+protected:
+	void SetUp() {
+		_file = tmpfile();
+	}
+
+	void TearDown() {
+		fclose(_file);
+	}
+
+	string Contents() {
+		fflush(_file);
+		rewind(_file);
+		string contents;
+		char buf[4096];
+		size_t n;
+		while ((n = fread(buf, 1, sizeof(buf), _file)) > 0)
+			contents.append(buf, n);
+		return contents;
+	}
+
+	vector<string> Lines() {
+		vector<string> lines;
+		istringstream in(Contents());
+		for (string line; getline(in, line); )
+			lines.push_back(line);
+		return lines;
+	}
+
+	bool Write(AsyncLog &log, LogLevel level, const string &text, FILE *stream = NULL) {
+		LogMessage msg(NULL, level, "", __FILE__, __LINE__);
+		msg.log = text;
+		return log.Write(stream ? stream : _file, msg);
+	}
+
+	FILE *_file;
+};
+
+TEST_F(AsyncLogTest, WritesMessagesFromManyThreadsInOrder) {
+	static constexpr int threads = 4;
+	static constexpr int count = 5000;
+
+	AsyncLog log(256, AsyncLog::Block);
+	log.Start();
+
+	vector<thread> writers;
+	for (int t = 0; t < threads; t++) {
+		writers.emplace_back([this, &log, t]() {
+			for (int i = 0; i < count; i++)
+				ASSERT_TRUE(Write(log, logINFO, "thread " + to_string(t) + " message " + to_string(i)));
+		});
+	}
+	for (auto &writer : writers)
+		writer.join();
+	log.Stop();
+
+	ASSERT_EQ((uint64_t)threads * count, log.GetWriteCount());
+	ASSERT_EQ(0u, log.GetDropCount());
+
+	auto lines = Lines();
+	ASSERT_EQ((size_t)threads * count, lines.size());
+
+	// The messages of each thread are in the order they were logged
+	vector<int> next(threads, 0);
+	for (auto &line : lines) {
+		int t, i;
+		ASSERT_EQ(2, sscanf(line.substr(line.find(": thread")).c_str(), ": thread %d message %d", &t, &i)) << line;
+		ASSERT_EQ(next[t]++, i);
+	}
+}
+
+TEST_F(AsyncLogTest, FormatsLikeTheFileLog) {
+	AsyncLog log;
+	log.Start();
+	Write(log, logWARNING, "Something to note");
+	log.Stop();
+
+	auto lines = Lines();
+	ASSERT_EQ(1u, lines.size());
+	ASSERT_NE(string::npos, lines[0].find("AsyncLogTest.cpp"));
+	ASSERT_NE(string::npos, lines[0].find(" - WARNING: Something to note"));
+
+	// The time is when the message was logged
+	ASSERT_EQ('[', lines[0][0]);
+	ASSERT_NE("[1970", lines[0].substr(0, 5));
+}
+
+TEST_F(AsyncLogTest, WritesErrorsBeforeReturning) {
+	AsyncLog log(1024, AsyncLog::DropDebug, milliseconds(10000));
+	log.Start();
+
+	Write(log, logINFO, "Before");
+	Write(log, logERROR, "Failed");
+
+	auto contents = Contents();
+	ASSERT_NE(string::npos, contents.find("Before"));
+	ASSERT_NE(string::npos, contents.find("Failed"));
+}
+
+TEST_F(AsyncLogTest, AppliesOverflowPolicy) {
+	// Stall the background thread on a pipe that is not being read
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	FILE *pipeOut = fdopen(fds[1], "w");
+
+	AsyncLog log(4, AsyncLog::DropDebug);
+	log.Start();
+	Write(log, logINFO, string(256 * 1024, 'x'), pipeOut);
+	this_thread::sleep_for(milliseconds(50));
+
+	// Each thread has its own queue, so fill one from another thread that can then be left waiting
+	promise<uint64_t> filled;
+	auto writer = async(launch::async, [&]() {
+		for (int i = 0; i < 4; i++)
+			Write(log, logINFO, "queued " + to_string(i), pipeOut);
+
+		// Debug messages are dropped, anything else waits for room
+		Write(log, logDEBUG, "dropped", pipeOut);
+		Write(log, logDEBUG1, "dropped", pipeOut);
+		filled.set_value(log.GetDropCount());
+
+		return Write(log, logWARNING, "waited", pipeOut);
+	});
+
+	ASSERT_EQ(2u, filled.get_future().get());
+	ASSERT_EQ(future_status::timeout, writer.wait_for(milliseconds(50)));
+
+	auto reader = async(launch::async, [&]() {
+		string contents;
+		char buf[4096];
+		ssize_t n;
+		while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+			contents.append(buf, n);
+		close(fds[0]);
+		return contents;
+	});
+
+	ASSERT_TRUE(writer.get());
+	log.Stop();
+	fclose(pipeOut);
+
+	auto contents = reader.get();
+	ASSERT_NE(string::npos, contents.find("queued 3"));
+	ASSERT_NE(string::npos, contents.find("waited"));
+	ASSERT_EQ(string::npos, contents.find("dropped"));
+	ASSERT_NE(string::npos, contents.find("Dropped 2 log messages"));
+}
+
+TEST_F(AsyncLogTest, FileLogWritesAsynchronously) {
+	FILE *previous = Output2FILE::Stream();
+	Output2FILE::Stream() = _file;
+
+	FILE_LOG(logERROR) << "Through the file log " << 42;
+
+	Output2FILE::Stream() = previous;
+	ASSERT_NE(string::npos, Contents().find("ERROR  : Through the file log 42"));
+}
+
+/**
+ * Log calls per second, and how long each call takes, writing to a file directly and asynchronously.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+TEST_F(AsyncLogTest, DISABLED_Benchmark) {
+	static constexpr int count = 50000;
+
+	FILE *previousStream = Output2FILE::Stream();
+	LogLevel previousLevel = FILELog::ReportingLevel();
+	bool previousAsync = Output2FILE::Async();
+	AsyncLog::OverflowPolicy previousPolicy = AsyncLog::Instance().GetOverflowPolicy();
+
+	Output2FILE::Stream() = _file;
+	AsyncLog::Instance().SetOverflowPolicy(AsyncLog::Block);
+
+	struct Case { const char *name; LogLevel reporting; LogLevel level; };
+	const vector<Case> cases = {
+		{ "INFO at INFO", logINFO, logINFO },
+		{ "DEBUG at INFO (filtered)", logINFO, logDEBUG },
+		{ "DEBUG at DEBUG", logDEBUG, logDEBUG }
+	};
+
+	vector<nanoseconds> latencies(count);
+	double syncMedian = 0, asyncMedian = 0;
+
+	for (bool async : { false, true }) {
+		Output2FILE::Async() = async;
+		cout << (async ? "Asynchronous" : "Direct") << " file log" << endl;
+
+		for (auto &c : cases) {
+			FILELog::ReportingLevel() = c.reporting;
+
+			auto start = steady_clock::now();
+			for (int i = 0; i < count; i++) {
+				auto before = steady_clock::now();
+				FILE_LOG(c.level) << "Received message " << i << " from " << "10.0.0.1" << " with " << 3.5 << " ms latency";
+				latencies[i] = steady_clock::now() - before;
+			}
+			AsyncLog::Instance().Flush();
+			double elapsed = duration<double>(steady_clock::now() - start).count();
+
+			sort(latencies.begin(), latencies.end());
+			auto p50 = latencies[count / 2].count(), p99 = latencies[count * 99 / 100].count();
+			printf("  %-26s %10.0f calls/s  p50 %6lld ns  p99 %7lld ns\n", c.name, count / elapsed, (long long)p50, (long long)p99);
+
+			if (c.level == logINFO)
+				(async ? asyncMedian : syncMedian) = p50;
+		}
+	}
+
+	Output2FILE::Stream() = previousStream;
+	FILELog::ReportingLevel() = previousLevel;
+	Output2FILE::Async() = previousAsync;
+	AsyncLog::Instance().SetOverflowPolicy(previousPolicy);
+
+	ASSERT_LT(asyncMedian, syncMedian);
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,329 @@
+/*
+ * ByteCodecTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <Base64.h>
+#include <tmx/messages/byte_stream.hpp>
+#include <tmx/utils/ByteCodec.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace tmx;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+static const string Base64Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Straightforward versions of the codecs, to check every implementation against
+string ReferenceHexEncode(const byte_stream &bytes) {
+	string hex;
+	char buf[3];
+	for (auto b : bytes) {
+		snprintf(buf, sizeof(buf), "%02x", b);
+		hex += buf;
+	}
+	return hex;
+}
+
+byte_stream ReferenceHexDecode(const string &hex) {
+	byte_stream bytes;
+	for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+		if (!isxdigit((unsigned char)hex[i]) || !isxdigit((unsigned char)hex[i + 1]))
+			break;
+		bytes.push_back((byte_t)strtoul(hex.substr(i, 2).c_str(), NULL, 16));
+	}
+	return bytes;
+}
+
+string ReferenceBase64Encode(const byte_stream &bytes) {
+	string out;
+	for (size_t i = 0; i < bytes.size(); i += 3) {
+		uint32_t group = bytes[i] << 16;
+		if (i + 1 < bytes.size()) group |= bytes[i + 1] << 8;
+		if (i + 2 < bytes.size()) group |= bytes[i + 2];
+
+		out += Base64Alphabet[group >> 18];
+		out += Base64Alphabet[(group >> 12) & 0x3F];
+		out += i + 1 < bytes.size() ? Base64Alphabet[(group >> 6) & 0x3F] : '=';
+		out += i + 2 < bytes.size() ? Base64Alphabet[group & 0x3F] : '=';
+	}
+	return out;
+}
+
+string ReferenceBase64Decode(const string &in) {
+	string out;
+	uint32_t group = 0;
+	int count = 0;
+	for (char c : in) {
+		size_t value = Base64Alphabet.find(c);
+		if (c == '\0' || value == string::npos)
+			break;
+		group = group << 6 | value;
+		if (++count == 4) {
+			out += (char)(group >> 16);
+			out += (char)(group >> 8);
+			out += (char)group;
+			group = 0;
+			count = 0;
+		}
+	}
+	group <<= 6 * (4 - count);
+	if (count > 1) out += (char)(group >> 16);
+	if (count > 2) out += (char)(group >> 8);
+	return out;
+}
+
+class ByteCodecTest : public testing::Test {
+protected:
+	void SetUp() {
+		_default = byteCodec_getImplementation();
+	}
+
+	void TearDown() {
+		byteCodec_setImplementation(_default);
+	}
+
+	vector<ByteCodecImpl> Implementations() {
+		vector<ByteCodecImpl> impls;
+		for (auto impl : { ByteCodecImpl_Scalar, ByteCodecImpl_Sse2, ByteCodecImpl_Avx2, ByteCodecImpl_Neon }) {
+			if (byteCodec_setImplementation(impl))
+				impls.push_back(impl);
+		}
+		byteCodec_setImplementation(_default);
+		return impls;
+	}
+
+	byte_stream RandomBytes(size_t length) {
+		byte_stream bytes(length);
+		for (auto &b : bytes)
+			b = (byte_t)_random();
+		return bytes;
+	}
+
+	// Replaces one random character, sometimes with one that is valid in the alphabet
+	void Corrupt(string &str) {
+		static const char junk[] = "=gG \n-_.\x80\xff\0";
+		if (!str.empty())
+			str[_random() % str.size()] = junk[_random() % (sizeof(junk) - 1)];
+	}
+
+	ByteCodecImpl _default;
+	mt19937 _random { 17 };
+};
+
+TEST_F(ByteCodecTest, PicksTheBestImplementation) {
+	auto impls = Implementations();
+	ASSERT_EQ(impls.back(), _default);
+	cout << "Using the " << byteCodec_getImplementationName(_default) << " byte codec" << endl;
+}
+
+TEST_F(ByteCodecTest, HexMatchesReference) {
+	for (auto impl : Implementations()) {
+		ASSERT_TRUE(byteCodec_setImplementation(impl));
+		SCOPED_TRACE(byteCodec_getImplementationName(impl));
+
+		for (size_t length = 0; length < 300; length++) {
+			auto bytes = RandomBytes(length);
+			auto hex = ReferenceHexEncode(bytes);
+
+			string encoded(hex.size(), ' ');
+			byteCodec_hexEncode(bytes.data(), bytes.size(), &encoded[0]);
+			ASSERT_EQ(hex, encoded);
+
+			// Either case decodes
+			for (size_t i = 0; i < hex.size(); i += 3)
+				hex[i] = toupper(hex[i]);
+
+			byte_stream decoded(length);
+			ASSERT_EQ(length, byteCodec_hexDecode(hex.data(), hex.size(), decoded.data()));
+			ASSERT_EQ(bytes, decoded);
+
+			Corrupt(hex);
+			auto expected = ReferenceHexDecode(hex);
+			decoded.assign(length, 0);
+			ASSERT_EQ(expected.size(), byteCodec_hexDecode(hex.data(), hex.size(), decoded.data()));
+			decoded.resize(expected.size());
+			ASSERT_EQ(expected, decoded);
+		}
+	}
+}
+
+TEST_F(ByteCodecTest, Base64MatchesReference) {
+	for (auto impl : Implementations()) {
+		ASSERT_TRUE(byteCodec_setImplementation(impl));
+		SCOPED_TRACE(byteCodec_getImplementationName(impl));
+
+		for (size_t length = 0; length < 300; length++) {
+			auto bytes = RandomBytes(length);
+			auto base64 = ReferenceBase64Encode(bytes);
+
+			ASSERT_EQ(base64, Base64::Encode(bytes.data(), bytes.size()));
+			ASSERT_EQ(string(bytes.begin(), bytes.end()), Base64::Decode(base64));
+
+			Corrupt(base64);
+			ASSERT_EQ(ReferenceBase64Decode(base64), Base64::Decode(base64));
+		}
+	}
+}
+
+TEST_F(ByteCodecTest, Base64KnownValues) {
+	const vector<pair<string, string>> values = {
+		{ "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+		{ "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" }
+	};
+
+	for (auto &value : values) {
+		ASSERT_EQ(value.second, Base64::Encode((const unsigned char *)value.first.data(), value.first.size()));
+		ASSERT_EQ(value.first, Base64::Decode(value.second));
+	}
+
+	// A partial group decodes as far as it goes
+	ASSERT_EQ("foob", Base64::Decode("Zm9vYg"));
+	ASSERT_EQ("foo", Base64::Decode("Zm9v Ym"));
+}
+
+TEST_F(ByteCodecTest, ByteStreamDecodeIsStillLenient) {
+	ASSERT_EQ(byte_stream({ 0x01, 0xab, 0xc0 }), byte_stream_decode("01ABc"));
+	ASSERT_EQ(byte_stream({ 0x01, 0x00, 0x0a, 0x20 }), byte_stream_decode("01g1ax20"));
+	ASSERT_EQ("00ff10", byte_stream_encode({ 0x00, 0xff, 0x10 }));
+}
+
+/**
+ * Throughput of each implementation over a 1 MB buffer, next to the approaches it replaced.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+class ByteCodecBenchmark : public ByteCodecTest {
+protected:
+	static constexpr size_t Size = 1 << 20;
+
+	double Measure(const function<void()> &operation, size_t bytes) {
+		operation();
+
+		int iterations = 0;
+		auto start = chrono::steady_clock::now();
+		chrono::duration<double> elapsed;
+		do {
+			operation();
+			iterations++;
+			elapsed = chrono::steady_clock::now() - start;
+		} while (elapsed.count() < 0.2);
+
+		return (double)bytes * iterations / elapsed.count() / 1e9;
+	}
+
+	void Report(const string &name, double gbps) {
+		printf("  %-34s %8.3f GB/s\n", name.c_str(), gbps);
+	}
+};
+
+TEST_F(ByteCodecBenchmark, DISABLED_Hex) {
+	auto bytes = RandomBytes(Size);
+	auto hex = byte_stream_encode(bytes);
+	byte_stream decoded(Size);
+	string encoded(2 * Size, ' ');
+
+	cout << "Hex encode" << endl;
+	Report("stringstream (legacy)", Measure([&]() {
+		ostringstream out;
+		for (auto b : bytes)
+			out << std::hex << setw(2) << setfill('0') << (int)b;
+		encoded = out.str();
+	}, Size));
+
+	double fastest = 0;
+	for (auto impl : Implementations()) {
+		byteCodec_setImplementation(impl);
+		double gbps = Measure([&]() { byteCodec_hexEncode(bytes.data(), bytes.size(), &encoded[0]); }, Size);
+		Report(byteCodec_getImplementationName(impl), gbps);
+		fastest = max(fastest, gbps);
+	}
+
+	cout << "Hex decode" << endl;
+	double legacy = Measure([&]() {
+		byte_stream out;
+		out.reserve(hex.size() / 2);
+		for (size_t i = 0; i < hex.size(); i += 2)
+			out.push_back((uint8_t)strtol(hex.substr(i, 2).c_str(), nullptr, 16));
+		decoded.swap(out);
+	}, Size);
+	Report("strtol per pair (legacy)", legacy);
+
+	fastest = 0;
+	for (auto impl : Implementations()) {
+		byteCodec_setImplementation(impl);
+		double gbps = Measure([&]() { byteCodec_hexDecode(hex.data(), hex.size(), decoded.data()); }, Size);
+		Report(byteCodec_getImplementationName(impl), gbps);
+		fastest = max(fastest, gbps);
+	}
+
+	ASSERT_EQ(bytes, decoded);
+	ASSERT_GT(fastest, legacy);
+}
+
+TEST_F(ByteCodecBenchmark, DISABLED_Base64) {
+	auto bytes = RandomBytes(Size);
+	string base64 = Base64::Encode(bytes.data(), bytes.size());
+	string encoded(base64.size(), ' ');
+	byte_stream decoded(Size + 2);
+
+	cout << "Base64 encode" << endl;
+	Report("per character append (legacy)", Measure([&]() {
+		string out;
+		for (size_t i = 0; i + 2 < bytes.size(); i += 3) {
+			out += Base64Alphabet[bytes[i] >> 2];
+			out += Base64Alphabet[((bytes[i] & 0x03) << 4) + (bytes[i + 1] >> 4)];
+			out += Base64Alphabet[((bytes[i + 1] & 0x0f) << 2) + (bytes[i + 2] >> 6)];
+			out += Base64Alphabet[bytes[i + 2] & 0x3f];
+		}
+		encoded.swap(out);
+	}, Size));
+
+	for (auto impl : Implementations()) {
+		byteCodec_setImplementation(impl);
+		Report(byteCodec_getImplementationName(impl),
+				Measure([&]() { byteCodec_base64Encode(bytes.data(), bytes.size(), &encoded[0]); }, Size));
+	}
+
+	cout << "Base64 decode" << endl;
+	double legacy = Measure([&]() {
+		string out;
+		unsigned char group[4];
+		for (size_t i = 0; i + 3 < base64.size() && base64[i + 3] != '='; i += 4) {
+			for (int j = 0; j < 4; j++)
+				group[j] = Base64Alphabet.find(base64[i + j]);
+			out += (char)((group[0] << 2) + ((group[1] & 0x30) >> 4));
+			out += (char)(((group[1] & 0xf) << 4) + ((group[2] & 0x3c) >> 2));
+			out += (char)(((group[2] & 0x3) << 6) + group[3]);
+		}
+	}, Size);
+	Report("alphabet find (legacy)", legacy);
+
+	double fastest = 0;
+	for (auto impl : Implementations()) {
+		byteCodec_setImplementation(impl);
+		double gbps = Measure([&]() { byteCodec_base64Decode(base64.data(), base64.size(), decoded.data()); }, Size);
+		Report(byteCodec_getImplementationName(impl), gbps);
+		fastest = max(fastest, gbps);
+	}
+
+	decoded.resize(Size);
+	ASSERT_EQ(bytes, decoded);
+	ASSERT_GT(fastest, legacy);
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,212 @@
+/*
+ * ConversionCacheTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <ConversionCache.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+// A clock that only moves when told to
+struct ManualClock
+{
+	typedef steady_clock::duration duration;
+	typedef duration::rep rep;
+	typedef duration::period period;
+	typedef chrono::time_point<ManualClock> time_point;
+	static constexpr bool is_steady = true;
+
+	static time_point now() { return time_point(elapsed); }
+
+	static duration elapsed;
+};
+
+ManualClock::duration ManualClock::elapsed;
+
+class ConversionCacheTest : public testing::Test {
+protected:
+	typedef ConversionCache<string, ManualClock> Cache;
+
+	void SetUp() {
+		ManualClock::elapsed = ManualClock::duration::zero();
+	}
+
+	static Cache::ValuePtr Find(Cache &cache, const string &type, const string &bytes) {
+		return cache.Find(type, bytes.data(), bytes.size());
+	}
+
+	static void Insert(Cache &cache, const string &type, const string &bytes, const string &value) {
+		cache.Insert(type, bytes.data(), bytes.size(), value);
+	}
+};
+
+TEST_F(ConversionCacheTest, FindsValueForSameBytesAndType) {
+	Cache cache;
+	ASSERT_FALSE(Find(cache, "MAP-P", "00128a01"));
+
+	Insert(cache, "MAP-P", "00128a01", "converted");
+
+	auto value = Find(cache, "MAP-P", "00128a01");
+	ASSERT_TRUE(value);
+	ASSERT_EQ("converted", *value);
+
+	ASSERT_FALSE(Find(cache, "MAP-P", "00128a02"));
+	ASSERT_FALSE(Find(cache, "MAP-P", "00128a0"));
+	ASSERT_FALSE(Find(cache, "TIM", "00128a01"));
+
+	ASSERT_EQ(1u, cache.GetHitCount());
+	ASSERT_EQ(4u, cache.GetMissCount());
+	ASSERT_DOUBLE_EQ(20.0, cache.GetHitRate());
+}
+
+TEST_F(ConversionCacheTest, ReplacesValueForSameBytes) {
+	Cache cache;
+	Insert(cache, "MAP-P", "0012", "first");
+	Insert(cache, "MAP-P", "0012", "second");
+
+	ASSERT_EQ(1u, cache.GetSize());
+	ASSERT_EQ("second", *Find(cache, "MAP-P", "0012"));
+}
+
+TEST_F(ConversionCacheTest, ExpiresByTypeTtl) {
+	Cache cache(16, milliseconds(1000));
+	cache.SetTtl("MAP-P", milliseconds(5000));
+	ASSERT_EQ(milliseconds(1000), cache.GetTtl("TIM"));
+	ASSERT_EQ(milliseconds(5000), cache.GetTtl("MAP-P"));
+
+	Insert(cache, "TIM", "001f", "tim");
+	Insert(cache, "MAP-P", "0012", "map");
+
+	ManualClock::elapsed = milliseconds(999);
+	ASSERT_TRUE(Find(cache, "TIM", "001f"));
+
+	// Using an entry does not extend it
+	ManualClock::elapsed = milliseconds(1000);
+	ASSERT_FALSE(Find(cache, "TIM", "001f"));
+	ASSERT_TRUE(Find(cache, "MAP-P", "0012"));
+
+	ManualClock::elapsed = milliseconds(5000);
+	ASSERT_FALSE(Find(cache, "MAP-P", "0012"));
+	ASSERT_EQ(0u, cache.GetSize());
+}
+
+TEST_F(ConversionCacheTest, ZeroTtlTurnsOffCaching) {
+	Cache cache;
+	cache.SetTtl("SDSM", milliseconds(0));
+
+	cache.Insert("SDSM", "0029", 4, "sdsm");
+	ASSERT_FALSE(Find(cache, "SDSM", "0029"));
+	ASSERT_EQ(0u, cache.GetSize());
+
+	// The value is still handed back
+	int conversions = 0;
+	for (int i = 0; i < 3; i++) {
+		auto value = cache.Get("SDSM", "0029", 4, [&]() { conversions++; return string("sdsm"); });
+		ASSERT_EQ("sdsm", *value);
+	}
+	ASSERT_EQ(3, conversions);
+}
+
+TEST_F(ConversionCacheTest, EvictsLeastRecentlyUsed) {
+	Cache cache(3);
+	Insert(cache, "MAP-P", "a", "1");
+	Insert(cache, "MAP-P", "b", "2");
+	Insert(cache, "MAP-P", "c", "3");
+
+	// Holding a value keeps it valid after it is evicted
+	auto a = Find(cache, "MAP-P", "a");
+
+	Insert(cache, "MAP-P", "d", "4");
+	ASSERT_EQ(3u, cache.GetSize());
+	ASSERT_EQ(1u, cache.GetEvictionCount());
+	ASSERT_FALSE(Find(cache, "MAP-P", "b"));
+	ASSERT_TRUE(Find(cache, "MAP-P", "a"));
+	ASSERT_TRUE(Find(cache, "MAP-P", "c"));
+	ASSERT_TRUE(Find(cache, "MAP-P", "d"));
+
+	cache.SetCapacity(1);
+	ASSERT_EQ(1u, cache.GetSize());
+	ASSERT_TRUE(Find(cache, "MAP-P", "d"));
+
+	cache.SetCapacity(0);
+	Insert(cache, "MAP-P", "e", "5");
+	ASSERT_EQ(0u, cache.GetSize());
+	ASSERT_EQ("1", *a);
+}
+
+TEST_F(ConversionCacheTest, ConvertsOnlyOnMiss) {
+	Cache cache;
+	const string bytes = "0012839338023000205e96094d40df4c2ca626c8516e02dc3c2010640000000289e01c009f603f42e88039900000000a41107b027d80fd0a4200c6400000002973c04ac";
+
+	int conversions = 0;
+	auto convert = [&]() { conversions++; return string("{\"map_data\":{}}"); };
+
+	bool hit = true;
+	auto first = cache.Get("MAP-P", bytes.data(), bytes.size(), convert, &hit);
+	ASSERT_FALSE(hit);
+
+	for (int i = 0; i < 10; i++) {
+		auto value = cache.Get("MAP-P", bytes.data(), bytes.size(), convert, &hit);
+		ASSERT_TRUE(hit);
+		ASSERT_EQ(first.get(), value.get());
+	}
+
+	ASSERT_EQ(1, conversions);
+	ASSERT_EQ(10u, cache.GetHitCount());
+
+	cache.Clear();
+	cache.Get("MAP-P", bytes.data(), bytes.size(), convert, &hit);
+	ASSERT_FALSE(hit);
+	ASSERT_EQ(2, conversions);
+}
+
+TEST_F(ConversionCacheTest, HashesEveryByte) {
+	string bytes(37, 'x');
+	uint64_t hash = Cache::Hash(bytes.data(), bytes.size());
+	ASSERT_EQ(hash, Cache::Hash(string(37, 'x').data(), 37));
+	ASSERT_NE(hash, Cache::Hash(bytes.data(), bytes.size(), 1));
+
+	for (size_t i = 0; i < bytes.size(); i++) {
+		string changed = bytes;
+		changed[i] = 'y';
+		ASSERT_NE(hash, Cache::Hash(changed.data(), changed.size())) << "Byte " << i;
+		ASSERT_NE(hash, Cache::Hash(bytes.data(), i)) << "Length " << i;
+	}
+}
+
+TEST_F(ConversionCacheTest, SharedBetweenThreads) {
+	static constexpr int threads = 4;
+	static constexpr int count = 20000;
+
+	ConversionCache<string> cache(8);
+
+	vector<thread> workers;
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&cache]() {
+			for (int i = 0; i < count; i++) {
+				string bytes = to_string(i % 12);
+				auto value = cache.Get("MAP-P", bytes.data(), bytes.size(), [&]() { return "converted " + bytes; });
+				ASSERT_EQ("converted " + bytes, *value);
+			}
+		});
+	}
+	for (auto &worker : workers)
+		worker.join();
+
+	ASSERT_EQ((uint64_t)threads * count, cache.GetHitCount() + cache.GetMissCount());
+	ASSERT_LE(cache.GetSize(), 8u);
+}
+
+} /* namespace unit_test */
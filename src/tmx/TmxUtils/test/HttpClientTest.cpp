@@ -0,0 +1,544 @@
+/*
+ * HttpClientTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <HttpClient.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+/**
+ * A minimal HTTP/1.1 server on the loopback interface that answers every request with a JSON
+ * body echoing the request body, and keeps the connections alive.  The first FailRequests
+ * requests are answered with FailStatus instead.
+ */
+class StubHttpServer {
+public:
+	StubHttpServer() {
+		_socket = socket(AF_INET, SOCK_STREAM, 0);
+		int on = 1;
+		setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		bind(_socket, (sockaddr *)&addr, sizeof(addr));
+		listen(_socket, 64);
+
+		socklen_t len = sizeof(addr);
+		getsockname(_socket, (sockaddr *)&addr, &len);
+		_port = ntohs(addr.sin_port);
+
+		_acceptThread = thread(&StubHttpServer::Accept, this);
+	}
+
+	~StubHttpServer() {
+		_run = false;
+		shutdown(_socket, SHUT_RDWR);
+		close(_socket);
+		_acceptThread.join();
+		for (auto &t : _connectionThreads)
+			t.join();
+	}
+
+	string Url() { return "http://127.0.0.1:" + to_string(_port) + "/v1/scms/sign"; }
+
+	vector<string> Methods() {
+		lock_guard<mutex> lock(_methodsLock);
+		return _methods;
+	}
+
+	atomic<int> Connections {0};
+	atomic<int> Requests {0};
+	atomic<int> FailRequests {0};
+	atomic<int> FailStatus {503};
+	atomic<int> RetryAfter {0};
+private:
+	void Accept() {
+		while (_run) {
+			int fd = accept(_socket, NULL, NULL);
+			if (fd < 0)
+				break;
+
+			Connections++;
+			_connectionThreads.emplace_back(&StubHttpServer::Serve, this, fd);
+		}
+	}
+
+	void Serve(int fd) {
+		string buffer;
+		char chunk[4096];
+
+		while (_run) {
+			size_t headerEnd = buffer.find("\r\n\r\n");
+			if (headerEnd == string::npos) {
+				ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+				if (n <= 0)
+					break;
+				buffer.append(chunk, n);
+				continue;
+			}
+
+			size_t length = 0;
+			size_t pos = buffer.find("Content-Length: ");
+			if (pos != string::npos && pos < headerEnd)
+				length = stoul(buffer.substr(pos + 16));
+
+			if (buffer.size() < headerEnd + 4 + length) {
+				ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+				if (n <= 0)
+					break;
+				buffer.append(chunk, n);
+				continue;
+			}
+
+			string body = buffer.substr(headerEnd + 4, length);
+			{
+				lock_guard<mutex> lock(_methodsLock);
+				_methods.push_back(buffer.substr(0, buffer.find(' ')));
+			}
+			buffer.erase(0, headerEnd + 4 + length);
+			Requests++;
+
+			string response;
+			if (FailRequests-- > 0) {
+				response = "HTTP/1.1 " + to_string(FailStatus) + " Failed\r\nContent-Length: 0\r\n";
+				if (RetryAfter > 0)
+					response += "Retry-After: " + to_string(RetryAfter) + "\r\n";
+				response += "\r\n";
+			} else {
+				string reply = "{\"signedMessage\":" + body + "}";
+				response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+						to_string(reply.size()) + "\r\n\r\n" + reply;
+			}
+			send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+		}
+
+		close(fd);
+	}
+
+	mutex _methodsLock;
+	vector<string> _methods;
+	int _socket;
+	int _port;
+	atomic<bool> _run {true};
+	thread _acceptThread;
+	vector<thread> _connectionThreads;
+};
+
+TEST(HttpClientTest, PostCompletesWithResponse)
+{
+	StubHttpServer server;
+	HttpClient client(4);
+
+	atomic<int> done {0};
+	HttpResponse result;
+	client.Post(server.Url(), "\"ABCD\"", [&](const HttpResponse &response) {
+		result = response;
+		done++;
+	});
+	client.Flush();
+
+	ASSERT_EQ(1, done);
+	ASSERT_EQ(200, result.Status);
+	ASSERT_TRUE(result.Error.empty());
+	ASSERT_EQ("{\"signedMessage\":\"ABCD\"}", result.Body);
+}
+
+TEST(HttpClientTest, ReusesConnectionsWithinWindow)
+{
+	StubHttpServer server;
+	HttpClient client(8);
+
+	static constexpr int count = 5000;
+	atomic<int> ok {0};
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		client.Post(server.Url(), "\"" + to_string(i) + "\"", [&](const HttpResponse &response) {
+			if (response.Status == 200)
+				ok++;
+		});
+
+		ASSERT_LE(client.GetInFlight(), client.GetMaxInFlight());
+	}
+	client.Flush();
+	auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "Signed " << count << " messages in " << elapsed << " s (" << (count / elapsed) << " msg/s) over "
+			<< server.Connections << " connection(s)" << endl;
+
+	ASSERT_EQ(count, ok);
+	ASSERT_EQ(count, server.Requests);
+	ASSERT_LE(server.Connections, (int)client.GetMaxInFlight());
+}
+
+TEST(HttpClientTest, ReportsConnectionFailure)
+{
+	int port;
+	{
+		// Find a port that nothing is listening on
+		StubHttpServer server;
+		port = stoi(server.Url().substr(17, 5));
+	}
+
+	HttpClient client(1, 1000);
+
+	HttpResponse result;
+	client.Post("http://127.0.0.1:" + to_string(port) + "/", "{}", [&](const HttpResponse &response) {
+		result = response;
+	});
+	client.Flush();
+
+	ASSERT_EQ(0, result.Status);
+	ASSERT_FALSE(result.Error.empty());
+}
+
+TEST(HttpClientTest, GetAndExecute)
+{
+	StubHttpServer server;
+	HttpClient client(2);
+
+	HttpResponse result;
+	client.Get(server.Url(), [&](const HttpResponse &response) { result = response; });
+	client.Flush();
+	ASSERT_EQ(200, result.Status);
+	ASSERT_EQ("{\"signedMessage\":}", result.Body);
+
+	// The same easy handle goes back to posting after a GET
+	result = client.Execute("POST", server.Url(), "\"EF\"");
+	ASSERT_EQ(200, result.Status);
+	ASSERT_EQ("{\"signedMessage\":\"EF\"}", result.Body);
+
+	result = client.Execute("PUT", server.Url(), "1");
+	ASSERT_EQ(200, result.Status);
+
+	ASSERT_EQ(vector<string>({ "GET", "POST", "PUT" }), server.Methods());
+}
+
+TEST(HttpClientTest, RetriesWithBackoff)
+{
+	StubHttpServer server;
+	server.FailRequests = 3;
+
+	HttpRetryPolicy policy;
+	policy.MaxAttempts = 4;
+	policy.InitialBackoff = chrono::milliseconds(20);
+	HttpClient client(2, 1000, policy);
+
+	// Waits at least 10 + 20 + 40 ms, half of each backoff being random
+	auto start = chrono::steady_clock::now();
+	HttpResponse result = client.Execute("PUT", server.Url(), "\"retried\"");
+	auto elapsed = chrono::steady_clock::now() - start;
+
+	ASSERT_EQ(200, result.Status);
+	ASSERT_EQ(4u, result.Attempts);
+	ASSERT_EQ(4, server.Requests);
+	ASSERT_EQ(3u, client.GetRetryCount());
+	ASSERT_GE(elapsed, chrono::milliseconds(70));
+
+	client.Flush();
+	ASSERT_EQ(0u, client.GetInFlight());
+}
+
+TEST(HttpClientTest, GivesUpAfterMaxAttempts)
+{
+	StubHttpServer server;
+	server.FailRequests = 10;
+
+	HttpRetryPolicy policy;
+	policy.MaxAttempts = 3;
+	policy.InitialBackoff = chrono::milliseconds(1);
+	HttpClient client(2, 1000, policy);
+
+	HttpResponse result = client.Execute("PUT", server.Url(), "{}");
+	ASSERT_EQ(503, result.Status);
+	ASSERT_EQ(3u, result.Attempts);
+	ASSERT_EQ(3, server.Requests);
+
+	// Client errors are not retried
+	server.FailStatus = 404;
+	result = client.Execute("PUT", server.Url(), "{}");
+	ASSERT_EQ(404, result.Status);
+	ASSERT_EQ(1u, result.Attempts);
+}
+
+TEST(HttpClientTest, HonorsRetryAfter)
+{
+	StubHttpServer server;
+	server.FailRequests = 1;
+	server.FailStatus = 429;
+	server.RetryAfter = 1;
+
+	HttpRetryPolicy policy;
+	policy.MaxAttempts = 2;
+	policy.InitialBackoff = chrono::milliseconds(1);
+	HttpClient client(2, 1000, policy);
+
+	auto start = chrono::steady_clock::now();
+	HttpResponse result = client.Execute("PUT", server.Url(), "{}");
+	ASSERT_EQ(200, result.Status);
+	ASSERT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(1000));
+
+	// But never past the longest backoff
+	server.FailRequests = 1;
+	server.RetryAfter = 60;
+	policy.MaxBackoff = chrono::milliseconds(50);
+	HttpClient capped(2, 1000, policy);
+
+	start = chrono::steady_clock::now();
+	result = capped.Execute("PUT", server.Url(), "{}");
+	ASSERT_EQ(200, result.Status);
+	ASSERT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(1000));
+}
+
+TEST(HttpClientTest, RetriesConnectionFailure)
+{
+	int port;
+	{
+		StubHttpServer server;
+		port = stoi(server.Url().substr(17, 5));
+	}
+
+	HttpRetryPolicy policy;
+	policy.MaxAttempts = 3;
+	policy.InitialBackoff = chrono::milliseconds(1);
+	HttpClient client(1, 1000, policy);
+
+	HttpResponse result = client.Execute("POST", "http://127.0.0.1:" + to_string(port) + "/", "{}");
+	ASSERT_EQ(0, result.Status);
+	ASSERT_FALSE(result.Error.empty());
+	ASSERT_EQ(3u, result.Attempts);
+}
+
+/**
+ * A loopback port that accepts connections, but never reads the requests or answers them.
+ */
+class SilentServer {
+public:
+	SilentServer() {
+		_socket = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		bind(_socket, (sockaddr *)&addr, sizeof(addr));
+		listen(_socket, 64);
+
+		socklen_t len = sizeof(addr);
+		getsockname(_socket, (sockaddr *)&addr, &len);
+		_port = ntohs(addr.sin_port);
+	}
+
+	~SilentServer() {
+		close(_socket);
+	}
+
+	string Url() { return "http://127.0.0.1:" + to_string(_port) + "/"; }
+
+private:
+	int _socket;
+	int _port;
+};
+
+TEST(HttpClientTest, DestroyWakesBlockedSenders)
+{
+	SilentServer server;
+	HttpClient *client = new HttpClient(1, 5000);
+
+	// The only place in the window is taken by a request that is never answered
+	atomic<int> completed {0};
+	client->Post(server.Url(), "{}", [&](const HttpResponse &) { completed++; });
+
+	atomic<int> returned {0};
+	vector<thread> callers;
+	callers.emplace_back([&]() { client->Post(server.Url(), "{}", [&](const HttpResponse &) { completed++; }); returned++; });
+	callers.emplace_back([&]() { client->Flush(); returned++; });
+	callers.emplace_back([&]() { client->Execute("POST", server.Url(), "{}"); returned++; });
+
+	this_thread::sleep_for(chrono::milliseconds(100));
+	ASSERT_EQ(0, returned);
+
+	// Every caller has returned by the time the destructor does
+	auto start = chrono::steady_clock::now();
+	delete client;
+	ASSERT_EQ(3, returned);
+	ASSERT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(1000));
+	ASSERT_EQ(0, completed);
+
+	for (auto &caller : callers)
+		caller.join();
+}
+
+TEST(HttpClientTest, CallbackCanSendWhenWindowIsFull)
+{
+	StubHttpServer server;
+	HttpClient client(1);
+
+	// The completing request still holds the only place in the window while its callback runs
+	atomic<int> done {0};
+	client.Post(server.Url(), "1", [&](const HttpResponse &) {
+		client.Post(server.Url(), "2", [&](const HttpResponse &response) {
+			if (response.Status == 200)
+				done++;
+		});
+		done++;
+	});
+
+	auto start = chrono::steady_clock::now();
+	while (done < 2 && chrono::steady_clock::now() - start < chrono::seconds(5))
+		this_thread::sleep_for(chrono::milliseconds(1));
+	client.Flush();
+
+	ASSERT_EQ(2, done);
+	ASSERT_EQ(2, server.Requests);
+	ASSERT_EQ(0u, client.GetInFlight());
+
+	// Waiting on the transfer thread would never finish
+	atomic<bool> threw {false};
+	client.Post(server.Url(), "3", [&](const HttpResponse &) {
+		try {
+			client.Flush();
+		} catch (HttpClientRuntimeError &) {
+			threw = true;
+		}
+	});
+	client.Flush();
+	ASSERT_TRUE(threw);
+}
+
+TEST(HttpClientTest, PostIsOnlyRetriedIfNotSent)
+{
+	HttpRetryPolicy policy;
+	policy.MaxAttempts = 3;
+	policy.InitialBackoff = chrono::milliseconds(1);
+
+	// The server may have acted on a POST that it answered with an error
+	StubHttpServer server;
+	server.FailRequests = 10;
+	HttpClient client(1, 200, policy);
+	HttpResponse result = client.Execute("POST", server.Url(), "{}");
+	ASSERT_EQ(503, result.Status);
+	ASSERT_EQ(1u, result.Attempts);
+	ASSERT_EQ(1, server.Requests);
+
+	// Or on one that it never answered
+	SilentServer silent;
+	result = client.Execute("POST", silent.Url(), "{}");
+	ASSERT_EQ(0, result.Status);
+	ASSERT_EQ(1u, result.Attempts);
+
+	// But a POST that could not connect was never sent, even on an easy handle that sent the ones above
+	int port;
+	{
+		StubHttpServer closed;
+		port = stoi(closed.Url().substr(17, 5));
+	}
+	result = client.Execute("POST", "http://127.0.0.1:" + to_string(port) + "/", "{}");
+	ASSERT_EQ(0, result.Status);
+	ASSERT_EQ(3u, result.Attempts);
+}
+
+TEST(HttpClientTest, TrySendDropsWhenWindowIsFull)
+{
+	SilentServer server;
+	HttpClient client(2, 5000);
+
+	auto start = chrono::steady_clock::now();
+	ASSERT_TRUE(client.TrySend("POST", server.Url(), "1", nullptr));
+	ASSERT_TRUE(client.TrySend("POST", server.Url(), "2", nullptr));
+	ASSERT_FALSE(client.TrySend("POST", server.Url(), "3", nullptr));
+	ASSERT_FALSE(client.TrySend("POST", server.Url(), "4", nullptr));
+	ASSERT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(100));
+
+	ASSERT_EQ(2u, client.GetInFlight());
+	ASSERT_EQ(2u, client.GetDroppedCount());
+}
+
+/**
+ * Requests per second and latency of a burst of requests, sent the way the cloud plugins used
+ * to, with a new thread and curl handle for each, and through one HttpClient.  Disabled by
+ * default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+TEST(HttpClientTest, DISABLED_Benchmark)
+{
+	// Each of the old requests holds its own connection, so keep within the default descriptor limit
+	static constexpr int count = 400;
+
+	StubHttpServer server;
+	string url = server.Url();
+
+	auto report = [](const char *name, vector<chrono::nanoseconds> &latencies, double elapsed, int connections) {
+		sort(latencies.begin(), latencies.end());
+		printf("  %-30s %8.0f req/s  p50 %7.3f ms  p99 %7.3f ms  %5d connections\n", name, latencies.size() / elapsed,
+				latencies[latencies.size() / 2].count() / 1e6, latencies[latencies.size() * 99 / 100].count() / 1e6,
+				connections);
+		return latencies[latencies.size() * 99 / 100];
+	};
+
+	vector<chrono::nanoseconds> latencies(count);
+	atomic<int> done {0};
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		auto sent = chrono::steady_clock::now();
+		thread([&, i, sent]() {
+			CURL *req = curl_easy_init();
+			string body = "\"" + to_string(i) + "\"";
+			curl_easy_setopt(req, CURLOPT_URL, url.c_str());
+			curl_easy_setopt(req, CURLOPT_POSTFIELDS, body.c_str());
+			curl_easy_setopt(req, CURLOPT_TIMEOUT_MS, 5000L);
+			curl_easy_setopt(req, CURLOPT_WRITEFUNCTION, +[](char *, size_t size, size_t n, void *) { return size * n; });
+			curl_easy_perform(req);
+			curl_easy_cleanup(req);
+			latencies[i] = chrono::steady_clock::now() - sent;
+			done++;
+		}).detach();
+	}
+	while (done < count)
+		this_thread::sleep_for(chrono::milliseconds(1));
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	int legacyConnections = server.Connections;
+	auto legacyP99 = report("thread + curl handle each", latencies, elapsed, legacyConnections);
+
+	HttpClient client(HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT);
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		auto sent = chrono::steady_clock::now();
+		client.Post(url, "\"" + to_string(i) + "\"", [&latencies, i, sent](const HttpResponse &) {
+			latencies[i] = chrono::steady_clock::now() - sent;
+		});
+	}
+	client.Flush();
+	elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	int clientConnections = server.Connections - legacyConnections;
+	auto clientP99 = report("HttpClient", latencies, elapsed, clientConnections);
+
+	ASSERT_EQ(2 * count, server.Requests);
+	ASSERT_LE(clientConnections, HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT);
+	ASSERT_LT(clientP99, legacyP99);
+}
+
+}
@@ -0,0 +1,295 @@
+/*
+ * IvpMessageBinaryTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <tmx/IvpMessage.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+class IvpMessageBinaryTest : public testing::Test {
+protected:
+	// Offsets into the binary layout of a message without DSRC metadata
+	static constexpr size_t PayloadTypeOffset = 1;
+	static constexpr size_t TypeOffset = 20;
+
+	void TearDown() override {
+		if (_msg != NULL)
+			ivpMsg_destroy(_msg);
+	}
+
+	IvpMessage *Create(cJSON *payload) {
+		if (_msg != NULL)
+			ivpMsg_destroy(_msg);
+		_msg = ivpMsg_create("J2735", "BSM", "bytearray/hexstring", IvpMsgFlags_RouteDSRC, payload);
+		cJSON_Delete(payload);
+		_msg->source = strdup("DsrcImmediateForward");
+		_msg->sourceId = 0x01020304;
+		_msg->timestamp = 0x0102030405060708ULL;
+		return _msg;
+	}
+
+	static string Binary(IvpMessage *msg) {
+		int length = 0;
+		char *data = ivpMsg_createBinary(msg, &length);
+		EXPECT_NE((char *)NULL, data);
+		string results(data == NULL ? "" : string(data, length));
+		free(data);
+		return results;
+	}
+
+	static IvpMessage *Parse(const string &data) {
+		return ivpMsg_parseBinary(data.data(), data.size());
+	}
+
+	static string Payload(IvpMessage *msg) {
+		if (msg->payload == NULL)
+			return "<none>";
+		char *json = cJSON_PrintUnformatted(msg->payload);
+		string results(json);
+		free(json);
+		return results;
+	}
+
+	static void ExpectSame(IvpMessage *expected, IvpMessage *actual) {
+		ASSERT_NE((IvpMessage *)NULL, actual);
+		auto same = [](const char *a, const char *b) { return a == NULL ? b == NULL : b != NULL && strcmp(a, b) == 0; };
+		EXPECT_TRUE(same(expected->type, actual->type));
+		EXPECT_TRUE(same(expected->subtype, actual->subtype));
+		EXPECT_TRUE(same(expected->source, actual->source));
+		EXPECT_TRUE(same(expected->encoding, actual->encoding));
+		EXPECT_EQ(expected->sourceId, actual->sourceId);
+		EXPECT_EQ(expected->timestamp, actual->timestamp);
+		EXPECT_EQ(expected->flags, actual->flags);
+		ASSERT_EQ(expected->dsrcMetadata == NULL, actual->dsrcMetadata == NULL);
+		if (expected->dsrcMetadata != NULL) {
+			EXPECT_EQ(expected->dsrcMetadata->psid, actual->dsrcMetadata->psid);
+			EXPECT_EQ(expected->dsrcMetadata->channel, actual->dsrcMetadata->channel);
+		}
+		EXPECT_EQ(Payload(expected), Payload(actual));
+	}
+
+	// Offset of the payload bytes, after the header strings and the 4 byte payload length
+	static size_t PayloadOffset(IvpMessage *msg) {
+		size_t offset = TypeOffset + 4;
+		for (const char *str : { msg->type, msg->subtype, msg->source, msg->encoding })
+			offset += 2 + (str == NULL ? 0 : strlen(str));
+		return offset;
+	}
+
+	// Round trips a string payload and returns the payload type byte it was sent as
+	int RoundTripString(const char *payload, size_t expectedPayloadBytes) {
+		IvpMessage *msg = Create(cJSON_CreateString(payload));
+		string data = Binary(msg);
+		EXPECT_EQ(expectedPayloadBytes, data.size() - PayloadOffset(msg));
+
+		IvpMessage *parsed = Parse(data);
+		ExpectSame(msg, parsed);
+		if (parsed != NULL)
+			ivpMsg_destroy(parsed);
+		return data[PayloadTypeOffset];
+	}
+
+	IvpMessage *_msg = NULL;
+};
+
+TEST_F(IvpMessageBinaryTest, AllFieldsRoundTrip) {
+	IvpMessage *msg = Create(cJSON_Parse("{\"a\":[1,2.5,\"x\"],\"b\":{\"c\":null}}"));
+	ivpMsg_addDsrcMetadata(msg, 0x8002, 172);
+	msg->flags |= IvpMsgFlags_BinaryFraming;
+
+	IvpMessage *parsed = Parse(Binary(msg));
+	ExpectSame(msg, parsed);
+	ivpMsg_destroy(parsed);
+}
+
+TEST_F(IvpMessageBinaryTest, NullStringsUseTheMarker) {
+	IvpMessage *msg = Create(NULL);
+	free(msg->source);
+	msg->source = NULL;
+	free(msg->encoding);
+	msg->encoding = strdup("");
+
+	string data = Binary(msg);
+
+	// J2735, BSM, then the null source as 0xFFFF and the empty encoding as a zero length
+	size_t source = TypeOffset + 2 + 5 + 2 + 3;
+	EXPECT_EQ(string("\xFF\xFF\x00\x00", 4), data.substr(source, 4));
+
+	IvpMessage *parsed = Parse(data);
+	ExpectSame(msg, parsed);
+	EXPECT_EQ(NULL, parsed->source);
+	EXPECT_STREQ("", parsed->encoding);
+	EXPECT_EQ(NULL, parsed->payload);
+	ivpMsg_destroy(parsed);
+}
+
+TEST_F(IvpMessageBinaryTest, HexPayloadsArePackedInTheirCase) {
+	EXPECT_EQ(3, RoundTripString("0014abcdef0123456789", 10));
+	EXPECT_EQ(4, RoundTripString("0014ABCDEF0123456789", 10));
+
+	// Digits alone can be either, and come back as lower case
+	EXPECT_EQ(3, RoundTripString("00140123", 4));
+}
+
+TEST_F(IvpMessageBinaryTest, OtherStringsAreSentAsIs) {
+	// Mixed case could not be recreated from the bytes
+	EXPECT_EQ(2, RoundTripString("0014abCD", 8));
+	EXPECT_EQ(2, RoundTripString("0014a", 5));
+	EXPECT_EQ(2, RoundTripString("0014xy", 6));
+	EXPECT_EQ(2, RoundTripString("", 0));
+}
+
+TEST_F(IvpMessageBinaryTest, TruncatedMessagesAreRejected) {
+	IvpMessage *msg = Create(cJSON_CreateString("0014abcdef"));
+	ivpMsg_addDsrcMetadata(msg, 0x20, 172);
+	string data = Binary(msg);
+
+	// Every field is needed, so no prefix of the message can be parsed
+	for (size_t length = 0; length < data.size(); length++)
+		EXPECT_EQ(NULL, ivpMsg_parseBinary(data.data(), length)) << "length " << length;
+
+	IvpMessage *parsed = Parse(data);
+	ExpectSame(msg, parsed);
+	ivpMsg_destroy(parsed);
+}
+
+TEST_F(IvpMessageBinaryTest, LengthsPastTheEndAreRejected) {
+	string data = Binary(Create(cJSON_CreateString("hello")));
+	size_t payload = PayloadOffset(_msg) - 4;
+
+	// The type string claims one byte more than the whole message
+	string badString = data;
+	badString[TypeOffset] = (char)((data.size() - TypeOffset - 1) >> 8);
+	badString[TypeOffset + 1] = (char)(data.size() - TypeOffset - 1);
+	EXPECT_EQ(NULL, Parse(badString));
+
+	// The payload claims one byte more than is left, then the most a 4 byte length can
+	string badPayload = data;
+	badPayload[payload + 3] = 6;
+	EXPECT_EQ(NULL, Parse(badPayload));
+	badPayload.replace(payload, 4, "\xFF\xFF\xFF\xFF");
+	EXPECT_EQ(NULL, Parse(badPayload));
+
+	// A string length just under the null marker
+	string badMarker = data;
+	badMarker.replace(TypeOffset, 2, "\xFF\xFE");
+	EXPECT_EQ(NULL, Parse(badMarker));
+}
+
+TEST_F(IvpMessageBinaryTest, BadHeadersAndPayloadsAreRejected) {
+	string data = Binary(Create(cJSON_CreateString("hello")));
+
+	string badVersion = data;
+	badVersion[0] = 2;
+	EXPECT_EQ(NULL, Parse(badVersion));
+
+	string badType = data;
+	badType[PayloadTypeOffset] = 5;
+	EXPECT_EQ(NULL, Parse(badType));
+
+	// The payload bytes are not valid JSON
+	string badJson = data;
+	badJson[PayloadTypeOffset] = 1;
+	badJson.replace(badJson.size() - 5, 5, "{\"a\":");
+	EXPECT_EQ(NULL, Parse(badJson));
+}
+
+/**
+ * The cost of encoding a message for the core and parsing it back, as the binary frame and as the JSON frame, for a
+ * hex encoded BSM and SPaT and for a JSON object payload.  Disabled by default, run with --gtest_also_run_disabled_tests
+ * --gtest_filter='*Benchmark*'.
+ */
+class IvpMessageBinaryBenchmark : public IvpMessageBinaryTest {
+protected:
+	static constexpr int Messages = 50000;
+
+	struct Result {
+		size_t bytes;
+		double perSecond;
+		double p50;
+		double p99;
+	};
+
+	// Encodes and parses the message over and over, and returns the frame size, the messages per second and the
+	// latency percentiles of one encode and parse, in nanoseconds
+	static Result Run(IvpMessage *msg, bool binary) {
+		vector<int64_t> latencies;
+		latencies.reserve(Messages);
+		size_t bytes = 0;
+
+		auto start = steady_clock::now();
+		for (int i = 0; i < Messages; i++) {
+			auto before = steady_clock::now();
+
+			int length = 0;
+			char *data;
+			IvpMessage *parsed;
+			if (binary) {
+				data = ivpMsg_createBinary(msg, &length);
+				parsed = ivpMsg_parseBinary(data, length);
+			} else {
+				data = ivpMsg_createJsonString(msg, IvpMsg_FormatOptions_none);
+				length = strlen(data);
+				parsed = ivpMsg_parse(data);
+			}
+
+			EXPECT_NE((IvpMessage *)NULL, parsed);
+			if (parsed != NULL)
+				ivpMsg_destroy(parsed);
+			free(data);
+			bytes = length;
+
+			latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - before).count());
+		}
+		double seconds = duration_cast<duration<double>>(steady_clock::now() - start).count();
+
+		sort(latencies.begin(), latencies.end());
+		return Result { bytes, Messages / seconds, (double)latencies[Messages / 2], (double)latencies[Messages * 99 / 100] };
+	}
+};
+
+TEST_F(IvpMessageBinaryBenchmark, DISABLED_BinaryAndJsonThroughput) {
+	struct Payload {
+		const char *name;
+		cJSON *payload;
+	};
+
+	vector<Payload> payloads = {
+		{ "BSM", cJSON_CreateString("00143d604043030280ffdbfba868b3584ec40824646400320032000c888fc834e37fff0aaa960fa0"
+				"040d082408801148d693a431ad275c7c6b49d9e8d693b60e") },
+		{ "SPaT", cJSON_CreateString("0013808f44d48a0383ebe5e7d24eee997973cb8fa69dfb84653e000013522886841c02010fefdccfe5"
+				"cfe5c00000000000e08df7ee67f067f06000000000002043fbf7340234023000000000000821fdfb99fee9fee800000000000c1"
+				"1befdccfe0cfe0c000000000008087f7ee67f2e7f2e000000000005043fbf733fdd3fdd000000000003021fdfb9a011a0118000"
+				"000000") },
+		{ "JSON", cJSON_Parse("{\"Latitude\":38.9549610,\"Longitude\":-77.1493030,\"Speed\":12.5,\"Heading\":271.2,"
+				"\"Lanes\":[1,2,3,4],\"Status\":\"Running\"}") }
+	};
+
+	printf("  %-6s %-6s %8s %12s %10s %10s\n", "msg", "frame", "bytes", "msgs/s", "p50 ns", "p99 ns");
+	for (const Payload &payload : payloads) {
+		IvpMessage *msg = Create(payload.payload);
+		for (bool binary : { false, true }) {
+			Result result = Run(msg, binary);
+			printf("  %-6s %-6s %8zu %12.0f %10.0f %10.0f\n", payload.name, binary ? "binary" : "json",
+					result.bytes, result.perSecond, result.p50, result.p99);
+			EXPECT_GT(result.perSecond, 0);
+		}
+	}
+}
+
+} /* namespace unit_test */
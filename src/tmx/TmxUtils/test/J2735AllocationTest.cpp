@@ -0,0 +1,147 @@
+/*
+ * J2735AllocationTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <tmx/j2735_messages/J2735MessageFactory.hpp>
+
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
+using namespace std;
+using namespace tmx;
+using namespace tmx::messages;
+
+// Counts the heap allocations made on this thread while counting is on.  Both operator new and the C
+// allocation functions are replaced, since the header strings, the JSON payload and the ASN.1 structs
+// are allocated from C.  The replaced operator new goes straight to the C library, so it is counted once.
+static thread_local bool countAllocations = false;
+static thread_local uint64_t allocationCount = 0;
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	if (countAllocations) allocationCount++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	if (countAllocations) allocationCount++;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	if (countAllocations) allocationCount++;
+	return __libc_realloc(ptr, size);
+}
+
+}
+
+void *operator new(size_t size)
+{
+	if (countAllocations) allocationCount++;
+	void *ptr = __libc_malloc(size ? size : 1);
+	if (!ptr)
+		throw bad_alloc();
+	return ptr;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+namespace unit_test {
+
+/**
+ * Measures the allocations made by a message manager worker for each BSM it receives, which creates the
+ * message with its long-lived J2735 factory and hands it to the plugin handler that decodes it.
+ */
+class J2735AllocationTest : public testing::Test {
+protected:
+	static constexpr int Messages = 100;
+
+	// The most allocations per message that are not made by the ASN.1 decoder to build the BSM itself.
+	// These are the message and its IVP message header, the payload string, a copy of the bytes, and the
+	// decoded message handed to the plugin.
+	static constexpr double MaxOverhead = 20;
+
+	void SetUp() override {
+		_bytes = byte_stream_decode("00143d604043030280ffdbfba868b3584ec40824646400320032000c888fc834e37fff0aaa960fa0"
+				"040d082408801148d693a431ad275c7c6b49d9e8d693b60e");
+	}
+
+	// Creates and decodes one message, as RxThread::doWork and the plugin's BSM handler do
+	void Receive() {
+		byte_stream *bytes = new byte_stream(_bytes);
+		routeable_message *msg = _factory.NewMessage(*bytes);
+		ASSERT_TRUE(msg != NULL);
+
+		BsmMessage bsm = msg->get_payload<BsmMessage>();
+		ASSERT_TRUE(bsm.get_j2735_data() != NULL);
+		EXPECT_EQ(1, bsm.get_j2735_data()->coreData.msgCnt);
+		EXPECT_EQ(38954961, bsm.get_j2735_data()->coreData.lat);
+		EXPECT_EQ(-77149303, bsm.get_j2735_data()->coreData.Long);
+
+		delete msg;
+		delete bytes;
+	}
+
+	// Decodes only the BSM, which is what the ASN.1 decoder allocates for the payload
+	void DecodePayload() {
+		auto frame = BsmEncodedMessage::decode_j2735_data< codec::uper<MessageFrameMessage> >(_bytes);
+		ASSERT_TRUE(frame != NULL);
+	}
+
+	// Returns the average allocations per call, once the first calls have set up any caches
+	template <typename Function>
+	double AllocationsPerCall(Function function) {
+		for (int i = 0; i < 10; i++)
+			function();
+
+		allocationCount = 0;
+		countAllocations = true;
+		for (int i = 0; i < Messages; i++)
+			function();
+		countAllocations = false;
+
+		return (double)allocationCount / Messages;
+	}
+
+	byte_stream _bytes;
+	J2735MessageFactory _factory;
+};
+
+TEST_F(J2735AllocationTest, ReceivingABsmAllocatesLittleBeyondThePayload) {
+	double payload = AllocationsPerCall([this]() { DecodePayload(); });
+	double received = AllocationsPerCall([this]() { Receive(); });
+
+	cout << "Allocations per BSM: " << received << " received, of which " << payload << " for the decoded payload" << endl;
+
+	EXPECT_GT(payload, 0);
+	EXPECT_LE(received - payload, MaxOverhead);
+}
+
+TEST_F(J2735AllocationTest, ConstrainedIntegersAreDecodedWithoutAllocating) {
+	// The BSM holds more than 20 constrained integers, so this fails if decoding each one allocates
+	double payload = AllocationsPerCall([this]() { DecodePayload(); });
+	EXPECT_LE(payload, 30);
+}
+
+} /* namespace unit_test */
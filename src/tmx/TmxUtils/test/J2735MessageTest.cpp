@@ -805,4 +805,105 @@ TEST_F(J2735MessageTest, EncodeSDSM)
 	auto sdsm_ptr = SdsmEncodeMessage.decode_j2735_message().get_j2735_data();
 	ASSERT_EQ(10, sdsm_ptr->msgCnt);
 }
+
+TEST_F(J2735MessageTest, ScanUperFrameHeader)
+{
+	codec::uper_frame_header header;
+
+	byte_stream bsm = attribute_lexical_cast<byte_stream>(std::string("00143d604043030280ffdbfba868b3584ec40824646400320032000c888fc834e37fff0aaa960fa0040d082408801148d693a431ad275c7c6b49d9e8d693b60e"));
+	ASSERT_TRUE(codec::uper_scan_frame_header(bsm, header));
+	ASSERT_EQ(20, header.contentId);
+	ASSERT_EQ(61u, header.length);
+	ASSERT_EQ(24u, header.contentBit);
+	ASSERT_EQ(20, codec::uper<MessageFrameMessage>::decode_contentId(bsm));
+
+	byte_stream srm = attribute_lexical_cast<byte_stream>(std::string("001d311000605c0098c020008003d825e003d380247408910007b04bc007a60004303028001a6bbb1c9ad7882858201801ef8028"));
+	ASSERT_TRUE(codec::uper_scan_frame_header(srm, header));
+	ASSERT_EQ(29, header.contentId);
+	ASSERT_EQ(49u, header.length);
+
+	byte_stream sdsm = attribute_lexical_cast<byte_stream>(std::string("0029250a010c0c0a101f9c35a4e9266b49d1b20c34000a00000020000bba0a000200004400240009"));
+	J2735MessageFactory factory;
+	ASSERT_EQ(41, factory.GetMessageId(sdsm));
+
+	// A truncated frame is rejected, since the contents do not fit
+	bsm.resize(bsm.size() - 1);
+	ASSERT_FALSE(codec::uper_scan_frame_header(bsm, header));
+	ASSERT_GT(0, codec::uper<MessageFrameMessage>::decode_contentId(bsm));
+
+	bsm.resize(1);
+	ASSERT_FALSE(codec::uper_scan_frame_header(bsm, header));
+	ASSERT_FALSE(codec::uper_scan_frame_header(byte_stream(), header));
+}
+
+/**
+ * The cost of finding the message ID of a UPER MessageFrame, by decoding the whole frame and by scanning its header,
+ * over captured BSM, SPaT, MAP and SRM frames.  Disabled by default, run with --gtest_also_run_disabled_tests
+ * --gtest_filter='*Benchmark*'.
+ */
+class J2735UperScanBenchmark: public testing::Test {
+protected:
+	static constexpr int Iterations = 20000;
+
+	struct Frame {
+		const char *name;
+		int messageId;
+		byte_stream bytes;
+	};
+
+	void SetUp() override {
+		frames = {
+			{ "BSM", 20, Decode("00143d604043030280ffdbfba868b3584ec40824646400320032000c888fc834e37fff0aaa960fa0"
+					"040d082408801148d693a431ad275c7c6b49d9e8d693b60e") },
+			{ "SPaT", 19, Decode("0013808f44d48a0383ebe5e7d24eee997973cb8fa69dfb84653e000013522886841c02010fefdccfe5cfe5c0"
+					"0000000000e08df7ee67f067f06000000000002043fbf7340234023000000000000821fdfb99fee9fee800000000000c11bef"
+					"dccfe0cfe0c000000000008087f7ee67f2e7f2e000000000005043fbf733fdd3fdd000000000003021fdfb9a011a011800000"
+					"0000") },
+			{ "MAP", 18, Decode("001280a0080301026d906266e7b951ea6e2ac816e052001140000000c28c52085822a20bd76061954d9035f5e2"
+					"9001090000000614ac9d82ca56b85fe3380ccf7321b44fe8800c9000000030a7b556169cc303085b6867a3ce0dc785e40084"
+					"4000000185502e00b73682188ce8834660186f64642005340000000c2b158a85cc3760c6b7ae1a7d0e028a64c900319000000"
+					"0615d4d282ef5d5864840c0d638da149d3380") },
+			{ "SRM", 29, Decode("001d311000605c0098c020008003d825e003d380247408910007b04bc007a60004303028001a6bbb1c9ad78828"
+					"58201801ef8028") }
+		};
+	}
+
+	static byte_stream Decode(const char *hex) {
+		return attribute_lexical_cast<byte_stream>(std::string(hex));
+	}
+
+	// Returns the average time to find the message ID of the frame, in nanoseconds
+	template <typename Function>
+	static double Time(const Frame &frame, Function messageId) {
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Iterations; i++) {
+			if (messageId(frame.bytes) != frame.messageId)
+				return -1;
+		}
+
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() / Iterations;
+	}
+
+	vector<Frame> frames;
+};
+
+TEST_F(J2735UperScanBenchmark, DISABLED_MessageIdExtraction)
+{
+	auto fullDecode = [](const byte_stream &bytes) {
+		return (int)TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_data< codec::uper<MessageFrameMessage> >(bytes)->messageId;
+	};
+	auto headerScan = [](const byte_stream &bytes) {
+		return codec::uper<MessageFrameMessage>::decode_contentId(bytes);
+	};
+
+	printf("  %-6s %8s %16s %16s %10s\n", "frame", "bytes", "full decode ns", "header scan ns", "speedup");
+	for (const Frame &frame : frames) {
+		double decoded = Time(frame, fullDecode);
+		double scanned = Time(frame, headerScan);
+		printf("  %-6s %8zu %16.0f %16.1f %9.0fx\n", frame.name, frame.bytes.size(), decoded, scanned, decoded / scanned);
+
+		ASSERT_GT(decoded, 0) << frame.name << " did not decode to message " << frame.messageId;
+		ASSERT_GT(scanned, 0) << frame.name << " did not scan as message " << frame.messageId;
+	}
+}
 }
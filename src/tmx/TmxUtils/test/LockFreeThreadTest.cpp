@@ -0,0 +1,182 @@
+/*
+ * LockFreeThreadTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <LockFreeThread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+/**
+ * A worker that records how long each item, which holds the time it was pushed, waited to be dequeued.  When idle, it
+ * either parks, or sleeps with the additive increasing, multiplicative decreasing backoff of the message manager.
+ */
+class LatencyWorker : public LockFreeThread<int64_t> {
+public:
+	LatencyWorker(bool parking, microseconds parkTimeout) : _parking(parking), _parkTimeout(parkTimeout) { }
+
+	~LatencyWorker() {
+		if (joinable())
+			stop();
+	}
+
+	static int64_t Now() {
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	// The latency of each item processed so far, in nanoseconds.  Only read once the worker is stopped.
+	vector<int64_t> latencies;
+	atomic<uint64_t> processed {0};
+
+protected:
+	void doWork(int64_t &pushed) override {
+		latencies.push_back(Now() - pushed);
+		processed++;
+
+		if (this->inQueueSize() > 1 && _usecSleep > 0)
+			_usecSleep *= 0.1;
+	}
+
+	void idle() override {
+		if (_parking) {
+			this->park(_parkTimeout);
+			return;
+		}
+
+		this_thread::yield();
+		usleep((uint32_t)_usecSleep);
+		if (this->inQueueSize() < 1 && _usecSleep < 50000)
+			_usecSleep += 10;
+	}
+
+private:
+	bool _parking;
+	microseconds _parkTimeout;
+	double _usecSleep = 0;
+};
+
+class LockFreeThreadTest : public testing::Test {
+protected:
+	// Long enough that an item is only processed in time if pushing it woke the worker
+	static constexpr seconds ParkTimeout {30};
+
+	template <typename Predicate>
+	bool WaitFor(Predicate done, milliseconds timeout = milliseconds(2000)) {
+		auto deadline = steady_clock::now() + timeout;
+		while (!done() && steady_clock::now() < deadline)
+			this_thread::yield();
+		return done();
+	}
+};
+
+constexpr seconds LockFreeThreadTest::ParkTimeout;
+
+TEST_F(LockFreeThreadTest, PushWakesAParkedWorker) {
+	LatencyWorker worker(true, ParkTimeout);
+	worker.start();
+
+	// Long past the spinning, so the worker is parked
+	this_thread::sleep_for(milliseconds(100));
+	ASSERT_TRUE(worker.push(LatencyWorker::Now()));
+
+	EXPECT_TRUE(WaitFor([&]() { return worker.processed == 1; }));
+	worker.stop();
+}
+
+TEST_F(LockFreeThreadTest, NoWakeupIsLostWhileTheWorkerGoesToPark) {
+	LatencyWorker worker(true, ParkTimeout);
+	worker.start();
+
+	// Each item is pushed only after the last was processed, after a gap of up to 2 ms that varies from item to item,
+	// so that the pushes land at every point of the worker spinning and going to park.  A lost wakeup leaves the item
+	// queued until the park times out.
+	for (uint64_t i = 1; i <= 2000; i++) {
+		this_thread::sleep_for(nanoseconds(i * 7919 % 2000000));
+		ASSERT_TRUE(worker.push(LatencyWorker::Now()));
+		ASSERT_TRUE(WaitFor([&]() { return worker.processed == i; })) << "Item " << i << " was not processed";
+	}
+
+	worker.stop();
+}
+
+TEST_F(LockFreeThreadTest, StopWakesAParkedWorker) {
+	LatencyWorker worker(true, ParkTimeout);
+	worker.start();
+	this_thread::sleep_for(milliseconds(100));
+
+	auto start = steady_clock::now();
+	worker.stop();
+	EXPECT_LT(steady_clock::now() - start, seconds(2));
+}
+
+/**
+ * The time from an item being pushed to an idle worker until the worker dequeues it, when the worker sleeps and when
+ * it parks, at several arrival rates.  Disabled by default, run with --gtest_also_run_disabled_tests
+ * --gtest_filter='*Benchmark*'.
+ */
+class LockFreeThreadBenchmark : public LockFreeThreadTest {
+protected:
+	static constexpr int Items = 200;
+
+	// Returns the latencies in nanoseconds, sorted
+	static vector<int64_t> Run(bool parking, microseconds gap) {
+		LatencyWorker worker(parking, milliseconds(100));
+		worker.start();
+
+		for (int i = 0; i < Items; i++) {
+			this_thread::sleep_for(gap);
+			worker.push(LatencyWorker::Now());
+		}
+
+		while (worker.processed < Items)
+			this_thread::sleep_for(milliseconds(1));
+		worker.stop();
+
+		vector<int64_t> latencies = worker.latencies;
+		sort(latencies.begin(), latencies.end());
+		return latencies;
+	}
+
+	static void Print(const char *name, microseconds gap, const vector<int64_t> &latencies) {
+		static const int64_t bounds[] = { 10000, 100000, 1000000, 10000000 };
+
+		size_t buckets[5] = { 0, 0, 0, 0, 0 };
+		for (int64_t latency : latencies)
+			buckets[upper_bound(begin(bounds), end(bounds), latency) - begin(bounds)]++;
+
+		printf("  %-6s %8ld us %9.1f %9.1f", name, (long)gap.count(),
+				latencies[latencies.size() / 2] / 1000.0, latencies[latencies.size() * 99 / 100] / 1000.0);
+		for (size_t count : buckets)
+			printf(" %8zu", count);
+		printf("\n");
+	}
+};
+
+TEST_F(LockFreeThreadBenchmark, DISABLED_IdleToWakeLatency) {
+	printf("  %-6s %11s %9s %9s %8s %8s %8s %8s %8s\n", "idle", "gap", "p50 us", "p99 us",
+			"<10us", "<100us", "<1ms", "<10ms", ">=10ms");
+	for (microseconds gap : { microseconds(100), microseconds(1000), microseconds(10000) }) {
+		for (bool parking : { false, true }) {
+			vector<int64_t> latencies = Run(parking, gap);
+			ASSERT_EQ((size_t)Items, latencies.size());
+			Print(parking ? "Park" : "Sleep", gap, latencies);
+		}
+	}
+}
+
+} /* namespace unit_test */
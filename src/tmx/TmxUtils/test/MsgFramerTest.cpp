@@ -0,0 +1,296 @@
+/*
+ * MsgFramerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <tmx/utils/MsgFramer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+class MsgFramerTest : public testing::Test {
+protected:
+	typedef pair<MsgFramer_FrameType, string> Frame;
+
+	void TearDown() override {
+		msgFramer_destroy(&framer);
+	}
+
+	// Payload bytes that include the frame start and end bytes and nulls
+	static string Binary(size_t length) {
+		string data(length, '\0');
+		for (size_t i = 0; i < length; i++)
+			data[i] = (char)(i * 7);
+		return data;
+	}
+
+	static string Json(size_t length) {
+		string data(length, ' ');
+		for (size_t i = 0; i < length; i++)
+			data[i] = 'a' + (i % 26);
+		return data;
+	}
+
+	static string Framed(MsgFramer_FrameType type, const string &payload) {
+		int length;
+		char *framed = type == MsgFramer_FrameType_binary ?
+				msgFramer_createFramedBinaryMsg(payload.data(), payload.size(), &length) :
+				msgFramer_createFramedMsg(const_cast<char *>(payload.c_str()), payload.size(), &length);
+		string result(framed, length);
+		free(framed);
+		return result;
+	}
+
+	// Takes every complete frame out of the framer
+	void Drain(vector<Frame> &frames) {
+		char *data;
+		int length;
+		MsgFramer_FrameType type;
+		while ((data = msgFramer_getNextFrame(&framer, &length, &type)) != NULL)
+			frames.emplace_back(type, string(data, length));
+	}
+
+	// Copies the stream into the framer the way a socket read would, chunk bytes at a time
+	void Feed(const string &stream, size_t chunk, vector<Frame> &frames) {
+		for (size_t pos = 0; pos < stream.size();) {
+			size_t length = min(min(chunk, stream.size() - pos), (size_t)msgFramer_getBufLength(&framer));
+			ASSERT_GT(length, 0u);
+			memcpy(msgFramer_getBuf(&framer), stream.data() + pos, length);
+			msgFramer_incrementBufPos(&framer, length);
+			pos += length;
+			Drain(frames);
+		}
+	}
+
+	// Reads from the socket into the framer until count frames have arrived
+	void Receive(int fd, size_t count, vector<Frame> &frames, size_t readSize) {
+		while (frames.size() < count) {
+			size_t length = min(readSize, (size_t)msgFramer_getBufLength(&framer));
+			ssize_t received = recv(fd, msgFramer_getBuf(&framer), length, 0);
+			if (received <= 0)
+				break;
+			msgFramer_incrementBufPos(&framer, received);
+			Drain(frames);
+		}
+	}
+
+	MsgFramer framer = MSG_FRAMER_INITIALIZER;
+};
+
+TEST_F(MsgFramerTest, FramesSplitAcrossReads) {
+	string stream = "noise" + Framed(MsgFramer_FrameType_json, "{\"a\":1}") + Framed(MsgFramer_FrameType_binary, Binary(300)) +
+			Framed(MsgFramer_FrameType_binary, "") + Framed(MsgFramer_FrameType_json, "{}");
+
+	vector<Frame> frames;
+	Feed(stream, 1, frames);
+
+	ASSERT_EQ(4u, frames.size());
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, "{\"a\":1}"), frames[0]);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_binary, Binary(300)), frames[1]);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_binary, ""), frames[2]);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, "{}"), frames[3]);
+}
+
+TEST_F(MsgFramerTest, BufferGrowsPastItsInitialSize) {
+	EXPECT_EQ(MSG_FRAMER_INITIAL_BUF_SIZE, msgFramer_getBufLength(&framer));
+
+	// A frame that exactly fills the initial buffer, then ones that are one byte and many times larger
+	vector<size_t> sizes = { MSG_FRAMER_INITIAL_BUF_SIZE - MSG_FRAMER_BINARY_HEADER_SIZE,
+			MSG_FRAMER_INITIAL_BUF_SIZE - MSG_FRAMER_BINARY_HEADER_SIZE + 1, 50000 };
+	string stream;
+	for (size_t size : sizes)
+		stream += Framed(MsgFramer_FrameType_binary, Binary(size));
+	stream += Framed(MsgFramer_FrameType_json, Json(MSG_FRAMER_INITIAL_BUF_SIZE));
+
+	vector<Frame> frames;
+	Feed(stream, 4096, frames);
+
+	ASSERT_EQ(4u, frames.size());
+	for (size_t i = 0; i < sizes.size(); i++)
+		EXPECT_EQ(Frame(MsgFramer_FrameType_binary, Binary(sizes[i])), frames[i]);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, Json(MSG_FRAMER_INITIAL_BUF_SIZE)), frames[3]);
+	EXPECT_GT(framer.bufsize, MSG_FRAMER_INITIAL_BUF_SIZE);
+	EXPECT_LE(framer.bufsize, MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE);
+}
+
+TEST_F(MsgFramerTest, MaximumSizeFrameIsAccepted) {
+	string payload = Binary(MSG_FRAMER_MAX_FRAME_SIZE);
+
+	vector<Frame> frames;
+	Feed(Framed(MsgFramer_FrameType_binary, payload) + Framed(MsgFramer_FrameType_json, "{}"), 65536, frames);
+
+	ASSERT_EQ(2u, frames.size());
+	EXPECT_EQ(MsgFramer_FrameType_binary, frames[0].first);
+	EXPECT_TRUE(frames[0].second == payload);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, "{}"), frames[1]);
+	EXPECT_EQ(MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE, framer.bufsize);
+}
+
+TEST_F(MsgFramerTest, OversizeLengthIsSkipped) {
+	// A start byte followed by a length over the maximum can not be a real frame, so the framer
+	// moves past it and finds the frames that follow.  None of the length bytes look like a start byte.
+	uint32_t length = 0x7FFFFFFF;
+	string stream = { MSG_FRAMER_BINARY_START, (char)(length >> 24), (char)(length >> 16), (char)(length >> 8), (char)length };
+	stream += Framed(MsgFramer_FrameType_binary, Binary(100)) + Framed(MsgFramer_FrameType_json, "{}");
+
+	vector<Frame> frames;
+	Feed(stream, stream.size(), frames);
+
+	ASSERT_EQ(2u, frames.size());
+	EXPECT_EQ(Frame(MsgFramer_FrameType_binary, Binary(100)), frames[0]);
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, "{}"), frames[1]);
+	EXPECT_EQ(MSG_FRAMER_INITIAL_BUF_SIZE, framer.bufsize);
+}
+
+TEST_F(MsgFramerTest, UnterminatedFrameIsDroppedAtTheCap) {
+	// A JSON frame that never ends fills the buffer to the cap, then is thrown away
+	vector<Frame> frames;
+	Feed(string(1, MSG_FRAMER_JSON_START) + Json(MSG_FRAMER_MAX_FRAME_SIZE + 65536), 65536, frames);
+	EXPECT_TRUE(frames.empty());
+	EXPECT_EQ(MSG_FRAMER_MAX_FRAME_SIZE + MSG_FRAMER_BINARY_HEADER_SIZE, framer.bufsize);
+
+	Feed(Framed(MsgFramer_FrameType_json, "{}"), 65536, frames);
+	ASSERT_EQ(1u, frames.size());
+	EXPECT_EQ(Frame(MsgFramer_FrameType_json, "{}"), frames[0]);
+}
+
+namespace {
+
+atomic<int> interrupts(0);
+
+void OnInterrupt(int) {
+	interrupts++;
+}
+
+} /* namespace */
+
+TEST_F(MsgFramerTest, LargeFramesSurvivePartialWrites) {
+	int fds[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+	int bufferSize = 4096;
+	setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+	setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+	// Without SA_RESTART, a signal to the blocked writer makes writev return the part already sent
+	struct sigaction action, previous;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = OnInterrupt;
+	sigemptyset(&action.sa_mask);
+	ASSERT_EQ(0, sigaction(SIGUSR1, &action, &previous));
+
+	vector<Frame> sent = { Frame(MsgFramer_FrameType_binary, Binary(100 * 1024)),
+			Frame(MsgFramer_FrameType_json, Json(200 * 1024)),
+			Frame(MsgFramer_FrameType_binary, Binary(1024 * 1024)) };
+
+	atomic<bool> writing(true);
+	vector<int> written;
+	thread writer([&]() {
+		for (auto &frame : sent)
+			written.push_back(msgFramer_writeFramedMsg(fds[0], frame.second.data(), frame.second.size(), frame.first));
+		writing = false;
+	});
+
+	// Read slowly, interrupting the writer while it waits for space
+	vector<Frame> received;
+	while (received.size() < sent.size()) {
+		if (writing)
+			pthread_kill(writer.native_handle(), SIGUSR1);
+		this_thread::sleep_for(microseconds(50));
+
+		ssize_t length = recv(fds[1], msgFramer_getBuf(&framer), min(1500, msgFramer_getBufLength(&framer)), 0);
+		if (length <= 0)
+			break;
+		msgFramer_incrementBufPos(&framer, length);
+		Drain(received);
+	}
+	writer.join();
+	sigaction(SIGUSR1, &previous, NULL);
+	close(fds[0]);
+	close(fds[1]);
+
+	EXPECT_GT(interrupts.load(), 0);
+	ASSERT_EQ(sent.size(), written.size());
+	EXPECT_EQ((int)sent[0].second.size() + MSG_FRAMER_BINARY_HEADER_SIZE, written[0]);
+	EXPECT_EQ((int)sent[1].second.size() + 2, written[1]);
+	EXPECT_EQ((int)sent[2].second.size() + MSG_FRAMER_BINARY_HEADER_SIZE, written[2]);
+	ASSERT_EQ(sent.size(), received.size());
+	for (size_t i = 0; i < sent.size(); i++)
+		EXPECT_TRUE(sent[i] == received[i]) << "frame " << i;
+}
+
+/**
+ * Frames per second written with msgFramer_writeFramedMsg to a socket pair and split out by the
+ * framer on the other side, for message sizes from a BSM up to a large map or file transfer.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+class MsgFramerBenchmark : public MsgFramerTest {
+protected:
+	static constexpr size_t StreamBytes = 256 * 1024 * 1024;
+	static constexpr size_t MaxFrames = 200000;
+
+	double Run(MsgFramer_FrameType type, size_t size) {
+		int fds[2];
+		EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+		string payload = type == MsgFramer_FrameType_binary ? Binary(size) : Json(size);
+		size_t count = StreamBytes / size;
+		if (count > MaxFrames)
+			count = MaxFrames;
+
+		vector<Frame> frames;
+		frames.reserve(64);
+		size_t total = 0;
+		auto start = steady_clock::now();
+		thread writer([&]() {
+			for (size_t i = 0; i < count; i++)
+				msgFramer_writeFramedMsg(fds[0], payload.data(), payload.size(), type);
+		});
+		while (total < count) {
+			Receive(fds[1], 1, frames, 65536);
+			if (frames.empty())
+				break;
+			total += frames.size();
+			frames.clear();
+		}
+		double seconds = duration<double>(steady_clock::now() - start).count();
+		writer.join();
+		close(fds[0]);
+		close(fds[1]);
+
+		EXPECT_EQ(count, total);
+		return count / seconds;
+	}
+};
+
+TEST_F(MsgFramerBenchmark, DISABLED_FramesPerSecond) {
+	printf("  %-7s %9s %12s %10s\n", "type", "bytes", "frames/s", "MB/s");
+	for (size_t size : { 300, 4096, 100 * 1024, 1024 * 1024 }) {
+		for (auto type : { MsgFramer_FrameType_binary, MsgFramer_FrameType_json }) {
+			double framesPerSec = Run(type, size);
+			printf("  %-7s %9zu %12.0f %10.1f\n", type == MsgFramer_FrameType_binary ? "binary" : "json",
+					size, framesPerSec, framesPerSec * size / (1024 * 1024));
+			EXPECT_GT(framesPerSec, 0);
+		}
+	}
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,145 @@
+/*
+ * RouteableMessageTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <tmx/messages/routeable_message.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+using namespace tmx;
+
+namespace unit_test {
+
+class RouteableMessageTest : public testing::Test {
+protected:
+	void SetUp() override {
+		for (int i = 0; i < 40; i++)
+			_bytes.push_back((byte_t)(i * 37));
+
+		// The payload is copied
+		cJSON *payload = cJSON_CreateString(byte_stream_encode(_bytes).c_str());
+		_incoming = ivpMsg_create("J2735", "BSM", IVP_ENCODING_BYTEARRAY, IvpMsgFlags_None, payload);
+		cJSON_Delete(payload);
+		_incoming->source = strdup("DSRC");
+		_incoming->sourceId = 7;
+		_incoming->timestamp = 1234;
+	}
+
+	void TearDown() override {
+		ivpMsg_destroy(_incoming);
+	}
+
+	byte_stream _bytes;
+	IvpMessage *_incoming = NULL;
+};
+
+TEST_F(RouteableMessageTest, ReadsHeaderFromIvpMessage) {
+	routeable_message msg(_incoming);
+
+	ASSERT_EQ("J2735", msg.get_type());
+	ASSERT_EQ("BSM", msg.get_subtype());
+	ASSERT_EQ("DSRC", msg.get_source());
+	ASSERT_EQ(7u, msg.get_sourceId());
+	ASSERT_EQ(IVP_ENCODING_BYTEARRAY, msg.get_encoding());
+	ASSERT_EQ(1234u, msg.get_timestamp());
+	ASSERT_EQ(-1, msg.get_dsrcChannel());
+}
+
+TEST_F(RouteableMessageTest, DecodesPayloadBytes) {
+	routeable_message msg(_incoming);
+
+	ASSERT_EQ(byte_stream_encode(_bytes), msg.get_payload_str());
+	ASSERT_STREQ(byte_stream_encode(_bytes).c_str(), msg.get_payload_hex());
+	ASSERT_EQ(_bytes, msg.get_payload_bytes());
+	ASSERT_EQ(_bytes, msg.get_payload_bytes_view());
+
+	byte_stream other = { 0x01, 0xAB };
+	msg.set_payload_bytes(other);
+	ASSERT_EQ("01ab", msg.get_payload_str());
+	ASSERT_EQ(other, msg.get_payload_bytes_view());
+}
+
+TEST_F(RouteableMessageTest, SettersUpdateIvpMessage) {
+	routeable_message msg;
+	msg.initialize("Test", "Sub", "Source", 3, IvpMsgFlags_RouteDSRC);
+	msg.set_payload_bytes(_bytes);
+	msg.addDsrcMetadata(0x20, 172);
+
+	IvpMessage *copy = msg.get_message();
+	ASSERT_STREQ("Test", copy->type);
+	ASSERT_STREQ("Sub", copy->subtype);
+	ASSERT_STREQ("Source", copy->source);
+	ASSERT_EQ(3u, copy->sourceId);
+	ASSERT_EQ(IvpMsgFlags_RouteDSRC, copy->flags);
+	ASSERT_STREQ(IVP_ENCODING_BYTEARRAY, copy->encoding);
+	ASSERT_EQ(172, copy->dsrcMetadata->channel);
+	ASSERT_STREQ(byte_stream_encode(_bytes).c_str(), copy->payload->valuestring);
+	ivpMsg_destroy(copy);
+}
+
+TEST_F(RouteableMessageTest, StringRoundTrip) {
+	routeable_message msg(_incoming);
+	msg.set_dsrcChannel(172);
+
+	routeable_message parsed(msg.to_string());
+	ASSERT_EQ("J2735", parsed.get_type());
+	ASSERT_EQ("DSRC", parsed.get_source());
+	ASSERT_EQ(7u, parsed.get_sourceId());
+	ASSERT_EQ(1234u, parsed.get_timestamp());
+	ASSERT_EQ(172, parsed.get_dsrcChannel());
+	ASSERT_EQ(_bytes, parsed.get_payload_bytes());
+
+	// A changed header is serialized again
+	msg.set_subtype("MAP");
+	ASSERT_NE(string::npos, msg.to_string().find("\"MAP\""));
+}
+
+TEST_F(RouteableMessageTest, CopyAndAssign) {
+	routeable_message msg(_incoming);
+	routeable_message copy(msg);
+	routeable_message assigned;
+	assigned = copy;
+	assigned = assigned;
+
+	copy.set_type("Other");
+	ASSERT_EQ("J2735", msg.get_type());
+	ASSERT_EQ("J2735", assigned.get_type());
+	ASSERT_EQ(_bytes, assigned.get_payload_bytes());
+}
+
+TEST_F(RouteableMessageTest, ReceiveDecodeRebroadcastCycle) {
+	static constexpr int count = 100000;
+	size_t total = 0;
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		routeable_message received(_incoming);
+		if (received.get_type() == "J2735" && received.get_subtype() == "BSM")
+		{
+			const byte_stream &bytes = received.get_payload_bytes_view();
+			total += bytes.size();
+
+			routeable_message forward;
+			forward.initialize(received.get_type(), received.get_subtype(), "Forward", 0, IvpMsgFlags_RouteDSRC);
+			forward.set_payload_bytes(bytes);
+
+			IvpMessage *out = forward.get_message();
+			ivpMsg_destroy(out);
+		}
+	}
+	auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "Received, decoded and rebroadcast " << count << " messages in " << elapsed << " s (" <<
+			(elapsed / count * 1e6) << " us/message)" << endl;
+
+	ASSERT_EQ(count * _bytes.size(), total);
+}
+
+}
@@ -0,0 +1,311 @@
+/*
+ * Rtcm3FramerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <rtcm/RtcmMessage.h>
+#include <rtcm/Rtcm3Framer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+using namespace tmx;
+using namespace tmx::messages;
+using namespace tmx::messages::rtcm;
+
+namespace unit_test {
+
+// The 1005 example from RTCM 10403.3 section 4.2
+static const byte_stream specFrame = {
+	0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E, 0xDE, 0xEF, 0x34, 0xB4,
+	0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98
+};
+
+class Rtcm3FramerTest : public testing::Test {
+protected:
+	typedef vector<byte_stream> frame_list;
+
+	/**
+	 * Build a frame with the given message number and random content.
+	 */
+	static byte_stream MakeFrame(uint16_t msgNum, size_t payloadLen, minstd_rand &random) {
+		byte_stream frame { Rtcm3Framer::preamble, (byte_t)(payloadLen >> 8), (byte_t)payloadLen };
+		for (size_t i = 0; i < payloadLen; i++)
+			frame.push_back((byte_t)random());
+
+		if (payloadLen >= 2) {
+			frame[3] = (byte_t)(msgNum >> 4);
+			frame[4] = (byte_t)((msgNum << 4) | (frame[4] & 0x0F));
+		}
+
+		uint32_t crc = crc24q(frame.data(), frame.size());
+		frame.push_back((byte_t)(crc >> 16));
+		frame.push_back((byte_t)(crc >> 8));
+		frame.push_back((byte_t)crc);
+		return frame;
+	}
+
+	/**
+	 * A correction stream shaped like one from a caster: MSM7 observations each epoch,
+	 * with the station, GLONASS biases and receiver description every few epochs, and
+	 * an occasional empty keep-alive frame.
+	 */
+	static frame_list MakeStream(size_t epochs, unsigned int seed = 1) {
+		minstd_rand random(seed);
+		frame_list frames;
+
+		for (size_t e = 0; e < epochs; e++) {
+			frames.push_back(MakeFrame(1077, 150 + random() % 250, random));
+			frames.push_back(MakeFrame(1087, 100 + random() % 150, random));
+
+			if (e % 5 == 0) {
+				frames.push_back(MakeFrame(1005, 19, random));
+				frames.push_back(MakeFrame(1230, 6, random));
+			}
+			if (e % 10 == 0)
+				frames.push_back(MakeFrame(1033, 30, random));
+			if (e % 20 == 0)
+				frames.push_back(MakeFrame(0, 0, random));
+		}
+
+		return frames;
+	}
+
+	// Not counting the keep-alive frames
+	static size_t CountMessages(const frame_list &frames) {
+		return count_if(frames.begin(), frames.end(),
+				[](const byte_stream &frame) { return Rtcm3Framer::messageNumber(frame.data()) > 0; });
+	}
+
+	static void ExpectFrames(const frame_list &expected, const frame_list &found) {
+		for (size_t i = 0; i < expected.size() && i < found.size(); i++) {
+			ASSERT_EQ(expected[i].size(), found[i].size()) << "Frame " << i;
+			ASSERT_TRUE(equal(expected[i].begin(), expected[i].end(), found[i].begin())) << "Frame " << i;
+		}
+		ASSERT_EQ(expected.size(), found.size());
+	}
+
+	static byte_stream Join(const frame_list &frames) {
+		byte_stream bytes;
+		for (auto &frame : frames)
+			bytes.insert(bytes.end(), frame.begin(), frame.end());
+		return bytes;
+	}
+
+	/**
+	 * Push the bytes through the framer in random size pieces, as they might come off a socket.
+	 */
+	static frame_list Replay(Rtcm3Framer &framer, const byte_stream &bytes, size_t maxSegment, unsigned int seed = 1) {
+		minstd_rand random(seed);
+		frame_list found;
+
+		for (size_t pos = 0; pos < bytes.size(); ) {
+			size_t n = min<size_t>(1 + random() % maxSegment, bytes.size() - pos);
+			framer.push(bytes.data() + pos, n, [&found](const byte_t *frame, size_t len) {
+				found.emplace_back(frame, frame + len);
+			});
+			pos += n;
+		}
+
+		return found;
+	}
+};
+
+TEST_F(Rtcm3FramerTest, FindsSpecExampleFrame) {
+	ASSERT_EQ(0x360B98u, crc24q(specFrame.data(), specFrame.size() - 3));
+
+	// Garbage and a partial preamble before the frame
+	byte_stream bytes { 0x00, 0xD3, 0x55, Rtcm3Framer::preamble };
+	bytes.insert(bytes.end(), specFrame.begin(), specFrame.end());
+
+	Rtcm3Framer framer;
+	auto found = Replay(framer, bytes, 1);
+	ASSERT_EQ(1u, found.size());
+	ASSERT_EQ(specFrame, found[0]);
+	ASSERT_EQ(1u, framer.frameCount());
+	ASSERT_EQ(4u, framer.discardedBytes());
+
+	ASSERT_EQ(19u, Rtcm3Framer::payloadLength(found[0].data()));
+	ASSERT_EQ(1005, Rtcm3Framer::messageNumber(found[0].data()));
+	ASSERT_EQ(2003u, getBits(found[0].data(), 36, 12));
+
+	// The same through the message factory
+	TmxRtcmEncodedMessage encodedMsg;
+	encodedMsg.set_subtype(RtcmVersionName(SC10403_3));
+	encodedMsg.set_payload_bytes(found[0]);
+	ASSERT_EQ(1u, encodedMsg.size());
+	ASSERT_EQ(1005u, (*encodedMsg.begin())->get_MessageType());
+}
+
+TEST_F(Rtcm3FramerTest, ReadsBitFields) {
+	const byte_t bytes[] = { 0xA5, 0x5A, 0xFF, 0x00, 0x81, 0x42, 0x24, 0x18, 0xC3 };
+
+	ASSERT_EQ(0xA5u, getBits(bytes, 0, 8));
+	ASSERT_EQ(0x5u, getBits(bytes, 4, 4));
+	ASSERT_EQ(0x55Au, getBits(bytes, 4, 12));
+	ASSERT_EQ(1u, getBits(bytes, 0, 1));
+	ASSERT_EQ(0xABu, getBits(bytes, 3, 10));
+	ASSERT_EQ(0x8C3u, getBits(bytes, 60, 12));
+	ASSERT_EQ(0xA55AFF00814224ull, getBits(bytes, 0, 56));
+	ASSERT_EQ(0x15AFF0081422418ull, getBits(bytes, 7, 57));
+}
+
+TEST_F(Rtcm3FramerTest, ReplaysStreamInAnySegmentation) {
+	auto frames = MakeStream(200);
+	auto bytes = Join(frames);
+
+	for (size_t maxSegment : { 1, 2, 7, 64, 1500, 4000, 100000 }) {
+		Rtcm3Framer framer;
+		auto found = Replay(framer, bytes, maxSegment, maxSegment);
+
+		ExpectFrames(frames, found);
+		ASSERT_FALSE(HasFailure()) << "Segments of up to " << maxSegment << " bytes";
+		ASSERT_EQ(frames.size(), framer.frameCount());
+		ASSERT_EQ(0u, framer.crcErrorCount());
+		ASSERT_EQ(0u, framer.discardedBytes());
+	}
+}
+
+TEST_F(Rtcm3FramerTest, ResyncsAfterCorruption) {
+	minstd_rand random(7);
+
+	for (int run = 0; run < 50; run++) {
+		auto frames = MakeStream(40, run + 1);
+
+		// Damage some frames and put garbage, including preambles, between others
+		frame_list expected;
+		byte_stream bytes;
+		for (auto &frame : frames) {
+			switch (random() % 8) {
+			case 0:
+				frame[random() % frame.size()] ^= (byte_t)(1 + random() % 255);
+				bytes.insert(bytes.end(), frame.begin(), frame.end());
+				continue;
+			case 1:
+				// Cut off
+				bytes.insert(bytes.end(), frame.begin(), frame.begin() + random() % frame.size());
+				continue;
+			case 2:
+				for (size_t n = random() % 64; n > 0; n--)
+					bytes.push_back(random() % 4 == 0 ? Rtcm3Framer::preamble : (byte_t)random());
+				break;
+			case 3:
+				// A header that claims more bytes than follow it
+				bytes.insert(bytes.end(), { Rtcm3Framer::preamble, 0x03, 0xFF });
+				break;
+			}
+
+			bytes.insert(bytes.end(), frame.begin(), frame.end());
+			expected.push_back(frame);
+		}
+
+		// Enough idle bytes at the end to rule out any header still waiting for its frame
+		bytes.insert(bytes.end(), Rtcm3Framer::maxFrameBytes, 0);
+
+		Rtcm3Framer framer;
+		auto found = Replay(framer, bytes, 1 + random() % 2000, run);
+
+		ExpectFrames(expected, found);
+		ASSERT_FALSE(HasFailure()) << "Run " << run;
+		ASSERT_GT(framer.discardedBytes(), 0u);
+	}
+}
+
+TEST_F(Rtcm3FramerTest, DecodesOneMessagePerFrame) {
+	auto frames = MakeStream(20);
+	auto bytes = Join(frames);
+
+	Rtcm3Framer framer;
+	size_t messages = 0;
+	framer.push(bytes.data(), bytes.size(), [&](const byte_t *frame, size_t len) {
+		uint16_t msgNum = Rtcm3Framer::messageNumber(frame);
+		if (!msgNum)
+			return;
+
+		TmxRtcmEncodedMessage encodedMsg;
+		encodedMsg.set_subtype(RtcmVersionName(SC10403_3));
+		encodedMsg.set_payload_bytes(byte_stream(frame, frame + len));
+
+		ASSERT_EQ(1u, encodedMsg.size());
+		ASSERT_EQ(msgNum, (*encodedMsg.begin())->get_MessageType());
+		messages++;
+	});
+
+	ASSERT_EQ(CountMessages(frames), messages);
+}
+
+/**
+ * Frames per second through the framer alone, and through the message factory, compared to
+ * decoding each 4000 byte read from the socket as it comes.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+TEST_F(Rtcm3FramerTest, DISABLED_Benchmark) {
+	auto frames = MakeStream(500);
+	auto bytes = Join(frames);
+	static constexpr size_t readSize = 4000;
+
+	// Each pass returns the number of messages found
+	auto run = [&](const char *name, int passes, std::function<size_t()> pass) {
+		size_t messages = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < passes; i++)
+			messages = pass();
+		double elapsed = duration<double>(steady_clock::now() - start).count();
+
+		printf("  %-20s %10.0f frames/s  %6zu of %zu messages\n", name, passes * frames.size() / elapsed, messages, CountMessages(frames));
+		return messages;
+	};
+
+	size_t framed = run("Framer", 100, [&]() {
+		Rtcm3Framer framer;
+		size_t messages = 0;
+		for (size_t pos = 0; pos < bytes.size(); pos += readSize) {
+			framer.push(bytes.data() + pos, min(readSize, bytes.size() - pos), [&messages](const byte_t *frame, size_t) {
+				if (Rtcm3Framer::messageNumber(frame)) messages++;
+			});
+		}
+		return messages;
+	});
+
+	size_t decoded = run("Framer and factory", 1, [&]() {
+		Rtcm3Framer framer;
+		size_t messages = 0;
+		for (size_t pos = 0; pos < bytes.size(); pos += readSize) {
+			framer.push(bytes.data() + pos, min(readSize, bytes.size() - pos), [&messages](const byte_t *frame, size_t len) {
+				if (!Rtcm3Framer::messageNumber(frame))
+					return;
+
+				TmxRtcmEncodedMessage encodedMsg;
+				encodedMsg.set_subtype(RtcmVersionName(SC10403_3));
+				encodedMsg.set_payload_bytes(byte_stream(frame, frame + len));
+				messages += encodedMsg.size();
+			});
+		}
+		return messages;
+	});
+
+	size_t legacy = run("Factory per read", 1, [&]() {
+		size_t messages = 0;
+		for (size_t pos = 0; pos < bytes.size(); pos += readSize) {
+			TmxRtcmEncodedMessage encodedMsg;
+			encodedMsg.set_subtype(RtcmVersionName(SC10403_3));
+			encodedMsg.set_payload_bytes(byte_stream(bytes.begin() + pos, bytes.begin() + min(pos + readSize, bytes.size())));
+			messages += encodedMsg.size();
+		}
+		return messages;
+	});
+
+	ASSERT_EQ(CountMessages(frames), framed);
+	ASSERT_EQ(CountMessages(frames), decoded);
+	ASSERT_LT(legacy, decoded);
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,393 @@
+/*
+ * ShmRingTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <tmx/utils/ShmRing.h>
+#include <tmx/utils/MsgFramer.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace unit_test {
+
+class ShmRingTest : public testing::Test {
+protected:
+	// Each ring gets its own name, so tests do not see a segment left over from another run
+	static string NewName() {
+		static atomic<int> count(0);
+		return "/tmx_test_ring_" + to_string(getpid()) + "_" + to_string(count++);
+	}
+
+	static string Record(size_t length, char first) {
+		string data(length, ' ');
+		for (size_t i = 0; i < length; i++)
+			data[i] = (char)(first + i);
+		return data;
+	}
+
+	static int Write(ShmRing *ring, const string &data, int timeoutMs = 0) {
+		return shmRing_write(ring, data.data(), data.size(), timeoutMs);
+	}
+
+	static string Read(ShmRing *ring, int timeoutMs = 0) {
+		const char *data = NULL;
+		uint32_t length = 0;
+		if (shmRing_read(ring, &data, &length, timeoutMs) != 1)
+			return "<none>";
+		string record(data, length);
+		shmRing_release(ring);
+		return record;
+	}
+};
+
+TEST_F(ShmRingTest, RecordsRoundTripBetweenMappings) {
+	string name = NewName();
+	ShmRing *writer = shmRing_create(name.c_str(), 4096);
+	ASSERT_TRUE(writer);
+	ShmRing *reader = shmRing_open(name.c_str());
+	ASSERT_TRUE(reader);
+
+	// A second ring with the same name can not be created
+	ASSERT_FALSE(shmRing_create(name.c_str(), 4096));
+
+	vector<string> records = { "", Record(1, 'a'), Record(7, 'b'), Record(8, 'c'), Record(100, 'd'), Record(1000, 'e') };
+	for (auto &record : records)
+		ASSERT_EQ(1, Write(writer, record));
+
+	for (auto &record : records)
+		ASSERT_EQ(record, Read(reader));
+
+	ASSERT_EQ("<none>", Read(reader));
+
+	shmRing_close(reader);
+	shmRing_close(writer);
+
+	// The segment is removed by the ring that created it
+	ASSERT_FALSE(shmRing_open(name.c_str()));
+}
+
+TEST_F(ShmRingTest, RecordsWrapAroundTheEnd) {
+	string name = NewName();
+	ShmRing *writer = shmRing_create(name.c_str(), 256);
+	ASSERT_TRUE(writer);
+	ShmRing *reader = shmRing_open(name.c_str());
+	ASSERT_TRUE(reader);
+
+	// Record sizes that do not divide the capacity, so records have to skip to the start of the ring
+	for (int i = 0; i < 200; i++) {
+		string first = Record(20 + i % 50, 'A' + i % 26);
+		string second = Record(3 + i % 11, 'a' + i % 26);
+		ASSERT_EQ(1, Write(writer, first)) << "Record " << i;
+		ASSERT_EQ(1, Write(writer, second)) << "Record " << i;
+		ASSERT_EQ(first, Read(reader)) << "Record " << i;
+		ASSERT_EQ(second, Read(reader)) << "Record " << i;
+	}
+
+	// Fill the ring, then make room by reading
+	int written = 0;
+	while (Write(writer, Record(60, 'x')) == 1)
+		written++;
+	ASSERT_GT(written, 0);
+	ASSERT_EQ(0, Write(writer, Record(60, 'x')));
+
+	ASSERT_EQ(Record(60, 'x'), Read(reader));
+	ASSERT_EQ(1, Write(writer, Record(60, 'y')));
+	for (int i = 1; i < written; i++)
+		ASSERT_EQ(Record(60, 'x'), Read(reader));
+	ASSERT_EQ(Record(60, 'y'), Read(reader));
+
+	shmRing_close(reader);
+	shmRing_close(writer);
+}
+
+TEST_F(ShmRingTest, OversizeRecordsAreRejectedWithoutClosing) {
+	string name = NewName();
+	ShmRing *writer = shmRing_create(name.c_str(), 1024);
+	ASSERT_TRUE(writer);
+	ShmRing *reader = shmRing_open(name.c_str());
+	ASSERT_TRUE(reader);
+
+	uint32_t maxLength = shmRing_getMaxLength(writer);
+	ASSERT_EQ(512u - 4, maxLength);
+	ASSERT_EQ(maxLength, shmRing_getMaxLength(reader));
+
+	ASSERT_EQ(-1, Write(writer, Record(1024 - 3, 'a'), 100));
+	ASSERT_EQ(-1, Write(writer, Record(100000, 'a'), 100));
+
+	// The ring is still usable
+	ASSERT_EQ(1, Write(writer, Record(maxLength, 'b')));
+	ASSERT_EQ(Record(maxLength, 'b'), Read(reader));
+	ASSERT_EQ(1, Write(writer, Record(10, 'c')));
+	ASSERT_EQ(Record(10, 'c'), Read(reader));
+
+	shmRing_close(reader);
+	shmRing_close(writer);
+}
+
+/**
+ * A record is never split across the end of the ring, so the largest record has to fit wherever the ring empties.
+ */
+TEST_F(ShmRingTest, LargestRecordFitsAfterAPartialWrite) {
+	for (uint32_t capacity : { 256u, 1000u, 1024u }) {
+		// Leave the empty ring at each aligned offset in turn, and write the largest record from there
+		for (uint32_t offset = 0; offset < capacity; offset += 8) {
+			string name = NewName();
+			ShmRing *writer = shmRing_create(name.c_str(), capacity);
+			ASSERT_TRUE(writer);
+			ShmRing *reader = shmRing_open(name.c_str());
+			ASSERT_TRUE(reader);
+			uint32_t maxLength = shmRing_getMaxLength(writer);
+
+			if (offset > 0) {
+				ASSERT_EQ(1, Write(writer, Record(offset - 4, 'a')));
+				ASSERT_EQ(Record(offset - 4, 'a'), Read(reader));
+			}
+			ASSERT_EQ(1, Write(writer, Record(maxLength, 'b'))) << capacity << " at " << offset;
+			ASSERT_EQ(Record(maxLength, 'b'), Read(reader));
+
+			shmRing_close(reader);
+			shmRing_close(writer);
+		}
+	}
+}
+
+TEST_F(ShmRingTest, ShutdownFailsBothSides) {
+	string name = NewName();
+	ShmRing *writer = shmRing_create(name.c_str(), 1024);
+	ASSERT_TRUE(writer);
+	ShmRing *reader = shmRing_open(name.c_str());
+	ASSERT_TRUE(reader);
+
+	ASSERT_EQ(1, Write(writer, "last"));
+	shmRing_shutdown(reader);
+
+	const char *data;
+	uint32_t length;
+	ASSERT_EQ(-1, Write(writer, "after"));
+	// Records written before the shutdown can still be read
+	ASSERT_EQ("last", Read(reader));
+	ASSERT_EQ(-1, shmRing_read(reader, &data, &length, 100));
+
+	shmRing_close(reader);
+	shmRing_close(writer);
+}
+
+TEST_F(ShmRingTest, WaitingSidesAreWoken) {
+	string name = NewName();
+	ShmRing *writer = shmRing_create(name.c_str(), 256);
+	ASSERT_TRUE(writer);
+	ShmRing *reader = shmRing_open(name.c_str());
+	ASSERT_TRUE(reader);
+
+	// A reader waiting on an empty ring gets the next record without waiting for its timeout
+	auto start = steady_clock::now();
+	thread later([writer]() {
+		this_thread::sleep_for(milliseconds(50));
+		Write(writer, "woken");
+	});
+	ASSERT_EQ("woken", Read(reader, 5000));
+	ASSERT_LT(steady_clock::now() - start, milliseconds(2000));
+	later.join();
+
+	// A writer waiting on a full ring writes as soon as the reader releases a record
+	while (Write(writer, Record(60, 'x')) == 1);
+	start = steady_clock::now();
+	thread release([reader]() {
+		this_thread::sleep_for(milliseconds(50));
+		Read(reader);
+	});
+	ASSERT_EQ(1, Write(writer, Record(60, 'y'), 5000));
+	ASSERT_LT(steady_clock::now() - start, milliseconds(2000));
+	release.join();
+
+	// Without a reader the write times out
+	ASSERT_EQ(0, Write(writer, Record(200, 'z'), 50));
+
+	shmRing_close(reader);
+	shmRing_close(writer);
+}
+
+/**
+ * Fan-out of BSM sized frames from one sender to 5 subscribers, as the core sends a BSM to each plugin
+ * that subscribes to it, over shared memory rings and over loopback TCP sockets.
+ */
+class ShmRingBenchmark : public ShmRingTest {
+protected:
+	static constexpr int Subscribers = 5;
+	static constexpr size_t FrameSize = 300;
+	static constexpr int ThroughputCount = 200000;
+	static constexpr int LatencyCount = 10000;
+
+	struct Result {
+		double messagesPerSec;
+		double medianUs;
+		double p99Us;
+	};
+
+	// Each frame carries the time it was sent, so the subscriber can work out its latency
+	static void Stamp(char *frame) {
+		int64_t now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+		memcpy(frame, &now, sizeof(now));
+	}
+
+	static double LatencyUs(const char *frame) {
+		int64_t sent;
+		memcpy(&sent, frame, sizeof(sent));
+		return (duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - sent) / 1000.0;
+	}
+
+	// Sends count frames to every subscriber, pausing between frames for the latency run, and collects
+	// the latency of every frame received.
+	static Result Run(function<void(const char *)> send, function<void(int, int, vector<double> &)> receive,
+			int count, microseconds interval) {
+		vector<vector<double>> latencies(Subscribers);
+		vector<thread> subscribers;
+		for (int s = 0; s < Subscribers; s++)
+			subscribers.emplace_back([&, s]() { receive(s, count, latencies[s]); });
+
+		char frame[FrameSize];
+		memset(frame, 'b', sizeof(frame));
+		auto start = steady_clock::now();
+		for (int i = 0; i < count; i++) {
+			if (interval.count() > 0)
+				this_thread::sleep_until(start + interval * i);
+			Stamp(frame);
+			send(frame);
+		}
+		for (auto &subscriber : subscribers)
+			subscriber.join();
+		double seconds = duration<double>(steady_clock::now() - start).count();
+
+		vector<double> all;
+		for (auto &l : latencies)
+			all.insert(all.end(), l.begin(), l.end());
+		EXPECT_EQ((size_t)Subscribers * count, all.size());
+		sort(all.begin(), all.end());
+
+		Result result;
+		result.messagesPerSec = count / seconds;
+		result.medianUs = all.empty() ? 0 : all[all.size() / 2];
+		result.p99Us = all.empty() ? 0 : all[all.size() * 99 / 100];
+		return result;
+	}
+
+	static Result RunSharedMemory(int count, microseconds interval) {
+		vector<ShmRing *> writers, readers;
+		for (int s = 0; s < Subscribers; s++) {
+			string name = NewName();
+			writers.push_back(shmRing_create(name.c_str(), SHM_RING_DEFAULT_CAPACITY));
+			readers.push_back(shmRing_open(name.c_str()));
+		}
+
+		Result result = Run([&](const char *frame) {
+			for (auto writer : writers)
+				EXPECT_EQ(1, shmRing_write(writer, frame, FrameSize, 1000));
+		}, [&](int s, int count, vector<double> &latencies) {
+			latencies.reserve(count);
+			const char *data;
+			uint32_t length;
+			while ((int)latencies.size() < count && shmRing_read(readers[s], &data, &length, 1000) == 1) {
+				latencies.push_back(LatencyUs(data));
+				shmRing_release(readers[s]);
+			}
+		}, count, interval);
+
+		for (int s = 0; s < Subscribers; s++) {
+			shmRing_close(readers[s]);
+			shmRing_close(writers[s]);
+		}
+		return result;
+	}
+
+	static Result RunTcp(int count, microseconds interval) {
+		int listener = socket(AF_INET, SOCK_STREAM, 0);
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t addrLength = sizeof(addr);
+		EXPECT_EQ(0, ::bind(listener, (struct sockaddr *)&addr, sizeof(addr)));
+		EXPECT_EQ(0, listen(listener, Subscribers));
+		getsockname(listener, (struct sockaddr *)&addr, &addrLength);
+
+		vector<int> senders, receivers;
+		int noDelay = 1;
+		for (int s = 0; s < Subscribers; s++) {
+			int fd = socket(AF_INET, SOCK_STREAM, 0);
+			EXPECT_EQ(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+			receivers.push_back(fd);
+			int sender = accept(listener, NULL, NULL);
+			setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+			senders.push_back(sender);
+		}
+		close(listener);
+
+		Result result = Run([&](const char *frame) {
+			for (auto sender : senders)
+				EXPECT_EQ((int)FrameSize + MSG_FRAMER_BINARY_HEADER_SIZE,
+						msgFramer_writeFramedMsg(sender, frame, FrameSize, MsgFramer_FrameType_binary));
+		}, [&](int s, int count, vector<double> &latencies) {
+			latencies.reserve(count);
+			MsgFramer framer = MSG_FRAMER_INITIALIZER;
+			while ((int)latencies.size() < count) {
+				int received = recv(receivers[s], msgFramer_getBuf(&framer), msgFramer_getBufLength(&framer), 0);
+				if (received <= 0)
+					break;
+				msgFramer_incrementBufPos(&framer, received);
+
+				char *data;
+				int length;
+				MsgFramer_FrameType type;
+				while ((data = msgFramer_getNextFrame(&framer, &length, &type)) != NULL)
+					latencies.push_back(LatencyUs(data));
+			}
+			msgFramer_destroy(&framer);
+		}, count, interval);
+
+		for (int s = 0; s < Subscribers; s++) {
+			close(senders[s]);
+			close(receivers[s]);
+		}
+		return result;
+	}
+
+	static void Report(const string &name, const Result &throughput, const Result &latency) {
+		printf("  %-14s %9.0f messages/s   latency at 10 kHz: median %6.1f us, p99 %6.1f us\n",
+				name.c_str(), throughput.messagesPerSec, latency.medianUs, latency.p99Us);
+	}
+};
+
+TEST_F(ShmRingBenchmark, DISABLED_BsmFanOut) {
+	Result shmThroughput = RunSharedMemory(ThroughputCount, microseconds(0));
+	Result shmLatency = RunSharedMemory(LatencyCount, microseconds(100));
+	Result tcpThroughput = RunTcp(ThroughputCount, microseconds(0));
+	Result tcpLatency = RunTcp(LatencyCount, microseconds(100));
+
+	printf("%zu byte frames from one sender to %d subscribers\n", FrameSize, Subscribers);
+	Report("TCP loopback", tcpThroughput, tcpLatency);
+	Report("shared memory", shmThroughput, shmLatency);
+
+	ASSERT_GT(shmThroughput.messagesPerSec, tcpThroughput.messagesPerSec);
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,135 @@
+/*
+ * StatusCacheTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <StatusCache.h>
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+class StatusCacheTest : public testing::Test {
+protected:
+	StatusCache::FlushHandler Handler() {
+		return [this](const StatusCache::Changes &changes) {
+			lock_guard<mutex> lock(_lock);
+			_batches.push_back(changes);
+		};
+	}
+
+	vector<StatusCache::Changes> Batches() {
+		lock_guard<mutex> lock(_lock);
+		return _batches;
+	}
+
+	mutex _lock;
+	vector<StatusCache::Changes> _batches;
+};
+
+TEST_F(StatusCacheTest, SendsOnlyTheLatestValueOfEachKey) {
+	StatusCache cache(Handler(), chrono::hours(1));
+
+	for (int i = 0; i < 100; i++)
+		cache.Set("Count", to_string(i));
+	cache.Set("Other", "x");
+	cache.Flush();
+
+	auto batches = Batches();
+	ASSERT_EQ(1u, batches.size());
+	ASSERT_EQ(2u, batches[0].size());
+	ASSERT_EQ(make_pair(true, string("99")), batches[0]["Count"]);
+	ASSERT_EQ(101u, cache.GetUpdateCount());
+	ASSERT_EQ(1u, cache.GetFlushCount());
+}
+
+TEST_F(StatusCacheTest, SkipsUnchangedValues) {
+	StatusCache cache(Handler(), chrono::hours(1));
+
+	ASSERT_TRUE(cache.Set("Key", "a"));
+	ASSERT_FALSE(cache.Set("Key", "a"));
+	cache.Flush();
+	ASSERT_FALSE(cache.Set("Key", "a"));
+	cache.Flush();
+
+	ASSERT_EQ(1u, Batches().size());
+}
+
+TEST_F(StatusCacheTest, LastOfSetAndRemoveWins) {
+	StatusCache cache(Handler(), chrono::hours(1));
+
+	cache.Set("Removed", "a");
+	cache.Remove("Removed");
+	cache.Remove("Set");
+	cache.Set("Set", "b");
+	cache.Flush();
+
+	auto batches = Batches();
+	ASSERT_EQ(1u, batches.size());
+	ASSERT_FALSE(batches[0]["Removed"].first);
+	ASSERT_EQ(make_pair(true, string("b")), batches[0]["Set"]);
+
+	// A removed key is sent again even with the same value
+	ASSERT_TRUE(cache.Set("Removed", "a"));
+}
+
+TEST_F(StatusCacheTest, FlushesAfterInterval) {
+	StatusCache cache(Handler(), chrono::milliseconds(20));
+	cache.Set("Key", "a");
+
+	auto deadline = chrono::steady_clock::now() + chrono::seconds(2);
+	while (Batches().empty() && chrono::steady_clock::now() < deadline)
+		this_thread::sleep_for(chrono::milliseconds(5));
+
+	ASSERT_EQ(1u, Batches().size());
+}
+
+TEST_F(StatusCacheTest, ZeroIntervalSendsImmediately) {
+	StatusCache cache(Handler(), chrono::milliseconds(0));
+	cache.Set("Key", "a");
+	cache.Set("Key", "b");
+
+	ASSERT_EQ(2u, Batches().size());
+}
+
+TEST_F(StatusCacheTest, FlushesOnDestruction) {
+	{
+		StatusCache cache(Handler(), chrono::hours(1));
+		cache.Set("Key", "a");
+	}
+
+	ASSERT_EQ(1u, Batches().size());
+}
+
+TEST_F(StatusCacheTest, CoalescesPerMessageUpdates) {
+	static constexpr int count = 100000;
+	auto start = chrono::steady_clock::now();
+	uint64_t flushes;
+	{
+		StatusCache cache(Handler(), chrono::milliseconds(100));
+		for (int i = 0; i < count; i++)
+		{
+			cache.Set("Messages Received", to_string(i));
+			cache.Set("Last Message", to_string(i % 10));
+		}
+		cache.Flush();
+		flushes = cache.GetFlushCount();
+	}
+	auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "Set " << 2 * count << " status values in " << elapsed << " s, sent " << flushes << " batches" << endl;
+
+	ASSERT_LT(Batches().size(), 100u);
+}
+
+}
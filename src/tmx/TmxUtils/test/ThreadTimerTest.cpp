@@ -0,0 +1,228 @@
+/*
+ * ThreadTimerTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: ivp
+ */
+
+#include <gtest/gtest.h>
+#include <ThreadTimer.h>
+#include <tmx/TmxException.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+using namespace tmx::utils;
+
+namespace unit_test {
+
+class ThreadTimerTest : public testing::Test {
+protected:
+	// Records when each call happened
+	function<void(void)> Recorder(vector<steady_clock::time_point> &calls) {
+		return [this, &calls]() {
+			lock_guard<mutex> lock(_lock);
+			calls.push_back(steady_clock::now());
+		};
+	}
+
+	size_t Count(const vector<steady_clock::time_point> &calls) {
+		lock_guard<mutex> lock(_lock);
+		return calls.size();
+	}
+
+	template <typename Predicate>
+	bool WaitFor(Predicate done, milliseconds timeout = milliseconds(2000)) {
+		auto deadline = steady_clock::now() + timeout;
+		while (!done() && steady_clock::now() < deadline)
+			this_thread::sleep_for(milliseconds(1));
+		return done();
+	}
+
+	mutex _lock;
+};
+
+TEST_F(ThreadTimerTest, CallsTickAtItsFrequency) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	timer.AddPeriodicTick(Recorder(calls), milliseconds(20));
+
+	timer.Start();
+	this_thread::sleep_for(milliseconds(210));
+	timer.Stop();
+
+	// Called at 0, 20, ... 200 ms
+	ASSERT_NEAR(11, (int)calls.size(), 1);
+}
+
+TEST_F(ThreadTimerTest, WaitsForStartDelay) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	timer.AddPeriodicTick(Recorder(calls), milliseconds(1000), milliseconds(50));
+
+	auto start = steady_clock::now();
+	timer.Start();
+	ASSERT_TRUE(WaitFor([&]() { return Count(calls) > 0; }));
+	timer.Stop();
+
+	auto delay = duration_cast<milliseconds>(calls.front() - start);
+	ASSERT_GE(delay.count(), 50);
+	ASSERT_LT(delay.count(), 70);
+}
+
+TEST_F(ThreadTimerTest, AddsTickWhileRunning) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	timer.Start();
+
+	this_thread::sleep_for(milliseconds(20));
+	auto added = steady_clock::now();
+	timer.AddPeriodicTick(Recorder(calls), milliseconds(1000), milliseconds(30));
+
+	ASSERT_TRUE(WaitFor([&]() { return Count(calls) > 0; }));
+	ASSERT_GE(duration_cast<milliseconds>(calls.front() - added).count(), 30);
+}
+
+TEST_F(ThreadTimerTest, ChangesFrequency) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	uint id = timer.AddPeriodicTick(Recorder(calls), milliseconds(10000), milliseconds(10000));
+
+	timer.Start();
+	this_thread::sleep_for(milliseconds(20));
+	ASSERT_EQ(0u, Count(calls));
+
+	// The next call is due right away, since the last one was more than 10 ms ago
+	timer.ChangeFrequency(id, milliseconds(10));
+	ASSERT_TRUE(WaitFor([&]() { return Count(calls) >= 5; }, milliseconds(200)));
+}
+
+TEST_F(ThreadTimerTest, TriggersNow) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	uint id = timer.AddPeriodicTick(Recorder(calls), milliseconds(10000), milliseconds(10000));
+
+	timer.Start();
+	this_thread::sleep_for(milliseconds(20));
+
+	auto triggered = steady_clock::now();
+	timer.TriggerNow(id);
+	ASSERT_TRUE(WaitFor([&]() { return Count(calls) > 0; }));
+	ASSERT_LT(duration_cast<milliseconds>(calls.front() - triggered).count(), 10);
+}
+
+TEST_F(ThreadTimerTest, ZeroFrequencyPausesTick) {
+	vector<steady_clock::time_point> calls;
+	ThreadTimer timer;
+	uint id = timer.AddPeriodicTick(Recorder(calls), milliseconds(0));
+
+	timer.Start();
+	this_thread::sleep_for(milliseconds(50));
+	ASSERT_EQ(0u, Count(calls));
+
+	timer.ChangeFrequency(id, milliseconds(10));
+	ASSERT_TRUE(WaitFor([&]() { return Count(calls) > 0; }));
+}
+
+TEST_F(ThreadTimerTest, RemovesTick) {
+	vector<steady_clock::time_point> removed, kept;
+	ThreadTimer timer;
+	uint id = timer.AddPeriodicTick(Recorder(removed), milliseconds(10));
+	timer.AddPeriodicTick(Recorder(kept), milliseconds(10));
+
+	timer.Start();
+	ASSERT_TRUE(WaitFor([&]() { return Count(removed) > 0; }));
+	timer.RemovePeriodicTick(id);
+	size_t count = Count(removed);
+
+	this_thread::sleep_for(milliseconds(50));
+	timer.Stop();
+
+	// The removed tick may have been running at the time, but is not called again
+	ASSERT_LE(Count(removed), count + 1);
+	ASSERT_GT(Count(kept), 4u);
+
+	ASSERT_THROW(timer.ChangeFrequency(id, milliseconds(10)), tmx::TmxException);
+	ASSERT_THROW(timer.TriggerNow(id + 100), tmx::TmxException);
+	ASSERT_THROW(timer.RemovePeriodicTick(id), tmx::TmxException);
+}
+
+TEST_F(ThreadTimerTest, HandlesThousandsOfTicks) {
+	static constexpr int count = 5000;
+	atomic<int> calls{0};
+
+	ThreadTimer timer;
+	vector<uint> ids;
+	for (int i = 0; i < count; i++)
+		ids.push_back(timer.AddPeriodicTick([&calls]() { calls++; }, milliseconds(20 + i % 20), milliseconds(i % 20)));
+
+	timer.Start();
+	this_thread::sleep_for(milliseconds(200));
+
+	// Remove half of them, and the rest keep going
+	for (int i = 0; i < count; i += 2)
+		timer.RemovePeriodicTick(ids[i]);
+
+	int before = calls;
+	this_thread::sleep_for(milliseconds(200));
+	timer.Stop();
+
+	// Every tick fires at least 5 times in the first 200 ms, and the remaining half at least 5 times in the next
+	ASSERT_GE(before, count * 5);
+	ASSERT_GE(calls - before, count / 2 * 5);
+	ASSERT_LT(calls - before, count / 2 * 12);
+}
+
+/**
+ * How late each call is compared to when it was due, at common periods.  Since each deadline
+ * follows from the last one, the lateness must not grow over time.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+ */
+TEST_F(ThreadTimerTest, DISABLED_JitterBenchmark) {
+	const vector<pair<milliseconds, int>> periods = {
+		{ milliseconds(10), 300 }, { milliseconds(100), 30 }, { milliseconds(1000), 3 }
+	};
+
+	vector<vector<steady_clock::time_point>> calls(periods.size());
+	ThreadTimer timer;
+	for (size_t i = 0; i < periods.size(); i++)
+		timer.AddPeriodicTick(Recorder(calls[i]), periods[i].first);
+
+	auto start = steady_clock::now();
+	timer.Start();
+	ASSERT_TRUE(WaitFor([&]() {
+		for (size_t i = 0; i < periods.size(); i++) {
+			if (Count(calls[i]) < (size_t)periods[i].second)
+				return false;
+		}
+		return true;
+	}, milliseconds(5000)));
+	timer.Stop();
+
+	for (size_t i = 0; i < periods.size(); i++) {
+		double total = 0, worst = 0;
+		for (int n = 0; n < periods[i].second; n++) {
+			double late = duration<double, milli>(calls[i][n] - (start + n * periods[i].first)).count();
+			total += late;
+			worst = max(worst, late);
+		}
+
+		double last = duration<double, milli>(calls[i][periods[i].second - 1] -
+				(start + (periods[i].second - 1) * periods[i].first)).count();
+		printf("  %5lld ms period: mean %.3f ms late, worst %.3f ms, last %.3f ms over %d calls\n",
+				(long long)periods[i].first.count(), total / periods[i].second, worst, last, periods[i].second);
+
+		ASSERT_LT(total / periods[i].second, 2.0);
+		ASSERT_LT(last, 5.0);
+	}
+}
+
+} /* namespace unit_test */
@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+#include "kafka/kafka_client.h"
+#include <librdkafka/rdkafka_mock.h>
+#include <chrono>
+#include <map>
+
+namespace
+{
+    /**
+     * @brief Runs a librdkafka mock cluster in process, so that messages can be produced and consumed
+     * without launching a kafka broker.
+     */
+    class test_kafka_mock_cluster : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            char errstr[256];
+            _handle = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr, sizeof(errstr));
+            ASSERT_TRUE(_handle) << errstr;
+            _cluster = rd_kafka_mock_cluster_new(_handle, 1);
+            ASSERT_TRUE(_cluster);
+            _broker_str = rd_kafka_mock_cluster_bootstraps(_cluster);
+            rd_kafka_mock_topic_create(_cluster, "spat", 1, 1);
+            rd_kafka_mock_topic_create(_cluster, "ssm", 1, 1);
+        }
+
+        void TearDown() override
+        {
+            if (_cluster)
+                rd_kafka_mock_cluster_destroy(_cluster);
+            if (_handle)
+                rd_kafka_destroy(_handle);
+        }
+
+        // Produce count messages, alternating between the topics, and wait for them to be delivered
+        void produce(int count, size_t size = 0)
+        {
+            tmx::utils::kafka_producer_worker producer(_broker_str);
+            ASSERT_TRUE(producer.init_producer());
+            for (int i = 0; i < count; i++)
+            {
+                std::string msg = std::to_string(i);
+                msg.resize(std::max(size, msg.size()), ' ');
+                producer.send(msg, i % 2 ? "ssm" : "spat");
+            }
+            producer.stop();
+            ASSERT_EQ((uint64_t)count, producer.get_metrics().delivered);
+        }
+
+        rd_kafka_t *_handle = nullptr;
+        rd_kafka_mock_cluster_t *_cluster = nullptr;
+        std::string _broker_str;
+        const std::vector<std::string> _topics = {"spat", "ssm"};
+    };
+
+    TEST_F(test_kafka_mock_cluster, consume_batch_from_several_topics)
+    {
+        produce(6);
+
+        tmx::utils::kafka_consumer_worker consumer(_broker_str, _topics, "batch", RdKafka::Topic::OFFSET_BEGINNING);
+        ASSERT_TRUE(consumer.init());
+        consumer.subscribe();
+
+        std::map<std::string, std::vector<std::string>> consumed;
+        size_t count = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (count < 6 && std::chrono::steady_clock::now() < deadline)
+        {
+            auto batch = consumer.consume_batch(4, 500);
+            EXPECT_LE(batch.size(), 4u);
+            for (const auto &message : batch)
+            {
+                consumed[message.topic].push_back(message.str());
+                count++;
+            }
+        }
+
+        // Messages are in the order produced for each topic
+        EXPECT_EQ(std::vector<std::string>({"0", "2", "4"}), consumed["spat"]);
+        EXPECT_EQ(std::vector<std::string>({"1", "3", "5"}), consumed["ssm"]);
+        consumer.stop();
+    }
+
+    TEST_F(test_kafka_mock_cluster, consume_batch_does_not_wait_for_a_full_batch)
+    {
+        produce(6);
+
+        tmx::utils::kafka_consumer_worker consumer(_broker_str, _topics, "partial", RdKafka::Topic::OFFSET_BEGINNING);
+        ASSERT_TRUE(consumer.init());
+        consumer.subscribe();
+
+        // Wait for the first message, so that joining the group is not timed
+        size_t count = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (count == 0 && std::chrono::steady_clock::now() < deadline)
+            count += consumer.consume_batch(1, 500).size();
+        ASSERT_EQ(1u, count);
+
+        // Fewer messages are left than asked for, so they are returned long before the timeout
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::seconds(30);
+        while (count < 6 && std::chrono::steady_clock::now() < deadline)
+            count += consumer.consume_batch(256, 5000).size();
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(6u, count);
+        EXPECT_LT(elapsed_ms, 2500);
+        consumer.stop();
+    }
+
+    TEST_F(test_kafka_mock_cluster, send_does_not_block_when_queue_is_full)
+    {
+        // Nothing is listening on this port, so messages wait in the librdkafka queue until they time out
+        tmx::utils::kafka_producer_worker producer("127.0.0.1:1");
+        producer.set_conf("queue.buffering.max.messages", "2");
+        producer.set_conf("message.timeout.ms", "200");
+        producer.set_max_spill(3);
+        ASSERT_TRUE(producer.init_producer());
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 6; i++)
+            producer.send("message " + std::to_string(i), "spat");
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+        auto metrics = producer.get_metrics();
+        EXPECT_EQ(2u, metrics.queued);
+        EXPECT_EQ(4u, metrics.spilled);
+        EXPECT_EQ(1u, metrics.dropped);
+        EXPECT_EQ(3u, metrics.spill_depth);
+
+        // The held messages are sent as the queued ones fail
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while ((metrics.spill_depth > 0 || metrics.failed < metrics.queued) && std::chrono::steady_clock::now() < deadline)
+        {
+            producer.poll(100);
+            metrics = producer.get_metrics();
+        }
+        EXPECT_EQ(0u, metrics.spill_depth);
+        EXPECT_EQ(5u, metrics.queued);
+        EXPECT_EQ(5u, metrics.failed);
+        EXPECT_EQ(0u, metrics.delivered);
+    }
+
+    /**
+     * @brief Messages per second consumed one at a time and in batches of up to 256, from the mock cluster.
+     * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+     */
+    TEST_F(test_kafka_mock_cluster, DISABLED_benchmark_consume_batch)
+    {
+        const int count = 20000;
+        produce(count, 200);
+
+        // One message per call
+        tmx::utils::kafka_consumer_worker single(_broker_str, _topics, "single", RdKafka::Topic::OFFSET_BEGINNING);
+        ASSERT_TRUE(single.init());
+        single.subscribe();
+        int consumed = 0;
+        // Wait for the first message, so that joining the group is not timed. The payload is not
+        // null terminated, so only its first byte is read.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (consumed == 0 && std::chrono::steady_clock::now() < deadline)
+            consumed += *single.consume(500) != '\0' ? 1 : 0;
+        auto start = std::chrono::steady_clock::now();
+        while (consumed < count && std::chrono::steady_clock::now() - start < std::chrono::seconds(60))
+            consumed += *single.consume(500) != '\0' ? 1 : 0;
+        double single_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_EQ(count, consumed);
+        single.stop();
+
+        // Up to 256 messages per call
+        tmx::utils::kafka_consumer_worker batched(_broker_str, _topics, "batched", RdKafka::Topic::OFFSET_BEGINNING);
+        ASSERT_TRUE(batched.init());
+        batched.subscribe();
+        consumed = 0;
+        deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (consumed == 0 && std::chrono::steady_clock::now() < deadline)
+            consumed += batched.consume_batch(1, 500).size();
+        start = std::chrono::steady_clock::now();
+        int calls = 0;
+        while (consumed < count && std::chrono::steady_clock::now() - start < std::chrono::seconds(60))
+        {
+            consumed += batched.consume_batch(256, 500).size();
+            calls++;
+        }
+        double batched_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_EQ(count, consumed);
+        batched.stop();
+
+        printf("%d messages of 200 bytes consumed from 2 topics\n", count);
+        printf("  consume()             %9.0f messages/s\n", count / single_us * 1e6);
+        printf("  consume_batch(256)    %9.0f messages/s (%d calls)\n", count / batched_us * 1e6, calls);
+    }
+}
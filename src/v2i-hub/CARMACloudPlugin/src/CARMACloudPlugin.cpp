@@ -18,6 +18,12 @@ namespace CARMACloudPlugin {
  */
 CARMACloudPlugin::CARMACloudPlugin(string name) :PluginClient(name) {
 
+	// The requests are POSTs, so they are only retried when the connection could not be made.
+	// Each attempt gets the same 1 second timeout that each request had before.
+	HttpRetryPolicy retryPolicy;
+	retryPolicy.MaxAttempts = 3;
+	_cloudClient.reset(new HttpClient(HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT, 1000, retryPolicy));
+
 	UpdateConfigSettings();
 	std::lock_guard<mutex> lock(_cfgLock);
 	AddMessageFilter < tsm4Message > (this, &CARMACloudPlugin::HandleCARMARequest);
@@ -95,7 +101,7 @@ void CARMACloudPlugin::HandleCARMARequest(tsm4Message &msg, routeable_message &r
 	sprintf(xml_str,"<?xml version=\"1.0\" encoding=\"UTF-8\"?><TrafficControlRequest port=\"%s\" list=\"%s\"><reqid>%s</reqid><reqseq>%ld</reqseq><scale>%ld</scale>%s</TrafficControlRequest>",std::to_string(webport).c_str(),list_tcm.c_str(),reqid, reqseq,scale,bounds_str);
 
 	PLOG(logINFO) << "Sent TCR to cloud: "<< xml_str<<endl;
-	CloudSend(xml_str,url, base_req, method);
+	CloudSendAsync(xml_str,url, base_req, method);
 }
 
 void CARMACloudPlugin::HandleMobilityOperationMessage(tsm3Message &msg, routeable_message &routeableMsg){
@@ -515,34 +521,26 @@ void CARMACloudPlugin::OnStateChange(IvpPluginState state) {
 
 void CARMACloudPlugin::CloudSendAsync(const string& local_msg,const string& local_url, const string& local_base, const string& local_method)
 {
-	std::thread t([this, &local_msg, &local_url, &local_base, &local_method](){	
-		CloudSend(local_msg, local_url, local_base, local_method);	
-	});
-	t.detach();
+	string urlfull = local_url+local_base;
+	// PLOG uses the plugin name. The client is a member, so its callbacks are finished before the plugin is destroyed.
+	_cloudClient->Send(local_method, urlfull, local_msg, [this, urlfull](const HttpResponse &response) {
+		if (!response.Error.empty() || response.Status >= 400)
+		{
+			PLOG(logERROR) << "Cloud send to " << urlfull << " failed after " << response.Attempts << " attempt(s): "
+					<< (response.Error.empty() ? "HTTP " + std::to_string(response.Status) : response.Error);
+		}
+	}, CLOUD_CONTENT_TYPE);
 }
 
 int CARMACloudPlugin::CloudSend(const string &local_msg, const string& local_url, const string& local_base, const string& local_method)
 { 	
-	CURL *req;
-	CURLcode res;
 	string urlfull = local_url+local_base;	
-	req = curl_easy_init();
-	if(req) {
-		curl_easy_setopt(req, CURLOPT_URL, urlfull.c_str());
-
-		if(strcmp(local_method.c_str(),"POST")==0)
-		{
-			curl_easy_setopt(req, CURLOPT_POSTFIELDS, local_msg.c_str());
-			curl_easy_setopt(req, CURLOPT_TIMEOUT_MS, 1000L); // Request operation complete within max millisecond timeout 
-			res = curl_easy_perform(req);
-			if(res != CURLE_OK)
-			{
-				fprintf(stderr, "curl send failed: %s\n",curl_easy_strerror(res));
-				return 1;
-			}	  
-		}
-		curl_easy_cleanup(req);
-	}	
+	auto response = _cloudClient->Execute(local_method, urlfull, local_msg, CLOUD_CONTENT_TYPE);
+	if (!response.Error.empty())
+	{
+		PLOG(logERROR) << "Cloud send to " << urlfull << " failed after " << response.Attempts << " attempt(s): " << response.Error;
+		return 1;
+	}
   	
   return 0;
 }
@@ -39,6 +39,7 @@
 
 #include "PluginUtil.h"
 #include "PluginClient.h"
+#include "HttpClient.h"
 
 #include <ApplicationMessage.h>
 #include <ApplicationDataMessage.h>
@@ -69,8 +70,6 @@
 #include <qhttpengine/server.h>
 #include <v2xhubWebAPI/OAIApiRouter.h>
 
-
-#include <curl/curl.h>
 #include <algorithm>
 
 
@@ -111,7 +110,7 @@ protected:
 	int  StartWebService();
 	void CARMAResponseHandler(QHttpEngine::Socket *socket);
 	int CloudSend(const string& msg,const string& url, const string& base, const string& method);
-	//Send HTTP request async
+	//Send HTTP request async. The response is logged on the HTTP client thread.
 	void CloudSendAsync(const string& msg,const string& url, const string& base, const string& method);
 	string updateTags(string s,string t, string t1);
 
@@ -210,6 +209,10 @@ private:
 	const char *CONTENT_ENCODING_KEY = "Content-Encoding";
     const char *CONTENT_ENCODING_VALUE = "gzip";
 	std::string list_tcm = "true";
+	//Content type carma-cloud has always received, which is the curl default for a POST
+	const string CLOUD_CONTENT_TYPE = "application/x-www-form-urlencoded";
+	//Keeps the connection to carma-cloud open, and retries requests that fail
+	std::unique_ptr<HttpClient> _cloudClient;
 	
 };
 std::mutex _cfgLock;
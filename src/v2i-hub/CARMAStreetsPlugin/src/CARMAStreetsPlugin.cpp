@@ -51,6 +51,14 @@ void CARMAStreetsPlugin::UpdateConfigSettings() {
 	GetConfigValue<string>("SimSensorDetectedObjTopic", _transmitSimSensorDetectedObjTopic); 
 	GetConfigValue<string>("SdsmSubscribeTopic", _subscribeToSdsmTopic);
 	GetConfigValue<string>("SdsmTransmitTopic", _transmitSDSMTopic);
+	// MAP conversion cache
+	uint64_t mapCacheTtl = CONVERSION_CACHE_DEFAULT_TTL_MS;
+	GetConfigValue<uint64_t>("MapCacheTtl", mapCacheTtl);
+	_mapDataCache.SetTtl(MapDataMessage::MessageSubType, std::chrono::milliseconds(mapCacheTtl));
+	_mapDataCache.Clear();
+	string suppressRepeatedMap;
+	GetConfigValue<string>("SuppressRepeatedMap", suppressRepeatedMap);
+	_suppressRepeatedMap = boost::iequals(suppressRepeatedMap, "1") || boost::iequals(suppressRepeatedMap, "true");
 	 // Populate strategies config
 	string config;
 	GetConfigValue<string>("MobilityOperationStrategies", config);
@@ -79,25 +87,32 @@ void CARMAStreetsPlugin::InitKafkaConsumerProducers()
 		
 	}
 
-	//Consumers
-	_spat_kafka_consumer_ptr = client.create_consumer(kafkaConnectString, _subscribeToSpatTopic,this->_name);
-	_scheduing_plan_kafka_consumer_ptr = client.create_consumer(kafkaConnectString, _subscribeToSchedulingPlanTopic, this->_name);
-	_ssm_kafka_consumer_ptr = client.create_consumer(kafkaConnectString, _subscribeToSsmTopic,this->_name);
-	_sdsm_kafka_consumer_ptr = client.create_consumer(kafkaConnectString, _subscribeToSdsmTopic,this->_name);
-	if(!_scheduing_plan_kafka_consumer_ptr || !_spat_kafka_consumer_ptr || !_ssm_kafka_consumer_ptr || !_sdsm_kafka_consumer_ptr)
+	//Consumer, one for all the topics consumed
+	std::vector<std::string> topics;
+	_kafka_consumer_topics.clear();
+	for (const auto &topic : { _subscribeToSchedulingPlanTopic, _subscribeToSpatTopic, _subscribeToSsmTopic, _subscribeToSdsmTopic })
 	{
-		throw TmxException("Failed to create Kafka consumers.");
+		if (!topic.empty())
+		{
+			topics.push_back(topic);
+			_kafka_consumer_topics += (_kafka_consumer_topics.empty() ? "" : ",") + topic;
+		}
+	}
+	if (topics.empty())
+		return;
+
+	_kafka_consumer_ptr = client.create_consumer(kafkaConnectString, topics, this->_name);
+	if(!_kafka_consumer_ptr)
+	{
+		throw TmxException("Failed to create Kafka consumer.");
 	}
-	PLOG(logDEBUG) <<"Kafka consumers created";
-	if(!_spat_kafka_consumer_ptr->init()  || !_scheduing_plan_kafka_consumer_ptr->init() || !_ssm_kafka_consumer_ptr->init() || !_sdsm_kafka_consumer_ptr->init())
+	PLOG(logDEBUG) <<"Kafka consumer created";
+	if(!_kafka_consumer_ptr->init())
 	{
-		throw TmxException("Kafka consumers init() failed!");
+		throw TmxException("Kafka consumer init() failed!");
 	}
 	// TODO: Replace with tmxutil ThreadTimer or some other more appropriate Thread wrapper.
-	boost::thread thread_schpl(&CARMAStreetsPlugin::SubscribeSchedulingPlanKafkaTopic, this);
-	boost::thread thread_spat(&CARMAStreetsPlugin::SubscribeSpatKafkaTopic, this);
-	boost::thread thread_ssm(&CARMAStreetsPlugin::SubscribeSSMKafkaTopic, this);
-	boost::thread thread_sdsm(&CARMAStreetsPlugin::SubscribeSDSMKafkaTopic, this);
+	boost::thread thread_consumer(&CARMAStreetsPlugin::SubscribeKafkaTopics, this);
 
 }
 
@@ -449,17 +464,53 @@ void CARMAStreetsPlugin::HandleBasicSafetyMessage(BsmMessage &msg, routeable_mes
 	}
 }
 
+void CARMAStreetsPlugin::OnMessageReceived(IvpMessage *msg)
+{
+	// The MAP of an intersection is usually the same from one broadcast to the next
+	if (msg && msg->type && msg->subtype && msg->payload && msg->payload->type == cJSON_String && msg->payload->valuestring
+			&& strcmp(msg->type, MapDataMessage::MessageType) == 0 && strcmp(msg->subtype, MapDataMessage::MessageSubType) == 0)
+	{
+		auto mapDataJson = _mapDataCache.Find(MapDataMessage::MessageSubType, msg->payload->valuestring, strlen(msg->payload->valuestring));
+		if (mapDataJson)
+		{
+			ForwardMapMessage(*mapDataJson, true);
+			return;
+		}
+	}
+
+	PluginClientClockAware::OnMessageReceived(msg);
+}
+
 void CARMAStreetsPlugin::HandleMapMessage(MapDataMessage &msg, routeable_message &routeableMsg)
 {
 	std::shared_ptr<MapData> mapMsgPtr = msg.get_j2735_data();
 	PLOG(logDEBUG) << "Intersection count: " << mapMsgPtr->intersections->list.count <<std::endl;
 	Json::Value mapJson;
 	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
 	J2735MapToJsonConverter jsonConverter;
 	jsonConverter.convertJ2735MAPToMapJSON(mapMsgPtr, mapJson);
 	PLOG(logDEBUG) << "mapJson: " << mapJson << std::endl;
-	const std::string message 	= Json::writeString(builder, mapJson);
-	produce_kafka_msg(message, _transmitMAPTopic);	
+	const std::string mapDataJson = Json::writeString(builder, mapJson["map_data"]);
+	// Keep the map data for when the same MAP is received again
+	const char *payload = routeableMsg.get_payload_hex();
+	if (payload)
+		_mapDataCache.Insert(MapDataMessage::MessageSubType, payload, strlen(payload), mapDataJson);
+	ForwardMapMessage(mapDataJson, false);
+}
+
+void CARMAStreetsPlugin::ForwardMapMessage(const std::string &mapDataJson, bool repeated)
+{
+	if (repeated && _suppressRepeatedMap)
+	{
+		SetStatus<uint>(Key_MAPMessageSuppressed, ++_mapMessageSuppressed);
+	}
+	else
+	{
+		J2735MapToJsonConverter jsonConverter;
+		produce_kafka_msg(jsonConverter.composeMapJSON(mapDataJson), _transmitMAPTopic);
+	}
+	SetStatus(Key_MAPCacheHitRate, _mapDataCache.GetHitRate(), false, 0);
 }
 
 void CARMAStreetsPlugin::HandleSDSMMessage(SdsmMessage &msg, routeable_message &routeableMsg)
@@ -489,219 +540,187 @@ void CARMAStreetsPlugin::OnStateChange(IvpPluginState state) {
 	}
 }
 
-void CARMAStreetsPlugin::SubscribeSchedulingPlanKafkaTopic()
-{	
-	// TODO: Update methods to represent consuming a single message from Kafka topic
-	if(_subscribeToSchedulingPlanTopic.length() > 0)
+void CARMAStreetsPlugin::SubscribeKafkaTopics()
+{
+	PLOG(logDEBUG) << "SubscribeKafkaTopics: " << _kafka_consumer_topics << std::endl;
+	_kafka_consumer_ptr->subscribe();
+	while (_kafka_consumer_ptr->is_running())
 	{
-		PLOG(logDEBUG) << "SubscribeSchedulingPlanKafkaTopics:" <<_subscribeToSchedulingPlanTopic << std::endl;
-		_scheduing_plan_kafka_consumer_ptr->subscribe();
-
-		while (_scheduing_plan_kafka_consumer_ptr->is_running()) 
+		// Messages from all the topics, in the order they were received for each topic
+		auto batch = _kafka_consumer_ptr->consume_batch(_kafkaConsumeBatchSize, 500);
+		for (const auto &message : batch)
 		{
-			std::string payload_str = _scheduing_plan_kafka_consumer_ptr->consume(500);
-			if(payload_str.length() > 0)
-			{
-				PLOG(logDEBUG) << "consumed message payload: " << payload_str <<std::endl;
-				Json::Value  payload_root;
-				Json::Reader payload_reader;
-				bool parse_sucessful = payload_reader.parse(payload_str, payload_root);
-				if( !parse_sucessful )
-				{	
-					PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
-					SetStatus<uint>(Key_ScheduleMessageSkipped, ++_scheduleMessageSkipped);
-					continue;
-				}
-
-				Json::Value metadata = payload_root["metadata"];
-				Json::Value payload_json_array = payload_root["payload"];
-				
-				for ( int index = 0; index < payload_json_array.size(); ++index )
-				{
-					PLOG(logDEBUG) << payload_json_array[index] << std::endl;
-					Json::Value payload_json =  payload_json_array[index];
-					tsm3EncodedMessage tsm3EncodedMsgs;
-					if( getEncodedtsm3 (&tsm3EncodedMsgs,  metadata,  payload_json) )
-					{
-						tsm3EncodedMsgs.set_flags( IvpMsgFlags_RouteDSRC );
-						tsm3EncodedMsgs.addDsrcMetadata(0xBFEE );
-						PLOG(logDEBUG) << "tsm3EncodedMsgs: " << tsm3EncodedMsgs;
-						BroadcastMessage(static_cast<routeable_message &>( tsm3EncodedMsgs ));
-					}
-				}
-				//Empty payload
-				if(payload_json_array.empty())
-				{
-					Json::Value payload_json = {};
-					tsm3EncodedMessage tsm3EncodedMsgs;
-					if( getEncodedtsm3 (&tsm3EncodedMsgs,  metadata,  payload_json) )
-					{
-						tsm3EncodedMsgs.set_flags( IvpMsgFlags_RouteDSRC );
-						tsm3EncodedMsgs.addDsrcMetadata(0xBFEE);
-						PLOG(logDEBUG) << "tsm3EncodedMsgs: " << tsm3EncodedMsgs;
-						BroadcastMessage(static_cast<routeable_message &>( tsm3EncodedMsgs ));
-					}
-				}			
-			}
+			if (message.len == 0)
+				continue;
+
+			PLOG(logDEBUG) << "consumed message payload from " << message.topic << ": " << message.str() << std::endl;
+			if (_subscribeToSchedulingPlanTopic == message.topic)
+				HandleSchedulingPlanPayload(message);
+			else if (_subscribeToSpatTopic == message.topic)
+				HandleSpatPayload(message);
+			else if (_subscribeToSsmTopic == message.topic)
+				HandleSSMPayload(message);
+			else if (_subscribeToSdsmTopic == message.topic)
+				HandleSDSMPayload(message);
 		}
-
 	}
 }
 
-void CARMAStreetsPlugin::SubscribeSpatKafkaTopic(){
-	// TODO: Update methods to represent consuming a single message from Kafka topic
-	if(_subscribeToSpatTopic.length() > 0)
+void CARMAStreetsPlugin::HandleSchedulingPlanPayload(const kafka_message_view &message)
+{
+	Json::Value  payload_root;
+	Json::Reader payload_reader;
+	bool parse_sucessful = payload_reader.parse(message.payload, message.payload + message.len, payload_root);
+	if( !parse_sucessful )
+	{	
+		PLOG(logERROR) << "Error parsing payload: " << message.str() << std::endl;
+		SetStatus<uint>(Key_ScheduleMessageSkipped, ++_scheduleMessageSkipped);
+		return;
+	}
+
+	Json::Value metadata = payload_root["metadata"];
+	Json::Value payload_json_array = payload_root["payload"];
+	
+	for ( int index = 0; index < payload_json_array.size(); ++index )
 	{
-		PLOG(logDEBUG) << "SubscribeSpatKafkaTopics:" <<_subscribeToSpatTopic << std::endl;
-		_spat_kafka_consumer_ptr->subscribe();
-		//Initialize Json to J2735 Spat convertor		
-		JsonToJ2735SpatConverter spat_convertor;
-		while (_spat_kafka_consumer_ptr->is_running()) 
+		PLOG(logDEBUG) << payload_json_array[index] << std::endl;
+		Json::Value payload_json =  payload_json_array[index];
+		tsm3EncodedMessage tsm3EncodedMsgs;
+		if( getEncodedtsm3 (&tsm3EncodedMsgs,  metadata,  payload_json) )
 		{
-			std::string payload_str = _spat_kafka_consumer_ptr->consume(500);
-			if(payload_str.length() > 0)
-			{
-				PLOG(logDEBUG) << "consumed message payload: " << payload_str <<std::endl;
-				Json::Value  payload_root;
-				Json::Reader payload_reader;
-				bool parse_sucessful = payload_reader.parse(payload_str, payload_root);
-				if( !parse_sucessful )
-				{	
-					PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
-					SetStatus<uint>(Key_SPATMessageSkipped, ++_spatMessageSkipped);
-					continue;
-				}
-				//Convert the SPAT JSON string into J2735 SPAT message and encode it.
-				auto spat_ptr = std::make_shared<SPAT>();
-				spat_convertor.convertJson2Spat(payload_root, spat_ptr.get());
-				tmx::messages::SpatEncodedMessage spatEncodedMsg;
-				try
-				{
-					spat_convertor.encodeSpat(spat_ptr, spatEncodedMsg);
-				}
-				catch (TmxException &ex) 
-				{
-					// Skip messages that fail to encode.
-					PLOG(logERROR) << "Failed to encoded SPAT message : \n" << payload_str << std::endl << "Exception encountered: " 
-						<< ex.what() << std::endl;
-					ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SPAT, spat_ptr.get());
-					SetStatus<uint>(Key_SPATMessageSkipped, ++_spatMessageSkipped);
-
-					continue;
-				}
-				
-				ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SPAT, spat_ptr.get());
-				PLOG(logDEBUG) << "SpatEncodedMessage: "  << spatEncodedMsg;
-
-				//Broadcast the encoded SPAT message
-				spatEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
-				spatEncodedMsg.addDsrcMetadata(0x8002);
-				BroadcastMessage(static_cast<routeable_message &>(spatEncodedMsg));		
-			}
+			tsm3EncodedMsgs.set_flags( IvpMsgFlags_RouteDSRC );
+			tsm3EncodedMsgs.addDsrcMetadata(0xBFEE );
+			PLOG(logDEBUG) << "tsm3EncodedMsgs: " << tsm3EncodedMsgs;
+			BroadcastMessage(static_cast<routeable_message &>( tsm3EncodedMsgs ));
 		}
 	}
-}
-
-void CARMAStreetsPlugin::SubscribeSSMKafkaTopic(){
-	// TODO: Update methods to represent consuming a single message from Kafka topic
-	if(_subscribeToSsmTopic.length() > 0)
+	//Empty payload
+	if(payload_json_array.empty())
 	{
-		PLOG(logDEBUG) << "SubscribeSSMKafkaTopics:" <<_subscribeToSsmTopic << std::endl;
-		_ssm_kafka_consumer_ptr->subscribe();
-		//Initialize Json to J2735 SSM convertor 
-		JsonToJ2735SSMConverter ssm_convertor;
-		while (_ssm_kafka_consumer_ptr->is_running()) 
+		Json::Value payload_json = {};
+		tsm3EncodedMessage tsm3EncodedMsgs;
+		if( getEncodedtsm3 (&tsm3EncodedMsgs,  metadata,  payload_json) )
 		{
-			std::string payload_str = _ssm_kafka_consumer_ptr->consume(500);			
-			if(payload_str.length() > 0)
-			{
-				PLOG(logDEBUG) << "consumed message payload: " << payload_str <<std::endl;
-				Json::Value ssmDoc;
-				auto parse_sucessful = ssm_convertor.parseJsonString(payload_str, ssmDoc);
-				if( !parse_sucessful )
-				{	
-					PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
-					SetStatus<uint>(Key_SSMMessageSkipped, ++_ssmMessageSkipped);
-					continue;
-				}
-				//Convert the SSM JSON string into J2735 SSM message and encode it.
-				auto ssm_ptr = std::make_shared<SignalStatusMessage>();
-				ssm_convertor.toJ2735SSM(ssmDoc, ssm_ptr);
-				tmx::messages::SsmEncodedMessage ssmEncodedMsg;
-				try
-				{
-					ssm_convertor.encodeSSM(ssm_ptr, ssmEncodedMsg);
-				}
-				catch (TmxException &ex) 
-				{
-					// Skip messages that fail to encode.
-					PLOG(logERROR) << "Failed to encoded SSM message : \n" << payload_str << std::endl << "Exception encountered: " 
-						<< ex.what() << std::endl;
-					ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SignalStatusMessage, ssm_ptr.get());
-					SetStatus<uint>(Key_SSMMessageSkipped, ++_ssmMessageSkipped);
-					continue;
-				}
-				
-				ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SignalStatusMessage, ssm_ptr.get());
-				PLOG(logDEBUG) << "ssmEncodedMsg: "  << ssmEncodedMsg;
-
-				//Broadcast the encoded SSM message
-				ssmEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
-				ssmEncodedMsg.addDsrcMetadata(0x8002);
-				BroadcastMessage(static_cast<routeable_message &>(ssmEncodedMsg));		
-			}
+			tsm3EncodedMsgs.set_flags( IvpMsgFlags_RouteDSRC );
+			tsm3EncodedMsgs.addDsrcMetadata(0xBFEE);
+			PLOG(logDEBUG) << "tsm3EncodedMsgs: " << tsm3EncodedMsgs;
+			BroadcastMessage(static_cast<routeable_message &>( tsm3EncodedMsgs ));
 		}
 	}
+}
 
+void CARMAStreetsPlugin::HandleSpatPayload(const kafka_message_view &message)
+{
+	Json::Value  payload_root;
+	Json::Reader payload_reader;
+	bool parse_sucessful = payload_reader.parse(message.payload, message.payload + message.len, payload_root);
+	if( !parse_sucessful )
+	{	
+		PLOG(logERROR) << "Error parsing payload: " << message.str() << std::endl;
+		SetStatus<uint>(Key_SPATMessageSkipped, ++_spatMessageSkipped);
+		return;
+	}
+	//Convert the SPAT JSON string into J2735 SPAT message and encode it.
+	JsonToJ2735SpatConverter spat_convertor;
+	auto spat_ptr = std::make_shared<SPAT>();
+	spat_convertor.convertJson2Spat(payload_root, spat_ptr.get());
+	tmx::messages::SpatEncodedMessage spatEncodedMsg;
+	try
+	{
+		spat_convertor.encodeSpat(spat_ptr, spatEncodedMsg);
+	}
+	catch (TmxException &ex) 
+	{
+		// Skip messages that fail to encode.
+		PLOG(logERROR) << "Failed to encoded SPAT message : \n" << message.str() << std::endl << "Exception encountered: " 
+			<< ex.what() << std::endl;
+		ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SPAT, spat_ptr.get());
+		SetStatus<uint>(Key_SPATMessageSkipped, ++_spatMessageSkipped);
+		return;
+	}
+	
+	ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SPAT, spat_ptr.get());
+	PLOG(logDEBUG) << "SpatEncodedMessage: "  << spatEncodedMsg;
+
+	//Broadcast the encoded SPAT message
+	spatEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
+	spatEncodedMsg.addDsrcMetadata(0x8002);
+	BroadcastMessage(static_cast<routeable_message &>(spatEncodedMsg));
 }
 
-void CARMAStreetsPlugin::SubscribeSDSMKafkaTopic(){
-	// TODO: Update methods to represent consuming a single message from Kafka topic
-	if(_subscribeToSdsmTopic.length() > 0)
+void CARMAStreetsPlugin::HandleSSMPayload(const kafka_message_view &message)
+{
+	const std::string payload_str = message.str();
+	//Initialize Json to J2735 SSM convertor 
+	JsonToJ2735SSMConverter ssm_convertor;
+	Json::Value ssmDoc;
+	auto parse_sucessful = ssm_convertor.parseJsonString(payload_str, ssmDoc);
+	if( !parse_sucessful )
+	{	
+		PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
+		SetStatus<uint>(Key_SSMMessageSkipped, ++_ssmMessageSkipped);
+		return;
+	}
+	//Convert the SSM JSON string into J2735 SSM message and encode it.
+	auto ssm_ptr = std::make_shared<SignalStatusMessage>();
+	ssm_convertor.toJ2735SSM(ssmDoc, ssm_ptr);
+	tmx::messages::SsmEncodedMessage ssmEncodedMsg;
+	try
 	{
-		PLOG(logDEBUG) << "SubscribeSDSMKafkaTopics:" <<_subscribeToSdsmTopic << std::endl;
-		_sdsm_kafka_consumer_ptr->subscribe();
-		//Initialize Json to J3224 SDSM convertor 
-		JsonToJ3224SDSMConverter sdsm_convertor;
-		while (_sdsm_kafka_consumer_ptr->is_running()) 
-		{
-			std::string payload_str = _sdsm_kafka_consumer_ptr->consume(500);			
-			if(payload_str.length() > 0)
-			{
-				PLOG(logDEBUG) << "consumed message payload: " << payload_str <<std::endl;
-				Json::Value sdsmDoc;
-				auto parse_sucessful = sdsm_convertor.parseJsonString(payload_str, sdsmDoc);
-				if( !parse_sucessful )
-				{	
-					PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
-					SetStatus<uint>(Key_SDSMMessageSkipped, ++_sdsmMessageSkipped);
-					continue;
-				}
-				//Convert the SDSM JSON string into J3224 SDSM message and encode it.
-				auto sdsm_ptr = std::make_shared<SensorDataSharingMessage>();
-				sdsm_convertor.convertJsonToSDSM(sdsmDoc, sdsm_ptr);
-				tmx::messages::SdsmEncodedMessage sdsmEncodedMsg;
-				try
-				{
-					sdsm_convertor.encodeSDSM(sdsm_ptr, sdsmEncodedMsg);
-				}
-				catch( std::exception const & x )
-				{
-					PLOG(logERROR) << "Failed to encoded SDSM message : " << payload_str << std::endl << boost::diagnostic_information( x ) << std::endl;
-					SetStatus<uint>(Key_SDSMMessageSkipped, ++_sdsmMessageSkipped);
-					continue;
-				}
-				
-				PLOG(logDEBUG) << "sdsmEncodedMsg: "  << sdsmEncodedMsg;
-				//Broadcast the encoded SDSM message
-				sdsmEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
-				sdsmEncodedMsg.addDsrcMetadata(tmx::messages::api::msgPSID::sensorDataSharingMessage_PSID);
-				BroadcastMessage(static_cast<routeable_message &>(sdsmEncodedMsg));
-		
-			}
-		}
+		ssm_convertor.encodeSSM(ssm_ptr, ssmEncodedMsg);
 	}
+	catch (TmxException &ex) 
+	{
+		// Skip messages that fail to encode.
+		PLOG(logERROR) << "Failed to encoded SSM message : \n" << payload_str << std::endl << "Exception encountered: " 
+			<< ex.what() << std::endl;
+		ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SignalStatusMessage, ssm_ptr.get());
+		SetStatus<uint>(Key_SSMMessageSkipped, ++_ssmMessageSkipped);
+		return;
+	}
+	
+	ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SignalStatusMessage, ssm_ptr.get());
+	PLOG(logDEBUG) << "ssmEncodedMsg: "  << ssmEncodedMsg;
 
+	//Broadcast the encoded SSM message
+	ssmEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
+	ssmEncodedMsg.addDsrcMetadata(0x8002);
+	BroadcastMessage(static_cast<routeable_message &>(ssmEncodedMsg));
+}
+
+void CARMAStreetsPlugin::HandleSDSMPayload(const kafka_message_view &message)
+{
+	const std::string payload_str = message.str();
+	//Initialize Json to J3224 SDSM convertor 
+	JsonToJ3224SDSMConverter sdsm_convertor;
+	Json::Value sdsmDoc;
+	auto parse_sucessful = sdsm_convertor.parseJsonString(payload_str, sdsmDoc);
+	if( !parse_sucessful )
+	{	
+		PLOG(logERROR) << "Error parsing payload: " << payload_str << std::endl;
+		SetStatus<uint>(Key_SDSMMessageSkipped, ++_sdsmMessageSkipped);
+		return;
+	}
+	//Convert the SDSM JSON string into J3224 SDSM message and encode it.
+	auto sdsm_ptr = std::make_shared<SensorDataSharingMessage>();
+	sdsm_convertor.convertJsonToSDSM(sdsmDoc, sdsm_ptr);
+	tmx::messages::SdsmEncodedMessage sdsmEncodedMsg;
+	try
+	{
+		sdsm_convertor.encodeSDSM(sdsm_ptr, sdsmEncodedMsg);
+	}
+	catch( std::exception const & x )
+	{
+		PLOG(logERROR) << "Failed to encoded SDSM message : " << payload_str << std::endl << boost::diagnostic_information( x ) << std::endl;
+		SetStatus<uint>(Key_SDSMMessageSkipped, ++_sdsmMessageSkipped);
+		return;
+	}
+	
+	PLOG(logDEBUG) << "sdsmEncodedMsg: "  << sdsmEncodedMsg;
+	//Broadcast the encoded SDSM message
+	sdsmEncodedMsg.set_flags(IvpMsgFlags_RouteDSRC);
+	sdsmEncodedMsg.addDsrcMetadata(tmx::messages::api::msgPSID::sensorDataSharingMessage_PSID);
+	BroadcastMessage(static_cast<routeable_message &>(sdsmEncodedMsg));
 }
 
 void CARMAStreetsPlugin::HandleSimulatedSensorDetectedMessage(simulation::SensorDetectedObject &msg, routeable_message &routeableMsg)
@@ -845,6 +864,15 @@ int CARMAStreetsPlugin::Main() {
 
 	while (_plugin->state != IvpPluginState_error) {
 
+		if (_kafka_producer_ptr)
+		{
+			// Send anything held while the producer queue was full
+			_kafka_producer_ptr->poll(0);
+			auto metrics = _kafka_producer_ptr->get_metrics();
+			SetStatus<uint64_t>(Key_KafkaMessagesDelivered, metrics.delivered);
+			SetStatus<uint64_t>(Key_KafkaMessagesFailed, metrics.failed);
+			SetStatus<uint64_t>(Key_KafkaMessagesDropped, metrics.dropped);
+		}
 
 		usleep(100000); //sleep for microseconds set from config.
 	}
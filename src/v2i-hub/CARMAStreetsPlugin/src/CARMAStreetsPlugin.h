@@ -6,6 +6,7 @@
 #include <librdkafka/rdkafkacpp.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 #include <tmx/TmxException.hpp>
 #include <tmx/j2735_messages/BasicSafetyMessage.hpp>
 #include <tmx/j2735_messages/MapDataMessage.hpp>
@@ -14,6 +15,7 @@
 #include <pthread.h>
 #include <boost/thread.hpp>
 #include <mutex>
+#include <atomic>
 #include "J2735MapToJsonConverter.h"
 #include "JsonToJ2735SpatConverter.h"
 #include "J2735ToSRMJsonConverter.h"   
@@ -24,6 +26,7 @@
 #include "JsonToJ3224SDSMConverter.h"
 #include "J3224ToSDSMJsonConverter.h"
 #include "PluginClientClockAware.h"
+#include "ConversionCache.h"
 
 
 
@@ -48,6 +51,12 @@ protected:
 	void OnConfigChanged(const char *key, const char *value);
 
 	void OnStateChange(IvpPluginState state);
+	/**
+	 * @brief Forward a MAP that was received and converted before from the conversion cache, without decoding it again.
+	 * Any other message is handled as usual.
+	 * @param msg The message received from the TMX bus.
+	 */
+	void OnMessageReceived(IvpMessage *msg) override;
 	void HandleMobilityOperationMessage(tsm3Message &msg, routeable_message &routeableMsg);
 	void HandleMobilityPathMessage(tsm2Message &msg, routeable_message &routeableMsg);
 	void HandleBasicSafetyMessage(BsmMessage &msg, routeable_message &routeableMsg);
@@ -69,6 +78,12 @@ protected:
 	 * @param routeableMsg 
 	 */
 	void HandleMapMessage(MapDataMessage &msg, routeable_message &routeableMsg);
+	/**
+	 * @brief Produce the MAP JSON for the given map data to the MAP Kafka topic, unless it is a repeat that is to be suppressed.
+	 * @param mapDataJson The map data converted from the MAP, written as JSON.
+	 * @param repeated Whether the map data was found in the conversion cache.
+	 */
+	void ForwardMapMessage(const std::string &mapDataJson, bool repeated);
 	/**
 	 * @brief Subscribes to incoming ASN.1, C-Struct formatted SDSMs generated from broadcasting RSUs. These SDSM C-Structs are then converted to JSON to be forwarded to CARMA Streets/Kafka by the handler.
 	 * @param msg The J3224 SDSM received from the internal 
@@ -80,21 +95,30 @@ protected:
 	*/
 	void HandleSRMMessage (SrmMessage &msg, routeable_message &routeableMsg);
 	/**
-	 * @brief Subcribe to scheduling plan Kafka topic created by carma-streets
+	 * @brief Subcribe to the scheduling plan, SPAT, SSM and SDSM Kafka topics created by carma-streets with a single consumer,
+	 * and handle each batch of messages consumed according to the topic it came from.
 	 */
-	void SubscribeSchedulingPlanKafkaTopic();
+	void SubscribeKafkaTopics();
 	/**
-	 * @brief Subcribe to SPAT Kafka topic created by carma-streets
+	 * @brief Encode and broadcast the TSM3 messages in a scheduling plan consumed from Kafka
+	 * @param message The consumed message, valid until the next batch is consumed
 	 */
-	void SubscribeSpatKafkaTopic();
+	void HandleSchedulingPlanPayload(const kafka_message_view &message);
 	/**
-	 * @brief Subcribe to SSM Kafka topic created by carma-streets
+	 * @brief Encode and broadcast a SPAT consumed from Kafka
+	 * @param message The consumed message, valid until the next batch is consumed
 	 */
-	void SubscribeSSMKafkaTopic();
+	void HandleSpatPayload(const kafka_message_view &message);
 	/**
-	 * @brief Subcribe to SDSM Kafka topic created by carma-streets
+	 * @brief Encode and broadcast a SSM consumed from Kafka
+	 * @param message The consumed message, valid until the next batch is consumed
 	 */
-	void SubscribeSDSMKafkaTopic();
+	void HandleSSMPayload(const kafka_message_view &message);
+	/**
+	 * @brief Encode and broadcast a SDSM consumed from Kafka
+	 * @param message The consumed message, valid until the next batch is consumed
+	 */
+	void HandleSDSMPayload(const kafka_message_view &message);
 
 	bool getEncodedtsm3(tsm3EncodedMessage *tsm3EncodedMsg,  Json::Value metadata, Json::Value payload_json);
 	/**
@@ -129,10 +153,12 @@ private:
 	std::string _kafkaBrokerIp;
 	std::string _kafkaBrokerPort;
 	std::shared_ptr<kafka_producer_worker> _kafka_producer_ptr;
-	std::shared_ptr<kafka_consumer_worker> _spat_kafka_consumer_ptr;
-	std::shared_ptr<kafka_consumer_worker> _scheduing_plan_kafka_consumer_ptr;
-	std::shared_ptr<kafka_consumer_worker> _ssm_kafka_consumer_ptr;
-	std::shared_ptr<kafka_consumer_worker> _sdsm_kafka_consumer_ptr;
+	std::shared_ptr<kafka_consumer_worker> _kafka_consumer_ptr;
+	std::string _kafka_consumer_topics;
+	/**
+	 * @brief Most messages handled from each batch consumed from Kafka
+	 */
+	const size_t _kafkaConsumeBatchSize = 64;
 	std::vector<std::string> _strategies;
 	tmx::messages::tsm3Message *_tsm3Message{NULL};
 	std::mutex data_lock;
@@ -166,6 +192,31 @@ private:
 	 */
 	uint _mapMessageSkipped = 0;
 
+	/**
+	 * @brief The map data JSON converted from each recently received MAP, by the bytes of the encoded MAP.
+	 */
+	ConversionCache<std::string> _mapDataCache;
+
+	/**
+	 * @brief Whether to skip forwarding a MAP that is found in the conversion cache.
+	 */
+	std::atomic<bool> _suppressRepeatedMap {false};
+
+	/**
+	 * @brief Status label for the percentage of MAP messages found in the conversion cache.
+	 */
+	const char* Key_MAPCacheHitRate = "MAP messages found in conversion cache (%).";
+
+	/**
+	 * @brief Status label for repeated MAP messages that were not forwarded.
+	 */
+	const char* Key_MAPMessageSuppressed = "Repeated MAP messages not forwarded.";
+
+	/**
+	 * @brief Count for repeated MAP messages that were not forwarded.
+	 */
+	uint _mapMessageSuppressed = 0;
+
 	/**
 	 * @brief Status label for Mobility Operation messages skipped due to errors.
 	 */
@@ -229,6 +280,12 @@ private:
 	 * @brief Count for SRM messages skipped due to errors.
 	 */
 	uint _srmMessageSkipped = 0;
+	/**
+	 * @brief Status labels for messages produced to Kafka, counted by the Kafka producer.
+	 */
+	const char* Key_KafkaMessagesDelivered = "Messages delivered to Kafka.";
+	const char* Key_KafkaMessagesFailed = "Messages that failed to be delivered to Kafka.";
+	const char* Key_KafkaMessagesDropped = "Messages dropped while the Kafka producer queue was full.";
 };
 std::mutex _cfgLock;
 
@@ -56,6 +56,16 @@ namespace CARMAStreetsPlugin
         mapJson["map_data"] = mapDataJson;
     }
 
+    std::string J2735MapToJsonConverter::composeMapJSON(const std::string &mapDataJson) const
+    {
+        auto timestamp_utc = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        std::string mapJson;
+        mapJson.reserve(mapDataJson.size() + 64);
+        mapJson.append("{\"map_data\":").append(mapDataJson);
+        mapJson.append(",\"metadata\":{\"timestamp\":\"").append(std::to_string(timestamp_utc)).append("\"}}");
+        return mapJson;
+    }
+
     void J2735MapToJsonConverter::convertLanesetToJSON(const IntersectionGeometry *intersection, Json::Value &laneSetJson) const
     {
         // Construct laneset
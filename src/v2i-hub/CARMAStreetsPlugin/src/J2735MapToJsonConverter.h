@@ -21,6 +21,14 @@ namespace CARMAStreetsPlugin
          */
         void convertJ2735MAPToMapJSON(const std::shared_ptr<MapData> mapMsgPtr, Json::Value &mapJson) const;
 
+        /**
+         * @brief Compose the MAP JSON from map data that was already written as JSON, with the current time in its metadata.
+         * This lets the map data converted from a MAP be forwarded again without converting the MAP again.
+         * @param mapDataJson The "map_data" object of the MAP JSON, written as JSON.
+         * @return The MAP JSON with the same members as convertJ2735MAPToMapJSON populates.
+         */
+        std::string composeMapJSON(const std::string &mapDataJson) const;
+
         /**
          * @brief Convert the J2735 IntersectionGeometry into JSON format.
          * @param mapMsgPtr The input is a constant J2735 message pointer. This prevent any modification to the original IntersectionGeometry message
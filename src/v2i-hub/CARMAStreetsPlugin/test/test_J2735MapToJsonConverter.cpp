@@ -1,12 +1,78 @@
 #include <gtest/gtest.h>
 #include "jsoncpp/json/json.h"
 #include "J2735MapToJsonConverter.h"
+#include "ConversionCache.h"
+#include <cstring>
 
 class test_J2735MapToJsonConverter : public testing::Test
 {
 public:
     test_J2735MapToJsonConverter() = default;
     ~test_J2735MapToJsonConverter() = default;
+
+    /**
+     * @brief Build a MAP of one intersection with the given number of lanes, each with a few nodes and a connection.
+     */
+    static MapData *buildMap(int laneCount)
+    {
+        MapData *mapData = (MapData *)calloc(1, sizeof(MapData));
+        mapData->msgIssueRevision = 3;
+        mapData->layerID = (LayerID_t *)calloc(1, sizeof(LayerID_t));
+        *mapData->layerID = 1;
+        mapData->layerType = (LayerType_t *)calloc(1, sizeof(LayerType_t));
+        *mapData->layerType = LayerType_intersectionData;
+
+        IntersectionGeometry *intersection = (IntersectionGeometry *)calloc(1, sizeof(IntersectionGeometry));
+        intersection->id.id = 9945;
+        intersection->revision = 3;
+        intersection->refPoint.lat = 389549775;
+        intersection->refPoint.Long = -771491835;
+        intersection->laneWidth = (LaneWidth_t *)calloc(1, sizeof(LaneWidth_t));
+        *intersection->laneWidth = 371;
+
+        for (int i = 0; i < laneCount; i++)
+        {
+            GenericLane *lane = (GenericLane *)calloc(1, sizeof(GenericLane));
+            lane->laneID = i + 1;
+            lane->ingressApproach = (ApproachID_t *)calloc(1, sizeof(ApproachID_t));
+            *lane->ingressApproach = i % 4 + 1;
+            setBits(lane->laneAttributes.directionalUse, 2, 0x80);
+            setBits(lane->laneAttributes.sharedWith, 10, 0x00);
+            lane->laneAttributes.laneType.present = LaneTypeAttributes_PR_vehicle;
+            setBits(lane->laneAttributes.laneType.choice.vehicle, 8, 0x00);
+
+            lane->nodeList.present = NodeListXY_PR_nodes;
+            for (int n = 0; n < 6; n++)
+            {
+                NodeXY *node = (NodeXY *)calloc(1, sizeof(NodeXY));
+                node->delta.present = NodeOffsetPointXY_PR_node_XY2;
+                node->delta.choice.node_XY2.x = 120 * i - 900 + n * 7;
+                node->delta.choice.node_XY2.y = -800 + n * 250;
+                asn_sequence_add(&lane->nodeList.choice.nodes.list, node);
+            }
+
+            lane->connectsTo = (ConnectsToList *)calloc(1, sizeof(ConnectsToList));
+            Connection *connection = (Connection *)calloc(1, sizeof(Connection));
+            connection->connectingLane.lane = (i + 4) % laneCount + 1;
+            connection->signalGroup = (SignalGroupID_t *)calloc(1, sizeof(SignalGroupID_t));
+            *connection->signalGroup = i % 8 + 1;
+            asn_sequence_add(&lane->connectsTo->list, connection);
+
+            asn_sequence_add(&intersection->laneSet.list, lane);
+        }
+
+        mapData->intersections = (IntersectionGeometryList *)calloc(1, sizeof(IntersectionGeometryList));
+        asn_sequence_add(&mapData->intersections->list, intersection);
+        return mapData;
+    }
+
+    static void setBits(BIT_STRING_t &bits, int count, uint8_t first)
+    {
+        bits.size = (count + 7) / 8;
+        bits.bits_unused = bits.size * 8 - count;
+        bits.buf = (uint8_t *)calloc(bits.size + 1, 1);
+        bits.buf[0] = first;
+    }
 };
 
 namespace unit_test
@@ -49,4 +115,83 @@ namespace unit_test
         ASSERT_EQ("222", mapJson["map_data"]["intersections"]["intersection_geometry"]["ref_point"]["long"].asString());
         ASSERT_EQ("12", mapJson["map_data"]["intersections"]["intersection_geometry"]["lane_width"].asString());
     }
+
+    TEST_F(test_J2735MapToJsonConverter, composeMapJSON)
+    {
+        CARMAStreetsPlugin::J2735MapToJsonConverter converter;
+        std::shared_ptr<MapData> mapMsgPtr(buildMap(4), [](MapData *map) { ASN_STRUCT_FREE(asn_DEF_MapData, map); });
+        Json::Value mapJson;
+        converter.convertJ2735MAPToMapJSON(mapMsgPtr, mapJson);
+
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = "";
+        auto composed = converter.composeMapJSON(Json::writeString(builder, mapJson["map_data"]));
+
+        Json::Value composedJson;
+        std::string errors;
+        std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+        ASSERT_TRUE(reader->parse(composed.data(), composed.data() + composed.size(), &composedJson, &errors)) << errors;
+        ASSERT_EQ(mapJson["map_data"], composedJson["map_data"]);
+        ASSERT_EQ(4, composedJson["map_data"]["intersections"]["intersection_geometry"]["lane_set"].size());
+
+        // The timestamp is when the JSON was composed
+        auto timestamp = std::stoll(composedJson["metadata"]["timestamp"].asString());
+        ASSERT_GE(timestamp, std::stoll(mapJson["metadata"]["timestamp"].asString()));
+    }
+
+    /**
+     * @brief Time to forward a MAP received again, converting it each time as the plugin did before,
+     * and from the JSON kept in a conversion cache.
+     * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+     */
+    TEST_F(test_J2735MapToJsonConverter, DISABLED_benchmarkMapForwarding)
+    {
+        static constexpr int count = 2000;
+
+        tmx::messages::MapDataMessage mapMessage(buildMap(16));
+        tmx::messages::MapDataEncodedMessage encodedMap;
+        encodedMap.initialize(mapMessage);
+        tmx::routeable_message &received = encodedMap;
+
+        CARMAStreetsPlugin::J2735MapToJsonConverter converter;
+        std::string message;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+        {
+            auto map = received.get_payload<tmx::messages::MapDataMessage>();
+            Json::Value mapJson;
+            Json::StreamWriterBuilder builder;
+            converter.convertJ2735MAPToMapJSON(map.get_j2735_data(), mapJson);
+            message = Json::writeString(builder, mapJson);
+        }
+        double converted = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+
+        tmx::utils::ConversionCache<std::string> cache;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+        {
+            const char *payload = received.get_payload_hex();
+            auto mapDataJson = cache.Find(tmx::messages::MapDataMessage::MessageSubType, payload, strlen(payload));
+            if (!mapDataJson)
+            {
+                auto map = received.get_payload<tmx::messages::MapDataMessage>();
+                Json::Value mapJson;
+                Json::StreamWriterBuilder builder;
+                builder["indentation"] = "";
+                converter.convertJ2735MAPToMapJSON(map.get_j2735_data(), mapJson);
+                mapDataJson = cache.Insert(tmx::messages::MapDataMessage::MessageSubType, payload, strlen(payload),
+                        Json::writeString(builder, mapJson["map_data"]));
+            }
+            message = converter.composeMapJSON(*mapDataJson);
+        }
+        double cached = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+
+        printf("MAP of %zu hex digits forwarded %d times\n", strlen(received.get_payload_hex()), count);
+        printf("  converted each time  %9.1f us/MAP\n", converted);
+        printf("  conversion cache     %9.1f us/MAP (%.0f%% hits)\n", cached, cache.GetHitRate());
+
+        ASSERT_EQ(count - 1, cache.GetHitCount());
+        ASSERT_LT(cached, converted);
+    }
 }
\ No newline at end of file
@@ -4,6 +4,12 @@ namespace ERVCloudForwardingPlugin
 {
     ERVCloudForwardingPlugin::ERVCloudForwardingPlugin(const string &name) : PluginClient(name)
     {
+        // The requests are POSTs, so they are only retried when the connection could not be made
+        HttpRetryPolicy retryPolicy;
+        retryPolicy.MaxAttempts = 3;
+        _cloudClient = std::make_unique<HttpClient>(HTTP_CLIENT_DEFAULT_MAX_IN_FLIGHT, 5000, retryPolicy);
+        _cloudClient->SetMinTlsVersion(HttpTlsVersion::TLSv1_2);
+
         UpdateConfigSettings();
         std::lock_guard<mutex> lock(_cfgLock);
         AddMessageFilter<BsmMessage>(this, &ERVCloudForwardingPlugin::handleBSM);
@@ -177,37 +183,39 @@ namespace ERVCloudForwardingPlugin
 
     void ERVCloudForwardingPlugin::CloudSendAsync(const string &local_msg, const string &local_url, const string &local_base, const string &local_method)
     {
-        std::thread t([this, local_msg, &local_url, &local_base, &local_method]()
-                      { CloudSend(local_msg, local_url, local_base, local_method); });
-        t.detach();
+        string urlfull = local_url + local_base;
+        PLOG(logDEBUG) << "Forwarding message to cloud: " << local_msg << endl;
+        // PLOG uses the plugin name. The client is a member, so its callbacks are finished before the plugin is destroyed.
+        auto onResponse = [this, urlfull](const HttpResponse &response)
+        {
+            if (response.Error.empty())
+            {
+                PLOG(logDEBUG) << "Successfully forwarded message to cloud, HTTP status: " << response.Status << endl;
+            }
+            else
+            {
+                PLOG(logERROR) << "Failed to forward message to " << urlfull << " after " << response.Attempts << " attempt(s): " << response.Error << endl;
+            }
+        };
+        // Called for each BSM, so a message is dropped rather than holding up the BSM handler when the cloud falls behind
+        if (!_cloudClient->TrySend(local_method, urlfull, local_msg, onResponse, _CONTENTTYPE))
+        {
+            PLOG(logWARNING) << "Dropped message to " << urlfull << ", " << _cloudClient->GetMaxInFlight()
+                             << " requests are in flight. " << _cloudClient->GetDroppedCount() << " dropped in total." << endl;
+        }
     }
 
     int ERVCloudForwardingPlugin::CloudSend(const string &local_msg, const string &local_url, const string &local_base, const string &local_method)
     {
-        CURL *req;
-        CURLcode res;
         string urlfull = local_url + local_base;
-        req = curl_easy_init();
-        if (req)
+        PLOG(logDEBUG) << "Forwarding message to cloud: " << local_msg << endl;
+        auto response = _cloudClient->Execute(local_method, urlfull, local_msg, _CONTENTTYPE);
+        if (!response.Error.empty())
         {
-            curl_easy_setopt(req, CURLOPT_URL, urlfull.c_str());
-            if (strcmp(local_method.c_str(), "POST") == 0)
-            {
-                curl_easy_setopt(req, CURLOPT_POSTFIELDS, local_msg.c_str());
-                curl_easy_setopt(req, CURLOPT_TIMEOUT_MS, 5000L); //Http request timeout in 5 seconds
-                curl_easy_setopt(req, CURLOPT_SSLVERSION, CURL_SSLVERSION_TLSv1_2);
-                PLOG(logDEBUG) << "Forwarding message to cloud via curl: " << local_msg << endl;
-                res = curl_easy_perform(req);
-                if (res != CURLE_OK)
-                {
-                    fprintf(stderr, "curl send failed: %s\n", curl_easy_strerror(res));
-                    return EXIT_FAILURE;
-                }else{
-                    PLOG(logDEBUG) << "Successfully forwarded message to cloud via curl: " << local_msg << endl;
-                }
-            }
-            curl_easy_cleanup(req);
+            PLOG(logERROR) << "Failed to send message to " << urlfull << " after " << response.Attempts << " attempt(s): " << response.Error << endl;
+            return EXIT_FAILURE;
         }
+        PLOG(logDEBUG) << "Successfully forwarded message to cloud: " << local_msg << endl;
         return 0;
     }
 
@@ -14,7 +14,7 @@
 #include <tmx/messages/IvpJ2735.h>
 #include "PluginUtil.h"
 #include "PluginClient.h"
-#include <curl/curl.h>
+#include "HttpClient.h"
 #include <qhttpengine/server.h>
 #include <QCommandLineOption>
 #include <QCommandLineParser>
@@ -63,6 +63,10 @@ namespace ERVCloudForwardingPlugin
         const string _CLOUDRSUREQ = "/carmacloud/rsu/register";
         const string _POSTMETHOD = "POST";
         const string _HEXENC = "asn.1-uper/hexstring";
+        // carma-cloud has only ever been sent form encoded posts
+        const string _CONTENTTYPE = "application/x-www-form-urlencoded";
+        // Keeps the connection to carma-cloud open, and retries requests that fail
+        std::unique_ptr<HttpClient> _cloudClient;
 
     public:
         explicit ERVCloudForwardingPlugin(const string &);
@@ -91,7 +95,7 @@ namespace ERVCloudForwardingPlugin
          */
         int CloudSend(const string &msg, const string &url, const string &base, const string &method);
         /**
-         * @brief Create a new thread and send BSM request to the cloud
+         * @brief Queue a BSM request to the cloud, without waiting for the response
          * @param msg BSM message request
          * @param url The server IP and port the request is sent to
          * @param base The request path
@@ -37,7 +37,8 @@ ImmediateForwardPlugin::ImmediateForwardPlugin(std::string name) : PluginClient(
 	_configRead(false),
 	_skippedNoDsrcMetadata(0),
 	_skippedNoMessageRoute(0),
-	_skippedInvalidUdpClient(0)
+	_skippedInvalidUdpClient(0),
+	_signClient(new HttpClient())
 {
 	AddMessageFilter("J2735", "*", IvpMsgFlags_RouteDSRC);
 	AddMessageFilter("Battelle-DSRC", "*", IvpMsgFlags_RouteDSRC);
@@ -51,6 +52,9 @@ ImmediateForwardPlugin::ImmediateForwardPlugin(std::string name) : PluginClient(
 
 ImmediateForwardPlugin::~ImmediateForwardPlugin()
 {
+	// Stop any outstanding signing first, since the completions take the UDP client lock
+	_signClient.reset();
+
 	lock_guard<mutex> lock(_mutexUdpClient);
 
 	for (uint i = 0; i < _udpClientList.size(); i++)
@@ -119,6 +123,7 @@ void ImmediateForwardPlugin::UpdateConfigSettings()
 	{
 		lock_guard<mutex> lock(_mutexUdpClient);
 		_messageConfigMap.clear();
+		_configGeneration++;
 
 		_skippedNoDsrcMetadata = 0;
 		_skippedNoMessageRoute = 0;
@@ -173,6 +178,7 @@ bool ImmediateForwardPlugin::UpdateUdpClientFromConfigSettings(uint clientIndex)
 		// A lock_guard will unlock when it goes out of scope (even if an exception occurs).
 		lock_guard<mutex> lock(_mutexUdpClient);
 
+		_configGeneration++;
 		ParseJsonMessageConfig(messages, clientIndex);
 
 		for (uint i = 0; i < _udpClientList[clientIndex].size(); i++)
@@ -282,7 +288,15 @@ void ImmediateForwardPlugin::SendMessageToRadio(IvpMessage *msg)
 	bool foundMessageType = false;
 	static FrequencyThrottle<std::string> _statusThrottle(chrono::milliseconds(2000));
 
-	lock_guard<mutex> lock(_mutexUdpClient);
+	// Messages to sign are posted to the HSM after the lock is released, since
+	// the signing completions need the same lock to send to the UDP clients
+	std::vector<std::pair<MessageConfig, std::string>> signRequests;
+	std::string signUrl;
+	int channel = msg->dsrcMetadata->channel;
+
+	unique_lock<mutex> lock(_mutexUdpClient);
+
+	uint64_t generation = _configGeneration;
 
 	int msgCount = 0;
 
@@ -313,13 +327,6 @@ void ImmediateForwardPlugin::SendMessageToRadio(IvpMessage *msg)
 		if (_messageConfigMap[configIndex].TmxType == msg->subtype)
 		{
 			foundMessageType = true;
-			string payloadbyte="";
-
-
-			// Format the message using the protocol defined in the
-			// USDOT ROadside Unit Specifications Document v 4.0 Appendix C.
-
-			stringstream os;
 
 			/// if signing is Enabled, request signing with HSM 
 			
@@ -338,102 +345,148 @@ void ImmediateForwardPlugin::SendMessageToRadio(IvpMessage *msg)
 
 				hex2base64(msgString,base64str);  
 
-				std::string req = "\'{\"type\":\""+mType+"\",\"message\":\""+base64str+"\"}\'";
-
-
-
-				string cmd1="curl -X POST "+url+" -H \'Content-Type: application/json\' -d "+req; 
-				const char *cmd=cmd1.c_str();  
-				char buffer[2048];
-				std::string result="";
-				FILE* pipe= popen(cmd,"r"); 
-
-				if (pipe == NULL ) 
-					throw std::runtime_error("popen() failed!");
-				try{
-					while (fgets(buffer, sizeof(buffer),pipe) != NULL)
-					{
-						result+=buffer; 
-					}
-				} catch (std::exception const & ex) {
-					
-					pclose(pipe);
-					SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
-					PLOG(logERROR) << "Error parsing Messages: " << ex.what();
-					return;
-; 
-				}
-				PLOG(logDEBUG1) << "SCMS Contain response = " << result << std::endl;
-				cJSON *root   = cJSON_Parse(result.c_str());
-				// Check if status is 200 (successful)
-				cJSON *status = cJSON_GetObjectItem(root, "code");
-				if ( status ) {
-					// IF status code exists this means the SCMS container returned an error response on attempting to sign
-					// Set status will increment the count of message skipped due to signature error responses by one each
-					// time this occurs. This count will be visible under the "State" tab of this plugin.
-					cJSON *message = cJSON_GetObjectItem(root, "message");
-					SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
-					PLOG(logERROR) << "Error response from SCMS container HTTP code " << status->valueint << "!\n" << message->valuestring << std::endl;
-					return;
-				}
-				cJSON *sd = cJSON_GetObjectItem(root, "signedMessage");
-				string signedMsg = sd->valuestring;
-				base642hex(signedMsg,payloadbyte); // this allows sending hex of the signed message rather than base64
+				std::string req = "{\"type\":\""+mType+"\",\"message\":\""+base64str+"\"}";
 
+				signRequests.push_back(std::make_pair(_messageConfigMap[configIndex], req));
 			}
 			else 
 			{
-				payloadbyte=msg->payload->valuestring; 
+				SendMessageToClients(_messageConfigMap[configIndex], channel, msg->payload->valuestring, false);
 			}
-			// @SONAR_START@
+		}
+	}
 
-			os << "Version=0.7" << "\n";
-			os << "Type=" << _messageConfigMap[configIndex].SendType << "\n" << "PSID=" << _messageConfigMap[configIndex].Psid << "\n";
-			if (_messageConfigMap[configIndex].Channel.empty())
-				os << "Priority=7" << "\n" << "TxMode=CONT" << "\n" << "TxChannel=" << msg->dsrcMetadata->channel << "\n";
-			else
-				os << "Priority=7" << "\n" << "TxMode=CONT" << "\n" << "TxChannel=" << _messageConfigMap[configIndex].Channel << "\n";
-			os << "TxInterval=0" << "\n" << "DeliveryStart=\n" << "DeliveryStop=\n";
-			os << "Signature="<< (signState == 1 ? "True" : "False") << "\n" << "Encryption=False\n";
-			os << "Payload=" << payloadbyte << "\n";
+	signUrl = url;
+	lock.unlock();
 
-			string message = os.str();
+	for (auto &request : signRequests)
+	{
+		MessageConfig config = request.first;
+		_signClient->Post(signUrl, request.second, [this, config, channel, generation](const HttpResponse &response)
+		{
+			OnSignResponse(config, channel, generation, response);
+		});
+	}
 
+	if (!foundMessageType)
+	{
+		SetStatus<uint>(Key_SkippedNoMessageRoute, ++_skippedNoMessageRoute);
+		PLOG(logWARNING)<<" WARNING TMX Subtype not found in configuration. Message Ignored: " <<
+				"Type: " << msg->type << ", Subtype: " << msg->subtype;
+		return;
+	}
 
 
+}
 
-			// Send the message using the configured UDP client.
+// @SONAR_STOP@
+void ImmediateForwardPlugin::OnSignResponse(const MessageConfig &config, int channel, uint64_t generation, const HttpResponse &response)
+{
+	if (!response.Error.empty())
+	{
+		SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
+		PLOG(logERROR) << "Unable to reach SCMS container: " << response.Error;
+		return;
+	}
 
-			for (uint i = 0; i < _udpClientList[_messageConfigMap[configIndex].ClientIndex].size(); i++)
-			{
-				//cout << message << endl;
-
-				if (_udpClientList[_messageConfigMap[configIndex].ClientIndex][i] != NULL)
-				{
-					PLOG(logDEBUG2) << _logPrefix << "Sending - TmxType: " << _messageConfigMap[configIndex].TmxType << ", SendType: " << _messageConfigMap[configIndex].SendType
-						<< ", PSID: " << _messageConfigMap[configIndex].Psid << ", Client: " << _messageConfigMap[configIndex].ClientIndex
-						<< ", Channel: " << (_messageConfigMap[configIndex].Channel.empty() ? ::to_string( msg->dsrcMetadata->channel) : _messageConfigMap[configIndex].Channel)
-						<< ", Port: " << _udpClientList[_messageConfigMap[configIndex].ClientIndex][i]->GetPort();
-
-					_udpClientList[_messageConfigMap[configIndex].ClientIndex][i]->Send(message);
-				}
-				else
-				{
-					SetStatus<uint>(Key_SkippedInvalidUdpClient, ++_skippedInvalidUdpClient);
-					PLOG(logWARNING) << "UDP Client Invalid. Cannot send message. TmxType: " << _messageConfigMap[configIndex].TmxType;
-				}
-			}
-		}
+	PLOG(logDEBUG1) << "SCMS Contain response = " << response.Body << std::endl;
+	cJSON *root   = cJSON_Parse(response.Body.c_str());
+	if (!root)
+	{
+		SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
+		PLOG(logERROR) << "Invalid response from SCMS container HTTP code " << response.Status << ": " << response.Body;
+		return;
 	}
-	if (!foundMessageType)
+
+	// Check if status is 200 (successful)
+	cJSON *status = cJSON_GetObjectItem(root, "code");
+	if ( status ) {
+		// IF status code exists this means the SCMS container returned an error response on attempting to sign
+		// Set status will increment the count of message skipped due to signature error responses by one each
+		// time this occurs. This count will be visible under the "State" tab of this plugin.
+		cJSON *message = cJSON_GetObjectItem(root, "message");
+		SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
+		PLOG(logERROR) << "Error response from SCMS container HTTP code " << status->valueint << "!\n" << (message ? message->valuestring : "") << std::endl;
+		cJSON_Delete(root);
+		return;
+	}
+	cJSON *sd = cJSON_GetObjectItem(root, "signedMessage");
+	if (!sd || !sd->valuestring)
 	{
-		SetStatus<uint>(Key_SkippedNoMessageRoute, ++_skippedNoMessageRoute);
-		PLOG(logWARNING)<<" WARNING TMX Subtype not found in configuration. Message Ignored: " <<
-				"Type: " << msg->type << ", Subtype: " << msg->subtype;
+		SetStatus<uint>(Key_SkippedSignError, ++_skippedSignErrorResponse);
+		PLOG(logERROR) << "No signed message in SCMS container response: " << response.Body;
+		cJSON_Delete(root);
+		return;
+	}
+
+	string signedMsg = sd->valuestring;
+	cJSON_Delete(root);
+
+	string payloadbyte="";
+	base642hex(signedMsg,payloadbyte); // this allows sending hex of the signed message rather than base64
+
+	lock_guard<mutex> lock(_mutexUdpClient);
+
+	// The configuration may have been reloaded while the request was with the HSM,
+	// in which case the captured config no longer matches the UDP clients
+	if (generation != _configGeneration)
+	{
+		PLOG(logDEBUG) << "Dropping signed " << config.TmxType << " message requested before the configuration was reloaded.";
+		return;
+	}
+
+	SendMessageToClients(config, channel, payloadbyte, true);
+}
+// @SONAR_START@
+
+// Must be called with the UDP client mutex held
+void ImmediateForwardPlugin::SendMessageToClients(const MessageConfig &config, int channel, const std::string &payloadbyte, bool isSigned)
+{
+	// Format the message using the protocol defined in the
+	// USDOT ROadside Unit Specifications Document v 4.0 Appendix C.
+
+	stringstream os;
+
+	os << "Version=0.7" << "\n";
+	os << "Type=" << config.SendType << "\n" << "PSID=" << config.Psid << "\n";
+	if (config.Channel.empty())
+		os << "Priority=7" << "\n" << "TxMode=CONT" << "\n" << "TxChannel=" << channel << "\n";
+	else
+		os << "Priority=7" << "\n" << "TxMode=CONT" << "\n" << "TxChannel=" << config.Channel << "\n";
+	os << "TxInterval=0" << "\n" << "DeliveryStart=\n" << "DeliveryStop=\n";
+	os << "Signature="<< (isSigned ? "True" : "False") << "\n" << "Encryption=False\n";
+	os << "Payload=" << payloadbyte << "\n";
+
+	if (config.ClientIndex >= _udpClientList.size())
+	{
+		SetStatus<uint>(Key_SkippedInvalidUdpClient, ++_skippedInvalidUdpClient);
+		PLOG(logWARNING) << "UDP Client " << config.ClientIndex << " does not exist. Cannot send message. TmxType: " << config.TmxType;
 		return;
 	}
 
+	string message = os.str();
 
+	// Send the message using the configured UDP client.
+
+	for (uint i = 0; i < _udpClientList[config.ClientIndex].size(); i++)
+	{
+		//cout << message << endl;
+
+		if (_udpClientList[config.ClientIndex][i] != NULL)
+		{
+			PLOG(logDEBUG2) << _logPrefix << "Sending - TmxType: " << config.TmxType << ", SendType: " << config.SendType
+				<< ", PSID: " << config.Psid << ", Client: " << config.ClientIndex
+				<< ", Channel: " << (config.Channel.empty() ? ::to_string(channel) : config.Channel)
+				<< ", Port: " << _udpClientList[config.ClientIndex][i]->GetPort();
+
+			_udpClientList[config.ClientIndex][i]->Send(message);
+		}
+		else
+		{
+			SetStatus<uint>(Key_SkippedInvalidUdpClient, ++_skippedInvalidUdpClient);
+			PLOG(logWARNING) << "UDP Client Invalid. Cannot send message. TmxType: " << config.TmxType;
+		}
+	}
 }
 
 
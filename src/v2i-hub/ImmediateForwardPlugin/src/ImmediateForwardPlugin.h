@@ -13,6 +13,7 @@
 #include <map>
 #include <mutex>
 #include <vector>
+#include "HttpClient.h"
 #include "PluginClient.h"
 #include "UdpClient.h"
 
@@ -46,6 +47,8 @@ private:
 	bool ParseJsonMessageConfig(const std::string& json, uint clientIndex);
 	int GetUdpClientIndexForMessage(std::string subtype);
 	void SendMessageToRadio(IvpMessage *msg);
+	void OnSignResponse(const MessageConfig &config, int channel, uint64_t generation, const tmx::utils::HttpResponse &response);
+	void SendMessageToClients(const MessageConfig &config, int channel, const std::string &payloadbyte, bool isSigned);
 	// @SONAR_STOP@
  
 
@@ -61,6 +64,9 @@ private:
 	typedef std::vector<tmx::utils::UdpClient *> svr_list;
 	std::array<svr_list, 4> _udpClientList;
 	std::vector<MessageConfig> _messageConfigMap;
+	// Incremented whenever the clients or message configs are rebuilt, so that
+	// sign responses for requests made before a reload can be discarded.
+	uint64_t _configGeneration = 0;
 	std::map<std::string, int> _messageCountMap;
 	std::string signatureData; 
 	std::string url; 
@@ -73,9 +79,12 @@ private:
 	uint _skippedNoDsrcMetadata;
 	uint _skippedNoMessageRoute;
 	uint _skippedInvalidUdpClient;
-	uint _skippedSignErrorResponse;
+	std::atomic<uint> _skippedSignErrorResponse{0};
 
 	bool _muteDsrc;
+
+	// Keep-alive connection to the HSM used for signing
+	std::unique_ptr<tmx::utils::HttpClient> _signClient;
 	// @SONAR_START@
 
 };
@@ -0,0 +1,331 @@
+/**
+ * Copyright (C) 2019 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#include "LogWriter.h"
+
+#include <PluginLog.h>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+using namespace tmx::utils;
+
+namespace MessageLoggerPlugin
+{
+
+	LogWriter::LogWriter(size_t bufferCount, size_t bufferSize, std::chrono::milliseconds flushInterval) :
+		_bufferSize(bufferSize), _flushInterval(flushInterval)
+	{
+		if (bufferCount < 2)
+			bufferCount = 2;
+
+		for (size_t i = 0; i < bufferCount; i++)
+		{
+			_pool.emplace_back(new Buffer());
+			_pool.back()->Json.reserve(bufferSize);
+			_pool.back()->Bin.reserve(bufferSize);
+			_free.push_back(_pool.back().get());
+		}
+
+		_active = _free.front();
+		_free.pop_front();
+
+		_thread = std::thread(&LogWriter::Run, this);
+	}
+
+	/**
+	 * Write any remaining records, then stop the writer thread and close the files.
+	 */
+	LogWriter::~LogWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_run = false;
+
+			if (_active && (!_active->Json.empty() || !_active->Bin.empty()))
+			{
+				_full.push_back(_active);
+				_submitted++;
+			}
+			_active = nullptr;
+		}
+		_writeCond.notify_all();
+		_freeCond.notify_all();
+
+		if (_thread.joinable())
+			_thread.join();
+
+		CloseFiles();
+	}
+
+	void LogWriter::Open(const std::string &directory, const std::string &filename, uint64_t maxFileSize, bool writeJson)
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (!_run)
+			return;
+
+		if (!_active->Json.empty() || !_active->Bin.empty())
+			Submit(lock);
+
+		_requested.Directory = directory;
+		_requested.Filename = filename;
+		_requested.MaxFileSize = maxFileSize;
+		_requested.WriteJson = writeJson;
+
+		uint64_t request = ++_opensRequested;
+		_writeCond.notify_all();
+		_doneCond.wait(lock, [this, request]() { return _opensCompleted >= request || !_run; });
+	}
+
+	void LogWriter::SetFlushThresholds(size_t bufferSize, std::chrono::milliseconds flushInterval)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+			_bufferSize = bufferSize;
+			_flushInterval = flushInterval;
+		}
+		_writeCond.notify_all();
+	}
+
+	void LogWriter::Append(const char *json, size_t jsonLength, const char *record, size_t recordLength)
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (!_active)
+			return;
+
+		if ((!_active->Json.empty() || !_active->Bin.empty()) &&
+				(_active->Json.size() + jsonLength > _bufferSize || _active->Bin.size() + recordLength > _bufferSize))
+		{
+			Submit(lock);
+			if (!_active)
+				return;
+		}
+
+		if (json)
+			_active->Json.append(json, jsonLength);
+		_active->Bin.append(record, recordLength);
+	}
+
+	void LogWriter::Flush()
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+		if (_active && (!_active->Json.empty() || !_active->Bin.empty()))
+			Submit(lock);
+
+		uint64_t target = _submitted;
+		_doneCond.wait(lock, [this, target]() { return _completed >= target; });
+	}
+
+	uint64_t LogWriter::GetRotations()
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _rotations;
+	}
+
+	std::string LogWriter::GetCurDateTimeStr()
+	{
+		auto t = std::time(nullptr);
+		struct tm tm;
+		localtime_r(&t, &tm);
+		std::ostringstream oss;
+		oss << std::put_time(&tm, "%d%m%Y%H%M%S");
+		return oss.str();
+	}
+
+	/**
+	 * Hand the active buffer to the writer thread and replace it with one from the pool,
+	 * waiting for the writer to return one if the pool is empty.  Called with the lock held.
+	 */
+	void LogWriter::Submit(std::unique_lock<std::mutex> &lock)
+	{
+		_full.push_back(_active);
+		_submitted++;
+		_active = nullptr;
+		_writeCond.notify_all();
+
+		_freeCond.wait(lock, [this]() { return !_free.empty() || !_run; });
+		if (!_run)
+			return;
+
+		_active = _free.front();
+		_free.pop_front();
+	}
+
+	void LogWriter::Run()
+	{
+		std::unique_lock<std::mutex> lock(_lock);
+
+		while (true)
+		{
+			if (_run && _full.empty() && _opensCompleted == _opensRequested)
+				_writeCond.wait_for(lock, _flushInterval);
+
+			// Group commit whatever has accumulated, even if the buffer is not full yet
+			if (_full.empty() && _active && !_free.empty() && (!_active->Json.empty() || !_active->Bin.empty()))
+			{
+				_full.push_back(_active);
+				_submitted++;
+				_active = _free.front();
+				_free.pop_front();
+			}
+
+			std::deque<Buffer *> batch;
+			batch.swap(_full);
+			uint64_t opensRequested = _opensRequested;
+			Target requested = _requested;
+			lock.unlock();
+
+			for (Buffer *buffer : batch)
+				Write(*buffer);
+
+			if (!batch.empty())
+			{
+				if (_jsonFile.is_open())
+					_jsonFile.flush();
+				if (_binFile.is_open())
+					_binFile.flush();
+			}
+
+			if (opensRequested != _opensCompleted)
+			{
+				CloseFiles();
+				_current = requested;
+				OpenFiles();
+			}
+
+			lock.lock();
+			for (Buffer *buffer : batch)
+			{
+				buffer->Json.clear();
+				buffer->Bin.clear();
+				_free.push_back(buffer);
+			}
+			_completed += batch.size();
+			_opensCompleted = opensRequested;
+
+			_freeCond.notify_all();
+			_doneCond.notify_all();
+
+			if (!_run && _full.empty())
+				break;
+		}
+	}
+
+	/**
+	 * Write one buffer to the open files, rotating the logs once the binary log is full.
+	 * Only called from the writer thread.
+	 */
+	void LogWriter::Write(const Buffer &buffer)
+	{
+		if (_jsonFile.is_open() && !buffer.Json.empty())
+			_jsonFile.write(buffer.Json.data(), buffer.Json.size());
+
+		if (_binFile.is_open() && !buffer.Bin.empty())
+		{
+			_binFile.write(buffer.Bin.data(), buffer.Bin.size());
+			_binSize += buffer.Bin.size();
+		}
+
+		if (_current.MaxFileSize > 0 && _binSize >= _current.MaxFileSize)
+		{
+			CloseFiles();
+			OpenFiles();
+
+			std::lock_guard<std::mutex> lock(_lock);
+			_rotations++;
+		}
+	}
+
+	/**
+	 * Opens a new log file in the directory specified of specified name for logging messages. Any existing
+	 * log is first renamed by the current time and date, and the binary log is moved to an /ode/ directory
+	 * where it can be sent to an ODE using the filewatchscript.sh.  Only called from the writer thread.
+	 */
+	void LogWriter::OpenFiles()
+	{
+		if (_current.Directory.empty() || _current.Filename.empty())
+			return;
+
+		std::string curFilename = _current.Directory + "/" + _current.Filename + ".json";
+		std::string curFilenamebin = _current.Directory + "/" + _current.Filename + ".bin";
+		PLOG(logDEBUG) << "Message Log File: " << curFilename;
+
+		try
+		{
+			if (!boost::filesystem::exists(_current.Directory + "/json/"))
+				boost::filesystem::create_directory(_current.Directory + "/json/");
+			if (!boost::filesystem::exists(_current.Directory + "/ode/"))
+				boost::filesystem::create_directory(_current.Directory + "/ode/");
+		}
+		catch (boost::filesystem::filesystem_error &e)
+		{
+			PLOG(logERROR) << "Unable to create the log directories: " << e.what();
+		}
+
+		std::string dateTime = GetCurDateTimeStr();
+		std::string newFilename = _current.Directory + "/json/" + _current.Filename + dateTime + ".json";
+		std::string newbinFilename = _current.Directory + "/ode/" + _current.Filename + dateTime + ".bin";
+		if (boost::filesystem::exists(curFilenamebin))
+		{
+			if (boost::filesystem::exists(curFilename) && std::rename(curFilename.c_str(), newFilename.c_str()) != 0)
+			{
+				PLOG(logERROR) << "Failed to mv " << curFilename << " to " << newFilename;
+			}
+
+			if (std::rename(curFilenamebin.c_str(), newbinFilename.c_str()) != 0)
+			{
+				PLOG(logERROR) << "Failed to mv " << curFilenamebin << " to " << newbinFilename;
+			}
+		}
+
+		if (_current.WriteJson)
+		{
+			_jsonFile.open(curFilename);
+			if (!_jsonFile.is_open())
+			{
+				PLOG(logERROR) << "Could not open log " << curFilename << ": " << strerror(errno);
+			}
+			else
+			{
+				_jsonFile << "Message JSON Logs" << std::endl;
+			}
+		}
+
+		_binFile.open(curFilenamebin, std::ios::out | std::ios::binary | std::ios::app);
+		if (!_binFile.is_open())
+		{
+			PLOG(logERROR) << "Could not open log " << curFilenamebin << ": " << strerror(errno);
+		}
+
+		boost::system::error_code ec;
+		_binSize = boost::filesystem::file_size(curFilenamebin, ec);
+		if (ec)
+			_binSize = 0;
+	}
+
+	void LogWriter::CloseFiles()
+	{
+		if (_jsonFile.is_open())
+			_jsonFile.close();
+		if (_binFile.is_open())
+			_binFile.close();
+		_binSize = 0;
+	}
+
+} /* namespace MessageLoggerPlugin */
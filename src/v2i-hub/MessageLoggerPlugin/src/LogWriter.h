@@ -0,0 +1,159 @@
+/**
+ * Copyright (C) 2019 LEIDOS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+#ifndef TMX_PLUGINS_MESSAGELOGGERPLUGIN_LOGWRITER_H_
+#define TMX_PLUGINS_MESSAGELOGGERPLUGIN_LOGWRITER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace MessageLoggerPlugin
+{
+
+#define LOG_WRITER_DEFAULT_BUFFER_SIZE (64 * 1024)
+#define LOG_WRITER_DEFAULT_BUFFER_COUNT 8
+#define LOG_WRITER_DEFAULT_FLUSH_INTERVAL_MS 1000
+
+/**
+ * Writes the JSON and binary message logs from a background thread.
+ *
+ * Records are appended into buffers taken from a fixed pool, and a buffer is handed to
+ * the writer thread once it reaches the flush size, so each file sees one write per buffer
+ * instead of one per message.  A partially filled buffer is also handed over when the flush
+ * interval elapses, so a quiet log still reaches the disk.  If every buffer is waiting to be
+ * written, Append() blocks until one is free.
+ *
+ * The log files stay open between writes.  The writer thread closes them only to rotate
+ * the logs once the binary log reaches its maximum size, or when Open() changes the files.
+ */
+class LogWriter
+{
+public:
+	/**
+	 * @param bufferCount The number of buffers in the pool, at least 2.
+	 * @param bufferSize The number of bytes held by a buffer before it is written.
+	 * @param flushInterval The longest time an appended record waits to be written.
+	 */
+	LogWriter(size_t bufferCount = LOG_WRITER_DEFAULT_BUFFER_COUNT,
+			size_t bufferSize = LOG_WRITER_DEFAULT_BUFFER_SIZE,
+			std::chrono::milliseconds flushInterval = std::chrono::milliseconds(LOG_WRITER_DEFAULT_FLUSH_INTERVAL_MS));
+	virtual ~LogWriter();
+
+	/**
+	 * Rotate any existing logs and start writing to <directory>/<filename>.json and .bin.
+	 * Records appended before this call are written to the previous files.
+	 *
+	 * @param directory The directory to write the logs to.
+	 * @param filename The base name of the log files.
+	 * @param maxFileSize The size of the binary log, in bytes, at which the logs are rotated.
+	 * @param writeJson True to also open the JSON log.
+	 */
+	void Open(const std::string &directory, const std::string &filename, uint64_t maxFileSize, bool writeJson);
+
+	/**
+	 * Change the group commit thresholds.
+	 *
+	 * @param bufferSize The number of bytes held by a buffer before it is written.
+	 * @param flushInterval The longest time an appended record waits to be written.
+	 */
+	void SetFlushThresholds(size_t bufferSize, std::chrono::milliseconds flushInterval);
+
+	/**
+	 * Append one message to the logs.
+	 *
+	 * @param json The JSON text for the message, or NULL if there is none.
+	 * @param jsonLength The length of the JSON text.
+	 * @param record The binary record for the message.
+	 * @param recordLength The length of the binary record.
+	 */
+	void Append(const char *json, size_t jsonLength, const char *record, size_t recordLength);
+
+	/**
+	 * Block until every record appended so far has been written to the files.
+	 */
+	void Flush();
+
+	/**
+	 * @return The number of times the logs were rotated because the binary log was full.
+	 */
+	uint64_t GetRotations();
+
+	/**
+	 * @return The current date and time in ddmmyyyyhhmiss format, as used in rotated file names.
+	 */
+	static std::string GetCurDateTimeStr();
+
+private:
+	struct Buffer
+	{
+		std::string Json;
+		std::string Bin;
+	};
+
+	struct Target
+	{
+		std::string Directory;
+		std::string Filename;
+		uint64_t MaxFileSize = 0;
+		bool WriteJson = true;
+	};
+
+	void Run();
+	void Submit(std::unique_lock<std::mutex> &lock);
+	void Write(const Buffer &buffer);
+	void OpenFiles();
+	void CloseFiles();
+
+	std::mutex _lock;
+	std::condition_variable _writeCond;
+	std::condition_variable _freeCond;
+	std::condition_variable _doneCond;
+
+	std::vector<std::unique_ptr<Buffer>> _pool;
+	std::deque<Buffer *> _free;
+	std::deque<Buffer *> _full;
+	Buffer *_active;
+	size_t _bufferSize;
+	std::chrono::milliseconds _flushInterval;
+
+	uint64_t _submitted = 0;
+	uint64_t _completed = 0;
+	uint64_t _opensRequested = 0;
+	uint64_t _opensCompleted = 0;
+	uint64_t _rotations = 0;
+	Target _requested;
+	bool _run = true;
+
+	// Only used by the writer thread
+	Target _current;
+	std::ofstream _jsonFile;
+	std::ofstream _binFile;
+	uint64_t _binSize = 0;
+
+	std::thread _thread;
+};
+
+} /* namespace MessageLoggerPlugin */
+
+#endif /* TMX_PLUGINS_MESSAGELOGGERPLUGIN_LOGWRITER_H_ */
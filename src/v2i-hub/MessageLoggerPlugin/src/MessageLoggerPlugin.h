@@ -22,6 +22,7 @@
 
 #include "PluginClient.h"
 #include "PluginDataMonitor.h"
+#include "LogWriter.h"
 
 #include <iostream>
 #include <cstring>
@@ -81,20 +82,16 @@ private:
 	std::atomic<uint64_t> _frequency{0};
 	DATA_MONITOR(_frequency);   // Declares the
 
-	void OpenMSGLogFile();
-	void CheckMSGLogFileSizeAndRename();
-	std::string  GetCurDateTimeStr();
+	void AppendRecord(cJSON *root, const std::string &record);
 
-	std::ofstream _logFile;
-	std::ofstream _logFilebin;
+	LogWriter _writer;
+	std::atomic<bool> _logJson{true};
 	std::string _filename, _fileDirectory;
 	std::string _curFilename;
-	std::string _curFilenamebin;
-	std::string _newFilename;
-	std::string _curFilenamesize;
-	int _logFilesize;
-	int _logFilebinsize;
-	int _maxFilesizeInMB;
+	std::string _logFormat;
+	int _maxFilesizeInMB = 0;
+	int _flushSizeInKB = 0;
+	int _flushIntervalInMs = 0;
 
 };
 std::mutex _cfgLock;
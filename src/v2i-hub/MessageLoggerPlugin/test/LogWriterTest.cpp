@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "LogWriter.h"
+
+using namespace std;
+using namespace MessageLoggerPlugin;
+
+namespace unit_test
+{
+    class LogWriterTest : public ::testing::Test
+    {
+    public:
+        boost::filesystem::path _directory;
+
+        void SetUp()
+        {
+            _directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+            boost::filesystem::create_directories(_directory);
+        }
+
+        void TearDown()
+        {
+            boost::filesystem::remove_all(_directory);
+        }
+
+        string ReadFile(const string &name)
+        {
+            ifstream in((_directory / name).string(), ios::binary);
+            return string(istreambuf_iterator<char>(in), {});
+        }
+
+        size_t CountFiles(const string &subdirectory)
+        {
+            size_t count = 0;
+            for (auto &entry : boost::filesystem::directory_iterator(_directory / subdirectory))
+            {
+                if (boost::filesystem::is_regular_file(entry.path()))
+                    count++;
+            }
+            return count;
+        }
+    };
+
+    TEST_F(LogWriterTest, WritesBothLogs)
+    {
+        LogWriter writer;
+        writer.Open(_directory.string(), "logTx", 100 * 1048576, true);
+
+        string json = "{\"BsmMessageContent\":[]}";
+        string record("\x01\x02\x00\x03", 4);
+        for (int i = 0; i < 3; i++)
+            writer.Append(json.data(), json.size(), record.data(), record.size());
+        writer.Flush();
+
+        ASSERT_EQ("Message JSON Logs\n" + json + json + json, ReadFile("logTx.json"));
+        ASSERT_EQ(record + record + record, ReadFile("logTx.bin"));
+    }
+
+    TEST_F(LogWriterTest, BinaryFormatSkipsJsonLog)
+    {
+        LogWriter writer;
+        writer.Open(_directory.string(), "logTx", 100 * 1048576, false);
+
+        string record("\x01\xff", 2);
+        writer.Append(NULL, 0, record.data(), record.size());
+        writer.Flush();
+
+        ASSERT_FALSE(boost::filesystem::exists(_directory / "logTx.json"));
+        ASSERT_EQ(record, ReadFile("logTx.bin"));
+    }
+
+    TEST_F(LogWriterTest, FlushesPartialBufferAfterInterval)
+    {
+        LogWriter writer(2, 64 * 1024, chrono::milliseconds(20));
+        writer.Open(_directory.string(), "logTx", 100 * 1048576, true);
+
+        string record("\x01\x02\x03", 3);
+        writer.Append(NULL, 0, record.data(), record.size());
+
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(2);
+        while (ReadFile("logTx.bin").empty() && chrono::steady_clock::now() < deadline)
+            this_thread::sleep_for(chrono::milliseconds(5));
+
+        ASSERT_EQ(record, ReadFile("logTx.bin"));
+    }
+
+    TEST_F(LogWriterTest, ReopenRotatesExistingLogs)
+    {
+        string record(16, 'x');
+        {
+            LogWriter writer;
+            writer.Open(_directory.string(), "logTx", 100 * 1048576, true);
+            writer.Append("{}", 2, record.data(), record.size());
+        }
+
+        LogWriter writer;
+        writer.Open(_directory.string(), "logTx", 100 * 1048576, true);
+        writer.Flush();
+
+        ASSERT_EQ(1u, CountFiles("ode"));
+        ASSERT_EQ(1u, CountFiles("json"));
+        ASSERT_TRUE(ReadFile("logTx.bin").empty());
+    }
+
+    TEST_F(LogWriterTest, RotatesWhenBinaryLogIsFull)
+    {
+        LogWriter writer(4, 256);
+        writer.Open(_directory.string(), "logTx", 1024, false);
+
+        string record(100, 'x');
+        for (int i = 0; i < 30; i++)
+            writer.Append(NULL, 0, record.data(), record.size());
+        writer.Flush();
+
+        ASSERT_LE(2u, writer.GetRotations());
+        ASSERT_LT(ReadFile("logTx.bin").size(), 1024u);
+    }
+
+    /**
+     * Writes 100,000 BSM sized entries to both logs and checks that the writer keeps up with 10,000 a second.
+     * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'.
+     */
+    class LogWriterBenchmark : public LogWriterTest
+    {
+    };
+
+    TEST_F(LogWriterBenchmark, DISABLED_KeepsUpWithTenThousandBsmsPerSecond)
+    {
+        LogWriter writer;
+        writer.Open(_directory.string(), "logTx", 100 * 1048576, true);
+
+        // Roughly the size of a pretty printed BSM entry and its binary record
+        string json(900, 'j');
+        string record(80, 'b');
+
+        static constexpr int count = 100000;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+            writer.Append(json.data(), json.size(), record.data(), record.size());
+        writer.Flush();
+        auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "Logged " << count << " BSMs in " << elapsed << " s (" << (count / elapsed) << " msg/s)" << endl;
+
+        ASSERT_EQ(count * record.size(), boost::filesystem::file_size(_directory / "logTx.bin"));
+        ASSERT_GT(count / elapsed, 10000);
+    }
+}
@@ -28,7 +28,8 @@ namespace MessageReceiver
 	static std::atomic<uint64_t> totalBytes{0};
 	static std::map<std::string, std::atomic<uint32_t>> totalCount;
 
-	MessageReceiverPlugin::MessageReceiverPlugin(std::string name) : TmxMessageManager(name)
+	MessageReceiverPlugin::MessageReceiverPlugin(std::string name) : TmxMessageManager(name),
+		hsmClient(new HttpClient())
 	{
 		errThrottle.set_Frequency(std::chrono::milliseconds(ERROR_WAIT_MS));
 		statThrottle.set_Frequency(std::chrono::milliseconds(STATUS_WAIT_MS));
@@ -49,7 +50,11 @@ namespace MessageReceiver
 		}
 	}
 
-	MessageReceiverPlugin::~MessageReceiverPlugin() {}
+	MessageReceiverPlugin::~MessageReceiverPlugin()
+	{
+		// Stop any outstanding verifications before the rest of the plugin goes away
+		hsmClient.reset();
+	}
 
 	template <typename T>
 	TmxJ2735EncodedMessage<T> *encode(TmxJ2735EncodedMessage<T> &encMsg, T *msg)
@@ -463,6 +468,166 @@ namespace MessageReceiver
 		}
 	}
 
+	// @SONAR_STOP@
+	void MessageReceiverPlugin::VerifyMessage(const tmx::byte_t *bytes, size_t len, uint64_t time)
+	{
+		//  convert unit8_t vector to hex stream
+
+		stringstream ss;
+		ss << std::hex << std::setfill('0');
+
+		for (size_t it = 0; it < len; it++)
+		{
+			ss << std::setw(2) << static_cast<unsigned>(bytes[it]);
+		}
+
+		string msg = ss.str();
+
+		// the incoming payload is hex encoded, convert this to base64
+		std::string base64msg = "";
+
+		hex2base64(msg, base64msg);
+
+		// use this string for verification with base64.
+
+		std::string req = "{\"message\":\"" + base64msg + "\"}";
+
+		std::string verifyUrl;
+		{
+			lock_guard<mutex> lock(syncLock);
+			verifyUrl = url;
+		}
+
+		// The response is handled on the HSM client thread, which then hands the verified message back to Main
+		hsmClient->Post(verifyUrl, req, [this, msg, time](const HttpResponse &response)
+		{
+			OnVerifyResponse(msg, time, response);
+		});
+	}
+
+	void MessageReceiverPlugin::OnVerifyResponse(const std::string &msg, uint64_t time, const HttpResponse &response)
+	{
+		if (!response.Error.empty())
+		{
+			SetStatus<uint>(Key_SkippedSignVerifyError, ++_skippedSignVerifyErrorResponse);
+			PLOG(logERROR) << "Unable to reach SCMS container: " << response.Error;
+			return;
+		}
+
+		PLOG(logDEBUG1) << "SCMS Contain response = " << response.Body << std::endl;
+		cJSON *root = cJSON_Parse(response.Body.c_str());
+		if (!root)
+		{
+			SetStatus<uint>(Key_SkippedSignVerifyError, ++_skippedSignVerifyErrorResponse);
+			PLOG(logERROR) << "Invalid response from SCMS container HTTP code " << response.Status << ": " << response.Body;
+			return;
+		}
+
+		cJSON *status = cJSON_GetObjectItem(root, "code");
+		if (status)
+		{
+			cJSON *message = cJSON_GetObjectItem(root, "message");
+			// IF status code exists this means the SCMS container returned an error response on attempting to sign
+			// Set status will increment the count of message skipped due to signature error responses by one each
+			// time this occurs. This count will be visible under the "State" tab of this plugin.
+			SetStatus<uint>(Key_SkippedSignVerifyError, ++_skippedSignVerifyErrorResponse);
+			PLOG(logERROR) << "Error response from SCMS container HTTP code " << status->valueint << "!\n"
+						   << (message ? message->valuestring : "") << std::endl;
+			cJSON_Delete(root);
+			return;
+		}
+		cJSON *sd = cJSON_GetObjectItem(root, "signatureIsValid");
+
+		int msgValid = sd ? sd->valueint : 0;
+		cJSON_Delete(root);
+
+		if (msgValid != 1)
+		{
+			PLOG(logERROR) << " Unable to verify the incoming message: Message Verification Error and dropped \n";
+			return; // do not send the message out to v2x hub core if validation fails
+		}
+
+		std::vector<string> ids;
+		{
+			lock_guard<mutex> lock(syncLock);
+			ids = messageid;
+		}
+
+		// look for a valid message type. 0012,0013,0014 etc. and count length of bytes to extract the message
+		for (auto itr = ids.begin(); itr != ids.end(); itr++)
+		{
+			// look for the message header within the first 20 bytes.
+			size_t idloc = msg.find(*itr);
+
+			if (idloc != string::npos and idloc < IDCHECKLIMIT) // making sure the msgID lies within the first IDCHECKLIMIT Characters
+			{
+				string extractedmsg;
+				int mlen;
+
+				// message id found
+				if (msg[idloc + 4] == '8') // if the length is longer than 256
+				{
+					string tmp = msg.substr(idloc + 5, 3);
+					const char *c = tmp.c_str();			 // take out next three nibble for length
+					mlen = (strtol(c, nullptr, 16) + 4) * 2; // 5 nibbles added for msgid and the extra 1 byte
+					extractedmsg = msg.substr(idloc, mlen);
+				}
+				else
+				{
+					string tmp = msg.substr(idloc + 4, 2);
+					const char *c = tmp.c_str();			 // take out next three nibble for length
+					mlen = (strtol(c, nullptr, 16) + 3) * 2; // 5 nibbles added for msgid and the extra 1 byte
+					extractedmsg = msg.substr(idloc, mlen);
+				}
+
+				lock_guard<mutex> lock(verifiedLock);
+				verifiedMessages.emplace_back(byte_stream_decode(extractedmsg), time);
+				return; // can break out if already found a msg id
+			}
+		}
+
+		PLOG(logERROR) << " Unable to find any valid msg ID in the incoming message. \n";
+	}
+	// @SONAR_START@
+
+	void MessageReceiverPlugin::ForwardMessage(const tmx::byte_t *bytes, size_t len, uint64_t time)
+	{
+		// Support different encodings
+		string enc;
+		if (len > 0)
+		{
+			switch (bytes[0])
+			{
+			case 0x00:
+				enc = api::ENCODING_ASN1_UPER_STRING;
+				break;
+			case 0x30:
+				enc = api::ENCODING_ASN1_BER_STRING;
+				break;
+			case '{':
+				enc = api::ENCODING_JSON_STRING;
+				break;
+			default:
+				enc = api::ENCODING_BYTEARRAY_STRING;
+				break;
+			}
+		}
+
+		this->IncomingMessage(bytes, len, enc.empty() ? nullptr : enc.c_str(), 0, 0, time);
+	}
+
+	void MessageReceiverPlugin::ForwardVerifiedMessages()
+	{
+		std::deque<std::pair<byte_stream, uint64_t>> verified;
+		{
+			lock_guard<mutex> lock(verifiedLock);
+			verified.swap(verifiedMessages);
+		}
+
+		for (auto &message : verified)
+			ForwardMessage(message.first.data(), message.first.size(), message.second);
+	}
+
 	int MessageReceiverPlugin::Main()
 	{
 		PLOG(logERROR) << "Starting plugin.";
@@ -470,9 +635,6 @@ namespace MessageReceiver
 		byte_stream incoming(4000);
 		std::unique_ptr<tmx::utils::UdpServer> server;
 
-		byte_stream extractedpayload(4000);
-		int mlen = 0;
-
 		while (_plugin->state != IvpPluginState_error)
 		{
 			// See if the server values are different
@@ -498,171 +660,20 @@ namespace MessageReceiver
 					uint64_t time = Clock::GetMillisecondsSinceEpoch();
 
 					totalBytes += len;
-					int txlen = 0;
 
 					// @SONAR_STOP@
 					// if verification enabled, access HSM
 
 					if (verState == 1)
 					{
-
-						//  convert unit8_t vector to hex stream
-
-						stringstream ss;
-						ss << std::hex << std::setfill('0');
-						uint16_t it = 0;
-
-						for (uint16_t it = 0; it < len; it++)
-						{
-							ss << std::setw(2) << static_cast<unsigned>(incoming[it]);
-						}
-
-						string msg = ss.str();
-
-						// the incoming payload is hex encoded, convert this to base64
-						std::string base64msg = "";
-
-						hex2base64(msg, base64msg);
-
-						// use this string for verification with base64.
-
-						std::string req = "\'{\"message\":\"" + base64msg + "\"}\'";
-
-						string cmd1 = "curl -X POST " + url + " -H \'Content-Type: application/json\' -d " + req;
-
-						const char *cmd = cmd1.c_str();
-						char buffer[2048];
-						std::string result = "";
-						FILE *pipemsg = popen(cmd, "r");
-
-						if (pipemsg == NULL)
-							throw std::runtime_error("popen() failed!");
-
-						try
-						{
-							while (fgets(buffer, sizeof(buffer), pipemsg) != NULL)
-							{
-								result += buffer;
-							}
-						}
-						catch (std::exception const &ex)
-						{
-
-							pclose(pipemsg);
-							SetStatus<uint>(Key_SkippedSignVerifyError, ++_skippedSignVerifyErrorResponse);
-							PLOG(logERROR) << "Error parsing Messages: " << ex.what();
-							continue;
-						}
-						PLOG(logDEBUG1) << "SCMS Contain response = " << result << std::endl;
-						cJSON *root = cJSON_Parse(result.c_str());
-						cJSON *status = cJSON_GetObjectItem(root, "code");
-						if (status)
-						{
-							cJSON *message = cJSON_GetObjectItem(root, "message");
-							// IF status code exists this means the SCMS container returned an error response on attempting to sign
-							// Set status will increment the count of message skipped due to signature error responses by one each
-							// time this occurs. This count will be visible under the "State" tab of this plugin.
-							SetStatus<uint>(Key_SkippedSignVerifyError, ++_skippedSignVerifyErrorResponse);
-							PLOG(logERROR) << "Error response from SCMS container HTTP code " << status->valueint << "!\n"
-										   << message->valuestring << std::endl;
-							continue;
-						}
-						cJSON *sd = cJSON_GetObjectItem(root, "signatureIsValid");
-
-						int msgValid = sd->valueint;
-
-						string extractedmsg = "";
-						bool foundId = false;
-
-						if (msgValid == 1)
-						{
-							// look for a valid message type. 0012,0013,0014 etc. and count length of bytes to extract the message
-
-							std::vector<string>::iterator itr = messageid.begin();
-							int mlen;
-
-							while (itr != messageid.end())
-							{
-								// look for the message header within the first 20 bytes.
-								size_t idloc = msg.find(*itr);
-
-								if (idloc != string::npos and idloc < IDCHECKLIMIT) // making sure the msgID lies within the first IDCHECKLIMIT Characters
-								{
-									// message id found
-									if (msg[idloc + 4] == '8') // if the length is longer than 256
-									{
-										string tmp = msg.substr(idloc + 5, 3);
-										const char *c = tmp.c_str();			 // take out next three nibble for length
-										mlen = (strtol(c, nullptr, 16) + 4) * 2; // 5 nibbles added for msgid and the extra 1 byte
-										extractedmsg = msg.substr(idloc, mlen);
-									}
-									else
-									{
-										string tmp = msg.substr(idloc + 4, 2);
-										const char *c = tmp.c_str();			 // take out next three nibble for length
-										mlen = (strtol(c, nullptr, 16) + 3) * 2; // 5 nibbles added for msgid and the extra 1 byte
-										extractedmsg = msg.substr(idloc, mlen);
-									}
-
-									foundId = true;
-
-									int k = 0;
-
-									for (unsigned int i = 0; i < extractedmsg.length(); i += 2)
-									{
-										string bs = extractedmsg.substr(i, 2);
-										uint8_t byte = (uint8_t)strtol(bs.c_str(), nullptr, 16);
-										extractedpayload[k++] = byte;
-										txlen++;
-									}
-									break; // can break out if already found a msg id
-								}
-								itr++;
-							}
-
-							if (foundId == false)
-							{
-								PLOG(logERROR) << " Unable to find any valid msg ID in the incoming message. \n";
-								continue; // do not send the message out to v2x hub if msgid check fails
-							}
-						}
-						else
-						{
-							PLOG(logERROR) << " Unable to verify the incoming message: Message Verification Error and dropped \n";
-
-							continue; // do not send the message out to v2x hub core if validation fails
-						}
+						VerifyMessage(incoming.data(), len, time);
 					}
 					else
 					{
-						extractedpayload = incoming;
-						txlen = len;
+						ForwardMessage(incoming.data(), len, time);
 					}
 
 					// @SONAR_START@
-
-					// Support different encodings
-					string enc;
-					if (extractedpayload.size() > 0)
-					{
-						switch (extractedpayload[0])
-						{
-						case 0x00:
-							enc = api::ENCODING_ASN1_UPER_STRING;
-							break;
-						case 0x30:
-							enc = api::ENCODING_ASN1_BER_STRING;
-							break;
-						case '{':
-							enc = api::ENCODING_JSON_STRING;
-							break;
-						default:
-							enc = api::ENCODING_BYTEARRAY_STRING;
-							break;
-						}
-					}
-
-					this->IncomingMessage(extractedpayload.data(), txlen, enc.empty() ? nullptr : enc.c_str(), 0, 0, time);
 				}
 				else if (len < 0)
 				{
@@ -671,6 +682,8 @@ namespace MessageReceiver
 						PLOG(logERROR) << "Could not receive from socket: " << strerror(errno);
 					}
 				}
+
+				ForwardVerifiedMessages();
 			}
 			catch (exception &ex)
 			{
@@ -9,6 +9,8 @@
 #define SRC_MESSAGERECEIVERPLUGIN_H_
 
 #include <atomic>
+#include <deque>
+#include <HttpClient.h>
 #include <PluginClient.h>
 #include <TmxMessageManager.h>
 #include <UdpClient.h>
@@ -60,6 +62,11 @@ namespace MessageReceiver
 		void OnStateChange(IvpPluginState state);
 
 	private:
+		void VerifyMessage(const tmx::byte_t *bytes, size_t len, uint64_t time);
+		void OnVerifyResponse(const std::string &msg, uint64_t time, const tmx::utils::HttpResponse &response);
+		void ForwardMessage(const tmx::byte_t *bytes, size_t len, uint64_t time);
+		void ForwardVerifiedMessages();
+
 		tmx::messages::BsmMessage *DecodeBsmNew(uint32_t vehicleId, uint32_t heading, uint32_t speed, uint32_t latitude,
 												uint32_t longitude, uint32_t elevation);
 		tmx::messages::BsmMessage *DecodeBsm(uint32_t vehicleId, uint32_t heading, uint32_t speed, uint32_t latitude,
@@ -82,8 +89,13 @@ namespace MessageReceiver
 		std::mutex syncLock;
 		tmx::utils::FrequencyThrottle<int> errThrottle;
 		tmx::utils::FrequencyThrottle<int> statThrottle;
-		uint _skippedSignVerifyErrorResponse;
+		std::atomic<uint> _skippedSignVerifyErrorResponse{0};
 		const char *Key_SkippedSignVerifyError = "Message Skipped (Signature Verification Error Response)";
+		std::unique_ptr<tmx::utils::HttpClient> hsmClient;
+		// Messages verified on the HSM client thread, waiting for Main to forward them.  The worker
+		// queues only allow one thread to add messages, so they are never forwarded from the client thread.
+		std::mutex verifiedLock;
+		std::deque<std::pair<tmx::byte_stream, uint64_t>> verifiedMessages;
 	};
 
 } /* namespace MessageReceiver */
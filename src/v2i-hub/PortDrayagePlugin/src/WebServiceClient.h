@@ -16,12 +16,16 @@
 
 #pragma once
 #include <iostream>
-#include <OAIDefaultApi.h>
+#include <memory>
 #include "PluginLog.h"
-#include <QEventLoop>
+#include "HttpClient.h"
 #include <OAIHelpers.h>
-#include <QTimer>
+#include <QUrl>
+#include <unistd.h>
+#include <OAIContainerRequest.h>
 #include <OAIContainerActionStatus.h>
+#include <OAIInspectionRequest.h>
+#include <OAIInspectionStatus.h>
 
 using namespace OpenAPI;
 using namespace tmx::utils;
@@ -33,23 +37,22 @@ static CONSTEXPR const uint16_t DEF_POLLING_FREQ = 5;
 static CONSTEXPR const bool DEF_SECURITY = false;
 
 /**
- * WebService REST Client using OpenAPI codegen library pdclient found under V2X-Hub/ext/pdclient. Contains several method to
- * send POST requests for loading, unloading, and inspection actions and poll the action status.
+ * WebService REST Client using the request and status models of the OpenAPI codegen library pdclient found under
+ * V2X-Hub/ext/pdclient. Contains several method to send POST requests for loading, unloading, and inspection actions
+ * and poll the action status. Requests are sent through one HttpClient, so the connection to the WebService is kept
+ * open across requests and polls, and failed requests are retried.
  * 
  * @author Paul Bourelly
  */
-class WebServiceClient : public QObject
+class WebServiceClient
 {
-    Q_OBJECT
-public slots:
-
 private:
     // Stored in Seconds
     uint16_t polling_frequency;
 
-
-    // OAIDefaultApi pointer
-    std::shared_ptr<OAIDefaultApi> api;
+    // WebService scheme, host and port
+    std::string base_url;
+    std::unique_ptr<HttpClient> http;
     std::shared_ptr<OAIContainerActionStatus> loading_status;
     std::shared_ptr<OAIContainerActionStatus> unloading_status;
     std::shared_ptr<OAIInspectionStatus> inspection_status;
@@ -85,6 +88,33 @@ private:
      */ 
     void initialize(const std::string &host, uint16_t port, bool secure , uint16_t polling_frequency);
 
+    /**
+     * Method to send a POST request with a JSON body to the WebService and wait for the response.
+     * 
+     * @param path request path, starting with /
+     * @param json request body
+     * @return true if the WebService accepted the request
+     */
+    bool post(const std::string &path, const QString &json);
+
+    /**
+     * Method to send a GET request to the WebService and wait for the response.
+     * 
+     * @param path request path, starting with /
+     * @param json set to the response body
+     * @return true if the WebService answered with a status
+     */
+    bool get(const std::string &path, QString &json);
+
+    /**
+     * Method to build a request path ending with a percent encoded action id.
+     * 
+     * @param path request path, ending with /
+     * @param action_id action id to append
+     * @return the request path
+     */
+    static std::string action_path(const std::string &path, const QString &action_id);
+
 
 public:
 
@@ -15,7 +15,6 @@
 #include <mutex>
 #include <sys/socket.h>
 #include <thread>
-#include <System.h>
 
 using namespace std;
 using namespace tmx;
@@ -125,6 +124,44 @@ void RtcmPlugin::BroadcastRTCMMessage(TmxRtcmMessage &msg, routeable_message &ro
 	}
 }
 
+void RtcmPlugin::BroadcastRTCMBytes(const byte_stream &bytes, const string &version) {
+	PLOG(logDEBUG1) << "RTCM Message Bytes:" << bytes;
+
+	// Convert the bytes to a set of new message
+	TmxRtcmEncodedMessage encodedMsg;
+	encodedMsg.set_subtype(version);
+	encodedMsg.set_payload_bytes(bytes);
+
+	PLOG(logDEBUG2) << "Trying to decode " << encodedMsg;
+
+	for (auto iter = encodedMsg.begin(); iter != encodedMsg.end(); iter++) {
+		if (*iter) this->BroadcastRTCMMessage(**iter, encodedMsg);
+	}
+
+	if (_routeRTCM)
+		this->BroadcastMessage(static_cast<routeable_message &>(encodedMsg));
+}
+
+void RtcmPlugin::HandleRTCMBytes(const byte_t *bytes, size_t length, const string &version) {
+	rtcm::RTCM_VERSION v = rtcm::RtcmVersion(version);
+
+	// RTCM 3 frames carry their own length and CRC, so each one can be decoded on its own
+	// no matter how the stream was split up by the socket.  If the version is not known,
+	// then the stream is taken to be RTCM 3 once the first good frame is found.
+	if (v == rtcm::SC10403_3 || v == rtcm::UNKNOWN) {
+		_framer.push(bytes, length, [this](const byte_t *frame, size_t frameLen) {
+			// Skip the empty frames some casters send to keep the connection alive
+			if (rtcm::Rtcm3Framer::messageNumber(frame))
+				this->BroadcastRTCMBytes(byte_stream(frame, frame + frameLen), rtcm::RtcmVersionName(rtcm::SC10403_3));
+		});
+
+		if (v == rtcm::SC10403_3 || _framer.frameCount() > 0)
+			return;
+	}
+
+	BroadcastRTCMBytes(byte_stream(bytes, bytes + length), version);
+}
+
 int RtcmPlugin::Main() {
 	PLOG(logINFO) << "Plugin started";
 
@@ -181,6 +218,9 @@ int RtcmPlugin::Main() {
 					   << Base64::Encode((unsigned char *)userpass.c_str(), userpass.length())
 					   << "\r\n\r\n";
 
+				// Anything left of a frame from the last connection cannot be completed
+				_framer.reset();
+
 				PLOG(logDEBUG) << "Writing header: \n" << header.str();
 				if (::send(sock, header.str().c_str(), header.str().length(), 0) < 0) {
 					PLOG(logDEBUG) << "Unable to write bytes to socket: " << strerror(errno);
@@ -212,13 +252,17 @@ int RtcmPlugin::Main() {
 				if (!_connected) {
 					PLOG(logDEBUG1) << "Recevied bytes:" << inBytes << endl;
 
+					// The caster may send the first corrections in the same read as the response header
+					string received((const char *)inBytes.data(), recv);
+					size_t headerLen = received.find("\r\n\r\n");
+					headerLen = (headerLen == string::npos ? received.length() : headerLen + 4);
+
 					// Read incoming message by line
-					istringstream inStream(string((const char *)inBytes.data(), recv));
+					istringstream inStream(received.substr(0, headerLen));
 					string line;
 					while (getline(inStream, line)) {
 						if (line[line.length()-1] == '\r') line.erase(line.length()-1);
 						PLOG(logDEBUG1) << line;
-						PLOG(logDEBUG1) << System::ExecCommand("echo '" + line + "' | gpsdecode");
 						response.push_back(line);
 					}
 
@@ -228,6 +272,9 @@ int RtcmPlugin::Main() {
 							_connected = true;
 							SetStatus("Connected", true);
 
+							if (headerLen < (size_t)recv)
+								HandleRTCMBytes(inBytes.data() + headerLen, recv - headerLen, ver);
+
 							if (::strncmp("ICY", response[0].c_str(), 3) == 0) {
 								// Ntrip 1.0 response.  Need to send NMEA string
 								ntripVer = 1;
@@ -254,23 +301,7 @@ int RtcmPlugin::Main() {
 						}
 					}
 				} else {
-					// Convert the bytes to a set of new message
-					tmx::byte_stream bytes(inBytes.begin(), inBytes.begin() + recv);
-
-					PLOG(logDEBUG1) << "RTCM Message Bytes:" << bytes;
-
-					TmxRtcmEncodedMessage encodedMsg;
-					encodedMsg.set_subtype(ver);
-					encodedMsg.set_payload_bytes(bytes);
-
-					PLOG(logDEBUG2) << "Trying to decode " << encodedMsg;
-
-					for (auto iter = encodedMsg.begin(); iter != encodedMsg.end(); iter++) {
-						if (*iter) this->BroadcastRTCMMessage(**iter, encodedMsg);
-					}
-
-					if (_routeRTCM)
-						this->BroadcastMessage(static_cast<routeable_message &>(encodedMsg));
+					HandleRTCMBytes(inBytes.data(), recv, ver);
 				}
 			} else {
 				_connected = false;
@@ -11,6 +11,7 @@
 #include <Base64.h>
 #include <PluginClient.h>
 #include <rtcm/RtcmMessage.h>
+#include <rtcm/Rtcm3Framer.h>
 #include <tmx/j2735_messages/RtcmMessage.hpp>
 #include <tmx/messages/TmxNmea.hpp>
 
@@ -23,6 +24,8 @@ public:
 
 	int Main();
 	void BroadcastRTCMMessage(tmx::messages::TmxRtcmMessage &msg, tmx::routeable_message &routeableMsg);
+	void BroadcastRTCMBytes(const tmx::byte_stream &bytes, const std::string &version);
+	void HandleRTCMBytes(const tmx::byte_t *bytes, size_t length, const std::string &version);
 protected:
 	void UpdateConfigSettings();
 
@@ -39,6 +42,9 @@ private:
 	std::string _nmea;
 	std::string _version;
 	std::atomic<bool> _routeRTCM { false };
+
+	// Used only by the main thread
+	tmx::messages::rtcm::Rtcm3Framer _framer;
 };
 
 } /* namespace RtcmPlugin */
@@ -35,6 +35,12 @@ void Ntcip1202::setSignalGroupMappingList(string json)
 	ptree root;
 	read_json(ss, root);
 
+	std::lock_guard<std::mutex> lock(_spat_lock);
+
+	signalGroupMappingList.clear();
+	_phaseSignalGroups.clear();
+	_spatMovements.clear();
+
 	for(auto & signalGroup : root.get_child("SignalGroups"))
 	{
 		int signalGroupId = signalGroup.second.get<int>("SignalGroupId");
@@ -50,13 +56,31 @@ void Ntcip1202::setSignalGroupMappingList(string json)
 
 		signalGroupMappingList.push_back(sgm);
 	}
+
+	// Index the mapping by phase once, rather than searching it for each phase of every status
+	static const std::pair<const char *, SignalGroupType> types[] = {
+			{ "vehicle", SignalGroupType::Vehicle },
+			{ "pedestrian", SignalGroupType::Pedestrian },
+			{ "overlap", SignalGroupType::Overlap } };
+
+	for (auto &type : types)
+	{
+		for (auto &sgm : signalGroupMappingList)
+		{
+			if (sgm.SignalGroupId > 0 && sgm.PhaseId >= 0 && sgm.PhaseId <= UINT8_MAX && boost::iequals(sgm.Type, type.first))
+				_phaseSignalGroups[sgm.PhaseId].push_back(PhaseSignalGroup { sgm.SignalGroupId, type.second });
+		}
+	}
 }
 
 void Ntcip1202::copyBytesIntoNtcip1202(char* buff, int numBytes)
 {
 	std::lock_guard<std::mutex> lock(_spat_lock);
 
-	std::memcpy(&ntcip1202Data, buff, numBytes);
+	// The status is kept between packets, so clear what a short packet does not fill
+	size_t length = std::min((size_t)std::max(numBytes, 0), sizeof(ntcip1202Data));
+	std::memset(&ntcip1202Data, 0, sizeof(ntcip1202Data));
+	std::memcpy(&ntcip1202Data, buff, length);
 
 	unsigned char * vptr = (unsigned char *)&(ntcip1202Data);
 
@@ -215,21 +239,88 @@ void Ntcip1202::printDebug()
 
 bool Ntcip1202::ToJ2735r41SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId)
 {
-	time_t epochSec = clock->nowInSeconds();
-	struct tm utctime;
-	gmtime_r( &epochSec, &utctime );
+	std::lock_guard<std::mutex> lock(_spat_lock);
 
-	// In SPAT, the time stamp is split into minute of the year and millisecond of the minute
-	// Calculate the minute of the year
-	long minOfYear = utctime.tm_min + (utctime.tm_hour * 60) + (utctime.tm_yday * 24 * 60);
+	buildJ2735SPAT(spat, intersectionName, intersectionId);
 
-	// Calculate the millisecond of the minute
-	auto epochMs = clock->nowInMilliseconds();
-	long msOfMin = 1000 * (epochSec % 60) + (epochMs % 1000);
+	return true;
+}
 
+bool Ntcip1202::UpdateJ2735SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId)
+{
 	std::lock_guard<std::mutex> lock(_spat_lock);
 
+	if (!isSpatCurrent(spat, intersectionName, intersectionId))
+	{
+		buildJ2735SPAT(spat, intersectionName, intersectionId);
+		return true;
+	}
+
+	IntersectionState *intersection = spat->intersections.list.array[0];
+	updateIntersectionTime(intersection);
+
+	uint16_t statusIntersection = ntcip1202Data.spatIntersectionStatus;
+	intersection->status.buf[1] = statusIntersection;
+	intersection->status.buf[0] = (statusIntersection >> 8);
+
+	for (size_t i = 0; i < _spatMovements.size(); i++)
+	{
+		populateSignalGroup(intersection->states.list.array[i], _spatMovements[i].first, _spatMovements[i].second.Type);
+	}
+
+	return false;
+}
+
+void Ntcip1202::getSpatMovements(std::vector<std::pair<uint8_t, PhaseSignalGroup> > &movements)
+{
+	movements.clear();
+
+	// Movement List
+	for (int m = 0; m < 16; m++)
+	{
+		uint8_t phase = ntcip1202Data.phaseTimes[m].phaseNumber;
+
+		auto signalGroups = _phaseSignalGroups.find(phase);
+		if (signalGroups == _phaseSignalGroups.end())
+			continue;
+
+		for (auto &signalGroup : signalGroups->second)
+			movements.push_back(std::make_pair(phase, signalGroup));
+	}
+}
+
+bool Ntcip1202::isSpatCurrent(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId)
+{
+	if (spat->intersections.list.count != 1)
+		return false;
+
+	IntersectionState *intersection = spat->intersections.list.array[0];
+	size_t nameLength = strlen(intersectionName);
+	if (intersection->id.id != intersectionId || !intersection->name || (size_t)intersection->name->size != nameLength ||
+			memcmp(intersection->name->buf, intersectionName, nameLength) != 0)
+		return false;
+
+	if (!intersection->moy || !intersection->timeStamp || intersection->status.size != 2)
+		return false;
+
+	// The controller reports the same phases in the same order, for the same mapping
+	getSpatMovements(_statusMovements);
+	if (_statusMovements != _spatMovements || (size_t)intersection->states.list.count != _spatMovements.size())
+		return false;
+
+	for (size_t i = 0; i < _spatMovements.size(); i++)
+	{
+		if (intersection->states.list.array[i]->signalGroup != _spatMovements[i].second.SignalGroupId)
+			return false;
+	}
+
+	return true;
+}
+
+void Ntcip1202::buildJ2735SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId)
+{
 	ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_SPAT, spat);
+	memset(spat, 0, sizeof(SPAT));
 
 #if SAEJ2735_SPEC < 63
 	spat->msgID = tmx::messages::SpatMessage::get_default_messageId();
@@ -246,10 +337,8 @@ bool Ntcip1202::ToJ2735r41SPAT(SPAT* spat, char* intersectionName, IntersectionI
 	intersection->revision = (MsgCount_t) 1;
 
 	intersection->moy = (MinuteOfTheYear_t *) calloc(1, sizeof(MinuteOfTheYear_t));
-	*(intersection->moy) = minOfYear;
-
 	intersection->timeStamp = (DSecond2_t *) calloc(1, sizeof(DSecond2_t));
-	*(intersection->timeStamp) = msOfMin;
+	updateIntersectionTime(intersection);
 
 	uint16_t statusIntersection = ntcip1202Data.spatIntersectionStatus;
 
@@ -259,72 +348,85 @@ bool Ntcip1202::ToJ2735r41SPAT(SPAT* spat, char* intersectionName, IntersectionI
 	intersection->status.buf[1] = statusIntersection;
 	intersection->status.buf[0] = (statusIntersection >> 8);
 
-	// Movement List
-	for (int m = 0; m < 16; m++)
+	getSpatMovements(_spatMovements);
+	for (auto &spatMovement : _spatMovements)
 	{
-		int phase = ntcip1202Data.phaseTimes[m].phaseNumber;
-
-		for(std::list<SignalGroupMapping>::iterator it = signalGroupMappingList.begin(); it != signalGroupMappingList.end(); it++)
-		{
-			if(it->PhaseId == phase && boost::iequals(it->Type,"vehicle"))
-			{
-				if(it->SignalGroupId > 0)
-				{
-					MovementState *movement = (MovementState *) calloc(1, sizeof(MovementState));
-					movement->signalGroup = it->SignalGroupId;
-
-					populateVehicleSignalGroup(movement, phase);
+		MovementState *movement = (MovementState *) calloc(1, sizeof(MovementState));
+		movement->signalGroup = spatMovement.second.SignalGroupId;
 
-					ASN_SEQUENCE_ADD(&intersection->states.list, movement);
-				}
-
-			}
-		}
+		populateSignalGroup(movement, spatMovement.first, spatMovement.second.Type);
 
-		for(std::list<SignalGroupMapping>::iterator it = signalGroupMappingList.begin(); it != signalGroupMappingList.end(); it++)
-		{
-			if(it->PhaseId == phase && boost::iequals(it->Type,"pedestrian"))
-			{
-				if(it->SignalGroupId > 0)
-				{
-					MovementState *movement = (MovementState *) calloc(1, sizeof(MovementState));
-					movement->signalGroup = it->SignalGroupId;
-
-					populatePedestrianSignalGroup(movement, phase);
-
-					ASN_SEQUENCE_ADD(&intersection->states.list, movement);
-				}
-			}
-		}
+		ASN_SEQUENCE_ADD(&intersection->states.list, movement);
+	}
+	ASN_SEQUENCE_ADD(&(spat->intersections.list), intersection);
+}
 
-		for(std::list<SignalGroupMapping>::iterator it = signalGroupMappingList.begin(); it != signalGroupMappingList.end(); it++)
-		{
-			if(it->PhaseId == phase && boost::iequals(it->Type,"overlap"))
-			{
-				if(it->SignalGroupId > 0)
-				{
-					MovementState *movement = (MovementState *) calloc(1, sizeof(MovementState));
-					movement->signalGroup = it->SignalGroupId;
+void Ntcip1202::updateIntersectionTime(IntersectionState *intersection)
+{
+	time_t epochSec = clock->nowInSeconds();
+	struct tm utctime;
+	gmtime_r( &epochSec, &utctime );
 
-					populateOverlapSignalGroup(movement, phase);
+	// In SPAT, the time stamp is split into minute of the year and millisecond of the minute
+	// Calculate the minute of the year
+	long minOfYear = utctime.tm_min + (utctime.tm_hour * 60) + (utctime.tm_yday * 24 * 60);
 
-					ASN_SEQUENCE_ADD(&intersection->states.list, movement);
-				}
+	// Calculate the millisecond of the minute
+	auto epochMs = clock->nowInMilliseconds();
+	long msOfMin = 1000 * (epochSec % 60) + (epochMs % 1000);
 
-			}
-		}
+	*(intersection->moy) = minOfYear;
+	*(intersection->timeStamp) = msOfMin;
+}
 
+void Ntcip1202::populateSignalGroup(MovementState *movement, int phase, SignalGroupType type)
+{
+	switch (type)
+	{
+	case SignalGroupType::Vehicle:
+		populateVehicleSignalGroup(movement, phase);
+		break;
+	case SignalGroupType::Pedestrian:
+		populatePedestrianSignalGroup(movement, phase);
+		break;
+	case SignalGroupType::Overlap:
+		populateOverlapSignalGroup(movement, phase);
+		break;
+	}
+}
 
+// The event for a movement, which is added the first time the movement is populated
+static MovementEvent *getMovementEvent(MovementState *movement)
+{
+	if (movement->state_time_speed.list.count == 0)
+	{
+		MovementEvent *stateTimeSpeed = (MovementEvent *) calloc(1, sizeof(MovementEvent));
+		stateTimeSpeed->timing = (TimeChangeDetails * ) calloc(1, sizeof(TimeChangeDetails));
+		ASN_SEQUENCE_ADD(&movement->state_time_speed.list, stateTimeSpeed);
 	}
-	ASN_SEQUENCE_ADD(&(spat->intersections.list), intersection);
 
+	return movement->state_time_speed.list.array[0];
+}
 
-	return true;
+// Set the max end time of an event, or remove it if there is none
+static void setMaxEndTime(MovementEvent *stateTimeSpeed, bool hasMaxEndTime, long maxEndTime)
+{
+	if (hasMaxEndTime)
+	{
+		if (!stateTimeSpeed->timing->maxEndTime)
+			stateTimeSpeed->timing->maxEndTime = (TimeMark_t *) calloc(1, sizeof(TimeMark_t));
+		*(stateTimeSpeed->timing->maxEndTime) = maxEndTime;
+	}
+	else if (stateTimeSpeed->timing->maxEndTime)
+	{
+		free(stateTimeSpeed->timing->maxEndTime);
+		stateTimeSpeed->timing->maxEndTime = nullptr;
+	}
 }
 
 void Ntcip1202::populateVehicleSignalGroup(MovementState *movement, int phase)
 {
-	MovementEvent *stateTimeSpeed = (MovementEvent *) calloc(1, sizeof(MovementEvent));
+	MovementEvent *stateTimeSpeed = getMovementEvent(movement);
 
 	bool isFlashing = getPhaseFlashingStatus(phase);
 	bool forceFlashing = isFlashingStatus();
@@ -360,14 +462,10 @@ void Ntcip1202::populateVehicleSignalGroup(MovementState *movement, int phase)
 		stateTimeSpeed->eventState = MovementPhaseState_dark;
 	}
 
-	stateTimeSpeed->timing = (TimeChangeDetails * ) calloc(1, sizeof(TimeChangeDetails));
 	stateTimeSpeed->timing->minEndTime =  getAdjustedTime(getVehicleMinTime(phase));
 
-	if (getVehicleMaxTime(phase) > 0)
-	{
-		stateTimeSpeed->timing->maxEndTime = (TimeMark_t *) calloc(1, sizeof(TimeMark_t));
-		*(stateTimeSpeed->timing->maxEndTime) = getAdjustedTime(getVehicleMaxTime(phase));
-	}
+	bool hasMaxEndTime = getVehicleMaxTime(phase) > 0;
+	setMaxEndTime(stateTimeSpeed, hasMaxEndTime, hasMaxEndTime ? getAdjustedTime(getVehicleMaxTime(phase)) : 0);
 
 	//we only get a phase number 1-16 from ped detect, assume its a ped phase
 //	if(getSpatPedestrianDetect(phase))
@@ -380,13 +478,11 @@ void Ntcip1202::populateVehicleSignalGroup(MovementState *movement, int phase)
 //		*(pedDetect->pedBicycleDetect) = 1;
 //		ASN_SEQUENCE_ADD(&movement->maneuverAssistList->list, pedDetect);
 //	}
-
-	ASN_SEQUENCE_ADD(&movement->state_time_speed.list, stateTimeSpeed);
 }
 
 void Ntcip1202::populatePedestrianSignalGroup(MovementState *movement, int phase)
 {
-	MovementEvent *stateTimeSpeed = (MovementEvent *) calloc(1, sizeof(MovementEvent));
+	MovementEvent *stateTimeSpeed = getMovementEvent(movement);
 
 	if(getPhaseDontWalkStatus(phase))
 	{
@@ -405,16 +501,20 @@ void Ntcip1202::populatePedestrianSignalGroup(MovementState *movement, int phase
 		stateTimeSpeed->eventState = MovementPhaseState_dark;
 	}
 
-	stateTimeSpeed->timing = (TimeChangeDetails * ) calloc(1, sizeof(TimeChangeDetails));
 	stateTimeSpeed->timing->minEndTime =  getAdjustedTime(getPedMinTime(phase));
 
-	if (ntcip1202Data.phaseTimes[phase].spatPedMaxTimeToChange > 0)
+	bool hasMaxEndTime = ntcip1202Data.phaseTimes[phase].spatPedMaxTimeToChange > 0;
+	setMaxEndTime(stateTimeSpeed, hasMaxEndTime, hasMaxEndTime ? getAdjustedTime(getPedMaxTime(phase)) : 0);
+
+	if(!getSpatPedestrianDetect(phase))
 	{
-		stateTimeSpeed->timing->maxEndTime = (TimeMark_t *) calloc(1, sizeof(TimeMark_t));
-		*(stateTimeSpeed->timing->maxEndTime) = getAdjustedTime(getPedMaxTime(phase));
+		if (movement->maneuverAssistList)
+		{
+			ASN_STRUCT_FREE(asn_DEF_ManeuverAssistList, movement->maneuverAssistList);
+			movement->maneuverAssistList = nullptr;
+		}
 	}
-
-	if(getSpatPedestrianDetect(phase))
+	else if (!movement->maneuverAssistList)
 	{
 		movement->maneuverAssistList = (ManeuverAssistList *) calloc(1, sizeof(ManeuverAssistList));
 		ConnectionManeuverAssist *pedDetect = (ConnectionManeuverAssist *) calloc(1, sizeof(ConnectionManeuverAssist));
@@ -424,12 +524,11 @@ void Ntcip1202::populatePedestrianSignalGroup(MovementState *movement, int phase
 		*(pedDetect->pedBicycleDetect) = 1;
 		ASN_SEQUENCE_ADD(&movement->maneuverAssistList->list, pedDetect);
 	}
-	ASN_SEQUENCE_ADD(&movement->state_time_speed.list, stateTimeSpeed);
 }
 
 void Ntcip1202::populateOverlapSignalGroup(MovementState *movement, int phase)
 {
-	MovementEvent *stateTimeSpeed = (MovementEvent *) calloc(1, sizeof(MovementEvent));
+	MovementEvent *stateTimeSpeed = getMovementEvent(movement);
 
 	bool isFlashing = getOverlapFlashingStatus(phase);
 
@@ -461,14 +560,10 @@ void Ntcip1202::populateOverlapSignalGroup(MovementState *movement, int phase)
 		stateTimeSpeed->eventState = MovementPhaseState_dark;
 	}
 
-	stateTimeSpeed->timing = (TimeChangeDetails * ) calloc(1, sizeof(TimeChangeDetails));
 	stateTimeSpeed->timing->minEndTime =  getAdjustedTime(getOverlapMinTime(phase));
 
-	if (getOverlapMaxTime(phase) > 0)
-	{
-		stateTimeSpeed->timing->maxEndTime = (TimeMark_t *) calloc(1, sizeof(TimeMark_t));
-		*(stateTimeSpeed->timing->maxEndTime) = getAdjustedTime(getOverlapMaxTime(phase));
-	}
+	bool hasMaxEndTime = getOverlapMaxTime(phase) > 0;
+	setMaxEndTime(stateTimeSpeed, hasMaxEndTime, hasMaxEndTime ? getAdjustedTime(getOverlapMaxTime(phase)) : 0);
 
 	//we only get a phase number 1-16 from ped detect, assume its a ped phase
 //	if(getSpatPedestrianDetect(phase))
@@ -481,8 +576,6 @@ void Ntcip1202::populateOverlapSignalGroup(MovementState *movement, int phase)
 //		*(pedDetect->pedBicycleDetect) = 1;
 //		ASN_SEQUENCE_ADD(&movement->maneuverAssistList->list, pedDetect);
 //	}
-
-	ASN_SEQUENCE_ADD(&movement->state_time_speed.list, stateTimeSpeed);
 }
 
 //this method assumes only one signal group per phase and will return last match, DONT USE
@@ -10,6 +10,8 @@
 
 #include <mutex>
 #include <list>
+#include <map>
+#include <vector>
 
 #include <tmx/j2735_messages/SpatMessage.hpp>
 
@@ -65,6 +67,25 @@ struct SignalGroupMapping
 	string Type;
 };
 
+enum class SignalGroupType
+{
+	Vehicle,
+	Pedestrian,
+	Overlap
+};
+
+// A movement in the SPAT for a signal group mapped to a phase
+struct PhaseSignalGroup
+{
+	int SignalGroupId;
+	SignalGroupType Type;
+
+	bool operator==(const PhaseSignalGroup &other) const
+	{
+		return SignalGroupId == other.SignalGroupId && Type == other.Type;
+	}
+};
+
 class Ntcip1202
 {
 	public:
@@ -106,6 +127,13 @@ class Ntcip1202
 		bool isPhaseFlashing();
 
 		bool ToJ2735r41SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId);
+		/**
+		 * Update a SPAT built by ToJ2735r41SPAT from the current status in place, without
+		 * allocating it again.  The SPAT is rebuilt if its movements no longer match the
+		 * phases reported by the controller.
+		 * @return True if the SPAT was rebuilt
+		 */
+		bool UpdateJ2735SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId);
 
 		void printDebug();
 	private:
@@ -117,6 +145,18 @@ class Ntcip1202
 		std::mutex _spat_lock;
 
 		list<SignalGroupMapping> signalGroupMappingList;
+		// The signal groups of each phase, vehicle then pedestrian then overlap, built once from the mapping
+		std::map<uint8_t, std::vector<PhaseSignalGroup> > _phaseSignalGroups;
+		// The phase of each movement in the last SPAT built, in order
+		std::vector<std::pair<uint8_t, PhaseSignalGroup> > _spatMovements;
+		// The phase of each movement for the current status
+		std::vector<std::pair<uint8_t, PhaseSignalGroup> > _statusMovements;
+
+		void getSpatMovements(std::vector<std::pair<uint8_t, PhaseSignalGroup> > &movements);
+		bool isSpatCurrent(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId);
+		void buildJ2735SPAT(SPAT* spat, char* intersectionName, IntersectionID_t intersectionId);
+		void updateIntersectionTime(IntersectionState *intersection);
+		void populateSignalGroup(MovementState *movement, int phase, SignalGroupType type);
 
 		int getVehicleSignalGroupForPhase(int phase);
 		int getPedestrianSignalGroupForPhase(int phase);
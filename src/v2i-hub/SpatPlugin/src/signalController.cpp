@@ -39,6 +39,7 @@ SignalController::~SignalController() {
 void SignalController::Start(std::string signalGroupMappingJson)
 {
 	_signalGroupMappingJson = signalGroupMappingJson;
+	_ntcip1202.setSignalGroupMappingList(_signalGroupMappingJson);
 
 	// Create mutex for the Spat message
 	pthread_mutex_init(&spat_message_mutex, nullptr);
@@ -166,26 +167,7 @@ void SignalController::start_signalController()
 					else {
 
 						IsReceiving = 1;
-						pthread_mutex_lock(&spat_message_mutex);
-						auto ntcip1202 = std::make_shared<Ntcip1202>(clock);
-						ntcip1202->setSignalGroupMappingList(_signalGroupMappingJson);
-						//printf("Signal Controller calling ntcip1202 copyBytesIntoNtcip1202");
-						ntcip1202->copyBytesIntoNtcip1202(buf, numbytes);
-
-						//printf("Signal Controller calling ntcip1202 ToJ2735r41SPAT");
-						SPAT *_spat = (SPAT *) calloc(1, sizeof(SPAT));
-						ntcip1202->ToJ2735r41SPAT(_spat, _intersectionName, _intersectionId);
-						
-						//printf("Signal Controller calling _spatMessage set_j2735_data\n");
-						//_spatMessage.set_j2735_data(_spat);
-						if (_spatMessage != nullptr)
-						{
-							_spatMessage = nullptr;
-						}
-						_spatMessage = std::make_shared<tmx::messages::SpatMessage>(_spat);
-
-						pthread_mutex_unlock(&spat_message_mutex);
-						PLOG(logDEBUG) << *_spatMessage;
+						updateSpat(buf, numbytes);
 					}
 				}
 			}
@@ -193,17 +175,64 @@ void SignalController::start_signalController()
 	    }
 }
 
+void SignalController::updateSpat(const char *buf, int numBytes)
+{
+	//printf("Signal Controller calling ntcip1202 copyBytesIntoNtcip1202");
+	_ntcip1202.copyBytesIntoNtcip1202(const_cast<char *>(buf), numBytes);
+
+	if (_spat == nullptr)
+	{
+		_spat = std::shared_ptr<SPAT>((SPAT *) calloc(1, sizeof(SPAT)), [](SPAT *spat) { ASN_STRUCT_FREE(asn_DEF_SPAT, spat); });
+		_spatMessage = std::make_shared<tmx::messages::SpatMessage>(_spat);
+	}
+
+	//printf("Signal Controller calling ntcip1202 UpdateJ2735SPAT");
+	if (_ntcip1202.UpdateJ2735SPAT(_spat.get(), _intersectionName, _intersectionId))
+	{
+		PLOG(logDEBUG) << "SPAT movements rebuilt for the phases reported by the controller";
+	}
+
+	// Only this thread changes the front buffer, so the back buffer is not being read
+	int back = 1 - _encodedSpatFront;
+	try
+	{
+		SpatEncodedMessage spatEncodedMsg;
+		PedestrianDetectionForSPAT pedDetect;
+		pedDetect.updateEncodedSpat(spatEncodedMsg, _spatMessage, "");
+		_encodedSpat[back] = spatEncodedMsg.get_data();
+	}
+	catch (exception &ex)
+	{
+		PLOG(logERROR) << "Unable to encode SPAT: " << ex.what();
+		return;
+	}
+
+	pthread_mutex_lock(&spat_message_mutex);
+	_encodedSpatFront = back;
+	_hasEncodedSpat = true;
+	pthread_mutex_unlock(&spat_message_mutex);
+
+	PLOG(logDEBUG) << *_spatMessage;
+}
+
 void SignalController::getEncodedSpat(SpatEncodedMessage* spatEncodedMsg, std::string currentPedLanes)
 {
 	pthread_mutex_lock(&spat_message_mutex);
 
-	if (_spatMessage != nullptr) {
-		PedestrianDetectionForSPAT pedDetect;
-		pedDetect.updateEncodedSpat(*spatEncodedMsg, _spatMessage, currentPedLanes);
+	if (_hasEncodedSpat) {
+		spatEncodedMsg->set_data(_encodedSpat[_encodedSpatFront]);
 	}
 
 	pthread_mutex_unlock(&spat_message_mutex);
 
+	if (!currentPedLanes.empty() && !spatEncodedMsg->get_data().empty()) {
+		// Add the detections to a decoded copy, since the SPAT itself belongs to the receiver thread
+		std::unique_ptr<MessageFrameMessage> frame(TmxJ2735EncodedMessage<MessageFrameMessage>::decode_j2735_message<
+				codec::uper<MessageFrameMessage> >(spatEncodedMsg->get_data()));
+		auto spatMessage = std::make_shared<SpatMessage>(frame->get_j2735_data());
+		PedestrianDetectionForSPAT pedDetect;
+		pedDetect.updateEncodedSpat(*spatEncodedMsg, spatMessage, currentPedLanes);
+	}
 }
 
 int SignalController::getIsConnected()
@@ -18,11 +18,13 @@
 
 #include "carma-clock/carma_clock.h"
 
+#include "NTCIP1202.h"
+
 class SignalController
 {
 	public:
 		inline explicit SignalController(std::shared_ptr<fwha_stol::lib::time::CarmaClock> clock) :
-			clock(clock) {};
+			clock(clock), _ntcip1202(clock) {};
 		~SignalController();
 
 		void Start(std::string signalGroupMappingJson);
@@ -35,6 +37,16 @@ class SignalController
 
 		//int getDerEncodedSpat(unsigned char* derEncodedBuffer);
 
+		/**
+		 * Update the SPAT from a status packet received from the controller, and encode it for getEncodedSpat.
+		 * The SPAT is updated in place, and the encoding is written to the buffer not being read.
+		 */
+		void updateSpat(const char *buf, int numBytes);
+
+		/**
+		 * Get the SPAT encoded from the last status packet, adding any pedestrian detections.  This does not
+		 * wait for a packet being processed.
+		 */
 		void getEncodedSpat(tmx::messages::SpatEncodedMessage* spatEncodedMsg, std::string currentPedLanes = "");
 
 		pthread_mutex_t spat_message_mutex;
@@ -59,7 +71,16 @@ class SignalController
 		uint32_t _tscRemoteSnmpPort;
 
 		std::string _signalGroupMappingJson;
+		// Status from the controller and the signal group mapping, which is parsed once
+		Ntcip1202 _ntcip1202;
+		// The SPAT, which is kept between packets and updated in place
+		std::shared_ptr<SPAT> _spat;
 		std::shared_ptr<tmx::messages::SpatMessage> _spatMessage;
+		// The SPAT encoded from the last two packets.  The receiver thread encodes into the back buffer,
+		// then swaps it to the front while holding spat_message_mutex.
+		tmx::byte_stream _encodedSpat[2];
+		int _encodedSpatFront{0};
+		bool _hasEncodedSpat{false};
 		int counter;
 		unsigned long normalstate;
 		unsigned long crossstate;
@@ -2,9 +2,32 @@
 #include <gtest/gtest.h>
 #include <tmx/j2735_messages/SpatMessage.hpp>
 #include <NTCIP1202.h>
+#include <PedestrianDetectionForSPAT.h>
+
+#include <chrono>
+#include <vector>
 
 using namespace fwha_stol::lib::time;
 
+// A status packet captured from a controller, with phases 1 to 8 in use
+static std::vector<char> createStatusPacket()
+{
+    unsigned int raw_data[] =  {4294967245, 16, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 118, 0, 118, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 4294967208, 0, 4294967208, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 118, 0, 118, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 0, 4294967208, 0, 4294967208, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4294967295, 4294967261, 0, 0, 0, 34, 4294967295, 4294967295, 0, 0, 0, 0, 4294967295, 4294967295, 0, 0, 0, 0, 0, 0, 0, 0, 4294967168, 0, 8, 103, 1, 10, 4294967237, 0, 0};
+    std::vector<char> buf;
+    for (auto byte : raw_data)
+        buf.push_back(static_cast<char>(byte));
+    return buf;
+}
+
+static const std::string signalGroupMappingJson = "{\"SignalGroups\":[{\"SignalGroupId\":1,\"Phase\":1,\"Type\":\"vehicle\"},{\"SignalGroupId\":2,\"Phase\":2,\"Type\":\"vehicle\"},{\"SignalGroupId\":3,\"Phase\":3,\"Type\":\"vehicle\"},{\"SignalGroupId\":4,\"Phase\":4,\"Type\":\"vehicle\"},{\"SignalGroupId\":5,\"Phase\":5,\"Type\":\"vehicle\"},{\"SignalGroupId\":6,\"Phase\":6,\"Type\":\"vehicle\"},{\"SignalGroupId\":7,\"Phase\":7,\"Type\":\"vehicle\"},{\"SignalGroupId\":8,\"Phase\":8,\"Type\":\"vehicle\"},{\"SignalGroupId\":22,\"Phase\":2,\"Type\":\"pedestrian\"},{\"SignalGroupId\":24,\"Phase\":4,\"Type\":\"pedestrian\"},{\"SignalGroupId\":26,\"Phase\":6,\"Type\":\"pedestrian\"},{\"SignalGroupId\":28,\"Phase\":8,\"Type\":\"pedestrian\"}]}";
+
+static std::string encodeSpat(SPAT *spat)
+{
+    tmx::messages::SpatEncodedMessage spatEncoded;
+    PedestrianDetectionForSPAT().updateEncodedSpat(spatEncoded, std::make_shared<tmx::messages::SpatMessage>(*spat), "");
+    return spatEncoded.get_payload_str();
+}
+
 TEST(NTCIP1202Test, copyBytesIntoNtcip1202)
 {
     DescriptiveName_t *update_to_intersection_name = (DescriptiveName_t *)calloc(1, sizeof(DescriptiveName_t));
@@ -80,4 +103,96 @@ TEST(NTCIP1202Test, TestAdjustedTime)
     // cross hour boundary
     result = ntcip1202_p->getAdjustedTime(10200);
     EXPECT_EQ((baseTenthsOfSeconds + 10200) % 36000, result);
-}
\ No newline at end of file
+}
+TEST(NTCIP1202Test, UpdateJ2735SPAT)
+{
+    auto clock = std::make_shared<CarmaClock>(true);
+    clock->update((uint64_t)1677775434 * 1000 + 400);
+    char intersectionName[] = "test intersection name";
+    auto buf = createStatusPacket();
+
+    Ntcip1202 ntcip1202(clock);
+    ntcip1202.setSignalGroupMappingList(signalGroupMappingJson);
+    ntcip1202.copyBytesIntoNtcip1202(buf.data(), buf.size());
+    std::shared_ptr<SPAT> spat((SPAT *)calloc(1, sizeof(SPAT)), [](SPAT *spat) { ASN_STRUCT_FREE(asn_DEF_SPAT, spat); });
+    ASSERT_TRUE(ntcip1202.UpdateJ2735SPAT(spat.get(), intersectionName, 9012));
+    ASSERT_EQ(12, spat->intersections.list.array[0]->states.list.count);
+    MovementState *movement = spat->intersections.list.array[0]->states.list.array[0];
+
+    // A new status for the same phases is written into the same SPAT
+    buf[17] = 90;
+    clock->update((uint64_t)1677775434 * 1000 + 500);
+    ntcip1202.copyBytesIntoNtcip1202(buf.data(), buf.size());
+    ASSERT_FALSE(ntcip1202.UpdateJ2735SPAT(spat.get(), intersectionName, 9012));
+    ASSERT_EQ(movement, spat->intersections.list.array[0]->states.list.array[0]);
+
+    // It is the same as a SPAT built from the status
+    std::shared_ptr<SPAT> expected((SPAT *)calloc(1, sizeof(SPAT)), [](SPAT *spat) { ASN_STRUCT_FREE(asn_DEF_SPAT, spat); });
+    ASSERT_TRUE(ntcip1202.ToJ2735r41SPAT(expected.get(), intersectionName, 9012));
+    ASSERT_EQ(encodeSpat(expected.get()), encodeSpat(spat.get()));
+
+    // The SPAT is rebuilt when a phase is no longer reported
+    buf[28] = 0;
+    ntcip1202.copyBytesIntoNtcip1202(buf.data(), buf.size());
+    ASSERT_TRUE(ntcip1202.UpdateJ2735SPAT(spat.get(), intersectionName, 9012));
+    ASSERT_EQ(11, spat->intersections.list.array[0]->states.list.count);
+    ASSERT_TRUE(ntcip1202.ToJ2735r41SPAT(expected.get(), intersectionName, 9012));
+    ASSERT_EQ(encodeSpat(expected.get()), encodeSpat(spat.get()));
+}
+
+/**
+ * Time to generate the encoded SPAT from replayed status packets, building the SPAT for each packet
+ * as the SignalController did before, and updating one SPAT in place.
+ * Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+ */
+TEST(NTCIP1202Test, DISABLED_benchmarkSpatGeneration)
+{
+    static constexpr int count = 2000;
+
+    auto clock = std::make_shared<CarmaClock>();
+    char intersectionName[] = "test intersection name";
+    std::vector<std::vector<char>> packets;
+    for (int i = 0; i < 100; i++)
+    {
+        auto buf = createStatusPacket();
+        // Count down the time to change for phases 2 and 6
+        buf[17] = buf[69] = 118 - i;
+        buf[19] = buf[71] = 118 - i;
+        packets.push_back(buf);
+    }
+
+    std::string encoded;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        auto &buf = packets[i % packets.size()];
+        auto ntcip1202 = std::make_shared<Ntcip1202>(clock);
+        ntcip1202->setSignalGroupMappingList(signalGroupMappingJson);
+        ntcip1202->copyBytesIntoNtcip1202(buf.data(), buf.size());
+        SPAT *spat = (SPAT *)calloc(1, sizeof(SPAT));
+        ntcip1202->ToJ2735r41SPAT(spat, intersectionName, 9012);
+        encoded = encodeSpat(spat);
+        ASN_STRUCT_FREE(asn_DEF_SPAT, spat);
+    }
+    double built = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+
+    Ntcip1202 ntcip1202(clock);
+    ntcip1202.setSignalGroupMappingList(signalGroupMappingJson);
+    std::shared_ptr<SPAT> spat((SPAT *)calloc(1, sizeof(SPAT)), [](SPAT *spat) { ASN_STRUCT_FREE(asn_DEF_SPAT, spat); });
+    int rebuilt = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        auto &buf = packets[i % packets.size()];
+        ntcip1202.copyBytesIntoNtcip1202(buf.data(), buf.size());
+        rebuilt += ntcip1202.UpdateJ2735SPAT(spat.get(), intersectionName, 9012) ? 1 : 0;
+        encoded = encodeSpat(spat.get());
+    }
+    double updated = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+
+    printf("%d status packets of %zu bytes replayed\n", count, packets[0].size());
+    printf("  SPAT built per packet   %9.1f us/packet\n", built);
+    printf("  SPAT updated in place   %9.1f us/packet\n", updated);
+
+    ASSERT_EQ(1, rebuilt);
+}
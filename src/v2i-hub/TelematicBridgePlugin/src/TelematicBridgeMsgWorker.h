@@ -1,6 +1,7 @@
 #pragma once
 #include "PluginLog.h"
 #include <tmx/messages/TmxJ2735.hpp>
+#include <tmx/utils/ByteCodec.h>
 #include "TelematicBridgeException.h"
 #include "jsoncpp/json/json.h"
 #include <boost/algorithm/string.hpp>
@@ -30,39 +31,25 @@ namespace TelematicBridge
      */
     bool HexToBytes(const string &hexPaylod, vector<char> &byteBuffer)
     {
-        uint8_t d = 0;
-        int i = 0;
+        auto offset = byteBuffer.size();
+        auto pairs = hexPaylod.size() / 2;
+        byteBuffer.resize(offset + (hexPaylod.size() + 1) / 2);
 
-        for (const char &c : hexPaylod)
+        auto bytes = reinterpret_cast<uint8_t *>(byteBuffer.data() + offset);
+        if (byteCodec_hexDecode(hexPaylod.data(), hexPaylod.size(), bytes) != pairs)
         {
-            if (c <= '9' && c >= '0')
-            {
-                d = c - '0';
-            }
-            else if (c <= 'F' && c >= 'A')
-            {
-                d = c - 55; // c - 'A' + 10
-            }
-            else if (c <= 'f' && c >= 'a')
-            {
-                d = c - 87; // c - 'a' + 10;
-            }
-            else
-            {
-                return false;
-            }
+            return false;
+        }
 
-            if (i % 2)
-            {
-                // low order nibble.
-                byteBuffer.back() |= d;
-            }
-            else
+        if (hexPaylod.size() % 2)
+        {
+            // An odd last digit is the high order nibble.
+            int d = tmx::hex_digit_value(hexPaylod.back());
+            if (d < 0)
             {
-                // high order nibble.
-                byteBuffer.push_back(d << 4);
+                return false;
             }
-            ++i;
+            bytes[pairs] = d << 4;
         }
         return true;
     }